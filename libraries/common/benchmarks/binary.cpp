@@ -0,0 +1,133 @@
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <common/include/binary.hpp>
+
+namespace common::benchmarks::binary {
+
+namespace {
+
+/// @class Temporary file removed with the benchmark.
+class TempFile {
+public:
+    explicit TempFile(const std::string& name)
+        : path_{std::filesystem::temp_directory_path() / name} {}
+    ~TempFile() {
+        std::error_code error_code{};
+        std::filesystem::remove(path_, error_code);
+    }
+
+    const std::filesystem::path& GetPath() const {
+        return path_;
+    }
+
+private:
+    std::filesystem::path path_;
+};
+
+// values written per a single stream, so the file open is amortized
+constexpr size_t kValuesPerStream = 1024;
+
+void BM_BinaryOutNumbers(benchmark::State& state) {
+    TempFile file("bench_binary_out_numbers.bin");
+    for (auto _ : state) {
+        common::binary::BinaryOutStream stream(file.GetPath(), true);
+        for (size_t i = 0; i < kValuesPerStream; i++) {
+            stream << i << static_cast<double>(i) << static_cast<int32_t>(i);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kValuesPerStream * 3);
+}
+
+void BM_BinaryOutStrings(benchmark::State& state) {
+    TempFile file("bench_binary_out_strings.bin");
+    const std::string value(static_cast<size_t>(state.range(0)), 'x');
+    for (auto _ : state) {
+        common::binary::BinaryOutStream stream(file.GetPath(), true);
+        for (size_t i = 0; i < kValuesPerStream; i++) {
+            stream << value;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * kValuesPerStream * state.range(0));
+}
+
+void BM_BinaryOutVector(benchmark::State& state) {
+    TempFile file("bench_binary_out_vector.bin");
+    const std::vector<uint64_t> values(static_cast<size_t>(state.range(0)), 42);
+    for (auto _ : state) {
+        common::binary::BinaryOutStream stream(file.GetPath(), true);
+        stream << values;
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(uint64_t));
+}
+
+void BM_BinaryInNumbers(benchmark::State& state) {
+    TempFile file("bench_binary_in_numbers.bin");
+    {
+        common::binary::BinaryOutStream stream(file.GetPath(), true);
+        for (size_t i = 0; i < kValuesPerStream; i++) {
+            stream << i << static_cast<double>(i) << static_cast<int32_t>(i);
+        }
+    }
+    for (auto _ : state) {
+        common::binary::BinaryInStream stream(file.GetPath());
+        size_t integer{};
+        double real{};
+        int32_t small{};
+        for (size_t i = 0; i < kValuesPerStream; i++) {
+            stream >> integer >> real >> small;
+        }
+        benchmark::DoNotOptimize(integer);
+    }
+    state.SetItemsProcessed(state.iterations() * kValuesPerStream * 3);
+}
+
+void BM_BinaryInStrings(benchmark::State& state) {
+    TempFile file("bench_binary_in_strings.bin");
+    {
+        const std::string value(static_cast<size_t>(state.range(0)), 'x');
+        common::binary::BinaryOutStream stream(file.GetPath(), true);
+        for (size_t i = 0; i < kValuesPerStream; i++) {
+            stream << value;
+        }
+    }
+    for (auto _ : state) {
+        common::binary::BinaryInStream stream(file.GetPath());
+        std::string value{};
+        for (size_t i = 0; i < kValuesPerStream; i++) {
+            stream >> value;
+        }
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetBytesProcessed(state.iterations() * kValuesPerStream * state.range(0));
+}
+
+void BM_BinaryInVector(benchmark::State& state) {
+    TempFile file("bench_binary_in_vector.bin");
+    {
+        const std::vector<uint64_t> values(static_cast<size_t>(state.range(0)), 42);
+        common::binary::BinaryOutStream stream(file.GetPath(), true);
+        stream << values;
+    }
+    for (auto _ : state) {
+        common::binary::BinaryInStream stream(file.GetPath());
+        std::vector<uint64_t> values{};
+        stream >> values;
+        benchmark::DoNotOptimize(values);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(uint64_t));
+}
+
+} // namespace
+
+BENCHMARK(BM_BinaryOutNumbers);
+BENCHMARK(BM_BinaryOutStrings)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK(BM_BinaryOutVector)->RangeMultiplier(16)->Range(16, 64 * 1024);
+BENCHMARK(BM_BinaryInNumbers);
+BENCHMARK(BM_BinaryInStrings)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK(BM_BinaryInVector)->RangeMultiplier(16)->Range(16, 64 * 1024);
+
+} // namespace common::benchmarks::binary
@@ -0,0 +1,87 @@
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <common/include/format.hpp>
+
+namespace common::benchmarks::format {
+
+namespace {
+
+/// @brief Format string of the requested number of placeholders
+/// separated by the text, as in the log and error messages.
+std::string MakeFormat(size_t placeholders_count) {
+    std::string format = "message";
+    for (size_t i = 0; i < placeholders_count; i++) {
+        format += " value {},";
+    }
+    return format;
+}
+
+void BM_FormatIntegers(benchmark::State& state) {
+    const auto format = MakeFormat(4);
+    int64_t value = 0;
+    for (auto _ : state) {
+        auto result = common::format::Format(format, value, value + 1, value + 2, value + 3);
+        benchmark::DoNotOptimize(result);
+        value++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_FormatStrings(benchmark::State& state) {
+    const auto format = MakeFormat(4);
+    const std::string argument(static_cast<size_t>(state.range(0)), 'x');
+    for (auto _ : state) {
+        auto result = common::format::Format(format, argument, argument, argument, argument);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetBytesProcessed(state.iterations() * 4 * state.range(0));
+}
+
+void BM_FormatMixed(benchmark::State& state) {
+    const auto format = MakeFormat(4);
+    const std::string name = "document";
+    for (auto _ : state) {
+        auto result = common::format::Format(format, name, 42, true, "literal");
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief Formatting cost growth with the arguments count.
+template<size_t... Indexes>
+void FormatSequence(const std::string& format, std::index_sequence<Indexes...>) {
+    auto result = common::format::Format(format, Indexes...);
+    benchmark::DoNotOptimize(result);
+}
+
+template<size_t ArgumentsCount>
+void BM_FormatArguments(benchmark::State& state) {
+    const auto format = MakeFormat(ArgumentsCount);
+    for (auto _ : state) {
+        FormatSequence(format, std::make_index_sequence<ArgumentsCount>{});
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_TimePointToString(benchmark::State& state) {
+    const auto timepoint = std::chrono::system_clock::now();
+    for (auto _ : state) {
+        auto result = common::format::TimePointToString(timepoint);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_FormatIntegers);
+BENCHMARK(BM_FormatStrings)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK(BM_FormatMixed);
+BENCHMARK_TEMPLATE(BM_FormatArguments, 1);
+BENCHMARK_TEMPLATE(BM_FormatArguments, 4);
+BENCHMARK_TEMPLATE(BM_FormatArguments, 16);
+BENCHMARK(BM_TimePointToString);
+
+} // namespace common::benchmarks::format
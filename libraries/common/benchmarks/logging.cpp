@@ -0,0 +1,83 @@
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include <common/include/logging.hpp>
+#include <common/src/logging/logger.hpp>
+#include <common/src/logging/sink_base.hpp>
+
+namespace common::benchmarks::logging {
+
+namespace {
+
+using common::logging::LogLevel;
+
+/// @class Sink dropping the flushed buffer, so only the logger is measured.
+class SinkNull : public common::logging::LoggerSinkBase {
+public:
+    void Write(const std::stringstream& buffer) override {
+        benchmark::DoNotOptimize(buffer.rdbuf());
+    }
+};
+
+/// @brief Sets the main logger up as the services do, with a null sink.
+common::logging::Logger& SetupLogger() {
+    auto& logger = common::logging::LoggerFrontend::GetMainLogger();
+    logger.SetLevelFilter(LogLevel::Info);
+    logger.SetFlushLevel(LogLevel::Error);
+    logger.SetBufferMaxSize(common::logging::LogSettings{}.buffer_max_size);
+    logger.ResetSinks();
+    logger.AddSink(std::make_shared<SinkNull>());
+    return logger;
+}
+
+void BM_LogFiltered(benchmark::State& state) {
+    SetupLogger();
+    size_t value = 0;
+    for (auto _ : state) {
+        LOG_DEBUG() << "filtered message " << value++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_Log(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        SetupLogger();
+    }
+    const std::string message(static_cast<size_t>(state.range(0)), 'x');
+    size_t value = 0;
+    for (auto _ : state) {
+        LOG_INFO() << message << " " << value++;
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        common::logging::LoggerFrontend::GetMainLogger().Clear();
+    }
+}
+
+void BM_LoggerLog(benchmark::State& state) {
+    auto& logger = SetupLogger();
+    const std::string message(static_cast<size_t>(state.range(0)), 'x');
+    for (auto _ : state) {
+        logger.Log(common::logging::LogMsg{
+            message, // message
+            LogLevel::Info, // level
+            std::this_thread::get_id(), // thread_id
+            std::chrono::system_clock::now(), // timepoint
+            {}, // module
+        });
+    }
+    state.SetItemsProcessed(state.iterations());
+    logger.Clear();
+}
+
+} // namespace
+
+BENCHMARK(BM_LogFiltered);
+BENCHMARK(BM_Log)->Arg(16)->Arg(256)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_LoggerLog)->Arg(16)->Arg(256);
+
+} // namespace common::benchmarks::logging
@@ -0,0 +1,85 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <common/include/strong_typedef.hpp>
+
+namespace common::benchmarks::strong_typedef {
+
+namespace {
+
+using Name = common::types::StrongTypedef<std::string, struct NameTag>;
+using Id = common::types::StrongTypedef<uint64_t, struct IdTag>;
+
+/// @brief The raw type is the baseline of the wrapper moves.
+template<typename T>
+T MakeValue(size_t size) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return std::string(size, 'x');
+    } else {
+        return T(std::string(size, 'x'));
+    }
+}
+
+template<typename T>
+void BM_MoveConstruct(benchmark::State& state) {
+    auto value = MakeValue<T>(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        T moved(std::move(value));
+        benchmark::DoNotOptimize(moved);
+        value = std::move(moved);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void BM_MoveAssign(benchmark::State& state) {
+    auto first = MakeValue<T>(static_cast<size_t>(state.range(0)));
+    auto second = MakeValue<T>(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        first = std::move(second);
+        second = std::move(first);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+/// @brief Vector growth relocates the elements, they are copied
+/// instead of moved unless the move constructor is noexcept.
+template<typename T>
+void BM_VectorGrowth(benchmark::State& state) {
+    const auto value = MakeValue<T>(64);
+    const auto count = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        std::vector<T> values{};
+        for (size_t i = 0; i < count; i++) {
+            values.push_back(value);
+        }
+        benchmark::DoNotOptimize(values);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_IdCopy(benchmark::State& state) {
+    Id id{42};
+    for (auto _ : state) {
+        Id copy(id);
+        benchmark::DoNotOptimize(copy);
+        id = Id{copy.GetUnderlying() + 1};
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_MoveConstruct, std::string)->Arg(8)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_MoveConstruct, Name)->Arg(8)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_MoveAssign, std::string)->Arg(8)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_MoveAssign, Name)->Arg(8)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_VectorGrowth, std::string)->RangeMultiplier(16)->Range(16, 4096);
+BENCHMARK_TEMPLATE(BM_VectorGrowth, Name)->RangeMultiplier(16)->Range(16, 4096);
+BENCHMARK(BM_IdCopy);
+
+} // namespace common::benchmarks::strong_typedef
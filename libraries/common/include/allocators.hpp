@@ -0,0 +1,238 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+namespace common::memory {
+
+/// @brief Allocates a block from the calling thread cache of the freed
+/// blocks of the same size class, falls back to operator new.
+void* AllocateRecycled(size_t size);
+
+/// @brief Returns a block into the calling thread cache. A block may be
+/// returned by a thread other than the one allocated it.
+void DeallocateRecycled(void* ptr, size_t size) noexcept;
+
+/// @class Stateless allocator recycling the freed blocks within a thread.
+/// Suits objects of the same size created and destroyed over and over,
+/// like the connection sessions, their buffers and async operations.
+template<typename T>
+class RecyclingAllocator {
+public:
+    using value_type = T;
+
+    RecyclingAllocator() noexcept = default;
+
+    template<typename U>
+    RecyclingAllocator(const RecyclingAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count) {
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+                      "over-aligned types are not supported");
+        return static_cast<T*>(AllocateRecycled(count * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t count) noexcept {
+        DeallocateRecycled(ptr, count * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const RecyclingAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const RecyclingAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+/// @class Monotonic (bump pointer) memory arena. Deallocation is a no-op,
+/// the whole memory is reclaimed at once by Reset(). The blocks are kept
+/// for the next use, so a reused arena does not allocate once warmed up.
+/// Not thread-safe.
+class MonotonicArena : private boost::noncopyable {
+public:
+    static constexpr size_t kDefaultBlockSize = 4096;
+    // memory above this size is released on reset
+    static constexpr size_t kMaxRetainedSize = 64 * 1024;
+
+    explicit MonotonicArena(size_t block_size = kDefaultBlockSize);
+
+    void* Allocate(size_t size, size_t alignment);
+    void Reset();
+
+    /// @brief Returns size of the memory owned by the arena.
+    size_t GetCapacity() const;
+    /// @brief Returns size of the memory allocated since the last reset.
+    size_t GetUsedSize() const;
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    void AddBlock(size_t min_size);
+
+    const size_t block_size_;
+    std::vector<Block> blocks_;
+    size_t block_index_;
+    size_t block_offset_;
+    size_t used_size_;
+};
+
+class ArenaPool;
+
+namespace detail {
+
+/// @class Arena owned by a pool. Reference counted by the allocators,
+/// returns itself into the pool once the last of them is destroyed.
+class PooledArena : public MonotonicArena {
+public:
+    PooledArena() = default;
+
+    void AddRef() noexcept;
+    void Release() noexcept;
+
+private:
+    friend class common::memory::ArenaPool;
+
+    std::atomic<size_t> refs_count_{0};
+    // set while the arena is in use, keeps the pool alive
+    std::shared_ptr<ArenaPool> pool_ptr_{};
+};
+
+} // namespace detail
+
+template<typename T>
+class ArenaAllocator;
+
+/**
+ * @class Thread-safe pool of monotonic arenas. An arena taken from the pool
+ * serves a single object (e.g. a message) via ArenaAllocator and gets reset
+ * and returned once the object and all of the allocator copies are gone.
+ */
+class ArenaPool : public std::enable_shared_from_this<ArenaPool>,
+                  private boost::noncopyable {
+public:
+    static constexpr size_t kDefaultMaxSize = 1024;
+
+    static std::shared_ptr<ArenaPool> Create(size_t max_size = kDefaultMaxSize);
+    ~ArenaPool();
+
+    /// @brief Takes a free arena or creates a new one.
+    ArenaAllocator<char> Acquire();
+
+    /// @brief Returns number of free arenas.
+    size_t GetSize() const;
+
+private:
+    friend class detail::PooledArena;
+
+    explicit ArenaPool(size_t max_size);
+    void Return(detail::PooledArena* arena_ptr) noexcept;
+
+    const size_t max_size_;
+    mutable std::mutex mutex_;
+    std::vector<detail::PooledArena*> arenas_;
+};
+
+/// @class Allocator over a pooled arena. Copies made for the copy
+/// construction of containers use the global heap, so a copied object
+/// never prolongs the arena of the original one. A default constructed
+/// allocator uses the global heap as well. Moves are copies: a moved-from
+/// container may still need the allocator to free its own memory.
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    ArenaAllocator() noexcept : arena_ptr_{nullptr} {}
+
+    ArenaAllocator(const ArenaAllocator& other) noexcept
+        : arena_ptr_{other.arena_ptr_} {
+        AddRef();
+    }
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : arena_ptr_{other.arena_ptr_} {
+        AddRef();
+    }
+
+    ~ArenaAllocator() {
+        if (arena_ptr_ != nullptr) {
+            arena_ptr_->Release();
+        }
+    }
+
+    ArenaAllocator& operator=(const ArenaAllocator& other) noexcept {
+        ArenaAllocator(other).Swap(*this);
+        return *this;
+    }
+
+    T* allocate(size_t count) {
+        if (arena_ptr_ == nullptr) {
+            return static_cast<T*>(::operator new(count * sizeof(T)));
+        }
+        return static_cast<T*>(arena_ptr_->Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, size_t) noexcept {
+        if (arena_ptr_ == nullptr) {
+            ::operator delete(ptr);
+        }
+    }
+
+    ArenaAllocator select_on_container_copy_construction() const noexcept {
+        return ArenaAllocator{};
+    }
+
+    bool IsArenaBacked() const noexcept {
+        return arena_ptr_ != nullptr;
+    }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ptr_ == other.arena_ptr_;
+    }
+
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ptr_ != other.arena_ptr_;
+    }
+
+private:
+    template<typename U>
+    friend class ArenaAllocator;
+    friend class ArenaPool;
+
+    /// @brief Takes ownership of an arena reference.
+    explicit ArenaAllocator(detail::PooledArena* arena_ptr) noexcept
+        : arena_ptr_{arena_ptr} {}
+
+    void AddRef() noexcept {
+        if (arena_ptr_ != nullptr) {
+            arena_ptr_->AddRef();
+        }
+    }
+
+    void Swap(ArenaAllocator& other) noexcept {
+        std::swap(arena_ptr_, other.arena_ptr_);
+    }
+
+    detail::PooledArena* arena_ptr_;
+};
+
+} // namespace common::memory
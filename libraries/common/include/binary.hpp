@@ -6,6 +6,7 @@
 #include <list>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <boost/noncopyable.hpp>
@@ -233,6 +234,16 @@ public:
         return *this;
     }
 
+    /// @brief Writes raw bytes with no size prefix, e.g. a part of a string
+    /// whose size is written separately.
+    /// @param data bytes to store
+    /// @return ref to self
+    BinaryOutStream& Write(std::string_view data);
+
+    /// @brief Passes the buffered data to the file, so it is visible
+    /// to the other readers of the file.
+    void Flush();
+
     /// @brief Writes a null-formatted string. Note: this method has no analogue for reading operation,
     /// since char* is not a safe way to control data buffer. Consider to use read operation with std::string.
     /// @param str pointer to a null-terminated sequence of characters
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+#include <common/include/config.hpp>
+#include <common/include/json.hpp>
+#include <common/include/thread_pool.hpp>
+
+namespace common::threading {
+
+void from_json(const json::json& data, ThreadPoolSettings& settings);
+
+} // namespace common::threading
+
+namespace common::config {
+
+/// @brief Returns threadpool config loaded by specified path
+/// or default config if nothing was found.
+threading::ThreadPoolSettings GetThreadPoolConfig(
+    const std::string& path = "./thread_pool_config.json");
+
+} // namespace common::config
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace common::metrics {
+
+/**
+ * @class High dynamic range histogram of integer values. Keeps the
+ * specified number of significant decimal digits over the whole trackable
+ * range with a fixed amount of memory: buckets are powers of two, each of
+ * them split into the linear sub-buckets. Recording is O(1) and does not
+ * allocate. Not thread-safe, histograms of the threads may be merged.
+ * Values above the highest trackable one are recorded as the highest.
+ */
+class HdrHistogram {
+public:
+    /// @param lowest_value lowest discernible value, at least 1
+    /// @param highest_value highest trackable value, at least twice the lowest
+    /// @param significant_digits precision of the values, from 1 to 5
+    /// @throws std::logic_error on invalid parameters
+    HdrHistogram(int64_t lowest_value, int64_t highest_value, int significant_digits);
+
+    /// @brief Records a value the specified number of times. Negative
+    /// values are recorded as zero.
+    void Record(int64_t value, uint64_t count = 1);
+
+    /// @brief Records a value, then the values missed by a measurement loop
+    /// stalled for longer than the expected interval between the samples.
+    /// Compensates the coordinated omission of a closed loop load.
+    void RecordCorrected(int64_t value, int64_t expected_interval);
+
+    /// @throws std::logic_error if the histograms are of different layouts
+    void Merge(const HdrHistogram& other);
+    void Reset();
+
+    uint64_t GetTotalCount() const;
+    int64_t GetMin() const;
+    int64_t GetMax() const;
+    double GetMean() const;
+    double GetStdDeviation() const;
+
+    /// @brief Returns the highest value equivalent to the one below which
+    /// the specified percentage of the values fall.
+    /// @param percentile from 0 to 100
+    int64_t GetValueAtPercentile(double percentile) const;
+
+    /// @brief Prints the percentile distribution in the HdrHistogram text
+    /// format, readable by the common plotting tools.
+    /// @param ticks_per_half_distance number of the reported percentiles
+    /// per each halving of the distance to 100%
+    /// @param value_scale values are divided by the scale on output
+    void PrintPercentiles(std::ostream& stream, int ticks_per_half_distance = 5,
+                          double value_scale = 1.0) const;
+
+private:
+    size_t GetIndex(int64_t value) const;
+    int64_t GetValueFromIndex(size_t index) const;
+    int64_t GetLowestEquivalent(int64_t value) const;
+    int64_t GetHighestEquivalent(int64_t value) const;
+    int64_t GetMedianEquivalent(int64_t value) const;
+    int64_t GetEquivalentRangeSize(int64_t value) const;
+
+    int64_t lowest_value_;
+    int64_t highest_value_;
+    int significant_digits_;
+    int unit_magnitude_;
+    int sub_bucket_half_count_magnitude_;
+    int64_t sub_bucket_count_;
+    int64_t sub_bucket_half_count_;
+    int64_t sub_bucket_mask_;
+    std::vector<uint64_t> counts_;
+    uint64_t total_count_;
+    int64_t min_;
+    int64_t max_;
+};
+
+} // namespace common::metrics
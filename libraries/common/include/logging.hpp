@@ -64,12 +64,20 @@ private:
     LogMsg log_entry_;
 };
 
+/// @brief Checks the main logger level filter. Filtered out messages
+/// are not even formatted, so disabled logs cost nothing on hot paths.
+bool IsLevelEnabled(LogLevel level);
+
 #ifdef _MSC_VER
-    #define LOG(lvl) common::logging::LogHolder((lvl), __FUNCSIG__)
+    #define LOG_FUNCTION_NAME __FUNCSIG__
 #else
-    #define LOG(lvl) common::logging::LogHolder((lvl), __PRETTY_FUNCTION__)
+    #define LOG_FUNCTION_NAME __PRETTY_FUNCTION__
 #endif
 
+#define LOG(lvl) \
+    if (!common::logging::IsLevelEnabled(lvl)) {} \
+    else common::logging::LogHolder((lvl), LOG_FUNCTION_NAME)
+
 /// @brief macros for stream like logging.
 /// Example: LOG_INFO() << "log message";
 #define LOG_TRACE() LOG(common::logging::LogLevel::Trace)
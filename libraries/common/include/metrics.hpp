@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+namespace common::metrics {
+
+/// @brief Metric labels, the order is kept in the exposition.
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+/// @brief Number of shards of a metric. Threads are spread over the shards,
+/// so the concurrent updates rarely touch the same cache line.
+constexpr size_t kShardsCount = 16;
+
+/// @brief Returns the shard of the calling thread.
+size_t GetShardIndex();
+
+/// @class Monotonic counter sharded by the updating threads.
+/// Updates are lock-free and never contended unless there are
+/// more updating threads than shards. Reads sum up the shards.
+class Counter : private boost::noncopyable {
+public:
+    Counter();
+
+    void Add(uint64_t value = 1);
+    uint64_t Get() const;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+
+    std::unique_ptr<Shard[]> shards_;
+};
+
+/// @struct Point in time view of a histogram.
+struct HistogramSnapshot {
+    // upper bounds of the buckets, the last +Inf bucket is implicit
+    std::vector<double> bounds{};
+    // not cumulative, one more than the bounds
+    std::vector<uint64_t> counts{};
+    uint64_t count{};
+    double sum{};
+};
+
+/// @class Histogram with fixed buckets sharded by the updating threads.
+/// A value falls into the first bucket whose upper bound is not less
+/// than the value. Observation is lock-free and does not allocate.
+class Histogram : private boost::noncopyable {
+public:
+    /// @throws std::logic_error if the bounds are not strictly increasing
+    explicit Histogram(std::vector<double> bounds);
+
+    void Observe(double value);
+    HistogramSnapshot GetSnapshot() const;
+
+private:
+    struct alignas(64) Shard {
+        std::unique_ptr<std::atomic<uint64_t>[]> counts{};
+        std::atomic<double> sum{0.0};
+    };
+
+    std::vector<double> bounds_;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+/// @brief Latency buckets in seconds, from 500us up to 10s.
+const std::vector<double>& GetDefaultLatencyBounds();
+
+/**
+ * @class Global registry of the process metrics.
+ * Metrics are identified by the name and the labels. They are created on
+ * the first request and live as long as the process, so the returned
+ * references may be cached by the callers to keep the registry lock off
+ * the hot path. Renders the metrics in the Prometheus text format.
+ */
+class Registry : private boost::noncopyable {
+public:
+    static Registry& GetInstance();
+    ~Registry();
+
+    /// @throws std::logic_error if the name is registered as a metric of another type
+    Counter& GetCounter(const std::string& name, const std::string& help,
+                        const Labels& labels = {});
+
+    /// @brief Returns the histogram, the bounds are used only on creation.
+    /// @throws std::logic_error if the name is registered as a metric of another type
+    Histogram& GetHistogram(const std::string& name, const std::string& help,
+                            const Labels& labels = {},
+                            const std::vector<double>& bounds = GetDefaultLatencyBounds());
+
+    /// @brief Renders all of the metrics in the Prometheus text exposition format.
+    std::string Render() const;
+
+private:
+    enum class Type {
+        Counter,
+        Histogram,
+    };
+
+    struct Family {
+        Type type{};
+        std::string help{};
+        // series in the creation order
+        std::vector<std::pair<Labels, std::unique_ptr<Counter>>> counters{};
+        std::vector<std::pair<Labels, std::unique_ptr<Histogram>>> histograms{};
+    };
+
+    Registry();
+
+    Family& GetFamily(const std::string& name, const std::string& help, Type type);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family> families_;
+};
+
+} // namespace common::metrics
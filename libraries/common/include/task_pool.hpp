@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <boost/asio/post.hpp>
+#include <boost/core/noncopyable.hpp>
+
+namespace common::threading {
+
+/// @struct Snapshot of the task pool statistics.
+struct TaskPoolStats {
+    size_t executed{};
+    // tasks taken by a worker from the queue of another one
+    size_t stolen{};
+};
+
+/**
+ * @class Work-stealing threadpool intended for CPU-bound work (e.g. serialization
+ * of large documents) which must not hold the I/O threads. Every worker owns a
+ * task deque: the tasks posted by a worker go to its own deque and are taken
+ * back in LIFO order while they are hot in its cache, the idle workers steal
+ * the oldest tasks of the others. The tasks posted from the other threads are
+ * spread over the deques round-robin. The tasks must not block on I/O, use
+ * WorkerPool for that.
+ */
+class TaskPool : private boost::noncopyable {
+public:
+    using Task = std::function<void()>;
+
+    explicit TaskPool(size_t pool_size = std::thread::hardware_concurrency());
+    ~TaskPool();
+
+    void Run();
+
+    /// @brief Stops accepting new tasks, executes the queued
+    /// ones and joins the workers.
+    void Stop();
+    void Join();
+
+    /// @brief Enqueues a task to be executed by one of the workers.
+    /// @returns false if the pool is stopped.
+    bool Post(Task&& task);
+
+    /// @brief Enqueues the function and returns the future of its result.
+    /// @throws std::runtime_error if the pool is stopped
+    template <typename Function>
+    auto Submit(Function&& function) {
+        using Result = std::invoke_result_t<std::decay_t<Function>>;
+        auto task_ptr = std::make_shared<std::packaged_task<Result()>>(
+            std::forward<Function>(function));
+        auto future = task_ptr->get_future();
+        if (!Post([task_ptr] { (*task_ptr)(); })) {
+            throw std::runtime_error("Task pool is stopped");
+        }
+        return future;
+    }
+
+    /// @brief Enqueues the function and posts the continuation with the ready
+    /// future of its result to the executor, e.g. to the strand of a connection,
+    /// so the result is handled back on the I/O thread.
+    /// @throws std::runtime_error if the pool is stopped
+    template <typename Function, typename Executor, typename Continuation>
+    void Submit(Function&& function, const Executor& executor, Continuation&& continuation) {
+        using Result = std::invoke_result_t<std::decay_t<Function>>;
+        auto task_ptr = std::make_shared<std::packaged_task<Result()>>(
+            std::forward<Function>(function));
+        auto future_ptr = std::make_shared<std::future<Result>>(task_ptr->get_future());
+        auto continuation_ptr = std::make_shared<std::decay_t<Continuation>>(
+            std::forward<Continuation>(continuation));
+        const auto is_posted = Post([task_ptr, future_ptr, continuation_ptr, executor] {
+            (*task_ptr)();
+            boost::asio::post(executor, [future_ptr, continuation_ptr] {
+                (*continuation_ptr)(std::move(*future_ptr));
+            });
+        });
+        if (!is_posted) {
+            throw std::runtime_error("Task pool is stopped");
+        }
+    }
+
+    /// @brief Invokes the function for every index of [begin, end) split into
+    /// chunks of grain_size indexes. The chunks are executed by the workers and
+    /// by the calling thread, which returns once all of them are done, so it is
+    /// safe to call from a worker as well.
+    /// @throws the first exception thrown by the function, the chunks
+    /// not started by then are skipped
+    template <typename Function>
+    void ParallelFor(size_t begin, size_t end, Function&& function, size_t grain_size = 1) {
+        if (begin >= end) {
+            return;
+        }
+        grain_size = std::max<size_t>(grain_size, 1);
+        const auto chunks_count = (end - begin + grain_size - 1) / grain_size;
+        RunChunks(chunks_count, [begin, end, grain_size, &function](size_t chunk) {
+            const auto chunk_begin = begin + chunk * grain_size;
+            const auto chunk_end = std::min(end, chunk_begin + grain_size);
+            for (auto index = chunk_begin; index < chunk_end; index++) {
+                function(index);
+            }
+        });
+    }
+
+    /// @returns true if called from a worker of the pool.
+    bool IsWorkerThread() const;
+
+    size_t GetPoolSize() const;
+    TaskPoolStats GetStats() const;
+
+private:
+    struct Queue {
+        std::mutex mutex{};
+        std::deque<Task> tasks{};
+    };
+
+    void RunWorker(size_t index);
+    bool TryPop(size_t index, Task& task);
+    bool TrySteal(size_t index, Task& task);
+    void RunChunks(size_t chunks_count, const std::function<void(size_t chunk)>& run_chunk);
+
+    const size_t pool_size_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> pool_;
+    // next queue for the tasks posted from outside of the pool
+    std::atomic<size_t> next_queue_;
+    // the idle workers sleep until there are pending tasks,
+    // a task is pending from before it is queued until it is taken
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_condition_;
+    std::atomic<size_t> sleeping_count_;
+    std::atomic<size_t> pending_count_;
+    std::atomic<bool> is_stopped_;
+    std::atomic<size_t> executed_count_;
+    std::atomic<size_t> stolen_count_;
+};
+
+} // namespace common::threading
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -8,26 +14,119 @@
 
 namespace common::threading {
 
+/// @struct Settings of the I/O pool threads.
+struct ThreadPoolSettings {
+    // 0 for a thread per CPU available to the process
+    size_t threads_count = 0;
+    // the threads are named "<name>-<index>", Linux cuts the names to 15 characters
+    std::string name = "io";
+    // pin the threads to the CPUs one by one, so a thread stays on the
+    // NUMA node of the memory it has touched first
+    bool pin_threads = false;
+    // CPUs to pin the threads to, all of the CPUs available to the process if empty
+    std::vector<size_t> cpus{};
+};
+
+/// @brief Returns the CPUs the process is allowed to run on.
+std::vector<size_t> GetAvailableCpus();
+
+/// @brief Returns NUMA node of the CPU or std::nullopt if it is unknown.
+std::optional<size_t> GetCpuNode(size_t cpu);
+
 /// @class Threadpool intended for async work
 /// with boost async I/O context.
 class IoThreadPool : private boost::noncopyable {
 public:
     IoThreadPool(size_t pool_size = 1);
+    /// @throws std::invalid_argument if a CPU to pin to is not available
+    explicit IoThreadPool(const ThreadPoolSettings& settings);
     ~IoThreadPool();
 
     std::shared_ptr<boost::asio::io_context> GetContextPtr() const;
+    size_t GetPoolSize() const;
     
     void Run();
+    /// @brief Runs the context in the calling thread as one of the pool
+    /// threads, which is pinned if required, but keeps its name.
     void RunInThisThread();
     void Stop();
     void Join();
     void Detach();
 
 private:
+    void RunThreads(size_t first_index);
+
+    const ThreadPoolSettings settings_;
     const size_t pool_size_;
     std::vector<std::thread> pool_;
     std::shared_ptr<boost::asio::io_context> context_ptr_;
 };
 
+/// @class Multi-reactor threadpool. Every thread owns and runs
+/// its own boost async I/O context, so the work posted to a context
+/// never leaves the thread (and the core) it was posted to.
+/// The contexts of the pinned threads are created on their CPUs,
+/// so their memory is allocated on the local NUMA nodes.
+class IoReactorPool : private boost::noncopyable {
+public:
+    IoReactorPool(size_t pool_size = 1);
+    /// @throws std::invalid_argument if a CPU to pin to is not available
+    explicit IoReactorPool(const ThreadPoolSettings& settings);
+    ~IoReactorPool();
+
+    std::vector<std::shared_ptr<boost::asio::io_context>> GetContextPtrs() const;
+    size_t GetPoolSize() const;
+
+    void Run();
+    /// @brief Runs the first context in the calling thread, which
+    /// is pinned if required, but keeps its name.
+    void RunInThisThread();
+    void Stop();
+    void Join();
+    void Detach();
+
+private:
+    void RunContexts(size_t first_index);
+
+    const ThreadPoolSettings settings_;
+    const size_t pool_size_;
+    std::vector<std::thread> pool_;
+    std::vector<std::shared_ptr<boost::asio::io_context>> context_ptrs_;
+};
+
+/// @class Fixed size threadpool with a bounded task queue.
+/// Intended for blocking work (e.g. file I/O) which must
+/// not be executed on the I/O threads.
+class WorkerPool : private boost::noncopyable {
+public:
+    using Task = std::function<void()>;
+
+    WorkerPool(size_t pool_size = 1, size_t max_queue_size = 1024);
+    ~WorkerPool();
+
+    /// @brief Enqueues a task to be executed by one of the workers.
+    /// @returns false if the queue is full or the pool is stopped.
+    bool TryPost(Task&& task);
+
+    void Run();
+
+    /// @brief Stops accepting new tasks, executes the queued
+    /// ones and joins the workers.
+    void Stop();
+    void Join();
+
+    size_t GetQueueSize() const;
+
+private:
+    void RunWorker();
+
+    const size_t pool_size_;
+    const size_t max_queue_size_;
+    std::vector<std::thread> pool_;
+    mutable std::mutex queue_mutex_;
+    std::condition_variable queue_condition_;
+    std::deque<Task> queue_;
+    bool is_stopped_;
+};
 
 } // namespace common::threading
\ No newline at end of file
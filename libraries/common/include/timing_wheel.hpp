@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/core/noncopyable.hpp>
+
+namespace common::threading {
+
+/**
+ * @class Hierarchical timing wheel. Serves a large number of coarse timeouts
+ * (e.g. the connection ones) with a single asio timer ticking on the context.
+ * Arming, re-arming and cancellation of a timer take constant time and never
+ * allocate: timers are intrusive list nodes owned by the user. Timers fire
+ * not earlier than requested and not later than a tick after that.
+ * Thread-safe, though a wheel per reactor is used by a single thread only,
+ * so its lock is never contended. Ticks only while there are armed timers.
+ */
+class TimingWheel : public std::enable_shared_from_this<TimingWheel>,
+                    private boost::noncopyable {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kLevelsCount = 4;
+    static constexpr size_t kSlotBits = 6;
+    static constexpr size_t kSlotsCount = size_t{1} << kSlotBits;
+    static constexpr std::chrono::milliseconds kDefaultResolution{100};
+
+    /// @class Timer of the wheel. Must not outlive the wheel it is armed in,
+    /// gets cancelled on destruction.
+    class Timer : private boost::noncopyable {
+    public:
+        /// @brief Invoked by the wheel ticking thread outside of the wheel lock.
+        /// The timer may be re-armed or destroyed concurrently, so the callback
+        /// must not refer to the timer owner without keeping it alive.
+        using Callback = std::function<void()>;
+
+        Timer();
+        explicit Timer(Callback&& on_expired);
+        ~Timer();
+
+        void SetCallback(Callback&& on_expired);
+
+    private:
+        friend class TimingWheel;
+
+        Callback on_expired_;
+        TimingWheel* wheel_ptr_;
+        // intrusive list of the wheel slot
+        Timer* prev_ptr_;
+        Timer* next_ptr_;
+        Timer** slot_ptr_;
+        uint64_t expires_at_tick_;
+    };
+
+    static std::shared_ptr<TimingWheel> Create(
+        std::shared_ptr<boost::asio::io_context> io_context_ptr,
+        Clock::duration resolution = kDefaultResolution);
+    ~TimingWheel();
+
+    /// @brief Arms the timer to expire after the timeout, re-arms it if
+    /// it is armed already.
+    void Arm(Timer& timer, Clock::duration timeout);
+
+    /// @brief Cancels the timer if it is armed, the callback is not invoked then.
+    void Cancel(Timer& timer);
+
+    bool IsArmed(const Timer& timer) const;
+
+    /// @brief Returns number of the armed timers.
+    size_t GetSize() const;
+
+    /// @brief Fires the timers expired by the time point. Invoked by the wheel
+    /// itself on every tick, may be invoked directly to drive the wheel manually.
+    void Advance(Clock::time_point now);
+
+private:
+    using Slots = std::array<Timer*, kSlotsCount>;
+
+    TimingWheel(std::shared_ptr<boost::asio::io_context> io_context_ptr,
+                Clock::duration resolution);
+
+    uint64_t GetTick(Clock::time_point time_point) const;
+    void Insert(Timer& timer);
+    void Unlink(Timer& timer);
+    void Cascade(size_t level, size_t index);
+    void ScheduleTick();
+    void OnTick();
+
+    std::shared_ptr<boost::asio::io_context> io_context_ptr_;
+    const Clock::duration resolution_;
+    const Clock::time_point started_at_;
+    boost::asio::steady_timer tick_timer_;
+    mutable std::mutex mutex_;
+    std::array<Slots, kLevelsCount> levels_;
+    // the next tick to process
+    uint64_t current_tick_;
+    size_t size_;
+    bool is_ticking_;
+};
+
+} // namespace common::threading
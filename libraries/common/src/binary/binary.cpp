@@ -150,6 +150,15 @@ BinaryOutStream& BinaryOutStream::operator<<(
     return *this;
 }
 
+BinaryOutStream& BinaryOutStream::Write(std::string_view data) {
+    stream_.write(reinterpret_cast<const BinaryByteT*>(data.data()), data.size());
+    return *this;
+}
+
+void BinaryOutStream::Flush() {
+    stream_.flush();
+}
+
 BinaryOutStream& BinaryOutStream::operator<<(const char* str) {
     const size_t size = strlen(str);
     *this << size;
@@ -0,0 +1,42 @@
+#include <common/include/config/thread_pool_config.hpp>
+
+#include <exception>
+#include <stdexcept>
+
+#include <common/include/format.hpp>
+
+namespace common {
+
+namespace threading {
+
+void from_json(const json::json& data, ThreadPoolSettings& settings) {
+    const ThreadPoolSettings defaults{};
+    settings.threads_count = data.value("threads_count", defaults.threads_count);
+    settings.name = data.value("name", defaults.name);
+    settings.pin_threads = data.value("pin_threads", defaults.pin_threads);
+    settings.cpus = data.value("cpus", defaults.cpus);
+}
+
+} // namespace threading
+
+namespace config {
+
+threading::ThreadPoolSettings GetThreadPoolConfig(const std::string& path) {
+    Config config{};
+    try {
+        config = Config::FromFile(path);
+    } catch (const std::runtime_error&) {
+        return threading::ThreadPoolSettings{};
+    }
+
+    try {
+        return config.Get<threading::ThreadPoolSettings>();
+    } catch (const std::exception& ex) {
+        throw std::runtime_error(format::Format(
+            "Cannot load threadpool config: {}", ex.what()));
+    }
+}
+
+} // namespace config
+
+} // namespace common
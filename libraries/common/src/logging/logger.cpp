@@ -97,6 +97,10 @@ void Logger::SetLevelFilter(LogLevel level) {
     level_filter_ = level;
 }
 
+bool Logger::IsLevelEnabled(LogLevel level) const {
+    return level >= level_filter_.load(std::memory_order_relaxed);
+}
+
 void Logger::SetFlushLevel(LogLevel level) {
     flush_level_ = level;
 }
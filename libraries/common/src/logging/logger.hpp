@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <queue>
 
@@ -15,6 +16,7 @@ public:
 
     void Log(LogMsg&& msg);
     void SetLevelFilter(LogLevel level);
+    bool IsLevelEnabled(LogLevel level) const;
     void SetFlushLevel(LogLevel level);
     void Flush();
     void Clear();
@@ -33,7 +35,7 @@ private:
     size_t buffer_max_size_;
     std::recursive_mutex buffer_mutex_;
     std::queue<LogMsg> buffer_;
-    LogLevel level_filter_;
+    std::atomic<LogLevel> level_filter_;
     LogLevel flush_level_;
     size_t msg_max_size_;
 };
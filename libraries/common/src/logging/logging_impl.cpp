@@ -26,6 +26,10 @@ LogHolder::~LogHolder() {
     }
 }
 
+bool IsLevelEnabled(LogLevel level) {
+    return LoggerFrontend::GetMainLogger().IsLevelEnabled(level);
+}
+
 Logger& LoggerFrontend::GetMainLogger() {
     static Logger logger{};
     return logger;
@@ -0,0 +1,236 @@
+#include <common/include/allocators.hpp>
+
+#include <algorithm>
+#include <array>
+#include <new>
+
+namespace common::memory {
+
+namespace {
+
+constexpr size_t kMinBlockSizeLog = 6;    // 64 bytes
+constexpr size_t kMaxBlockSizeLog = 16;   // 64 KiB
+constexpr size_t kSizeClassesCount = kMaxBlockSizeLog - kMinBlockSizeLog + 1;
+constexpr size_t kMaxCachedBlocksCount = 32;
+
+/// @brief Returns index of the smallest size class fitting the size,
+/// or kSizeClassesCount if the size is too large to be recycled.
+size_t GetSizeClass(size_t size) {
+    size_t size_class = 0;
+    while (size_class < kSizeClassesCount &&
+           (size_t{1} << (kMinBlockSizeLog + size_class)) < size) {
+        size_class++;
+    }
+    return size_class;
+}
+
+size_t GetClassSize(size_t size_class) {
+    return size_t{1} << (kMinBlockSizeLog + size_class);
+}
+
+/// @class Per-thread cache of the freed blocks by size classes.
+class BlockCache {
+public:
+    BlockCache() : blocks_{} {
+        for (auto& blocks : blocks_) {
+            blocks.reserve(kMaxCachedBlocksCount);
+        }
+    }
+
+    ~BlockCache();
+
+    void* Pop(size_t size_class) {
+        auto& blocks = blocks_[size_class];
+        if (blocks.empty()) {
+            return nullptr;
+        }
+        auto ptr = blocks.back();
+        blocks.pop_back();
+        return ptr;
+    }
+
+    bool Push(size_t size_class, void* ptr) {
+        auto& blocks = blocks_[size_class];
+        if (blocks.size() == kMaxCachedBlocksCount) {
+            return false;
+        }
+        blocks.push_back(ptr);
+        return true;
+    }
+
+private:
+    std::array<std::vector<void*>, kSizeClassesCount> blocks_;
+};
+
+// trivially destructible, stays valid after the thread cache is destroyed
+thread_local bool is_cache_destroyed = false;
+
+BlockCache::~BlockCache() {
+    is_cache_destroyed = true;
+    for (auto& blocks : blocks_) {
+        for (auto ptr : blocks) {
+            ::operator delete(ptr);
+        }
+    }
+}
+
+BlockCache* GetThreadCache() {
+    if (is_cache_destroyed) {
+        return nullptr;
+    }
+    thread_local BlockCache cache{};
+    return &cache;
+}
+
+} // namespace
+
+void* AllocateRecycled(size_t size) {
+    const auto size_class = GetSizeClass(size);
+    if (size_class == kSizeClassesCount) {
+        return ::operator new(size);
+    }
+    if (auto cache_ptr = GetThreadCache(); cache_ptr != nullptr) {
+        if (auto ptr = cache_ptr->Pop(size_class); ptr != nullptr) {
+            return ptr;
+        }
+    }
+    return ::operator new(GetClassSize(size_class));
+}
+
+void DeallocateRecycled(void* ptr, size_t size) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    const auto size_class = GetSizeClass(size);
+    if (size_class != kSizeClassesCount) {
+        if (auto cache_ptr = GetThreadCache();
+            cache_ptr != nullptr && cache_ptr->Push(size_class, ptr)) {
+            return;
+        }
+    }
+    ::operator delete(ptr);
+}
+
+MonotonicArena::MonotonicArena(size_t block_size)
+    : block_size_{block_size}, blocks_{}, block_index_{0},
+      block_offset_{0}, used_size_{0} {}
+
+void* MonotonicArena::Allocate(size_t size, size_t alignment) {
+    while (block_index_ < blocks_.size()) {
+        auto& block = blocks_[block_index_];
+        const auto address = reinterpret_cast<uintptr_t>(block.data.get()) + block_offset_;
+        const auto padding = (alignment - address % alignment) % alignment;
+        if (block_offset_ + padding + size <= block.size) {
+            block_offset_ += padding + size;
+            used_size_ += size;
+            return reinterpret_cast<void*>(address + padding);
+        }
+        block_index_++;
+        block_offset_ = 0;
+    }
+
+    AddBlock(size + alignment);
+    return Allocate(size, alignment);
+}
+
+void MonotonicArena::Reset() {
+    if (GetCapacity() > kMaxRetainedSize) {
+        blocks_.clear();
+    }
+    block_index_ = 0;
+    block_offset_ = 0;
+    used_size_ = 0;
+}
+
+size_t MonotonicArena::GetCapacity() const {
+    size_t capacity = 0;
+    for (const auto& block : blocks_) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+size_t MonotonicArena::GetUsedSize() const {
+    return used_size_;
+}
+
+void MonotonicArena::AddBlock(size_t min_size) {
+    // every next block is twice as large to keep the blocks count low
+    const auto size = std::max(
+        min_size, blocks_.empty() ? block_size_ : blocks_.back().size * 2);
+    blocks_.push_back(Block{
+        std::unique_ptr<std::byte[]>(new std::byte[size]),  // data
+        size,                                               // size
+    });
+    block_index_ = blocks_.size() - 1;
+    block_offset_ = 0;
+}
+
+namespace detail {
+
+void PooledArena::AddRef() noexcept {
+    refs_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PooledArena::Release() noexcept {
+    if (refs_count_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    // the pool may be destroyed along with the last reference to it
+    auto pool_ptr = std::move(pool_ptr_);
+    pool_ptr->Return(this);
+}
+
+} // namespace detail
+
+std::shared_ptr<ArenaPool> ArenaPool::Create(size_t max_size) {
+    return std::shared_ptr<ArenaPool>(new ArenaPool(max_size));
+}
+
+ArenaPool::ArenaPool(size_t max_size)
+    : max_size_{max_size}, mutex_{}, arenas_{} {
+    arenas_.reserve(max_size_);
+}
+
+ArenaPool::~ArenaPool() {
+    for (auto arena_ptr : arenas_) {
+        delete arena_ptr;
+    }
+}
+
+ArenaAllocator<char> ArenaPool::Acquire() {
+    detail::PooledArena* arena_ptr = nullptr;
+    {
+        std::lock_guard lock(mutex_);
+        if (!arenas_.empty()) {
+            arena_ptr = arenas_.back();
+            arenas_.pop_back();
+        }
+    }
+    if (arena_ptr == nullptr) {
+        arena_ptr = new detail::PooledArena();
+    }
+
+    arena_ptr->pool_ptr_ = shared_from_this();
+    arena_ptr->refs_count_.store(1, std::memory_order_relaxed);
+    return ArenaAllocator<char>(arena_ptr);
+}
+
+size_t ArenaPool::GetSize() const {
+    std::lock_guard lock(mutex_);
+    return arenas_.size();
+}
+
+void ArenaPool::Return(detail::PooledArena* arena_ptr) noexcept {
+    arena_ptr->Reset();
+    {
+        std::lock_guard lock(mutex_);
+        if (arenas_.size() < max_size_) {
+            arenas_.push_back(arena_ptr);
+            return;
+        }
+    }
+    delete arena_ptr;
+}
+
+} // namespace common::memory
@@ -0,0 +1,239 @@
+#include "hdr_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+namespace common::metrics {
+
+namespace {
+
+int GetBitLength(uint64_t value) {
+    return value == 0 ? 0 : 64 - __builtin_clzll(value);
+}
+
+} // namespace
+
+HdrHistogram::HdrHistogram(int64_t lowest_value, int64_t highest_value, int significant_digits)
+    : lowest_value_{lowest_value}, highest_value_{highest_value},
+      significant_digits_{significant_digits}, counts_{}, total_count_{0},
+      min_{std::numeric_limits<int64_t>::max()}, max_{0} {
+    if (lowest_value < 1) {
+        throw std::logic_error("Lowest value of a histogram must be at least 1");
+    }
+    if (highest_value < 2 * lowest_value) {
+        throw std::logic_error("Highest value of a histogram must be at least twice the lowest");
+    }
+    if (significant_digits < 1 || significant_digits > 5) {
+        throw std::logic_error("Significant digits of a histogram must be from 1 to 5");
+    }
+
+    // values up to the one need a unit resolution to keep the precision
+    const int64_t largest_single_unit_value = 2 * static_cast<int64_t>(
+        std::pow(10, significant_digits));
+    const int sub_bucket_count_magnitude = GetBitLength(largest_single_unit_value - 1);
+    sub_bucket_half_count_magnitude_ = std::max(sub_bucket_count_magnitude, 1) - 1;
+    unit_magnitude_ = GetBitLength(lowest_value) - 1;
+    sub_bucket_count_ = int64_t{1} << (sub_bucket_half_count_magnitude_ + 1);
+    sub_bucket_half_count_ = sub_bucket_count_ / 2;
+    sub_bucket_mask_ = (sub_bucket_count_ - 1) << unit_magnitude_;
+
+    int64_t smallest_untrackable_value = sub_bucket_count_ << unit_magnitude_;
+    size_t buckets_count = 1;
+    while (smallest_untrackable_value <= highest_value) {
+        if (smallest_untrackable_value > std::numeric_limits<int64_t>::max() / 2) {
+            buckets_count++;
+            break;
+        }
+        smallest_untrackable_value <<= 1;
+        buckets_count++;
+    }
+    counts_.resize((buckets_count + 1) * static_cast<size_t>(sub_bucket_half_count_), 0);
+}
+
+void HdrHistogram::Record(int64_t value, uint64_t count) {
+    value = std::clamp(value, int64_t{0}, highest_value_);
+    counts_[GetIndex(value)] += count;
+    total_count_ += count;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+}
+
+void HdrHistogram::RecordCorrected(int64_t value, int64_t expected_interval) {
+    Record(value);
+    if (expected_interval <= 0) {
+        return;
+    }
+    for (auto missed_value = value - expected_interval; missed_value >= expected_interval;
+         missed_value -= expected_interval) {
+        Record(missed_value);
+    }
+}
+
+void HdrHistogram::Merge(const HdrHistogram& other) {
+    if (other.counts_.size() != counts_.size() || other.unit_magnitude_ != unit_magnitude_ ||
+        other.sub_bucket_count_ != sub_bucket_count_) {
+        throw std::logic_error("Cannot merge histograms of different layouts");
+    }
+    for (size_t i = 0; i < counts_.size(); i++) {
+        counts_[i] += other.counts_[i];
+    }
+    total_count_ += other.total_count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void HdrHistogram::Reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    total_count_ = 0;
+    min_ = std::numeric_limits<int64_t>::max();
+    max_ = 0;
+}
+
+uint64_t HdrHistogram::GetTotalCount() const {
+    return total_count_;
+}
+
+int64_t HdrHistogram::GetMin() const {
+    return total_count_ == 0 ? 0 : min_;
+}
+
+int64_t HdrHistogram::GetMax() const {
+    return max_;
+}
+
+double HdrHistogram::GetMean() const {
+    if (total_count_ == 0) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (size_t i = 0; i < counts_.size(); i++) {
+        if (counts_[i] != 0) {
+            sum += static_cast<double>(GetMedianEquivalent(GetValueFromIndex(i))) * counts_[i];
+        }
+    }
+    return sum / total_count_;
+}
+
+double HdrHistogram::GetStdDeviation() const {
+    if (total_count_ == 0) {
+        return 0.0;
+    }
+    const auto mean = GetMean();
+    double squares_sum = 0.0;
+    for (size_t i = 0; i < counts_.size(); i++) {
+        if (counts_[i] != 0) {
+            const auto deviation =
+                static_cast<double>(GetMedianEquivalent(GetValueFromIndex(i))) - mean;
+            squares_sum += deviation * deviation * counts_[i];
+        }
+    }
+    return std::sqrt(squares_sum / total_count_);
+}
+
+int64_t HdrHistogram::GetValueAtPercentile(double percentile) const {
+    if (total_count_ == 0) {
+        return 0;
+    }
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    const auto count_at_percentile = std::max<uint64_t>(
+        static_cast<uint64_t>(percentile / 100.0 * total_count_ + 0.5), 1);
+    uint64_t count = 0;
+    for (size_t i = 0; i < counts_.size(); i++) {
+        count += counts_[i];
+        if (count >= count_at_percentile) {
+            return std::min(GetHighestEquivalent(GetValueFromIndex(i)), max_);
+        }
+    }
+    return max_;
+}
+
+void HdrHistogram::PrintPercentiles(std::ostream& stream, int ticks_per_half_distance,
+                                    double value_scale) const {
+    const auto flags = stream.flags();
+    stream << std::fixed << std::setw(12) << "Value" << " " << std::setw(14) << "Percentile"
+           << " " << std::setw(10) << "TotalCount" << " " << std::setw(14) << "1/(1-Percentile)"
+           << "\n\n";
+
+    const auto print_line = [&](int64_t value, double percentile, uint64_t count) {
+        stream << std::setw(12) << std::setprecision(3) << value / value_scale << " "
+               << std::setprecision(12) << percentile / 100.0 << " " << std::setw(10) << count;
+        if (percentile < 100.0) {
+            stream << " " << std::setw(14) << std::setprecision(2)
+                   << 1.0 / (1.0 - percentile / 100.0);
+        }
+        stream << "\n";
+    };
+
+    double percentile = 0.0;
+    while (total_count_ != 0) {
+        const auto value = GetValueAtPercentile(percentile);
+        uint64_t count = 0;
+        for (size_t i = 0; i <= GetIndex(value); i++) {
+            count += counts_[i];
+        }
+        if (count >= total_count_) {
+            break;
+        }
+        print_line(value, percentile, count);
+        // the closer to 100%, the denser the reported percentiles are
+        const auto halvings = static_cast<int>(std::log2(100.0 / (100.0 - percentile)));
+        const auto ticks = static_cast<double>(ticks_per_half_distance) * (int64_t{1} << (halvings + 1));
+        percentile += 100.0 / ticks;
+    }
+    print_line(max_, 100.0, total_count_);
+
+    stream << std::setprecision(3)
+           << "#[Mean    = " << std::setw(12) << GetMean() / value_scale
+           << ", StdDeviation   = " << std::setw(12) << GetStdDeviation() / value_scale << "]\n"
+           << "#[Max     = " << std::setw(12) << max_ / value_scale
+           << ", Total count    = " << std::setw(12) << total_count_ << "]\n"
+           << "#[Buckets = " << std::setw(12) << counts_.size() / sub_bucket_half_count_ - 1
+           << ", SubBuckets     = " << std::setw(12) << sub_bucket_count_ << "]\n";
+    stream.flags(flags);
+}
+
+size_t HdrHistogram::GetIndex(int64_t value) const {
+    const int bucket_index = GetBitLength(static_cast<uint64_t>(value | sub_bucket_mask_)) -
+        unit_magnitude_ - (sub_bucket_half_count_magnitude_ + 1);
+    const int64_t sub_bucket_index = value >> (bucket_index + unit_magnitude_);
+    return static_cast<size_t>(
+        (static_cast<int64_t>(bucket_index + 1) << sub_bucket_half_count_magnitude_) +
+        (sub_bucket_index - sub_bucket_half_count_));
+}
+
+int64_t HdrHistogram::GetValueFromIndex(size_t index) const {
+    int bucket_index = static_cast<int>(index >> sub_bucket_half_count_magnitude_) - 1;
+    int64_t sub_bucket_index =
+        static_cast<int64_t>(index & (sub_bucket_half_count_ - 1)) + sub_bucket_half_count_;
+    if (bucket_index < 0) {
+        sub_bucket_index -= sub_bucket_half_count_;
+        bucket_index = 0;
+    }
+    return sub_bucket_index << (bucket_index + unit_magnitude_);
+}
+
+int64_t HdrHistogram::GetLowestEquivalent(int64_t value) const {
+    return GetValueFromIndex(GetIndex(value));
+}
+
+int64_t HdrHistogram::GetHighestEquivalent(int64_t value) const {
+    return GetLowestEquivalent(value) + GetEquivalentRangeSize(value) - 1;
+}
+
+int64_t HdrHistogram::GetMedianEquivalent(int64_t value) const {
+    return GetLowestEquivalent(value) + GetEquivalentRangeSize(value) / 2;
+}
+
+int64_t HdrHistogram::GetEquivalentRangeSize(int64_t value) const {
+    const int bucket_index = GetBitLength(static_cast<uint64_t>(value | sub_bucket_mask_)) -
+        unit_magnitude_ - (sub_bucket_half_count_magnitude_ + 1);
+    const int64_t sub_bucket_index = value >> (bucket_index + unit_magnitude_);
+    const int adjusted_bucket_index =
+        sub_bucket_index >= sub_bucket_count_ ? bucket_index + 1 : bucket_index;
+    return int64_t{1} << (unit_magnitude_ + adjusted_bucket_index);
+}
+
+} // namespace common::metrics
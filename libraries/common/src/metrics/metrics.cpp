@@ -0,0 +1,235 @@
+#include <common/include/metrics.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+#include <common/include/format.hpp>
+
+namespace common::metrics {
+
+namespace {
+
+constexpr const char* kBucketSuffix = "_bucket";
+constexpr const char* kSumSuffix = "_sum";
+constexpr const char* kCountSuffix = "_count";
+constexpr const char* kBoundLabel = "le";
+constexpr const char* kInfinity = "+Inf";
+
+std::string FormatValue(double value) {
+    char buffer[32];
+    const auto size = std::snprintf(buffer, sizeof(buffer), "%.12g", value);
+    return std::string(buffer, static_cast<size_t>(size));
+}
+
+void AppendEscaped(std::string& output, const std::string& value) {
+    for (const auto symbol : value) {
+        switch (symbol) {
+        case '\\':
+            output += "\\\\";
+            break;
+        case '"':
+            output += "\\\"";
+            break;
+        case '\n':
+            output += "\\n";
+            break;
+        default:
+            output += symbol;
+        }
+    }
+}
+
+/// @brief Appends a sample line like 'name{label="value"} 1'.
+void AppendSample(std::string& output, const std::string& name, const char* suffix,
+                  const Labels& labels, const char* bound, const std::string& value) {
+    output += name;
+    output += suffix;
+    if (!labels.empty() || bound != nullptr) {
+        output += '{';
+        bool is_first = true;
+        for (const auto& [label, label_value] : labels) {
+            if (!is_first) {
+                output += ',';
+            }
+            is_first = false;
+            output += label;
+            output += "=\"";
+            AppendEscaped(output, label_value);
+            output += '"';
+        }
+        if (bound != nullptr) {
+            if (!is_first) {
+                output += ',';
+            }
+            output += kBoundLabel;
+            output += "=\"";
+            output += bound;
+            output += '"';
+        }
+        output += '}';
+    }
+    output += ' ';
+    output += value;
+    output += '\n';
+}
+
+template<typename Series>
+auto FindSeries(Series& series, const Labels& labels) {
+    return std::find_if(series.begin(), series.end(),
+                        [&labels](const auto& item) { return item.first == labels; });
+}
+
+} // namespace
+
+size_t GetShardIndex() {
+    static std::atomic<size_t> next_index{0};
+    thread_local const size_t index =
+        next_index.fetch_add(1, std::memory_order_relaxed) % kShardsCount;
+    return index;
+}
+
+Counter::Counter() : shards_{std::make_unique<Shard[]>(kShardsCount)} {}
+
+void Counter::Add(uint64_t value) {
+    shards_[GetShardIndex()].value.fetch_add(value, std::memory_order_relaxed);
+}
+
+uint64_t Counter::Get() const {
+    uint64_t result = 0;
+    for (size_t i = 0; i < kShardsCount; i++) {
+        result += shards_[i].value.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+Histogram::Histogram(std::vector<double> bounds)
+    : bounds_{std::move(bounds)}, shards_{std::make_unique<Shard[]>(kShardsCount)} {
+    if (std::adjacent_find(bounds_.cbegin(), bounds_.cend(), std::greater_equal<double>()) !=
+        bounds_.cend()) {
+        throw std::logic_error("histogram bounds must be strictly increasing");
+    }
+    for (size_t i = 0; i < kShardsCount; i++) {
+        // the last bucket is the +Inf one
+        shards_[i].counts = std::make_unique<std::atomic<uint64_t>[]>(bounds_.size() + 1);
+        for (size_t bucket = 0; bucket <= bounds_.size(); bucket++) {
+            shards_[i].counts[bucket].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Histogram::Observe(double value) {
+    const auto bucket = static_cast<size_t>(std::distance(
+        bounds_.cbegin(), std::lower_bound(bounds_.cbegin(), bounds_.cend(), value)));
+    auto& shard = shards_[GetShardIndex()];
+    shard.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    // a shard is rarely shared, so the loop does not spin in practice
+    auto sum = shard.sum.load(std::memory_order_relaxed);
+    while (!shard.sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {}
+}
+
+HistogramSnapshot Histogram::GetSnapshot() const {
+    HistogramSnapshot snapshot{
+        bounds_,                                    // bounds
+        std::vector<uint64_t>(bounds_.size() + 1),  // counts
+        0,                                          // count
+        0.0,                                        // sum
+    };
+    for (size_t i = 0; i < kShardsCount; i++) {
+        for (size_t bucket = 0; bucket <= bounds_.size(); bucket++) {
+            const auto count = shards_[i].counts[bucket].load(std::memory_order_relaxed);
+            snapshot.counts[bucket] += count;
+            snapshot.count += count;
+        }
+        snapshot.sum += shards_[i].sum.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+const std::vector<double>& GetDefaultLatencyBounds() {
+    static const std::vector<double> kBounds{
+        0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0,
+    };
+    return kBounds;
+}
+
+Registry& Registry::GetInstance() {
+    static Registry registry{};
+    return registry;
+}
+
+Registry::Registry() : mutex_{}, families_{} {}
+
+Registry::~Registry() {}
+
+Registry::Family& Registry::GetFamily(const std::string& name, const std::string& help,
+                                      Type type) {
+    auto [it, is_inserted] = families_.try_emplace(name);
+    auto& family = it->second;
+    if (is_inserted) {
+        family.type = type;
+        family.help = help;
+    } else if (family.type != type) {
+        throw std::logic_error(common::format::Format(
+            "metric '{}' is already registered with another type", name));
+    }
+    return family;
+}
+
+Counter& Registry::GetCounter(const std::string& name, const std::string& help,
+                              const Labels& labels) {
+    std::lock_guard lock(mutex_);
+    auto& counters = GetFamily(name, help, Type::Counter).counters;
+    if (auto it = FindSeries(counters, labels); it != counters.end()) {
+        return *it->second;
+    }
+    counters.emplace_back(labels, std::make_unique<Counter>());
+    return *counters.back().second;
+}
+
+Histogram& Registry::GetHistogram(const std::string& name, const std::string& help,
+                                  const Labels& labels, const std::vector<double>& bounds) {
+    std::lock_guard lock(mutex_);
+    auto& histograms = GetFamily(name, help, Type::Histogram).histograms;
+    if (auto it = FindSeries(histograms, labels); it != histograms.end()) {
+        return *it->second;
+    }
+    histograms.emplace_back(labels, std::make_unique<Histogram>(bounds));
+    return *histograms.back().second;
+}
+
+std::string Registry::Render() const {
+    std::lock_guard lock(mutex_);
+    std::string output{};
+    for (const auto& [name, family] : families_) {
+        output += "# HELP " + name + " " + family.help + "\n";
+        if (family.type == Type::Counter) {
+            output += "# TYPE " + name + " counter\n";
+            for (const auto& [labels, counter_ptr] : family.counters) {
+                AppendSample(output, name, "", labels, nullptr,
+                             std::to_string(counter_ptr->Get()));
+            }
+            continue;
+        }
+
+        output += "# TYPE " + name + " histogram\n";
+        for (const auto& [labels, histogram_ptr] : family.histograms) {
+            const auto snapshot = histogram_ptr->GetSnapshot();
+            uint64_t cumulative_count = 0;
+            for (size_t bucket = 0; bucket < snapshot.bounds.size(); bucket++) {
+                cumulative_count += snapshot.counts[bucket];
+                AppendSample(output, name, kBucketSuffix, labels,
+                             FormatValue(snapshot.bounds[bucket]).c_str(),
+                             std::to_string(cumulative_count));
+            }
+            AppendSample(output, name, kBucketSuffix, labels, kInfinity,
+                         std::to_string(snapshot.count));
+            AppendSample(output, name, kSumSuffix, labels, nullptr, FormatValue(snapshot.sum));
+            AppendSample(output, name, kCountSuffix, labels, nullptr,
+                         std::to_string(snapshot.count));
+        }
+    }
+    return output;
+}
+
+} // namespace common::metrics
@@ -0,0 +1,213 @@
+#include <common/include/task_pool.hpp>
+
+#include <common/include/logging.hpp>
+
+namespace common::threading {
+
+namespace {
+
+/// @struct Worker the current thread belongs to.
+struct CurrentWorker {
+    const TaskPool* pool_ptr{nullptr};
+    size_t index{};
+};
+
+thread_local CurrentWorker current_worker{};
+
+/// @struct Shared state of a ParallelFor loop. The loop is over once all of the
+/// chunks are done, the late helpers find no chunks left and never touch run_chunk.
+struct Loop {
+    Loop(size_t chunks_count, const std::function<void(size_t chunk)>& run_chunk)
+        : chunks_count{chunks_count}, run_chunk{run_chunk}, next_chunk{0}, done_count{0},
+          is_failed{false}, mutex{}, done_condition{}, error_ptr{} {}
+
+    void Execute() {
+        for (;;) {
+            const auto chunk = next_chunk++;
+            if (chunk >= chunks_count) {
+                return;
+            }
+            if (!is_failed) {
+                try {
+                    run_chunk(chunk);
+                } catch (...) {
+                    std::lock_guard lock(mutex);
+                    if (error_ptr == nullptr) {
+                        error_ptr = std::current_exception();
+                    }
+                    is_failed = true;
+                }
+            }
+            if (++done_count == chunks_count) {
+                std::lock_guard lock(mutex);
+                done_condition.notify_all();
+            }
+        }
+    }
+
+    const size_t chunks_count;
+    const std::function<void(size_t chunk)>& run_chunk;
+    std::atomic<size_t> next_chunk;
+    std::atomic<size_t> done_count;
+    std::atomic<bool> is_failed;
+    std::mutex mutex;
+    std::condition_variable done_condition;
+    std::exception_ptr error_ptr;
+};
+
+} // namespace
+
+TaskPool::TaskPool(size_t pool_size)
+    : pool_size_{std::max<size_t>(pool_size, 1)}, queues_{}, pool_{}, next_queue_{0},
+      sleep_mutex_{}, sleep_condition_{}, sleeping_count_{0}, pending_count_{0},
+      is_stopped_{false}, executed_count_{0}, stolen_count_{0} {
+    queues_.reserve(pool_size_);
+    for (size_t i = 0; i < pool_size_; i++) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+}
+
+TaskPool::~TaskPool() {
+    Stop();
+}
+
+void TaskPool::Run() {
+    Join();
+    is_stopped_ = false;
+    pool_.clear();
+    pool_.reserve(pool_size_);
+    for (size_t i = 0; i < pool_size_; i++) {
+        pool_.emplace_back([this, i] { RunWorker(i); });
+    }
+}
+
+void TaskPool::Stop() {
+    is_stopped_ = true;
+    {
+        std::lock_guard lock(sleep_mutex_);
+    }
+    sleep_condition_.notify_all();
+    Join();
+}
+
+void TaskPool::Join() {
+    for (auto& thread : pool_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+bool TaskPool::Post(Task&& task) {
+    // the task is counted before the stop check, so the workers
+    // do not exit while it is being queued
+    pending_count_++;
+    if (is_stopped_) {
+        pending_count_--;
+        return false;
+    }
+
+    const auto index = current_worker.pool_ptr == this ?
+        current_worker.index : next_queue_++ % pool_size_;
+    {
+        auto& queue = *queues_[index];
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    if (sleeping_count_ > 0) {
+        {
+            std::lock_guard lock(sleep_mutex_);
+        }
+        sleep_condition_.notify_one();
+    }
+    return true;
+}
+
+bool TaskPool::IsWorkerThread() const {
+    return current_worker.pool_ptr == this;
+}
+
+size_t TaskPool::GetPoolSize() const {
+    return pool_size_;
+}
+
+TaskPoolStats TaskPool::GetStats() const {
+    return TaskPoolStats{
+        executed_count_,    // executed
+        stolen_count_,      // stolen
+    };
+}
+
+void TaskPool::RunWorker(size_t index) {
+    current_worker = CurrentWorker{this, index};
+    for (;;) {
+        Task task{};
+        if (!TryPop(index, task) && !TrySteal(index, task)) {
+            std::unique_lock lock(sleep_mutex_);
+            sleeping_count_++;
+            sleep_condition_.wait(lock, [this] { return is_stopped_ || pending_count_ > 0; });
+            sleeping_count_--;
+            if (is_stopped_ && pending_count_ == 0) {
+                break;
+            }
+            continue;
+        }
+
+        pending_count_--;
+        try {
+            task();
+        } catch (const std::exception& ex) {
+            LOG_ERROR() << "Not handled exception in pool task: " << ex.what();
+        }
+        executed_count_++;
+    }
+    current_worker = CurrentWorker{};
+}
+
+bool TaskPool::TryPop(size_t index, Task& task) {
+    auto& queue = *queues_[index];
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool TaskPool::TrySteal(size_t index, Task& task) {
+    for (size_t i = 1; i < pool_size_; i++) {
+        auto& queue = *queues_[(index + i) % pool_size_];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            stolen_count_++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskPool::RunChunks(size_t chunks_count,
+                         const std::function<void(size_t chunk)>& run_chunk) {
+    auto loop_ptr = std::make_shared<Loop>(chunks_count, run_chunk);
+    // the calling thread executes the chunks as well
+    const auto helpers_count = std::min(chunks_count - 1, pool_size_);
+    for (size_t i = 0; i < helpers_count; i++) {
+        if (!Post([loop_ptr] { loop_ptr->Execute(); })) {
+            break;
+        }
+    }
+    loop_ptr->Execute();
+
+    std::unique_lock lock(loop_ptr->mutex);
+    loop_ptr->done_condition.wait(lock, [&loop_ptr] {
+        return loop_ptr->done_count == loop_ptr->chunks_count;
+    });
+    if (loop_ptr->error_ptr != nullptr) {
+        std::rethrow_exception(loop_ptr->error_ptr);
+    }
+}
+
+} // namespace common::threading
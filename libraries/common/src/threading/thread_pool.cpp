@@ -1,10 +1,147 @@
 #include <common/include/thread_pool.hpp>
 
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <common/include/format.hpp>
+#include <common/include/logging.hpp>
+
 
 namespace common::threading {
 
+namespace {
+
+// Linux thread name limit without the terminating zero
+constexpr size_t kMaxThreadNameLength = 15;
+
+/// @brief Resolves the threads count and the CPUs to pin the threads to.
+/// @throws std::invalid_argument if a CPU to pin to is not available
+ThreadPoolSettings ResolveSettings(ThreadPoolSettings settings) {
+    const auto available_cpus = GetAvailableCpus();
+    if (settings.threads_count == 0) {
+        settings.threads_count = available_cpus.size();
+    }
+    if (!settings.pin_threads) {
+        return settings;
+    }
+    if (settings.cpus.empty()) {
+        settings.cpus = available_cpus;
+    }
+    for (const auto cpu : settings.cpus) {
+        if (std::find(available_cpus.begin(), available_cpus.end(), cpu) == available_cpus.end()) {
+            throw std::invalid_argument(format::Format("CPU {} is not available", cpu));
+        }
+    }
+    return settings;
+}
+
+std::string GetThreadName(const ThreadPoolSettings& settings, size_t index) {
+    auto name = format::Format("{}-{}", settings.name, index);
+    if (name.size() > kMaxThreadNameLength) {
+        name.resize(kMaxThreadNameLength);
+    }
+    return name;
+}
+
+std::optional<size_t> GetThreadCpu(const ThreadPoolSettings& settings, size_t index) {
+    if (!settings.pin_threads) {
+        return std::nullopt;
+    }
+    return settings.cpus[index % settings.cpus.size()];
+}
+
+void PinThread(size_t cpu) {
+#ifdef __linux__
+    cpu_set_t cpu_set{};
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    if (const auto error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        error != 0) {
+        LOG_WARNING() << format::Format("Cannot pin thread to CPU {}: {}",
+                                        cpu, std::string(std::strerror(error)));
+    }
+#endif
+}
+
+/// @brief Names the calling thread and pins it to the CPU if any.
+void SetupThread(const std::string& name, std::optional<size_t> cpu) {
+#ifdef __linux__
+    if (!name.empty()) {
+        pthread_setname_np(pthread_self(), name.c_str());
+    }
+#endif
+    if (cpu.has_value()) {
+        PinThread(cpu.value());
+        const auto node = GetCpuNode(cpu.value());
+        LOG_DEBUG() << format::Format("Thread {} is pinned to CPU {}, NUMA node {}",
+            name, cpu.value(), node.has_value() ? std::to_string(node.value()) : "unknown");
+    }
+}
+
+} // namespace
+
+std::vector<size_t> GetAvailableCpus() {
+    std::vector<size_t> cpus{};
+#ifdef __linux__
+    // the affinity mask respects the cgroup cpusets of the containers
+    cpu_set_t cpu_set{};
+    CPU_ZERO(&cpu_set);
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+        for (size_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &cpu_set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        const auto cpus_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        for (size_t cpu = 0; cpu < cpus_count; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+std::optional<size_t> GetCpuNode(size_t cpu) {
+    // a CPU directory in sysfs has a link to its node directory
+    const std::filesystem::path cpu_path = format::Format("/sys/devices/system/cpu/cpu{}", cpu);
+    std::error_code error_code{};
+    for (std::filesystem::directory_iterator it(cpu_path, error_code), end{};
+         !error_code && it != end; it.increment(error_code)) {
+        static constexpr std::string_view kNodePrefix = "node";
+        const auto file_name = it->path().filename().string();
+        if (file_name.size() <= kNodePrefix.size() ||
+            file_name.compare(0, kNodePrefix.size(), kNodePrefix) != 0) {
+            continue;
+        }
+        size_t node{};
+        const auto* end_ptr = file_name.data() + file_name.size();
+        const auto [ptr, error] = std::from_chars(file_name.data() + kNodePrefix.size(),
+                                                  end_ptr, node);
+        if (error == std::errc{} && ptr == end_ptr) {
+            return node;
+        }
+    }
+    return std::nullopt;
+}
+
 IoThreadPool::IoThreadPool(size_t pool_size) 
-    : pool_size_{pool_size} {
+    : settings_{}, pool_size_{pool_size} {
+    context_ptr_ = std::make_shared<
+        boost::asio::io_context>(pool_size_);
+}
+
+IoThreadPool::IoThreadPool(const ThreadPoolSettings& settings)
+    : settings_{ResolveSettings(settings)}, pool_size_{settings_.threads_count} {
     context_ptr_ = std::make_shared<
         boost::asio::io_context>(pool_size_);
 }
@@ -18,21 +155,35 @@ IoThreadPool::GetContextPtr() const {
     return context_ptr_;
 }
 
+size_t IoThreadPool::GetPoolSize() const {
+    return pool_size_;
+}
+
 void IoThreadPool::Run() {
+    RunThreads(0);
+}
+
+void IoThreadPool::RunInThisThread() {
+    RunThreads(1);
+    // renaming the main thread would rename the process
+    SetupThread({}, GetThreadCpu(settings_, 0));
+    context_ptr_->run();
+}
+
+void IoThreadPool::RunThreads(size_t first_index) {
     Join();
     pool_.clear();
     pool_.reserve(pool_size_);
-    for(auto i = 0; i < pool_size_; i++) {
+    for (auto i = first_index; i < pool_size_; i++) {
         pool_.emplace_back(
-            [context = this->context_ptr_] { context->run(); });
+            [context = this->context_ptr_, name = GetThreadName(settings_, i),
+             cpu = GetThreadCpu(settings_, i)] {
+                SetupThread(name, cpu);
+                context->run();
+            });
     }
 }
 
-void IoThreadPool::RunInThisThread() {
-    Run();
-    context_ptr_->run();
-}
-
 void IoThreadPool::Stop() {
     if (context_ptr_->stopped()) {
         return;
@@ -43,8 +194,11 @@ void IoThreadPool::Stop() {
 }
 
 void IoThreadPool::Join() {
+    // the threads are joined by Stop already if it is called before the destructor
     for (auto& thread : pool_) {
-        thread.join();
+        if (thread.joinable()) {
+            thread.join();
+        }
     }
 }
 
@@ -54,4 +208,178 @@ void IoThreadPool::Detach() {
     }
 }
 
+namespace {
+
+// Each reactor is driven by exactly one thread, that allows
+// boost::asio to drop the scheduler locking.
+constexpr int kReactorConcurrencyHint = 1;
+
+} // namespace
+
+IoReactorPool::IoReactorPool(size_t pool_size)
+    : settings_{}, pool_size_{std::max<size_t>(pool_size, 1)} {
+    context_ptrs_.reserve(pool_size_);
+    for (size_t i = 0; i < pool_size_; i++) {
+        context_ptrs_.push_back(std::make_shared<
+            boost::asio::io_context>(kReactorConcurrencyHint));
+    }
+}
+
+IoReactorPool::IoReactorPool(const ThreadPoolSettings& settings)
+    : settings_{ResolveSettings(settings)}, pool_size_{settings_.threads_count} {
+    context_ptrs_.reserve(pool_size_);
+    for (size_t i = 0; i < pool_size_; i++) {
+        const auto cpu = GetThreadCpu(settings_, i);
+        if (!cpu.has_value()) {
+            context_ptrs_.push_back(std::make_shared<
+                boost::asio::io_context>(kReactorConcurrencyHint));
+            continue;
+        }
+        // the context is created by a thread on its CPU, so the memory
+        // it touches first is allocated on the local NUMA node
+        std::shared_ptr<boost::asio::io_context> context_ptr{};
+        std::thread([&context_ptr, cpu] {
+            PinThread(cpu.value());
+            context_ptr = std::make_shared<
+                boost::asio::io_context>(kReactorConcurrencyHint);
+        }).join();
+        context_ptrs_.push_back(std::move(context_ptr));
+    }
+}
+
+IoReactorPool::~IoReactorPool() {
+    Join();
+}
+
+std::vector<std::shared_ptr<boost::asio::io_context>>
+IoReactorPool::GetContextPtrs() const {
+    return context_ptrs_;
+}
+
+size_t IoReactorPool::GetPoolSize() const {
+    return pool_size_;
+}
+
+void IoReactorPool::Run() {
+    RunContexts(0);
+}
+
+void IoReactorPool::RunInThisThread() {
+    RunContexts(1);
+    // renaming the main thread would rename the process
+    SetupThread({}, GetThreadCpu(settings_, 0));
+    context_ptrs_.front()->run();
+}
+
+void IoReactorPool::RunContexts(size_t first_index) {
+    Join();
+    pool_.clear();
+    pool_.reserve(pool_size_);
+    for (auto i = first_index; i < pool_size_; i++) {
+        pool_.emplace_back(
+            [context = context_ptrs_[i], name = GetThreadName(settings_, i),
+             cpu = GetThreadCpu(settings_, i)] {
+                SetupThread(name, cpu);
+                context->run();
+            });
+    }
+}
+
+void IoReactorPool::Stop() {
+    for (auto& context_ptr : context_ptrs_) {
+        context_ptr->stop();
+    }
+    Join();
+}
+
+void IoReactorPool::Join() {
+    for (auto& thread : pool_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void IoReactorPool::Detach() {
+    for (auto& thread : pool_) {
+        thread.detach();
+    }
+}
+
+WorkerPool::WorkerPool(size_t pool_size, size_t max_queue_size)
+    : pool_size_{std::max<size_t>(pool_size, 1)}, max_queue_size_{max_queue_size},
+      pool_{}, queue_mutex_{}, queue_condition_{}, queue_{}, is_stopped_{false} {}
+
+WorkerPool::~WorkerPool() {
+    Stop();
+}
+
+bool WorkerPool::TryPost(Task&& task) {
+    {
+        std::lock_guard lock(queue_mutex_);
+        if (is_stopped_ || queue_.size() >= max_queue_size_) {
+            return false;
+        }
+        queue_.push_back(std::move(task));
+    }
+    queue_condition_.notify_one();
+    return true;
+}
+
+void WorkerPool::Run() {
+    Join();
+    {
+        std::lock_guard lock(queue_mutex_);
+        is_stopped_ = false;
+    }
+    pool_.clear();
+    pool_.reserve(pool_size_);
+    for (size_t i = 0; i < pool_size_; i++) {
+        pool_.emplace_back([this] { RunWorker(); });
+    }
+}
+
+void WorkerPool::Stop() {
+    {
+        std::lock_guard lock(queue_mutex_);
+        is_stopped_ = true;
+    }
+    queue_condition_.notify_all();
+    Join();
+}
+
+void WorkerPool::Join() {
+    for (auto& thread : pool_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+size_t WorkerPool::GetQueueSize() const {
+    std::lock_guard lock(queue_mutex_);
+    return queue_.size();
+}
+
+void WorkerPool::RunWorker() {
+    for (;;) {
+        Task task{};
+        {
+            std::unique_lock lock(queue_mutex_);
+            queue_condition_.wait(lock, [this] { return is_stopped_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        try {
+            task();
+        } catch (const std::exception& ex) {
+            LOG_ERROR() << "Not handled exception in worker task: " << ex.what();
+        }
+    }
+}
+
 } // namespace common::threading
@@ -0,0 +1,222 @@
+#include <common/include/timing_wheel.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace common::threading {
+
+namespace {
+
+constexpr uint64_t kSlotMask = TimingWheel::kSlotsCount - 1;
+// timers further than that are parked in the last level until they come closer
+constexpr uint64_t kMaxDelta =
+    (uint64_t{1} << (TimingWheel::kSlotBits * TimingWheel::kLevelsCount)) - 1;
+
+} // namespace
+
+TimingWheel::Timer::Timer()
+    : on_expired_{}, wheel_ptr_{nullptr}, prev_ptr_{nullptr}, next_ptr_{nullptr},
+      slot_ptr_{nullptr}, expires_at_tick_{0} {}
+
+TimingWheel::Timer::Timer(Callback&& on_expired) : Timer() {
+    on_expired_ = std::move(on_expired);
+}
+
+TimingWheel::Timer::~Timer() {
+    // the wheel is set once on the first arming by the timer owner
+    if (wheel_ptr_ != nullptr) {
+        wheel_ptr_->Cancel(*this);
+    }
+}
+
+void TimingWheel::Timer::SetCallback(Callback&& on_expired) {
+    on_expired_ = std::move(on_expired);
+}
+
+std::shared_ptr<TimingWheel> TimingWheel::Create(
+    std::shared_ptr<boost::asio::io_context> io_context_ptr, Clock::duration resolution) {
+    return std::shared_ptr<TimingWheel>(new TimingWheel(std::move(io_context_ptr), resolution));
+}
+
+TimingWheel::TimingWheel(std::shared_ptr<boost::asio::io_context> io_context_ptr,
+                         Clock::duration resolution)
+    : io_context_ptr_{std::move(io_context_ptr)},
+      resolution_{std::max(resolution, Clock::duration{1})},
+      started_at_{Clock::now()}, tick_timer_{*io_context_ptr_}, mutex_{},
+      levels_{}, current_tick_{0}, size_{0}, is_ticking_{false} {}
+
+TimingWheel::~TimingWheel() {
+    for (auto& slots : levels_) {
+        for (auto timer_ptr : slots) {
+            for (; timer_ptr != nullptr; timer_ptr = timer_ptr->next_ptr_) {
+                timer_ptr->slot_ptr_ = nullptr;
+            }
+        }
+    }
+}
+
+void TimingWheel::Arm(Timer& timer, Clock::duration timeout) {
+    const auto expires_at = Clock::now() + std::max(timeout, Clock::duration{0});
+    bool is_tick_needed = false;
+    {
+        std::lock_guard lock(mutex_);
+        timer.wheel_ptr_ = this;
+        if (timer.slot_ptr_ != nullptr) {
+            Unlink(timer);
+            size_--;
+        }
+        // ticks are not processed while the wheel is empty
+        if (size_ == 0) {
+            current_tick_ = std::max(current_tick_, GetTick(Clock::now()));
+        }
+        // rounded up, so the timer never fires earlier
+        timer.expires_at_tick_ = (expires_at - started_at_ + resolution_ - Clock::duration{1}) /
+                                 resolution_;
+        Insert(timer);
+        size_++;
+        if (!is_ticking_) {
+            is_ticking_ = true;
+            is_tick_needed = true;
+        }
+    }
+    // only the thread switched the ticking on touches the asio timer
+    if (is_tick_needed) {
+        ScheduleTick();
+    }
+}
+
+void TimingWheel::Cancel(Timer& timer) {
+    std::lock_guard lock(mutex_);
+    if (timer.slot_ptr_ != nullptr) {
+        Unlink(timer);
+        size_--;
+    }
+}
+
+bool TimingWheel::IsArmed(const Timer& timer) const {
+    std::lock_guard lock(mutex_);
+    return timer.slot_ptr_ != nullptr;
+}
+
+size_t TimingWheel::GetSize() const {
+    std::lock_guard lock(mutex_);
+    return size_;
+}
+
+void TimingWheel::Advance(Clock::time_point now) {
+    std::vector<Timer::Callback> expired{};
+    {
+        std::lock_guard lock(mutex_);
+        const auto target_tick = GetTick(now);
+        for (; current_tick_ <= target_tick && size_ != 0; current_tick_++) {
+            const auto index = current_tick_ & kSlotMask;
+            // the next block of ticks has come, bring its timers one level down
+            if (index == 0) {
+                for (size_t level = 1; level < kLevelsCount; level++) {
+                    const auto level_index = (current_tick_ >> (kSlotBits * level)) & kSlotMask;
+                    Cascade(level, level_index);
+                    if (level_index != 0) {
+                        break;
+                    }
+                }
+            }
+
+            auto timer_ptr = levels_[0][index];
+            levels_[0][index] = nullptr;
+            while (timer_ptr != nullptr) {
+                const auto next_ptr = timer_ptr->next_ptr_;
+                timer_ptr->prev_ptr_ = nullptr;
+                timer_ptr->next_ptr_ = nullptr;
+                timer_ptr->slot_ptr_ = nullptr;
+                size_--;
+                expired.push_back(timer_ptr->on_expired_);
+                timer_ptr = next_ptr;
+            }
+        }
+        // nothing to process in between
+        if (size_ == 0) {
+            current_tick_ = std::max(current_tick_, target_tick + 1);
+        }
+    }
+
+    for (const auto& on_expired : expired) {
+        if (on_expired) {
+            on_expired();
+        }
+    }
+}
+
+uint64_t TimingWheel::GetTick(Clock::time_point time_point) const {
+    return (time_point - started_at_) / resolution_;
+}
+
+void TimingWheel::Insert(Timer& timer) {
+    const auto expires_at_tick = std::max(timer.expires_at_tick_, current_tick_);
+    const auto delta = std::min(expires_at_tick - current_tick_, kMaxDelta);
+    // the first level whose range covers the delta
+    size_t level = 0;
+    while (level + 1 < kLevelsCount && delta >> (kSlotBits * (level + 1)) != 0) {
+        level++;
+    }
+    const auto tick = current_tick_ + delta;
+    auto& head_ptr = levels_[level][(tick >> (kSlotBits * level)) & kSlotMask];
+
+    timer.prev_ptr_ = nullptr;
+    timer.next_ptr_ = head_ptr;
+    timer.slot_ptr_ = &head_ptr;
+    if (head_ptr != nullptr) {
+        head_ptr->prev_ptr_ = &timer;
+    }
+    head_ptr = &timer;
+}
+
+void TimingWheel::Unlink(Timer& timer) {
+    if (timer.prev_ptr_ != nullptr) {
+        timer.prev_ptr_->next_ptr_ = timer.next_ptr_;
+    } else {
+        *timer.slot_ptr_ = timer.next_ptr_;
+    }
+    if (timer.next_ptr_ != nullptr) {
+        timer.next_ptr_->prev_ptr_ = timer.prev_ptr_;
+    }
+    timer.prev_ptr_ = nullptr;
+    timer.next_ptr_ = nullptr;
+    timer.slot_ptr_ = nullptr;
+}
+
+void TimingWheel::Cascade(size_t level, size_t index) {
+    auto timer_ptr = levels_[level][index];
+    levels_[level][index] = nullptr;
+    while (timer_ptr != nullptr) {
+        const auto next_ptr = timer_ptr->next_ptr_;
+        Insert(*timer_ptr);
+        timer_ptr = next_ptr;
+    }
+}
+
+void TimingWheel::ScheduleTick() {
+    tick_timer_.expires_after(resolution_);
+    tick_timer_.async_wait(
+        [weak_ptr = weak_from_this()](const boost::system::error_code& error_code) {
+            if (error_code) {
+                return;
+            }
+            if (auto self_ptr = weak_ptr.lock(); self_ptr != nullptr) {
+                self_ptr->OnTick();
+            }
+        });
+}
+
+void TimingWheel::OnTick() {
+    Advance(Clock::now());
+    {
+        std::lock_guard lock(mutex_);
+        if (size_ == 0) {
+            is_ticking_ = false;
+            return;
+        }
+    }
+    ScheduleTick();
+}
+
+} // namespace common::threading
@@ -0,0 +1,119 @@
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <common/include/allocators.hpp>
+
+namespace common::tests::allocators {
+
+namespace {
+
+using String = std::basic_string<char, std::char_traits<char>,
+                                 common::memory::ArenaAllocator<char>>;
+
+bool IsAligned(const void* ptr, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+} // namespace
+
+TEST_CASE("Recycled blocks", "[RecyclingAllocator]") {
+    common::memory::RecyclingAllocator<uint64_t> allocator{};
+    auto first_ptr = allocator.allocate(10);
+    allocator.deallocate(first_ptr, 10);
+
+    // a block of the same size class is reused by the thread
+    auto second_ptr = allocator.allocate(12);
+    CHECK(second_ptr == first_ptr);
+    allocator.deallocate(second_ptr, 12);
+
+    std::vector<int, common::memory::RecyclingAllocator<int>> items{};
+    for (int i = 0; i < 1000; i++) {
+        items.push_back(i);
+    }
+    CHECK(items.back() == 999);
+}
+
+TEST_CASE("Monotonic arena", "[MonotonicArena]") {
+    common::memory::MonotonicArena arena(64);
+    auto first_ptr = arena.Allocate(10, 1);
+    auto second_ptr = arena.Allocate(8, 8);
+    CHECK(IsAligned(second_ptr, 8));
+    CHECK(static_cast<char*>(second_ptr) >= static_cast<char*>(first_ptr) + 10);
+    CHECK(arena.GetUsedSize() == 18);
+
+    // does not fit the first block
+    auto large_ptr = arena.Allocate(100, 16);
+    CHECK(IsAligned(large_ptr, 16));
+    const auto capacity = arena.GetCapacity();
+    CHECK(capacity >= 164);
+
+    // the memory is reused after reset
+    arena.Reset();
+    CHECK(arena.GetUsedSize() == 0);
+    CHECK(arena.Allocate(10, 1) == first_ptr);
+    CHECK(arena.GetCapacity() == capacity);
+}
+
+TEST_CASE("Arena pool", "[ArenaPool]") {
+    auto pool_ptr = common::memory::ArenaPool::Create(2);
+    CHECK(pool_ptr->GetSize() == 0);
+
+    const char* data_ptr = nullptr;
+    {
+        String value(pool_ptr->Acquire());
+        value.assign(1000, 'x');
+        data_ptr = value.data();
+        CHECK(pool_ptr->GetSize() == 0);
+    }
+    // the arena is back once the string is gone
+    CHECK(pool_ptr->GetSize() == 1);
+    {
+        String value(pool_ptr->Acquire());
+        value.assign(1000, 'y');
+        CHECK(value.data() == data_ptr);
+    }
+    CHECK(pool_ptr->GetSize() == 1);
+}
+
+TEST_CASE("Arena allocator copies", "[ArenaAllocator]") {
+    auto pool_ptr = common::memory::ArenaPool::Create();
+
+    String copy{};
+    String moved{};
+    {
+        String value(pool_ptr->Acquire());
+        value.assign(1000, 'x');
+        CHECK(value.get_allocator().IsArenaBacked());
+
+        // a copy does not hold the arena
+        copy = String(value);
+        CHECK_FALSE(String(value).get_allocator().IsArenaBacked());
+
+        moved = std::move(value);
+        CHECK(moved.get_allocator().IsArenaBacked());
+    }
+    CHECK(pool_ptr->GetSize() == 0);
+    CHECK(copy == moved);
+
+    moved = String{};
+    CHECK(pool_ptr->GetSize() == 1);
+}
+
+TEST_CASE("Arena outlives pool", "[ArenaPool]") {
+    auto pool_ptr = common::memory::ArenaPool::Create();
+    std::map<int, int, std::less<int>,
+             common::memory::ArenaAllocator<std::pair<const int, int>>>
+        items(pool_ptr->Acquire());
+    pool_ptr.reset();
+
+    for (int i = 0; i < 100; i++) {
+        items[i] = i;
+    }
+    CHECK(items.size() == 100);
+}
+
+} // namespace common::tests::allocators
@@ -311,4 +311,21 @@ TEST_CASE_METHOD(BinaryTestFixture, "Truncate", "[Binary]") {
     CHECK(result == str2);
 }
 
+TEST_CASE_METHOD(BinaryTestFixture, "RawWrite", "[Binary]") {
+    const std::string str = "Hello world";
+
+    {
+        // the size is written ahead of the parts, like a string would have it
+        common::binary::BinaryOutStream wrapper_out(kFileName);
+        wrapper_out << str.size();
+        wrapper_out.Write(std::string_view(str).substr(0, 6));
+        wrapper_out.Write(std::string_view(str).substr(6));
+    }
+
+    common::binary::BinaryInStream wrapper_in(kFileName);
+    std::string result;
+    wrapper_in >> result;
+    CHECK(result == str);
+}
+
 } // namespace common::tests::binary
@@ -0,0 +1,109 @@
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include <common/include/hdr_histogram.hpp>
+
+namespace common::tests::hdr_histogram {
+
+namespace {
+
+using common::metrics::HdrHistogram;
+
+constexpr int64_t kHighestValue = 3600LL * 1000 * 1000;
+
+} // namespace
+
+TEST_CASE("HDR histogram invalid parameters", "[HdrHistogram]") {
+    CHECK_THROWS_AS(HdrHistogram(0, 100, 3), std::logic_error);
+    CHECK_THROWS_AS(HdrHistogram(10, 15, 3), std::logic_error);
+    CHECK_THROWS_AS(HdrHistogram(1, 100, 0), std::logic_error);
+    CHECK_THROWS_AS(HdrHistogram(1, 100, 6), std::logic_error);
+}
+
+TEST_CASE("HDR histogram percentiles", "[HdrHistogram]") {
+    HdrHistogram histogram(1, kHighestValue, 3);
+    CHECK(histogram.GetValueAtPercentile(50.0) == 0);
+
+    // a uniform distribution over [1, 100000]
+    for (int64_t value = 1; value <= 100000; value++) {
+        histogram.Record(value);
+    }
+    CHECK(histogram.GetTotalCount() == 100000);
+    CHECK(histogram.GetMin() == 1);
+    CHECK(histogram.GetMax() == 100000);
+    CHECK(histogram.GetMean() == Approx(50000.5).epsilon(0.001));
+    CHECK(histogram.GetStdDeviation() == Approx(28867.5).epsilon(0.001));
+
+    // the relative error is within the precision
+    for (const double percentile : {1.0, 10.0, 50.0, 90.0, 99.0, 99.9}) {
+        CAPTURE(percentile);
+        CHECK(histogram.GetValueAtPercentile(percentile) ==
+              Approx(percentile * 1000).epsilon(0.001));
+    }
+    CHECK(histogram.GetValueAtPercentile(0.0) == 1);
+    CHECK(histogram.GetValueAtPercentile(100.0) == 100000);
+
+    // small values have the unit resolution
+    histogram.Reset();
+    histogram.Record(7, 3);
+    histogram.Record(1500);
+    CHECK(histogram.GetValueAtPercentile(75.0) == 7);
+    CHECK(histogram.GetValueAtPercentile(100.0) == 1500);
+}
+
+TEST_CASE("HDR histogram saturation", "[HdrHistogram]") {
+    HdrHistogram histogram(1, 1000, 2);
+    histogram.Record(-5);
+    histogram.Record(1000 * 1000);
+    CHECK(histogram.GetMin() == 0);
+    CHECK(histogram.GetMax() == 1000);
+    CHECK(histogram.GetTotalCount() == 2);
+}
+
+TEST_CASE("HDR histogram coordinated omission", "[HdrHistogram]") {
+    HdrHistogram histogram(1, kHighestValue, 3);
+    for (size_t i = 0; i < 99; i++) {
+        histogram.RecordCorrected(10, 100);
+    }
+    // a single stall of a second hides the 9999 samples a steady
+    // load would have measured meanwhile
+    histogram.RecordCorrected(1000 * 1000, 100);
+    CHECK(histogram.GetTotalCount() == 99 + 10000);
+    CHECK(histogram.GetValueAtPercentile(50.0) == Approx(495100).epsilon(0.001));
+    CHECK(histogram.GetMax() == 1000 * 1000);
+}
+
+TEST_CASE("HDR histogram merge", "[HdrHistogram]") {
+    HdrHistogram first(1, kHighestValue, 3);
+    HdrHistogram second(1, kHighestValue, 3);
+    first.Record(100, 10);
+    second.Record(5000, 10);
+    first.Merge(second);
+    CHECK(first.GetTotalCount() == 20);
+    CHECK(first.GetMin() == 100);
+    CHECK(first.GetMax() == 5000);
+    CHECK(first.GetValueAtPercentile(50.0) == 100);
+    CHECK(first.GetValueAtPercentile(60.0) == 5000);
+
+    HdrHistogram other_layout(1, 1000, 2);
+    CHECK_THROWS_AS(first.Merge(other_layout), std::logic_error);
+}
+
+TEST_CASE("HDR histogram percentile distribution", "[HdrHistogram]") {
+    HdrHistogram histogram(1, kHighestValue, 3);
+    for (int64_t value = 1; value <= 1000; value++) {
+        histogram.Record(value * 1000);
+    }
+    std::stringstream stream{};
+    histogram.PrintPercentiles(stream, 5, 1000.0);
+    const auto text = stream.str();
+    CHECK(text.find("Value     Percentile TotalCount 1/(1-Percentile)") != std::string::npos);
+    CHECK(text.find("    1000.000 1.000000000000       1000\n") != std::string::npos);
+    CHECK(text.find("#[Max     =     1000.000, Total count    =         1000]") !=
+          std::string::npos);
+}
+
+} // namespace common::tests::hdr_histogram
@@ -0,0 +1,84 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <common/include/metrics.hpp>
+
+namespace common::tests::metrics {
+
+namespace {
+
+using common::metrics::Registry;
+
+bool Contains(const std::string& text, const std::string& line) {
+    return text.find(line + "\n") != std::string::npos;
+}
+
+} // namespace
+
+TEST_CASE("Sharded counter", "[Metrics]") {
+    constexpr size_t kThreadsCount = 8;
+    constexpr size_t kIterations = 100 * 1000;
+
+    common::metrics::Counter counter{};
+    std::vector<std::thread> threads{};
+    for (size_t i = 0; i < kThreadsCount; i++) {
+        threads.emplace_back([&counter] {
+            for (size_t j = 0; j < kIterations; j++) {
+                counter.Add();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK(counter.Get() == kThreadsCount * kIterations);
+}
+
+TEST_CASE("Histogram buckets", "[Metrics]") {
+    common::metrics::Histogram histogram({1.0, 2.0, 5.0});
+    for (const auto value : {0.5, 1.0, 1.5, 3.0, 5.0, 10.0}) {
+        histogram.Observe(value);
+    }
+    const auto snapshot = histogram.GetSnapshot();
+    CHECK(snapshot.counts == std::vector<uint64_t>{2, 1, 2, 1});
+    CHECK(snapshot.count == 6);
+    CHECK(snapshot.sum == Approx(21.0));
+
+    CHECK_THROWS_AS(common::metrics::Histogram({1.0, 1.0}), std::logic_error);
+}
+
+TEST_CASE("Registry", "[Metrics]") {
+    auto& registry = Registry::GetInstance();
+    auto& counter = registry.GetCounter("test_registry_total", "Test counter",
+                                        {{"route", "/a"}});
+    CHECK(&registry.GetCounter("test_registry_total", "", {{"route", "/a"}}) == &counter);
+    CHECK(&registry.GetCounter("test_registry_total", "", {{"route", "/b"}}) != &counter);
+    CHECK_THROWS_AS(registry.GetHistogram("test_registry_total", ""), std::logic_error);
+}
+
+TEST_CASE("Text exposition", "[Metrics]") {
+    auto& registry = Registry::GetInstance();
+    registry.GetCounter("test_exposition_total", "Test counter",
+                        {{"route", "/a\"b"}, {"status", "200"}}).Add(3);
+    auto& histogram = registry.GetHistogram("test_exposition_seconds", "Test histogram",
+                                            {{"route", "/a"}}, {0.1, 1.0});
+    histogram.Observe(0.05);
+    histogram.Observe(0.5);
+    histogram.Observe(2.0);
+
+    const auto text = registry.Render();
+    CHECK(Contains(text, "# HELP test_exposition_total Test counter"));
+    CHECK(Contains(text, "# TYPE test_exposition_total counter"));
+    CHECK(Contains(text, "test_exposition_total{route=\"/a\\\"b\",status=\"200\"} 3"));
+    CHECK(Contains(text, "# TYPE test_exposition_seconds histogram"));
+    CHECK(Contains(text, "test_exposition_seconds_bucket{route=\"/a\",le=\"0.1\"} 1"));
+    CHECK(Contains(text, "test_exposition_seconds_bucket{route=\"/a\",le=\"1\"} 2"));
+    CHECK(Contains(text, "test_exposition_seconds_bucket{route=\"/a\",le=\"+Inf\"} 3"));
+    CHECK(Contains(text, "test_exposition_seconds_sum{route=\"/a\"} 2.55"));
+    CHECK(Contains(text, "test_exposition_seconds_count{route=\"/a\"} 3"));
+}
+
+} // namespace common::tests::metrics
@@ -0,0 +1,152 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/strand.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <common/include/task_pool.hpp>
+#include <common/include/thread_pool.hpp>
+
+namespace common::tests::task_pool {
+
+using common::threading::TaskPool;
+
+TEST_CASE("Submit", "[TaskPool]") {
+    TaskPool pool(4);
+    pool.Run();
+
+    auto future = pool.Submit([] { return 42; });
+    CHECK(future.get() == 42);
+
+    auto failed_future = pool.Submit([]() -> int { throw std::runtime_error("failed"); });
+    CHECK_THROWS_AS(failed_future.get(), std::runtime_error);
+
+    auto worker_future = pool.Submit([&pool] { return pool.IsWorkerThread(); });
+    CHECK(worker_future.get());
+    CHECK_FALSE(pool.IsWorkerThread());
+}
+
+TEST_CASE("Submit after stop", "[TaskPool]") {
+    TaskPool pool(2);
+    pool.Run();
+    pool.Stop();
+    CHECK_FALSE(pool.Post([] {}));
+    CHECK_THROWS_AS(pool.Submit([] {}), std::runtime_error);
+}
+
+TEST_CASE("Queued tasks are executed on stop", "[TaskPool]") {
+    constexpr size_t kTasksCount = 100;
+
+    std::atomic<size_t> counter{0};
+    TaskPool pool(4);
+    for (size_t i = 0; i < kTasksCount; i++) {
+        CHECK(pool.Post([&counter] { counter++; }));
+    }
+    pool.Run();
+    pool.Stop();
+    CHECK(counter == kTasksCount);
+    CHECK(pool.GetStats().executed == kTasksCount);
+}
+
+TEST_CASE("Work stealing", "[TaskPool]") {
+    constexpr size_t kTasksCount = 64;
+
+    TaskPool pool(4);
+    pool.Run();
+    std::atomic<size_t> counter{0};
+    // the tasks are queued by a worker to its own deque, the others steal them
+    pool.Submit([&pool, &counter] {
+        for (size_t i = 0; i < kTasksCount; i++) {
+            pool.Post([&counter] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                counter++;
+            });
+        }
+    }).get();
+    pool.Stop();
+
+    CHECK(counter == kTasksCount);
+    const auto stats = pool.GetStats();
+    CHECK(stats.executed == kTasksCount + 1);
+    CHECK(stats.stolen > 0);
+}
+
+TEST_CASE("Parallel for", "[TaskPool]") {
+    constexpr size_t kSize = 10000;
+
+    TaskPool pool(4);
+    pool.Run();
+    std::vector<size_t> values(kSize, 0);
+
+    SECTION("Every index is visited once") {
+        pool.ParallelFor(0, kSize, [&values](size_t index) { values[index] += index; }, 100);
+        CHECK(std::accumulate(values.begin(), values.end(), size_t{0}) == kSize * (kSize - 1) / 2);
+    }
+
+    SECTION("Empty range") {
+        size_t calls_count = 0;
+        pool.ParallelFor(10, 10, [&calls_count](size_t) { calls_count++; });
+        CHECK(calls_count == 0);
+    }
+
+    SECTION("Nested in a worker") {
+        // the workers are all busy with the outer loop, so the inner
+        // loops are executed by the workers calling them
+        pool.ParallelFor(0, 8, [&pool, &values](size_t outer) {
+            pool.ParallelFor(outer * 100, (outer + 1) * 100,
+                             [&values](size_t index) { values[index] = 1; });
+        });
+        CHECK(std::accumulate(values.begin(), values.end(), size_t{0}) == 800);
+    }
+
+    SECTION("Exception") {
+        CHECK_THROWS_AS(pool.ParallelFor(0, kSize, [](size_t index) {
+            if (index == 500) {
+                throw std::runtime_error("failed");
+            }
+        }, 10), std::runtime_error);
+    }
+}
+
+TEST_CASE("Continuation on the strand", "[TaskPool]") {
+    common::threading::IoThreadPool io_pool(2);
+    auto context_ptr = io_pool.GetContextPtr();
+    auto strand = boost::asio::make_strand(*context_ptr);
+    auto work_guard = boost::asio::make_work_guard(*context_ptr);
+    io_pool.Run();
+
+    TaskPool pool(2);
+    pool.Run();
+    std::promise<bool> promise{};
+    auto future = promise.get_future();
+    pool.Submit([] { return 42; }, strand,
+        [&promise, &strand](std::future<int>&& result) {
+            promise.set_value(result.get() == 42 && strand.running_in_this_thread());
+        });
+    CHECK(future.get());
+
+    std::promise<bool> failed_promise{};
+    auto failed_future = failed_promise.get_future();
+    pool.Submit([] { throw std::runtime_error("failed"); }, strand,
+        [&failed_promise](std::future<void>&& result) {
+            try {
+                result.get();
+                failed_promise.set_value(false);
+            } catch (const std::runtime_error&) {
+                failed_promise.set_value(true);
+            }
+        });
+    CHECK(failed_future.get());
+
+    pool.Stop();
+    work_guard.reset();
+    io_pool.Stop();
+}
+
+} // namespace common::tests::task_pool
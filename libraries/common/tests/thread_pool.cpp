@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <boost/asio/post.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <common/include/config.hpp>
+#include <common/include/config/thread_pool_config.hpp>
+#include <common/include/thread_pool.hpp>
+
+namespace common::tests::thread_pool {
+
+TEST_CASE("Execute tasks", "[WorkerPool]") {
+    constexpr size_t kTasksCount = 100;
+
+    std::atomic<size_t> counter{0};
+    common::threading::WorkerPool pool(4, kTasksCount);
+    for (size_t i = 0; i < kTasksCount; i++) {
+        CHECK(pool.TryPost([&counter] { counter++; }));
+    }
+    pool.Run();
+    pool.Stop();
+    CHECK(counter == kTasksCount);
+}
+
+TEST_CASE("Bounded queue", "[WorkerPool]") {
+    common::threading::WorkerPool pool(1, 2);
+    CHECK(pool.TryPost([] {}));
+    CHECK(pool.TryPost([] {}));
+    CHECK(!pool.TryPost([] {}));
+    CHECK(pool.GetQueueSize() == 2);
+}
+
+TEST_CASE("Post after stop", "[WorkerPool]") {
+    common::threading::WorkerPool pool(1);
+    pool.Run();
+    pool.Stop();
+    CHECK(!pool.TryPost([] {}));
+}
+
+TEST_CASE("Worker thread", "[WorkerPool]") {
+    common::threading::WorkerPool pool(1);
+    pool.Run();
+    std::promise<std::thread::id> promise{};
+    auto future = promise.get_future();
+    CHECK(pool.TryPost([&promise] { promise.set_value(std::this_thread::get_id()); }));
+    CHECK(future.get() != std::this_thread::get_id());
+}
+
+namespace {
+
+struct ThreadInfo {
+    std::string name;
+    int cpu;
+};
+
+/// @brief Returns name and CPU of the thread running the context.
+ThreadInfo GetThreadInfo(boost::asio::io_context& context) {
+    std::promise<ThreadInfo> promise{};
+    auto future = promise.get_future();
+    boost::asio::post(context, [&promise] {
+        char name[16]{};
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        promise.set_value(ThreadInfo{name, sched_getcpu()});
+    });
+    return future.get();
+}
+
+} // namespace
+
+TEST_CASE("Available CPUs", "[IoThreadPool]") {
+    const auto cpus = common::threading::GetAvailableCpus();
+    REQUIRE_FALSE(cpus.empty());
+
+    common::threading::IoThreadPool pool(common::threading::ThreadPoolSettings{});
+    CHECK(pool.GetPoolSize() == cpus.size());
+}
+
+TEST_CASE("Named threads", "[IoThreadPool]") {
+    common::threading::ThreadPoolSettings settings{};
+    settings.threads_count = 1;
+    settings.name = "test-pool";
+    common::threading::IoThreadPool pool(settings);
+    auto work_guard = boost::asio::make_work_guard(*pool.GetContextPtr());
+    pool.Run();
+    CHECK(GetThreadInfo(*pool.GetContextPtr()).name == "test-pool-0");
+
+    // the names are cut to the Linux limit
+    settings.name = "very-long-pool-name";
+    common::threading::IoReactorPool reactor_pool(settings);
+    auto reactor_guard = boost::asio::make_work_guard(*reactor_pool.GetContextPtrs().front());
+    reactor_pool.Run();
+    CHECK(GetThreadInfo(*reactor_pool.GetContextPtrs().front()).name == "very-long-pool-");
+
+    reactor_guard.reset();
+    reactor_pool.Stop();
+    work_guard.reset();
+    pool.Stop();
+}
+
+TEST_CASE("Pinned threads", "[IoThreadPool]") {
+    const auto cpus = common::threading::GetAvailableCpus();
+    common::threading::ThreadPoolSettings settings{};
+    settings.threads_count = 2;
+    settings.pin_threads = true;
+    settings.cpus = {cpus.back()};
+
+    common::threading::IoReactorPool pool(settings);
+    std::vector<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> work_guards{};
+    for (const auto& context_ptr : pool.GetContextPtrs()) {
+        work_guards.push_back(boost::asio::make_work_guard(*context_ptr));
+    }
+    pool.Run();
+    for (const auto& context_ptr : pool.GetContextPtrs()) {
+        CHECK(GetThreadInfo(*context_ptr).cpu == static_cast<int>(cpus.back()));
+    }
+    pool.Stop();
+
+    settings.cpus = {CPU_SETSIZE};
+    CHECK_THROWS_AS(common::threading::IoReactorPool(settings), std::invalid_argument);
+}
+
+TEST_CASE("Running in this thread", "[IoThreadPool]") {
+    const auto cpus = common::threading::GetAvailableCpus();
+    common::threading::ThreadPoolSettings settings{};
+    settings.threads_count = 2;
+    settings.pin_threads = true;
+    settings.cpus = {cpus.back()};
+    common::threading::IoThreadPool pool(settings);
+    auto work_guard = boost::asio::make_work_guard(*pool.GetContextPtr());
+    std::thread caller([&pool] { pool.RunInThisThread(); });
+
+    // the caller is one of the pool threads, no extra one runs the context
+    std::atomic<size_t> running_count{0};
+    std::atomic<size_t> max_running_count{0};
+    std::atomic<bool> is_caller_used{false};
+    std::vector<std::future<int>> cpu_futures{};
+    for (size_t i = 0; i < 8; i++) {
+        auto promise_ptr = std::make_shared<std::promise<int>>();
+        cpu_futures.push_back(promise_ptr->get_future());
+        boost::asio::post(*pool.GetContextPtr(), [&, promise_ptr, caller_id = caller.get_id()] {
+            const auto count = ++running_count;
+            auto max_count = max_running_count.load();
+            while (count > max_count &&
+                   !max_running_count.compare_exchange_weak(max_count, count)) {}
+            if (std::this_thread::get_id() == caller_id) {
+                is_caller_used = true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            --running_count;
+            promise_ptr->set_value(sched_getcpu());
+        });
+    }
+    for (auto& future : cpu_futures) {
+        CHECK(future.get() == static_cast<int>(cpus.back()));
+    }
+    CHECK(max_running_count <= settings.threads_count);
+    CHECK(is_caller_used);
+
+    work_guard.reset();
+    pool.Stop();
+    caller.join();
+}
+
+TEST_CASE("Threadpool config", "[IoThreadPool]") {
+    const auto default_settings = common::config::Config::FromJson(
+        common::json::json::object()).Get<common::threading::ThreadPoolSettings>();
+    CHECK(default_settings.threads_count == 0);
+    CHECK(default_settings.name == "io");
+    CHECK_FALSE(default_settings.pin_threads);
+    CHECK(default_settings.cpus.empty());
+
+    const auto settings = common::config::Config::FromJson(common::json::json{
+        {"threads_count", 2},
+        {"name", "reactor"},
+        {"pin_threads", true},
+        {"cpus", {0, 1}},
+    }).Get<common::threading::ThreadPoolSettings>();
+    CHECK(settings.threads_count == 2);
+    CHECK(settings.name == "reactor");
+    CHECK(settings.pin_threads);
+    CHECK(settings.cpus == std::vector<size_t>{0, 1});
+
+    // a missing config file falls back to the defaults
+    CHECK(common::config::GetThreadPoolConfig("missing_config.json").threads_count == 0);
+}
+
+} // namespace common::tests::thread_pool
@@ -0,0 +1,122 @@
+#include <chrono>
+#include <future>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <common/include/thread_pool.hpp>
+#include <common/include/timing_wheel.hpp>
+
+namespace common::tests::timing_wheel {
+
+namespace {
+
+using TimingWheel = common::threading::TimingWheel;
+using Clock = TimingWheel::Clock;
+using namespace std::chrono_literals;
+
+} // namespace
+
+TEST_CASE("Expiration", "[TimingWheel]") {
+    auto context_ptr = std::make_shared<boost::asio::io_context>();
+    auto wheel_ptr = TimingWheel::Create(context_ptr, 10ms);
+
+    size_t expired_count = 0;
+    TimingWheel::Timer timer([&expired_count] { expired_count++; });
+    const auto armed_at = Clock::now();
+    wheel_ptr->Arm(timer, 1s);
+    CHECK(wheel_ptr->IsArmed(timer));
+    CHECK(wheel_ptr->GetSize() == 1);
+
+    // never earlier than requested
+    wheel_ptr->Advance(armed_at + 990ms);
+    CHECK(expired_count == 0);
+
+    wheel_ptr->Advance(Clock::now() + 1s + 10ms);
+    CHECK(expired_count == 1);
+    CHECK_FALSE(wheel_ptr->IsArmed(timer));
+    CHECK(wheel_ptr->GetSize() == 0);
+}
+
+TEST_CASE("Re-arm and cancel", "[TimingWheel]") {
+    auto context_ptr = std::make_shared<boost::asio::io_context>();
+    auto wheel_ptr = TimingWheel::Create(context_ptr, 10ms);
+
+    size_t expired_count = 0;
+    TimingWheel::Timer timer([&expired_count] { expired_count++; });
+    wheel_ptr->Arm(timer, 100ms);
+    // the deadline is moved
+    wheel_ptr->Arm(timer, 10s);
+    CHECK(wheel_ptr->GetSize() == 1);
+    wheel_ptr->Advance(Clock::now() + 1s);
+    CHECK(expired_count == 0);
+
+    wheel_ptr->Cancel(timer);
+    CHECK(wheel_ptr->GetSize() == 0);
+    wheel_ptr->Advance(Clock::now() + 1min);
+    CHECK(expired_count == 0);
+
+    {
+        TimingWheel::Timer destroyed_timer([&expired_count] { expired_count++; });
+        wheel_ptr->Arm(destroyed_timer, 100ms);
+    }
+    CHECK(wheel_ptr->GetSize() == 0);
+}
+
+TEST_CASE("Timers of all levels", "[TimingWheel]") {
+    constexpr auto kResolution = 1ms;
+    constexpr auto kStep = 997ms;
+    constexpr size_t kTimersCount = 1000;
+
+    auto context_ptr = std::make_shared<boost::asio::io_context>();
+    auto wheel_ptr = TimingWheel::Create(context_ptr, kResolution);
+
+    // up to the 4th level of 1ms ticks
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int64_t> distribution(0, 500 * 1000);
+    const auto armed_at = Clock::now();
+    std::vector<Clock::duration> timeouts(kTimersCount);
+    std::vector<Clock::time_point> expired_at(kTimersCount);
+    std::vector<std::unique_ptr<TimingWheel::Timer>> timers{};
+    Clock::time_point now = armed_at;
+    for (size_t i = 0; i < kTimersCount; i++) {
+        timeouts[i] = std::chrono::milliseconds(distribution(generator));
+        timers.push_back(std::make_unique<TimingWheel::Timer>(
+            [&expired_at, &now, i] { expired_at[i] = now; }));
+        wheel_ptr->Arm(*timers.back(), timeouts[i]);
+    }
+    const auto last_armed_at = Clock::now();
+
+    while (wheel_ptr->GetSize() != 0) {
+        now += kStep;
+        wheel_ptr->Advance(now);
+    }
+    for (size_t i = 0; i < kTimersCount; i++) {
+        CAPTURE(i);
+        CHECK(expired_at[i] >= armed_at + timeouts[i]);
+        CHECK(expired_at[i] < last_armed_at + timeouts[i] + kStep + kResolution);
+    }
+}
+
+TEST_CASE("Ticking on the context", "[TimingWheel]") {
+    common::threading::IoReactorPool pool(1);
+    auto wheel_ptr = TimingWheel::Create(pool.GetContextPtrs().front(), 10ms);
+
+    std::promise<Clock::time_point> expired_promise{};
+    TimingWheel::Timer timer([&expired_promise] { expired_promise.set_value(Clock::now()); });
+    const auto armed_at = Clock::now();
+    // the ticking keeps the context running
+    wheel_ptr->Arm(timer, 50ms);
+    pool.Run();
+
+    auto expired_future = expired_promise.get_future();
+    REQUIRE(expired_future.wait_for(5s) == std::future_status::ready);
+    CHECK(expired_future.get() >= armed_at + 50ms);
+    CHECK(wheel_ptr->GetSize() == 0);
+
+    pool.Stop();
+}
+
+} // namespace common::tests::timing_wheel
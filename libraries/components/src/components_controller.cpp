@@ -3,6 +3,7 @@
 #include <common/include/json.hpp>
 #include <common/include/logging.hpp>
 #include <http/include/consts.hpp>
+#include <http/include/default_handlers.hpp>
 #include <http/include/models.hpp>
 #include <http/include/utils.hpp>
 
@@ -51,6 +52,7 @@ ComponentsController::ComponentsController()
       server_ptr_(std::make_shared<http::server::HttpServer>(
         pool_.GetContextPtr(), kDefaultContolServerAddress, kDefaultControlServerPort)) {
     server_ptr_->AddListener("/test-control/reset", http::Method::post, &HandleReset);
+    server_ptr_->AddListener("/metrics", http::Method::get, &http::handlers::handle_metrics);
 }
 
 ComponentsController::~ComponentsController() {}
@@ -0,0 +1,160 @@
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <new>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include <common/include/logging.hpp>
+#include <common/include/thread_pool.hpp>
+#include <http/include/consts.hpp>
+#include <http/include/default_handlers.hpp>
+#include <http/include/http_server.hpp>
+#include <http/include/models.hpp>
+
+namespace http::benchmarks::allocations {
+
+namespace {
+
+// only the allocations of the marked threads are counted
+std::atomic<size_t> allocations_count{0};
+thread_local bool is_counted_thread = false;
+
+} // namespace
+
+} // namespace http::benchmarks::allocations
+
+void* operator new(std::size_t size) {
+    if (http::benchmarks::allocations::is_counted_thread) {
+        http::benchmarks::allocations::allocations_count.fetch_add(
+            1, std::memory_order_relaxed);
+    }
+    if (auto ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace http::benchmarks::allocations {
+
+namespace {
+
+http::Response HandleEcho(http::Request&& request) {
+    http::Response response{http::Status::ok, request.version()};
+    response.body() = std::move(request.body());
+    return response;
+}
+
+common::logging::LogSettings MakeLogSettings() {
+    common::logging::LogSettings settings{};
+    // as in production, the per-request debug logs are disabled
+    settings.log_level = common::logging::LogLevel::Info;
+    settings.log_to_stdout = false;
+    // the file sink is always on, keep its output out of the working directory
+    settings.path = (std::filesystem::temp_directory_path() / "").string();
+    return settings;
+}
+
+/// @brief Runs a single reactor server counting its thread allocations.
+class CountedServer {
+public:
+    CountedServer() : log_controller_(MakeLogSettings()), pool_(1) {
+        server_ptr_ = std::make_shared<http::server::HttpServer>(
+            pool_.GetContextPtrs().front(), http::consts::kLocalhost, 0);
+        server_ptr_->AddListener("/ping", http::Method::get,
+                                 &http::handlers::handle_ping);
+        server_ptr_->AddListener("/echo", http::Method::post, &HandleEcho);
+        server_ptr_->Listen();
+        boost::asio::post(*pool_.GetContextPtrs().front(), [] {
+            is_counted_thread = true;
+        });
+        pool_.Run();
+    }
+
+    ~CountedServer() {
+        server_ptr_->Stop();
+        pool_.Stop();
+    }
+
+    unsigned short GetPort() const {
+        return server_ptr_->GetPort();
+    }
+
+private:
+    common::logging::LoggerController log_controller_;
+    common::threading::IoReactorPool pool_;
+    std::shared_ptr<http::server::HttpServer> server_ptr_;
+};
+
+/// @brief Reports the server allocations per keep-alive request.
+void RunRequests(benchmark::State& state, http::Request request) {
+    static CountedServer server{};
+
+    boost::asio::io_context context{};
+    boost::beast::tcp_stream stream(context);
+    stream.connect(boost::asio::ip::tcp::endpoint(
+        boost::asio::ip::make_address(http::consts::kLocalhost), server.GetPort()));
+
+    request.keep_alive(true);
+    request.set(boost::beast::http::field::user_agent, "bench_http");
+    request.set(boost::beast::http::field::accept, "*/*");
+    request.prepare_payload();
+
+    boost::beast::flat_buffer buffer{};
+    const auto warm_up = [&] {
+        boost::beast::http::write(stream, request);
+        http::Response response{};
+        boost::beast::http::read(stream, buffer, response);
+    };
+    // the first requests of a connection fill the pools and buffers
+    for (size_t i = 0; i < 16; i++) {
+        warm_up();
+    }
+
+    const auto allocations_before = allocations_count.load();
+    for (auto _ : state) {
+        boost::beast::http::write(stream, request);
+        http::Response response{};
+        boost::beast::http::read(stream, buffer, response);
+        benchmark::DoNotOptimize(response);
+    }
+    state.counters["allocs_per_request"] = benchmark::Counter(
+        static_cast<double>(allocations_count.load() - allocations_before),
+        benchmark::Counter::kAvgIterations);
+
+    boost::beast::error_code error_code{};
+    stream.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, error_code);
+}
+
+void BM_ServerAllocations(benchmark::State& state, http::Request request) {
+    RunRequests(state, std::move(request));
+}
+
+http::Request MakeEchoRequest() {
+    http::Request request{http::Method::post, "/echo", http::consts::kVersion};
+    request.body() = std::string(512, 'x');
+    return request;
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_ServerAllocations, ping,
+                  http::Request{http::Method::get, "/ping", http::consts::kVersion})
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ServerAllocations, echo, MakeEchoRequest())->UseRealTime();
+
+} // namespace http::benchmarks::allocations
@@ -0,0 +1,132 @@
+#include <array>
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+#include <boost/beast/http.hpp>
+
+#include <http/include/models.hpp>
+#include <http/include/request_parser.hpp>
+
+namespace http::benchmarks::parser {
+
+namespace {
+
+using http::parser::Isa;
+
+struct Capture {
+    std::string_view name;
+    std::string_view data;
+};
+
+// requests captured from the clients of the services
+constexpr std::array<Capture, 4> kCaptures{{
+    {"curl_ping",
+     "GET /ping HTTP/1.1\r\n"
+     "Host: localhost:5555\r\n"
+     "User-Agent: curl/7.88.1\r\n"
+     "Accept: */*\r\n"
+     "\r\n"},
+    {"requests_get",
+     "GET /api/v1/documents/get?id=1024 HTTP/1.1\r\n"
+     "Host: localhost:5555\r\n"
+     "User-Agent: python-requests/2.28.1\r\n"
+     "Accept-Encoding: gzip, deflate\r\n"
+     "Accept: */*\r\n"
+     "Connection: keep-alive\r\n"
+     "If-None-Match: \"1024-1697616000123456\"\r\n"
+     "\r\n"},
+    {"browser_get",
+     "GET /api/v1/api-config/list?user=admin HTTP/1.1\r\n"
+     "Host: zoo.local\r\n"
+     "Connection: keep-alive\r\n"
+     "sec-ch-ua: \"Chromium\";v=\"118\", \"Google Chrome\";v=\"118\", \"Not=A?Brand\";v=\"99\"\r\n"
+     "sec-ch-ua-mobile: ?0\r\n"
+     "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+     "Chrome/118.0.0.0 Safari/537.36\r\n"
+     "sec-ch-ua-platform: \"Linux\"\r\n"
+     "Accept: application/json, text/plain, */*\r\n"
+     "Sec-Fetch-Site: same-origin\r\n"
+     "Sec-Fetch-Mode: cors\r\n"
+     "Sec-Fetch-Dest: empty\r\n"
+     "Referer: http://zoo.local/configs\r\n"
+     "Accept-Encoding: gzip, deflate, br\r\n"
+     "Accept-Language: en-US,en;q=0.9\r\n"
+     "Cookie: session=7f3c2a9e4b1d4e8fa0c6d2b1e5f7a9c3; theme=dark\r\n"
+     "\r\n"},
+    {"requests_create",
+     "POST /api/v1/documents/create HTTP/1.1\r\n"
+     "Host: localhost:5555\r\n"
+     "User-Agent: python-requests/2.28.1\r\n"
+     "Accept-Encoding: gzip, deflate\r\n"
+     "Accept: */*\r\n"
+     "Connection: keep-alive\r\n"
+     "Content-Length: 66\r\n"
+     "Content-Type: application/json\r\n"
+     "\r\n"
+     "{\"name\": \"doc\", \"owner\": \"me\", \"namespace\": \"\", \"payload\": \"abc\"}"},
+}};
+
+const Capture& GetCapture(benchmark::State& state) {
+    const auto& capture = kCaptures[static_cast<size_t>(state.range(0))];
+    state.SetLabel(std::string(capture.name));
+    return capture;
+}
+
+/// @brief Beast parser as the session uses it, the fields in the heap.
+void BM_BeastParser(benchmark::State& state) {
+    const auto& capture = GetCapture(state);
+    for (auto _ : state) {
+        boost::beast::http::request_parser<http::StringBody> parser{};
+        parser.eager(true);
+        boost::beast::error_code error_code{};
+        parser.put(boost::asio::buffer(capture.data.data(), capture.data.size()), error_code);
+        benchmark::DoNotOptimize(parser.get());
+    }
+    state.SetBytesProcessed(state.iterations() * capture.data.size());
+}
+
+/// @brief Request head parsing only, nothing is allocated.
+template<Isa kIsa>
+void BM_ParseRequestHead(benchmark::State& state) {
+    if (http::parser::GetSupportedIsa() < kIsa) {
+        state.SkipWithError("instruction set is not supported");
+        return;
+    }
+    const auto& capture = GetCapture(state);
+    http::parser::RequestHead head{};
+    for (auto _ : state) {
+        auto result = http::parser::ParseRequestHead(capture.data, head, kIsa);
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(head);
+    }
+    state.SetBytesProcessed(state.iterations() * capture.data.size());
+}
+
+/// @brief Parsing and adapting to the request the handlers take.
+void BM_ParseToRequest(benchmark::State& state) {
+    const auto& capture = GetCapture(state);
+    http::parser::RequestHead head{};
+    for (auto _ : state) {
+        const auto result = http::parser::ParseRequestHead(capture.data, head);
+        auto request = http::parser::ToRequest(head, capture.data.substr(result.size));
+        benchmark::DoNotOptimize(request);
+    }
+    state.SetBytesProcessed(state.iterations() * capture.data.size());
+}
+
+void CaptureArguments(benchmark::internal::Benchmark* benchmark) {
+    for (size_t i = 0; i < kCaptures.size(); i++) {
+        benchmark->Arg(static_cast<int64_t>(i));
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_BeastParser)->Apply(CaptureArguments);
+BENCHMARK_TEMPLATE(BM_ParseRequestHead, Isa::Scalar)->Apply(CaptureArguments);
+BENCHMARK_TEMPLATE(BM_ParseRequestHead, Isa::Sse42)->Apply(CaptureArguments);
+BENCHMARK_TEMPLATE(BM_ParseRequestHead, Isa::Avx2)->Apply(CaptureArguments);
+BENCHMARK(BM_ParseToRequest)->Apply(CaptureArguments);
+
+} // namespace http::benchmarks::parser
@@ -0,0 +1,123 @@
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <common/include/format.hpp>
+#include <http/include/http_server.hpp>
+#include <http/include/models.hpp>
+
+namespace http::benchmarks::router {
+
+namespace {
+
+// Routes which the CRUD generator registers for a single collection.
+const std::vector<std::pair<std::string, http::Method>> kCollectionRoutes = {
+    {"/api/v1/{}/create", http::Method::post},
+    {"/api/v1/{}/update", http::Method::post},
+    {"/api/v1/{}/delete", http::Method::post},
+    {"/api/v1/{}/list", http::Method::get},
+    {"/api/v1/{}/{id}", http::Method::get},
+};
+
+http::Response Handle(http::Request&&) {
+    return http::Response{};
+}
+
+std::string GetCollection(size_t index) {
+    return common::format::Format("collection_{}", index);
+}
+
+/// @brief Collections count to get the requested number of routes.
+size_t GetCollectionsCount(const benchmark::State& state) {
+    return static_cast<size_t>(state.range(0)) / kCollectionRoutes.size();
+}
+
+http::server::HttpHandlers MakeHandlers(size_t collections_count) {
+    http::server::HttpHandlers handlers{};
+    for (size_t i = 0; i < collections_count; i++) {
+        for (const auto& [pattern, method] : kCollectionRoutes) {
+            handlers.AddHandler(common::format::Format(pattern, GetCollection(i)),
+                                method, &Handle);
+        }
+    }
+    return handlers;
+}
+
+/// @brief Previous handlers container: full path to the method map.
+/// Kept as a baseline for the radix tree lookup.
+using LegacyHandlers = std::unordered_map<
+    std::string, std::unordered_map<http::Method, http::HttpHandler>>;
+
+LegacyHandlers MakeLegacyHandlers(size_t collections_count) {
+    LegacyHandlers handlers{};
+    for (size_t i = 0; i < collections_count; i++) {
+        for (const auto& [pattern, method] : kCollectionRoutes) {
+            handlers[common::format::Format(pattern, GetCollection(i))][method] = &Handle;
+        }
+    }
+    return handlers;
+}
+
+std::vector<http::Request> MakeRequests(size_t collections_count, bool with_params) {
+    std::vector<http::Request> requests{};
+    for (size_t i = 0; i < collections_count; i++) {
+        const auto target = with_params ?
+            common::format::Format("/api/v1/{}/{}?fields=all", GetCollection(i), i) :
+            common::format::Format("/api/v1/{}/list?fields=all", GetCollection(i));
+        requests.emplace_back(http::Method::get, target, 11);
+    }
+    return requests;
+}
+
+std::string_view GetPath(const http::Request& request) {
+    const auto target = request.target();
+    const auto path = std::string_view(target.data(), target.size());
+    return path.substr(0, path.find('?'));
+}
+
+void BM_RadixTreeMatch(benchmark::State& state, bool with_params) {
+    const auto collections_count = GetCollectionsCount(state);
+    const auto handlers = MakeHandlers(collections_count);
+    auto requests = MakeRequests(collections_count, with_params);
+
+    size_t index = 0;
+    for (auto _ : state) {
+        auto& request = requests[index++ % requests.size()];
+        auto route_ptr = handlers.Match(GetPath(request), request.method(),
+                                        &request.GetPathParams());
+        benchmark::DoNotOptimize(route_ptr);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_LegacyMapMatch(benchmark::State& state) {
+    const auto collections_count = GetCollectionsCount(state);
+    const auto handlers = MakeLegacyHandlers(collections_count);
+    const auto requests = MakeRequests(collections_count, false);
+
+    size_t index = 0;
+    for (auto _ : state) {
+        const auto& request = requests[index++ % requests.size()];
+        // copy the target and the handler as the previous implementation did
+        auto path = std::string(request.target());
+        path.erase(path.find('?'));
+        std::optional<http::HttpHandler> handler{};
+        if (auto uri_it = handlers.find(path); uri_it != handlers.end()) {
+            if (auto it = uri_it->second.find(request.method()); it != uri_it->second.end()) {
+                handler = it->second;
+            }
+        }
+        benchmark::DoNotOptimize(handler);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_RadixTreeMatch, static, false)->RangeMultiplier(2)->Range(1000, 8000);
+BENCHMARK_CAPTURE(BM_RadixTreeMatch, params, true)->RangeMultiplier(2)->Range(1000, 8000);
+BENCHMARK(BM_LegacyMapMatch)->RangeMultiplier(2)->Range(1000, 8000);
+
+} // namespace http::benchmarks::router
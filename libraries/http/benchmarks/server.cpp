@@ -0,0 +1,113 @@
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include <common/include/thread_pool.hpp>
+#include <http/include/consts.hpp>
+#include <http/include/default_handlers.hpp>
+#include <http/include/http_server.hpp>
+#include <http/include/models.hpp>
+
+namespace http::benchmarks::server {
+
+namespace {
+
+constexpr size_t kServerThreadsCount = 4;
+
+/// @class Keeps a running server of the specified kind
+/// for the whole benchmark process lifetime.
+template<typename PoolT, http::server::Transport kTransport>
+class ServerHolder {
+public:
+    ServerHolder() : pool_(kServerThreadsCount) {
+        http::server::ServerSettings settings{};
+        settings.transport = kTransport;
+        server_ptr_ = std::make_shared<http::server::HttpServer>(
+            GetContexts(), http::consts::kLocalhost, 0, settings);
+        server_ptr_->AddListener("/ping", http::Method::get,
+                                 &http::handlers::handle_ping);
+        server_ptr_->Listen();
+        pool_.Run();
+    }
+
+    ~ServerHolder() {
+        server_ptr_->Stop();
+        pool_.Stop();
+    }
+
+    unsigned short GetPort() const {
+        return server_ptr_->GetPort();
+    }
+
+    http::server::Transport GetTransport() const {
+        return server_ptr_->GetTransport();
+    }
+
+private:
+    auto GetContexts() {
+        if constexpr (std::is_same_v<PoolT, common::threading::IoThreadPool>) {
+            return pool_.GetContextPtr();
+        } else {
+            return pool_.GetContextPtrs();
+        }
+    }
+
+    PoolT pool_;
+    std::shared_ptr<http::server::HttpServer> server_ptr_;
+};
+
+/// @brief Each benchmark thread drives its own keep-alive connection.
+template<typename PoolT, http::server::Transport kTransport = http::server::Transport::Asio>
+void RunKeepAliveClient(benchmark::State& state) {
+    static ServerHolder<PoolT, kTransport> server{};
+    if (server.GetTransport() != kTransport) {
+        state.SkipWithError("transport is not supported");
+        return;
+    }
+
+    boost::asio::io_context context{};
+    boost::asio::ip::tcp::resolver resolver(context);
+    boost::beast::tcp_stream stream(context);
+    stream.connect(resolver.resolve(http::consts::kLocalhost,
+                                    std::to_string(server.GetPort())));
+
+    boost::beast::flat_buffer buffer{};
+    http::Request request{http::Method::get, "/ping", http::consts::kVersion};
+    request.keep_alive(true);
+    for (auto _ : state) {
+        boost::beast::http::write(stream, request);
+        http::Response response{};
+        boost::beast::http::read(stream, buffer, response);
+        benchmark::DoNotOptimize(response);
+    }
+    state.counters["rps"] = benchmark::Counter(
+        static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+
+    boost::beast::error_code error_code{};
+    stream.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, error_code);
+}
+
+void BM_SharedContext(benchmark::State& state) {
+    RunKeepAliveClient<common::threading::IoThreadPool>(state);
+}
+
+void BM_MultiReactor(benchmark::State& state) {
+    RunKeepAliveClient<common::threading::IoReactorPool>(state);
+}
+
+void BM_MultiReactorIoUring(benchmark::State& state) {
+    RunKeepAliveClient<common::threading::IoReactorPool, http::server::Transport::IoUring>(state);
+}
+
+} // namespace
+
+BENCHMARK(BM_SharedContext)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_MultiReactor)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_MultiReactorIoUring)->ThreadRange(1, 16)->UseRealTime();
+
+} // namespace http::benchmarks::server
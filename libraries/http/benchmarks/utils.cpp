@@ -0,0 +1,73 @@
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <common/include/format.hpp>
+#include <http/include/consts.hpp>
+#include <http/include/models.hpp>
+#include <http/include/request_view.hpp>
+#include <http/include/utils.hpp>
+
+namespace http::benchmarks::utils {
+
+namespace {
+
+http::Request MakeRequest(size_t params_count, size_t value_size) {
+    std::string target = "/api/v1/documents/get";
+    for (size_t i = 0; i < params_count; i++) {
+        target += common::format::Format("{}param_{}={}", i == 0 ? "?" : "&", i,
+                                         std::string(value_size, 'v'));
+    }
+    return http::Request{http::Method::get, target, http::consts::kVersion};
+}
+
+void BM_GetParams(benchmark::State& state) {
+    const auto request = MakeRequest(static_cast<size_t>(state.range(0)),
+                                     static_cast<size_t>(state.range(1)));
+    for (auto _ : state) {
+        auto params = http::utils::GetParams(request);
+        benchmark::DoNotOptimize(params);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * request.target().size());
+}
+
+/// @brief Lookup of the last parameter, the worst case of the view.
+void BM_RequestViewGetParam(benchmark::State& state) {
+    const auto params_count = static_cast<size_t>(state.range(0));
+    const auto request = MakeRequest(params_count, static_cast<size_t>(state.range(1)));
+    const auto name = common::format::Format("param_{}", params_count - 1);
+    std::string buffer{};
+    for (auto _ : state) {
+        auto value_opt = http::RequestView(request).GetParam(name, buffer);
+        benchmark::DoNotOptimize(value_opt);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_RequestViewGetParamAs(benchmark::State& state) {
+    const http::Request request{http::Method::get, "/api/v1/documents/get?id=1234567",
+                                http::consts::kVersion};
+    for (auto _ : state) {
+        auto id_opt = http::RequestView(request).GetParamAs<uint64_t>("id");
+        benchmark::DoNotOptimize(id_opt);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_MethodToString(benchmark::State& state) {
+    for (auto _ : state) {
+        auto result = http::utils::ToString(http::Method::post);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_GetParams)->ArgsProduct({{0, 1, 4, 16}, {8, 128}});
+BENCHMARK(BM_RequestViewGetParam)->ArgsProduct({{1, 4, 16}, {8, 128}});
+BENCHMARK(BM_RequestViewGetParamAs);
+BENCHMARK(BM_MethodToString);
+
+} // namespace http::benchmarks::utils
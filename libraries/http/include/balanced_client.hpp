@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/core/noncopyable.hpp>
+
+#include <http/include/http_client.hpp>
+#include <http/include/models.hpp>
+
+namespace http::client {
+
+/// @struct Address of a replica.
+struct Endpoint {
+    std::string host;
+    int port;
+};
+
+enum class Balancing {
+    // the endpoint with the fewest requests in flight, ties are broken round-robin
+    LeastOutstanding,
+    // the better of two random endpoints by the latency EWMA weighted by the requests in flight
+    PowerOfTwoChoices,
+};
+
+/// @struct BalancedClient settings.
+struct BalancerSettings {
+    Balancing balancing = Balancing::PowerOfTwoChoices;
+    // settings of the clients of the endpoints
+    ClientSettings client{};
+
+    // an idempotent request with no response for the hedge_percentile of
+    // the recent latencies is sent to another endpoint too, the first
+    // response wins; the percentile is updated every hedge_window_size
+    // responses, so there is no hedging until the first window is over
+    bool hedging = false;
+    double hedge_percentile = 95.0;
+    size_t hedge_window_size = 1000;
+    std::chrono::milliseconds min_hedge_delay{1};
+
+    // smoothing factor of the latency EWMA, the weight of the last response
+    double ewma_smoothing = 0.2;
+
+    // an endpoint is ejected for ejection_time after ejection_failures
+    // consecutive failures (errors or 5xx responses), or once its latency
+    // EWMA exceeds the median one of the rest by ejection_latency_factor,
+    // which is checked after ejection_min_samples responses
+    size_t ejection_failures = 5;
+    double ejection_latency_factor = 3.0;
+    size_t ejection_min_samples = 20;
+    std::chrono::milliseconds ejection_time{std::chrono::seconds(10)};
+    // at most this share of the endpoints is ejected at once
+    double max_ejected_share = 0.5;
+};
+
+/// @struct Snapshot of an endpoint state.
+struct EndpointStats {
+    Endpoint endpoint{};
+    size_t outstanding{};
+    size_t requests{};
+    size_t failures{};
+    size_t ejections{};
+    double latency_ewma_ms{};
+    bool is_ejected{};
+};
+
+/// @struct Snapshot of the balancer state.
+struct BalancerStats {
+    size_t hedges{};
+    // hedged requests answered by the second endpoint first
+    size_t hedge_wins{};
+    std::chrono::microseconds hedge_delay{};
+    std::vector<EndpointStats> endpoints{};
+};
+
+/**
+ * @class HTTP client of a number of replicas of a service. Every request is
+ * sent to the endpoint chosen by the balancing policy out of the ones not
+ * ejected as outliers. The latencies of the endpoints are tracked per
+ * endpoint with an EWMA, so a degraded replica gets less traffic and is
+ * ejected once it falls far behind the rest. The slow idempotent requests
+ * may be hedged by another endpoint. The client is thread-safe.
+ */
+class BalancedClient : private boost::noncopyable {
+public:
+    /// @brief Creates a client executing the requests on a private context.
+    /// @throws std::invalid_argument if there are no endpoints
+    BalancedClient(const std::vector<Endpoint>& endpoints,
+                   const BalancerSettings& settings = BalancerSettings{});
+    /// @brief Creates a client executing the requests on the context,
+    /// which must be run by the caller and outlive the client.
+    /// @throws std::invalid_argument if there are no endpoints
+    BalancedClient(std::shared_ptr<boost::asio::io_context> context_ptr,
+                   const std::vector<Endpoint>& endpoints,
+                   const BalancerSettings& settings = BalancerSettings{});
+    ~BalancedClient();
+
+    /// @brief Sends the request and waits for the response.
+    /// @throws the exceptions of HttpClient::Request
+    Response Request(const Request& request);
+
+    /// @brief Starts the request and returns immediately. The callback is
+    /// invoked from a thread of the client context and must not block.
+    void AsyncRequest(http::Request request, RequestCallback&& callback);
+
+    /// @brief Starts the request and returns the future of the response.
+    std::future<Response> AsyncRequest(http::Request request);
+
+    BalancerStats GetStats() const;
+
+private:
+    struct State;
+    using WorkGuard = boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
+
+    std::shared_ptr<boost::asio::io_context> context_ptr_;
+    std::shared_ptr<State> state_ptr_;
+    // the private context is run until the client is destroyed
+    std::unique_ptr<WorkGuard> work_guard_ptr_;
+    std::thread context_thread_;
+};
+
+} // namespace http::client
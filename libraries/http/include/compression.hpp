@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <boost/core/noncopyable.hpp>
+
+#include <common/include/json.hpp>
+
+#include "models.hpp"
+
+// zlib stream state, zlib.h is not exposed to the library users
+struct z_stream_s;
+
+namespace http::compression {
+
+/// @brief Response content encodings supported by the server.
+enum class Encoding {
+    Identity,
+    Gzip,
+    Deflate,
+};
+
+/// @brief Picks the most preferred of the supported encodings by the
+/// Accept-Encoding header value. Gzip wins a tie.
+Encoding ChooseEncoding(std::string_view accept_encoding);
+
+/// @brief Returns the Content-Encoding token of the encoding.
+std::string_view ToString(Encoding encoding);
+
+/// @struct Response compression settings.
+struct CompressionSettings {
+    bool enabled = false;
+    // smaller bodies are sent as is, chunked bodies are always compressed
+    size_t min_size = 1024;
+    // zlib level from 1 (fastest) to 9 (best compression)
+    int level = 6;
+};
+
+/// @struct Snapshot of the compression statistics.
+struct CompressionStats {
+    size_t responses{};
+    size_t input_bytes{};
+    size_t output_bytes{};
+    // CPU time of the threads spent on compression
+    uint64_t cpu_time_us{};
+};
+
+void to_json(common::json::json& json, const CompressionStats& stats);
+
+/// @class Thread-safe collector of the compression statistics.
+class CompressionMetrics : private boost::noncopyable {
+public:
+    CompressionMetrics();
+
+    void AddResponse();
+    void Add(size_t input_bytes, size_t output_bytes,
+             std::chrono::nanoseconds cpu_time);
+
+    CompressionStats GetStats() const;
+
+private:
+    std::atomic<size_t> responses_;
+    std::atomic<size_t> input_bytes_;
+    std::atomic<size_t> output_bytes_;
+    std::atomic<uint64_t> cpu_time_ns_;
+};
+
+/**
+ * @class Streaming zlib compressor producing gzip or deflate (zlib format,
+ * as HTTP defines it) stream. The input may come in any number of parts,
+ * the memory used does not depend on the total size.
+ */
+class Compressor : private boost::noncopyable {
+public:
+    /// @throws std::runtime_error if zlib cannot be initialized
+    Compressor(Encoding encoding, int level);
+    ~Compressor();
+
+    /// @brief Compresses the next part of the input, appends the produced
+    /// output. The output may be empty, zlib buffers the input.
+    void Compress(std::string_view input, std::string& output);
+
+    /// @brief Appends the rest of the output and ends the stream.
+    void Finish(std::string& output);
+
+private:
+    void Deflate(std::string_view input, int flush, std::string& output);
+
+    std::unique_ptr<z_stream_s> stream_ptr_;
+};
+
+/// @brief Compresses the response body, or wraps the chunk generator of
+/// a chunked response. Responses with an encoding set already, file range
+/// responses and the ones with the body below the threshold are left as is.
+void CompressResponse(Response& response, Encoding encoding,
+                      const CompressionSettings& settings,
+                      const std::shared_ptr<CompressionMetrics>& metrics_ptr);
+
+} // namespace http::compression
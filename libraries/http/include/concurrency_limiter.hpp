@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/core/noncopyable.hpp>
+
+#include <common/include/json.hpp>
+
+
+namespace http::server {
+
+/// @struct Admission control settings. Zero limits mean no limit.
+struct LimiterSettings {
+    size_t max_connections = 0;
+    // fixed limit of the requests handled concurrently, or the initial one in adaptive mode
+    size_t max_in_flight = 0;
+    // requests over the limit wait for a free slot in a short queue,
+    // the ones waiting for max_queue_wait are rejected
+    size_t max_queue_size = 0;
+    std::chrono::milliseconds max_queue_wait{50};
+
+    // adaptive mode adjusts the in-flight limit by the latency gradient:
+    // the limit shrinks once the latency grows over the long-term one
+    bool adaptive = false;
+    size_t min_in_flight = 4;
+    size_t max_in_flight_adaptive = 1024;
+    size_t adaptive_window_size = 100;  // latency samples per limit update
+    double adaptive_smoothing = 0.2;
+    double adaptive_tolerance = 1.5;    // latency growth tolerated as is
+};
+
+/// @struct Snapshot of the limiter state.
+struct LimiterState {
+    size_t connections{};
+    size_t max_connections{};
+    size_t in_flight{};
+    size_t in_flight_limit{};
+    size_t queue_size{};
+    size_t rejected_connections{};
+    size_t rejected_requests{};
+    // long-term latency estimate of the adaptive mode
+    double latency_ms{};
+};
+
+void to_json(common::json::json& json, const LimiterState& state);
+
+/**
+ * @class Thread-safe admission controller of the HttpServer.
+ * Limits the number of open connections and the number of requests
+ * handled concurrently, the excess is rejected immediately.
+ */
+class ConcurrencyLimiter : public std::enable_shared_from_this<ConcurrencyLimiter>,
+                           private boost::noncopyable {
+public:
+    /// @brief Continuation of a request, admitted or rejected.
+    using Task = std::function<void(bool is_admitted)>;
+    using Clock = std::chrono::steady_clock;
+    using Executor = boost::asio::any_io_executor;
+
+    explicit ConcurrencyLimiter(const LimiterSettings& settings);
+
+    /// @returns false if there are too many connections already.
+    bool TryAcquireConnection();
+    void ReleaseConnection();
+
+    /// @brief Runs the task once a request slot is free. The task is invoked
+    /// in place if a slot is free or the request is rejected right away.
+    /// A queued task is posted to the executor, the one of the request
+    /// connection, so it never runs on the thread releasing a slot.
+    /// A task queued for max_queue_wait is rejected on the executor by a timer,
+    /// which requires the limiter to be owned by a shared_ptr.
+    void Acquire(Task&& task, const Executor& executor);
+
+    /// @brief Frees a slot of an admitted request.
+    /// @param latency time the request has been handled for
+    void Release(Clock::duration latency);
+
+    /// @returns false if requests are not limited at all.
+    bool IsRequestsLimited() const;
+
+    LimiterState GetState() const;
+
+private:
+    using TimerPtr = std::shared_ptr<boost::asio::steady_timer>;
+
+    struct QueuedTask {
+        Task task;
+        Executor executor;
+        Clock::time_point enqueued_at;
+        TimerPtr timer_ptr;
+    };
+
+    void OnQueueWaitExpired(const TimerPtr& timer_ptr);
+    void UpdateLimit(Clock::duration latency);
+
+    const LimiterSettings settings_;
+
+    std::atomic<size_t> connections_;
+    std::atomic<size_t> rejected_connections_;
+
+    mutable std::mutex mutex_;
+    std::deque<QueuedTask> queue_;
+    size_t in_flight_;
+    double in_flight_limit_;
+    size_t rejected_requests_;
+
+    // adaptive mode state
+    double window_latency_sum_;
+    size_t window_samples_count_;
+    double long_latency_;
+};
+
+} // namespace http::server
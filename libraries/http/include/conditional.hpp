@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "models.hpp"
+
+namespace http::conditional {
+
+using TimePoint = std::chrono::system_clock::time_point;
+
+/// @struct Validators of the current representation of a resource.
+struct Validators {
+    // entity tag with the quotes, prefixed with W/ if weak
+    std::optional<std::string> etag{};
+    std::optional<TimePoint> last_modified{};
+};
+
+/// @brief Makes the validators of the requested resource. Invoked before
+/// the handler, so it should be much cheaper than that, e.g. must not read
+/// the payloads. A thrown HttpError is responded as the handler one.
+using ValidatorsProvider = std::function<Validators(const Request&)>;
+
+/// @brief Quotes the opaque tag, the tag must not contain quotes.
+std::string MakeETag(std::string_view tag, bool is_weak = false);
+
+/// @brief Formats the time as an IMF-fixdate, e.g. "Sun, 06 Nov 1994 08:49:37 GMT".
+std::string ToHttpDate(TimePoint time);
+
+/// @brief Parses an IMF-fixdate, the obsolete date formats are not supported.
+/// @returns std::nullopt if the value is not a valid date
+std::optional<TimePoint> ParseHttpDate(std::string_view value);
+
+/**
+ * @brief Evaluates If-None-Match and If-Modified-Since of a GET or HEAD
+ * request by RFC 7232. If-None-Match is compared weakly and takes
+ * precedence, If-Modified-Since has a second precision and is ignored
+ * if invalid. The preconditions of other methods are not evaluated.
+ * @returns true if the client representation is the current one
+ */
+bool IsNotModified(const RequestHeader& request, const Validators& validators);
+
+/// @brief Sets ETag and Last-Modified headers of the validators.
+void SetValidators(Response& response, const Validators& validators);
+
+/// @brief Makes 304 Not Modified response without a body.
+Response NotModifiedResponse(unsigned version, const Validators& validators);
+
+/// @brief Wraps the handler, so it is not invoked at all if the client
+/// has the current representation. The validators are added to the
+/// successful responses of the handler.
+HttpHandler MakeConditionalHandler(const ValidatorsProvider& provider,
+                                   const HttpHandler& handler);
+
+} // namespace http::conditional
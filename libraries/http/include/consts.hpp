@@ -4,5 +4,7 @@ namespace http::consts {
 
 static const unsigned kVersion = 11;
 static constexpr const char* kLocalhost = "127.0.0.1";
+// milliseconds left until the deadline of the caller
+static constexpr const char* kTimeoutHeader = "X-Request-Timeout-Ms";
 
 } // namespace http::consts
\ No newline at end of file
@@ -1,9 +1,21 @@
 #pragma once
 
+#include <memory>
+
+#include <http/include/http_server.hpp>
 #include <http/include/models.hpp>
 
 namespace http::handlers {
 
 Response handle_ping(Request&& request);
 
-} // namespace http::handlers
\ No newline at end of file
+/// @brief Makes a handler responding with the server admission control state.
+HttpHandler MakeLimiterStateHandler(std::weak_ptr<const server::HttpServer> server_ptr);
+
+/// @brief Makes a handler responding with the server response compression statistics.
+HttpHandler MakeCompressionStatsHandler(std::weak_ptr<const server::HttpServer> server_ptr);
+
+/// @brief Responds with the global metrics registry in the Prometheus text format.
+Response handle_metrics(Request&& request);
+
+} // namespace http::handlers
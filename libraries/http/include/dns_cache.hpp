@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/core/noncopyable.hpp>
+
+#include <common/include/thread_pool.hpp>
+
+namespace http::client {
+
+using Endpoints = std::vector<boost::asio::ip::tcp::endpoint>;
+
+/// @brief Blocking resolution of the host, may be replaced by a stand-in one.
+/// @throws std::runtime_error if the host cannot be resolved
+using ResolveFunction = std::function<Endpoints(const std::string& host, const std::string& port)>;
+
+/// @brief Resolves the host with the system resolver.
+/// @throws std::runtime_error if the host cannot be resolved
+Endpoints SystemResolve(const std::string& host, const std::string& port);
+
+/// @struct DnsCache settings. The system resolver does not report the TTLs
+/// of the records, so the cache uses the fixed ones.
+struct DnsCacheSettings {
+    // resolved addresses are fresh for ttl, then they are still served for up
+    // to max_stale while being refreshed in background
+    std::chrono::milliseconds ttl{std::chrono::seconds(30)};
+    std::chrono::milliseconds max_stale{std::chrono::minutes(10)};
+    // resolution failures are cached for negative_ttl, a failed refresh
+    // is retried after negative_ttl as well
+    std::chrono::milliseconds negative_ttl{std::chrono::seconds(5)};
+    size_t resolver_threads = 2;
+    size_t max_queue_size = 1024;
+};
+
+/// @struct Snapshot of the cache statistics.
+struct DnsCacheStats {
+    size_t hits{};
+    size_t stale_hits{};
+    size_t misses{};
+    size_t resolutions{};
+    size_t failures{};
+};
+
+/**
+ * @class Thread-safe cache of the resolved hosts. A miss is resolved by one
+ * of the resolver threads, the concurrent misses of the same host share the
+ * resolution. A stale host is served in place while it is refreshed in
+ * background, so the requests wait for the resolver only when the host
+ * is resolved for the first time or has not been used for max_stale.
+ */
+class DnsCache : private boost::noncopyable {
+public:
+    using Callback = std::function<void(std::exception_ptr error_ptr, const Endpoints& endpoints)>;
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Process-wide cache of the system resolver, used by the clients by default.
+    static DnsCache& GetInstance();
+
+    explicit DnsCache(const DnsCacheSettings& settings = DnsCacheSettings{},
+                      ResolveFunction resolve = &SystemResolve);
+    ~DnsCache();
+
+    /// @brief Invokes the callback with the addresses of the host or with the
+    /// resolution error. The callback is invoked in place if the host is cached,
+    /// otherwise from a resolver thread, so it must not block.
+    void Resolve(const std::string& host, const std::string& port, Callback&& callback);
+
+    /// @brief Blocking resolution through the cache.
+    /// @throws std::runtime_error if the host cannot be resolved
+    Endpoints Resolve(const std::string& host, const std::string& port);
+
+    void Clear();
+
+    DnsCacheStats GetStats() const;
+
+private:
+    struct Entry {
+        Endpoints endpoints{};
+        std::exception_ptr error_ptr{};
+        // the entry is fresh until expires_at, the endpoints
+        // are served while being refreshed until stale_until
+        Clock::time_point expires_at{};
+        Clock::time_point stale_until{};
+        bool is_resolving{false};
+        std::vector<Callback> callbacks{};
+    };
+
+    /// @brief Resolves the host by a resolver thread, must be called under the lock.
+    /// @returns false if the resolver queue is full
+    bool StartResolution(const std::string& host, const std::string& port, Entry& entry);
+    void OnResolved(const std::string& host, const std::string& port,
+                    Endpoints&& endpoints, std::exception_ptr error_ptr);
+
+    const DnsCacheSettings settings_;
+    const ResolveFunction resolve_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    DnsCacheStats stats_;
+    // the last member, so the resolver threads are joined first
+    common::threading::WorkerPool resolver_pool_;
+};
+
+} // namespace http::client
@@ -34,6 +34,16 @@ public:
     }
 };
 
+/// @class Payload too large error. Code 413.
+class PayloadTooLarge : public HttpError {
+public:
+    PayloadTooLarge(const char* msg) : HttpError(msg) {}
+    virtual ~PayloadTooLarge() {}
+    http::Status Code() const override {
+        return http::Status::payload_too_large;
+    }
+};
+
 /// @class Server error. Code 500.
 class ServerError : public HttpError {
 public:
@@ -44,4 +54,14 @@ public:
     }
 };
 
+/// @class Service unavailable error. Code 503.
+class ServiceUnavailable : public HttpError {
+public:
+    ServiceUnavailable(const char* msg) : HttpError(msg) {}
+    virtual ~ServiceUnavailable() {}
+    http::Status Code() const override {
+        return http::Status::service_unavailable;
+    }
+};
+
 } // namespace http::exceptions
\ No newline at end of file
@@ -1,8 +1,16 @@
 #pragma once
 
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
-#include <boost/beast/core.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
 
 #include <http/include/models.hpp>
 
@@ -10,16 +18,86 @@ namespace http::client {
 
 constexpr int kHttpVersion = 11;
 
+class ConnectionPool;
+class ContextGuard;
+class DnsCache;
+
+/// @struct HttpClient settings.
+struct ClientSettings {
+    // max number of connections to the host, the requests over
+    // the limit wait for a connection to be released
+    size_t max_connections = 64;
+    // max number of keep-alive connections kept open while unused
+    size_t max_idle_connections = 8;
+    // unused connections are closed after the timeout,
+    // should be below the server idle timeout
+    std::chrono::milliseconds idle_timeout{std::chrono::seconds(5)};
+    // every phase of a request (waiting for a connection, resolution, connect,
+    // write and read) is limited by the timeout or by the request deadline
+    // if it is closer, the rest of the time is sent to the server
+    std::chrono::milliseconds timeout{std::chrono::seconds(30)};
+    // the host is resolved through the process-wide cache if not set
+    std::shared_ptr<DnsCache> dns_cache_ptr{};
+};
+
+/// @struct Snapshot of the connection pool statistics.
+struct PoolStats {
+    size_t connects{};
+    size_t reuses{};
+    size_t active{};
+    size_t idle{};
+};
+
+/// @brief Completion callback of an asynchronous request. Gets either the
+/// response or the error the blocking request would throw.
+using RequestCallback = std::function<void(std::exception_ptr error_ptr, Response&& response)>;
+
+/**
+ * @class HTTP client of a single host. The connections are kept alive
+ * and reused by the following requests. The client is thread-safe,
+ * so it may be shared by the handlers, each of the concurrent requests
+ * takes a connection of its own.
+ * The requests are executed asynchronously on an I/O context, either
+ * a private one run by a thread of the client, or the one of the caller
+ * (e.g. the server context), so a handler may wait for the responses
+ * without blocking an I/O thread.
+ */
 class HttpClient {
-public: 
-    HttpClient(const std::string& host, int port = 80);
+public:
+    /// @brief Creates a client executing the requests on a private context.
+    HttpClient(const std::string& host, int port = 80,
+               const ClientSettings& settings = ClientSettings{});
+    /// @brief Creates a client executing the requests on the context,
+    /// which must be run by the caller and outlive the client.
+    HttpClient(std::shared_ptr<boost::asio::io_context> context_ptr,
+               const std::string& host, int port = 80,
+               const ClientSettings& settings = ClientSettings{});
     HttpClient(HttpClient&& client);
     ~HttpClient();
 
     HttpClient& operator=(HttpClient&& client);
 
+    /// @brief Sends the request and waits for the response. A request of an
+    /// idempotent method is retried once on a new connection if the reused
+    /// one turns out to be closed by the server.
+    /// @throws std::logic_error if called from a thread running the client context
+    /// @throws std::runtime_error if the host cannot be resolved
+    /// @throws boost::system::system_error on the connection errors,
+    /// with boost::beast::error::timeout once the deadline has passed
     Response Request(const Request& request);
+
+    /// @brief Starts the request and returns immediately. The callback is
+    /// invoked from a thread of the client context and must not block.
+    void AsyncRequest(http::Request request, RequestCallback&& callback);
+
+    /// @brief Starts the request and returns the future of the response.
+    std::future<Response> AsyncRequest(http::Request request);
+
+    PoolStats GetPoolStats() const;
+
 private:
+    using WorkGuard = boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
+
     HttpClient(const HttpClient&);
     HttpClient& operator=(const HttpClient&);
     void Swap(HttpClient&& other);
@@ -27,7 +105,32 @@ private:
     std::string host_;
     std::string port_;
     std::shared_ptr<boost::asio::io_context> context_ptr_;
-    boost::beast::flat_buffer buffer_;
+    // lets the resolver threads know the context is gone along with the client
+    std::shared_ptr<ContextGuard> context_guard_ptr_;
+    std::shared_ptr<ConnectionPool> pool_ptr_;
+    std::shared_ptr<DnsCache> dns_cache_ptr_;
+    std::chrono::milliseconds timeout_{};
+    // the private context is run until the client is destroyed
+    std::unique_ptr<WorkGuard> work_guard_ptr_;
+    std::thread context_thread_;
+};
+
+/// @struct Item of the RequestAll fan-out.
+struct ClientRequest {
+    HttpClient* client_ptr;
+    http::Request request;
 };
 
-} // namespace http::client
\ No newline at end of file
+using RequestAllCallback = std::function<void(std::vector<std::future<Response>>&&)>;
+
+/// @brief Starts the requests concurrently, possibly to different clients.
+/// The callback is invoked once all of them are completed with the ready
+/// futures of the responses in the order of the requests, from a thread
+/// of the client context completing the last one.
+void RequestAll(std::vector<ClientRequest>&& requests, RequestAllCallback&& callback);
+
+/// @brief Starts the requests concurrently and returns the futures
+/// of the responses in the order of the requests.
+std::vector<std::future<Response>> RequestAll(std::vector<ClientRequest>&& requests);
+
+} // namespace http::client
@@ -1,18 +1,67 @@
 #pragma once
 
-#include <string>
+#include <chrono>
+#include <memory>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <boost/asio/ip/tcp.hpp>
 
+#include <common/include/allocators.hpp>
+#include <common/include/thread_pool.hpp>
+#include <common/include/timing_wheel.hpp>
+
+#include "compression.hpp"
+#include "concurrency_limiter.hpp"
+#include "conditional.hpp"
 #include "models.hpp"
+#include "request_metrics.hpp"
+
 
+namespace http::tcp {
+
+struct BodyPolicy;
+
+} // namespace http::tcp
 
 namespace http::server {
 
+/// @brief Where a synchronous handler is executed.
+enum class Execution {
+    Reactor,     // inline on the I/O thread of the session
+    WorkerPool,  // on the server bounded worker pool
+};
+
+/// @brief How the connections I/O is done.
+enum class Transport {
+    Asio,     // via the context reactor, epoll on Linux
+    IoUring,  // via an io_uring per context, falls back to Asio if not supported
+};
+
+/// @struct Registered HTTP handler. Only one of the
+/// handler and async_handler is set. A route streaming the request
+/// bodies has the sink_factory, its handler finishes the sink.
+struct Route {
+    std::string pattern{};
+    Method method{};
+    HttpHandler handler{};
+    AsyncHttpHandler async_handler{};
+    Execution execution{};
+    std::shared_ptr<RouteMetrics> metrics_ptr{};
+    BodySinkFactory sink_factory{};
+    // overrides the server max_body_size
+    std::optional<uint64_t> body_limit{};
+};
+
 /**
  * @class container for HTTP handlers
  * HTTP handler = method + uri
+ * Handlers are stored in a radix tree, so the lookup does not allocate
+ * and takes time proportional to the path length. Uri may contain
+ * parameter segments like /documents/{id}, static segments have
+ * a priority over the parameters.
  */
 class HttpHandlers {
 public:
@@ -24,24 +73,70 @@ public:
     HttpHandlers& operator=(const HttpHandlers& other);
     HttpHandlers& operator=(HttpHandlers&& other);
 
-    void AddHandler(const std::string& uri, const Method method, const HttpHandler& handler);
+    /// @throws std::logic_error if uri pattern is invalid or conflicts
+    /// with the parameter names of already registered handlers
+    void AddHandler(const std::string& uri, const Method method, const HttpHandler& handler,
+                    const Execution execution = Execution::Reactor);
+    void AddHandler(const std::string& uri, const Method method, const AsyncHttpHandler& handler);
+    void AddHandler(const std::string& uri, const Method method, const BodySinkFactory& factory,
+                    const uint64_t body_limit, const Execution execution = Execution::Reactor);
     void RemoveHandler(const std::string& uri, const Method method);
-    std::optional<HttpHandler> GetHandler(const std::string& uri, const Method method) const;
+
+    /// @brief Finds a route for the path (without query) and the method.
+    /// @param params if specified, stores the captured path parameters
+    /// @returns pointer to the route or nullptr if nothing found
+    const Route* Match(std::string_view path, const Method method,
+                       PathParams* params = nullptr) const;
 
 private:
-    using MethodToHandler = std::unordered_map<Method, HttpHandler>;
-    using UriToMethod = std::unordered_map<std::string, MethodToHandler>;
+    struct Node;
+    using NodePtr = std::unique_ptr<Node>;
+
+    void AddRoute(Route&& route);
 
-    UriToMethod handlers_;
+    NodePtr root_;
+};
+
+/// @struct HttpServer settings.
+struct ServerSettings {
+    // worker pool for the handlers offloaded from the I/O threads,
+    // started once the first of such handlers is registered
+    size_t worker_pool_size = 4;
+    size_t worker_queue_max_size = 1024;
+    // max number of pipelined requests handled concurrently within
+    // a connection, responses are still sent in the requests order
+    size_t pipeline_depth = 1;
+    // a connection is closed once it has no requests in flight for idle_timeout,
+    // or once a response write makes no progress for active_timeout
+    std::chrono::milliseconds idle_timeout{std::chrono::seconds(10)};
+    std::chrono::milliseconds active_timeout{std::chrono::seconds(10)};
+    // requests with a larger body are answered with 413 Payload Too Large,
+    // with a known Content-Length even before the body is read
+    uint64_t max_body_size = 1024 * 1024;
+    // connections and in-flight requests limits, requests over
+    // the limits are answered with 503 Service Unavailable
+    LimiterSettings limiter{};
+    // compression of the responses by the request Accept-Encoding
+    compression::CompressionSettings compression{};
+    Transport transport = Transport::Asio;
 };
 
 /**
  * @class async HTTP server
+ * Works in one of two modes:
+ * - shared context: a single acceptor, the context is run by a number of
+ *   threads and every session is wrapped into a strand;
+ * - multi-reactor: each context owns its own SO_REUSEPORT acceptor, so the
+ *   kernel spreads connections and sessions never leave their context.
  */
 class HttpServer : public std::enable_shared_from_this<HttpServer> {
 public:
     HttpServer(std::shared_ptr<boost::asio::io_context> io_context_ptr,
-               const std::string& address, const unsigned short port);
+               const std::string& address, const unsigned short port,
+               const ServerSettings& settings = ServerSettings{});
+    HttpServer(const std::vector<std::shared_ptr<boost::asio::io_context>>& io_context_ptrs,
+               const std::string& address, const unsigned short port,
+               const ServerSettings& settings = ServerSettings{});
     HttpServer(HttpServer&& other);
     ~HttpServer();
 
@@ -51,24 +146,107 @@ public:
     /// @throws std::runtime error if unable to setup server
     void Listen();
 
+    /// @brief Stop accepting new connections
+    void Stop();
+
+    /// @brief Returns the port the server is listening on. Useful
+    /// when the server was created with port 0.
+    unsigned short GetPort() const;
+
     /// @brief Registers a new handler for the specified uri
+    /// @param execution where the handler is executed; blocking handlers
+    /// should use Execution::WorkerPool to keep I/O threads responsive
     void AddListener(const std::string& uri, const Method method,
-                     const HttpHandler& handler);
+                     const HttpHandler& handler,
+                     const Execution execution = Execution::Reactor);
+
+    /// @brief Registers a new handler of a conditional GET. The handler is
+    /// not invoked and 304 Not Modified is responded if the request
+    /// preconditions are matched by the validators of the resource.
+    /// @param validators provider of the resource validators, it is invoked
+    /// with the same execution ahead of the handler
+    void AddListener(const std::string& uri, const Method method,
+                     const HttpHandler& handler,
+                     const conditional::ValidatorsProvider& validators,
+                     const Execution execution = Execution::Reactor);
+
+    /// @brief Registers a new asynchronous handler for the specified uri.
+    /// The handler is invoked on the I/O thread, the response may be
+    /// delivered from any thread and is written within the session strand.
+    void AddListener(const std::string& uri, const Method method,
+                     const AsyncHttpHandler& handler);
+
+    /// @brief Registers a new handler streaming the request bodies into the
+    /// sinks made by the factory. The response is made by the sink once the
+    /// body is over. The execution is applied to all of the sink calls:
+    /// with Execution::WorkerPool the sink is made, written and released
+    /// on the workers, otherwise on the I/O thread.
+    /// @param body_limit max body size of the route instead of the server one
+    void AddListener(const std::string& uri, const Method method,
+                     const BodySinkFactory& factory, const uint64_t body_limit,
+                     const Execution execution = Execution::Reactor);
+
+    /// @brief Returns the current state of the admission control.
+    LimiterState GetLimiterState() const;
+
+    /// @brief Returns the response compression statistics.
+    compression::CompressionStats GetCompressionStats() const;
+
+    /// @brief Returns the transport actually used, which differs from
+    /// the requested one if io_uring is not supported.
+    Transport GetTransport() const;
 
 private:
+    struct UringAcceptOperation;
+
+    /// @brief Acceptor bound to its own I/O context. The connections
+    /// timeouts of the context are served by its timing wheel. With the
+    /// io_uring transport connections are accepted via the context ring.
+    struct Acceptor {
+        std::shared_ptr<boost::asio::io_context> io_context_ptr;
+        boost::asio::ip::tcp::acceptor acceptor;
+        std::shared_ptr<common::threading::TimingWheel> timing_wheel_ptr;
+        std::shared_ptr<UringAcceptOperation> uring_accept_ptr{};
+    };
+
     HttpServer(const HttpServer& other);
     HttpServer& operator=(const HttpServer& other);
 
-    void AsyncAcceptNextConnection();
-    void OnConnectionAccepted(const boost::beast::error_code error_code,
+    void SetupTransport();
+    void OpenAcceptor(boost::asio::ip::tcp::acceptor& acceptor);
+    void AsyncAcceptNextConnection(size_t acceptor_index);
+    void OnConnectionAccepted(size_t acceptor_index,
+                              const boost::beast::error_code error_code,
                               boost::asio::ip::tcp::socket socket);
 
-    Response HandleRequest(Request&& request);
-    Response RouteRequest(Request&& request);
-
-    std::shared_ptr<boost::asio::io_context> io_context_ptr_;
-    boost::asio::ip::tcp::acceptor acceptor_;
+    void RejectConnection(boost::asio::ip::tcp::socket& socket);
+    void StartWorkerPool();
+    tcp::BodyPolicy HandleHeader(const RequestHeader& header,
+                                 std::optional<uint64_t> content_length);
+    void MakeBodySink(const Route& route, const RequestHeader& header,
+                      std::optional<uint64_t> content_length, tcp::BodyPolicy& policy);
+    Response RejectHeader(const RequestHeader& header, const Route* route_ptr,
+                          Response&& handler_response);
+    /// @param executor executor of the request connection
+    void HandleRequest(Request&& request, ResponseCallback&& callback,
+                       const ConcurrencyLimiter::Executor& executor);
+    void RouteRequest(const Route* route_ptr, Request&& request, ResponseCallback&& callback);
+
+    std::vector<Acceptor> acceptors_;
+    boost::asio::ip::tcp::endpoint endpoint_;
+    bool reuse_port_;
     HttpHandlers handlers_;
+    // whether any of the routes overrides the body handling,
+    // so the routes have to be matched by the request headers
+    bool has_body_routes_;
+    ServerSettings settings_;
+    std::unique_ptr<common::threading::WorkerPool> worker_pool_ptr_;
+    std::shared_ptr<ConcurrencyLimiter> limiter_ptr_;
+    // arenas of the request and response messages
+    std::shared_ptr<common::memory::ArenaPool> arena_pool_ptr_;
+    std::shared_ptr<compression::CompressionMetrics> compression_metrics_ptr_;
+    // metrics of the requests matched no route
+    std::shared_ptr<RouteMetrics> unmatched_metrics_ptr_;
 };
 
 } // namespace http::server
\ No newline at end of file
@@ -1,15 +1,201 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
 #include <boost/beast/http.hpp>
+#include <boost/core/noncopyable.hpp>
+
+#include <common/include/allocators.hpp>
 
 
 namespace http {
 
 using StringBody = boost::beast::http::string_body;
-using Request = boost::beast::http::request<StringBody>;
-using Response = boost::beast::http::response<StringBody>;
+/// @brief Header fields. The server allocates them from a per-message
+/// arena, the messages created elsewhere use the global heap.
+using FieldsAllocator = common::memory::ArenaAllocator<char>;
+using Fields = boost::beast::http::basic_fields<FieldsAllocator>;
 using Method = boost::beast::http::verb;
 using Status = boost::beast::http::status;
+using RequestHeader = boost::beast::http::request_header<Fields>;
+
+class BodySink;
+
+/// @class Fixed capacity storage of the path parameters captured by the router,
+/// e.g. {id} in /documents/{id}. Values are stored as positions within the request
+/// target, so the storage never allocates and stays valid for request copies.
+class PathParams {
+public:
+    static constexpr size_t kMaxSize = 8;
+
+    PathParams();
+
+    /// @brief Adds a parameter. Name must outlive the parameters storage.
+    /// @returns false if there is no more space for parameters.
+    bool Push(std::string_view name, size_t offset, size_t size);
+
+    /// @brief Removes the last added parameter.
+    void Pop();
+
+    void Clear();
+    size_t Size() const;
+
+    /// @brief Looks up parameter value by name within the specified target.
+    std::optional<std::string_view> Get(std::string_view target,
+                                        std::string_view name) const;
+
+private:
+    struct Param {
+        std::string_view name{};
+        size_t offset{};
+        size_t size{};
+    };
+
+    std::array<Param, kMaxSize> params_;
+    size_t size_;
+};
+
+/// @class HTTP request. Carries the path parameters captured by the router
+/// and the deadline of the caller.
+class Request : public boost::beast::http::request<StringBody, Fields> {
+public:
+    using Base = boost::beast::http::request<StringBody, Fields>;
+    using Clock = std::chrono::steady_clock;
+    using Base::Base;
+
+    Request() = default;
+    explicit Request(Base&& base);
+
+    /// @brief Returns value of the path parameter or std::nullopt if not found.
+    /// The value refers to the request target.
+    std::optional<std::string_view> GetPathParam(std::string_view name) const;
+
+    PathParams& GetPathParams();
+    const PathParams& GetPathParams() const;
+
+    /// @brief Sink the body was streamed into instead of the body(),
+    /// set only for the routes streaming the request bodies.
+    void SetBodySink(std::shared_ptr<BodySink> sink_ptr);
+    const std::shared_ptr<BodySink>& GetBodySink() const;
+
+    /// @brief Point in time the caller stops waiting for the response at.
+    /// The server sets it by the timeout header of an incoming request,
+    /// the client sends the rest of it with an outgoing one, so a handler
+    /// passes its deadline on by setting it to the downstream requests.
+    void SetDeadline(std::optional<Clock::time_point> deadline);
+    const std::optional<Clock::time_point>& GetDeadline() const;
+
+    /// @returns true if the deadline is set and has passed.
+    bool IsExpired() const;
+
+private:
+    PathParams path_params_{};
+    std::shared_ptr<BodySink> body_sink_ptr_{};
+    std::optional<Clock::time_point> deadline_{};
+};
+
+/// @class Byte range of a file to be sent as a response body. The file is
+/// opened on construction, so the range stays readable even if the file
+/// is replaced afterwards. The server sends it with sendfile(2) right from
+/// the page cache to the socket, the bytes never pass through the user space.
+class FileRange : private boost::noncopyable {
+public:
+    /// @throws std::system_error if the file cannot be opened
+    FileRange(const std::filesystem::path& path, uint64_t offset, uint64_t size);
+    ~FileRange();
+
+    int GetDescriptor() const;
+    uint64_t GetOffset() const;
+    uint64_t GetSize() const;
+
+private:
+    int descriptor_;
+    uint64_t offset_;
+    uint64_t size_;
+};
+
+using FileRangePtr = std::shared_ptr<const FileRange>;
+
+/// @class HTTP response. Either carries the whole body, streams it
+/// with chunked transfer encoding from a generator, or sends a file range.
+class Response : public boost::beast::http::response<StringBody, Fields> {
+public:
+    using Base = boost::beast::http::response<StringBody, Fields>;
+    using Base::Base;
+
+    /// @brief Produces the next chunk of the body into the cleared buffer.
+    /// @returns false once the body is over, the buffer is not sent then.
+    /// Invoked when the previous chunk is sent, from the connection thread
+    /// or via the chunk executor if it is set.
+    using ChunkGenerator = std::function<bool(std::string& chunk)>;
+    /// @brief Executes a chunk generation off the connection thread.
+    /// @returns false if the generation cannot be scheduled
+    using ChunkExecutor = std::function<bool(std::function<void()>&&)>;
+
+    /// @brief Makes the response be sent chunk by chunk, the body() is ignored.
+    void SetChunkGenerator(ChunkGenerator&& generator);
+    bool IsChunked() const;
+    ChunkGenerator& GetChunkGenerator();
+
+    /// @brief Makes the chunks be generated via the executor, e.g. by
+    /// a blocking generator. The server sets it for the worker pool routes.
+    void SetChunkExecutor(ChunkExecutor&& executor);
+    const ChunkExecutor& GetChunkExecutor() const;
+
+    /// @brief Makes the file range be sent as the body, the body() is ignored.
+    void SetFileRange(FileRangePtr file_range_ptr);
+    bool HasFileRange() const;
+    const FileRangePtr& GetFileRange() const;
+
+private:
+    ChunkGenerator chunk_generator_{};
+    ChunkExecutor chunk_executor_{};
+    FileRangePtr file_range_ptr_{};
+};
+
+/// @class Consumer of a request body streamed by the server part by part
+/// as it arrives, so a large body is never held in memory as a whole.
+/// A sink destroyed without Finish must discard the consumed body.
+class BodySink {
+public:
+    virtual ~BodySink() = default;
+
+    /// @brief Consumes the next part of the body. Invoked with the execution
+    /// of the route, one part at a time, so a sink of a route executed on the
+    /// I/O thread must not block for long. Must not throw, a failure is
+    /// to be reported by Finish.
+    virtual void Write(std::string_view data) = 0;
+
+    /// @brief Completes the body and makes the response. Invoked as
+    /// a synchronous handler of the route, the request body() is empty.
+    virtual Response Finish(Request&& request) = 0;
+};
+
+using BodySinkPtr = std::shared_ptr<BodySink>;
+
+/// @brief Makes a sink for the request body once the request header is read,
+/// with the execution of the route. The content length is not known for
+/// a chunked body. May throw
+/// http::exceptions::HttpError to reject the request before its body.
+using BodySinkFactory =
+    std::function<BodySinkPtr(const RequestHeader&, std::optional<uint64_t> content_length)>;
+
 using HttpHandler = std::function<Response(Request&&)>;
 
-} // namespace http
\ No newline at end of file
+/// @brief Delivers a response of an asynchronous handler.
+/// May be invoked from any thread.
+using ResponseCallback = std::function<void(Response&&)>;
+
+/// @brief Asynchronous handler. Must invoke the callback exactly once
+/// and must not throw after that.
+using AsyncHttpHandler = std::function<void(Request&&, ResponseCallback&&)>;
+
+} // namespace http
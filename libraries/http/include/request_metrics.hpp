@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include <boost/core/noncopyable.hpp>
+
+#include <common/include/metrics.hpp>
+
+#include "models.hpp"
+
+namespace http::server {
+
+/// @brief Route label of the requests matched no route.
+constexpr const char* kUnmatchedRoute = "unmatched";
+
+/**
+ * @class Metrics of the requests of a single route and method:
+ * http_requests_total{route, method, status} counters and
+ * http_request_duration_seconds{route, method} histogram
+ * of the global metrics registry. The counters of the statuses
+ * are looked up in the registry once and cached, so recording
+ * a request takes no locks.
+ */
+class RouteMetrics : private boost::noncopyable {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    RouteMetrics(const std::string& route, Method method);
+
+    /// @brief Records a handled request.
+    void Record(unsigned int status, Clock::duration latency);
+
+private:
+    static constexpr unsigned int kMinStatus = 100;
+    static constexpr unsigned int kMaxStatus = 599;
+
+    common::metrics::Counter& GetStatusCounter(unsigned int status);
+
+    std::string route_;
+    std::string method_;
+    common::metrics::Histogram& latency_;
+    std::array<std::atomic<common::metrics::Counter*>, kMaxStatus - kMinStatus + 1> statuses_;
+};
+
+} // namespace http::server
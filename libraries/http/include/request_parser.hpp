@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+#include "models.hpp"
+
+namespace http::parser {
+
+/// @brief Instruction set the parser scans the bytes with.
+enum class Isa {
+    Scalar,  // byte by byte with lookup tables
+    Sse42,   // 16 bytes at a time with the string ranges compare
+    Avx2,    // 32 bytes at a time, SSE4.2 for the tokens
+};
+
+/// @brief Returns the best of the instruction sets supported by the CPU.
+/// Detected once, the parser uses it by default.
+Isa GetSupportedIsa();
+
+std::string_view ToString(Isa isa);
+
+/// @struct Header field referring to the parsed buffer.
+struct HeaderView {
+    std::string_view name{};
+    std::string_view value{};
+};
+
+/// @struct Request line and header fields referring to the parsed buffer,
+/// so the buffer must outlive the head. Nothing is copied or allocated.
+struct RequestHead {
+    static constexpr size_t kMaxHeaders = 64;
+
+    std::string_view method{};
+    std::string_view target{};
+    // 10 or 11, like beast encodes the version
+    unsigned version{};
+    std::array<HeaderView, kMaxHeaders> headers{};
+    size_t headers_count{};
+
+    /// @brief Finds the first field with the name, case-insensitive.
+    std::optional<std::string_view> FindHeader(std::string_view name) const;
+};
+
+enum class ParseStatus {
+    Complete,
+    // more data is needed, the same buffer with more data appended is parsed again
+    Incomplete,
+    Invalid,
+};
+
+/// @struct Parsing result, the size of a complete head includes the empty line.
+struct ParseResult {
+    ParseStatus status{};
+    size_t size{};
+};
+
+/**
+ * @brief Parses HTTP/1.0 or HTTP/1.1 request line and header fields in
+ * the picohttpparser manner: the delimiters are found by vectorized scans
+ * validating the bytes on the way, the values are views into the buffer.
+ * Lines are terminated by CRLF, the empty lines before the request line
+ * are skipped, the optional whitespace around the field values is trimmed.
+ * Folded field values and more than kMaxHeaders fields are invalid.
+ * A parsed head is undefined unless the status is Complete.
+ */
+ParseResult ParseRequestHead(std::string_view buffer, RequestHead& head,
+                             Isa isa = GetSupportedIsa());
+
+/// @brief Adapts the parsed request for the HttpHandler, the fields are
+/// copied to the request allocated with the allocator.
+/// @throws std::invalid_argument if the method is not known
+Request ToRequest(const RequestHead& head, std::string_view body,
+                  const FieldsAllocator& allocator = FieldsAllocator{});
+
+} // namespace http::parser
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <charconv>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <common/include/format.hpp>
+#include <http/include/exceptions.hpp>
+#include <http/include/models.hpp>
+
+namespace http {
+
+/// @brief Percent-decodes the value into the buffer, '+' is decoded as
+/// a space if specified. The buffer is cleared first, so a reused buffer
+/// does not allocate once it is large enough.
+/// @returns false if the value has an invalid escape sequence
+bool PercentDecode(std::string_view value, std::string& buffer, bool is_plus_space = true);
+
+/**
+ * @class Allocation-free view of a request target: the path, the query
+ * and its parameters as string_views into the request, parsed lazily on
+ * every lookup. Parameters without '=' or with an empty name are skipped,
+ * the last one of the repeated names wins. Names are matched as is, the
+ * values are percent-decoded on demand into a caller buffer.
+ * The view must not outlive the request.
+ */
+class RequestView {
+public:
+    explicit RequestView(const Request& request);
+    /// @brief View of a request header, e.g. of a body sink factory.
+    /// It has no path parameters, they are captured once the request is routed.
+    explicit RequestView(const RequestHeader& header);
+
+    /// @brief Path of the target, not decoded.
+    std::string_view GetPath() const;
+    /// @brief Query of the target after '?', not decoded.
+    std::string_view GetQuery() const;
+
+    /// @brief Returns the raw value of a query parameter.
+    std::optional<std::string_view> GetRawParam(std::string_view name) const;
+
+    /// @brief Returns the decoded value of a query parameter. The value refers
+    /// either to the target if it has nothing to decode, or to the buffer.
+    /// @throws http::exceptions::BadRequest if the value is badly encoded
+    std::optional<std::string_view> GetParam(std::string_view name, std::string& buffer) const;
+
+    /// @brief Parses the query parameter as an integer.
+    /// @throws http::exceptions::BadRequest if the value is not an integer of type T
+    template<typename T>
+    std::optional<T> GetParamAs(std::string_view name) const {
+        const auto value_opt = GetRawParam(name);
+        if (!value_opt.has_value()) {
+            return std::nullopt;
+        }
+        return ParseInteger<T>(name, value_opt.value());
+    }
+
+    /// @brief Returns the decoded value of a path parameter captured by the router.
+    /// @throws http::exceptions::BadRequest if the value is badly encoded
+    std::optional<std::string_view> GetPathParam(std::string_view name,
+                                                 std::string& buffer) const;
+
+    /// @brief Parses the path parameter as an integer.
+    /// @throws http::exceptions::BadRequest if the value is not an integer of type T
+    template<typename T>
+    std::optional<T> GetPathParamAs(std::string_view name) const {
+        const auto value_opt = GetRawPathParam(name);
+        if (!value_opt.has_value()) {
+            return std::nullopt;
+        }
+        return ParseInteger<T>(name, value_opt.value());
+    }
+
+    /// @brief Invokes the callback with the raw name and value of every
+    /// query parameter in the order of the target.
+    template<typename Callback>
+    void ForEachParam(Callback&& callback) const {
+        auto query = query_;
+        while (!query.empty()) {
+            const auto delimiter = query.find('&');
+            const auto param = query.substr(0, delimiter);
+            query = delimiter == std::string_view::npos ?
+                std::string_view{} : query.substr(delimiter + 1);
+            const auto equal = param.find('=');
+            if (equal == std::string_view::npos || equal == 0) {
+                continue;
+            }
+            callback(param.substr(0, equal), param.substr(equal + 1));
+        }
+    }
+
+private:
+    template<typename T>
+    static T ParseInteger(std::string_view name, std::string_view value) {
+        static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>,
+                      "Only integer parameters are supported");
+        // digits never need decoding, an encoded value is decoded first
+        std::string buffer{};
+        if (value.find('%') != std::string_view::npos) {
+            if (!PercentDecode(value, buffer)) {
+                ThrowInvalid(name);
+            }
+            value = buffer;
+        }
+        T result{};
+        const auto [end_ptr, error] = std::from_chars(
+            value.data(), value.data() + value.size(), result);
+        if (error != std::errc{} || end_ptr != value.data() + value.size()) {
+            ThrowInvalid(name);
+        }
+        return result;
+    }
+
+    [[noreturn]] static void ThrowInvalid(std::string_view name);
+
+    std::optional<std::string_view> GetRawPathParam(std::string_view name) const;
+
+    std::string_view target_;
+    // not set for a bare header
+    const PathParams* path_params_;
+    std::string_view path_;
+    std::string_view query_;
+};
+
+} // namespace http
@@ -12,6 +12,10 @@ namespace http::utils {
 
 std::string ToString(const Method method);
 
+/// @brief Returns true if the repeated requests of the method have
+/// the same effect as a single one, so they may be retried or hedged.
+bool IsIdempotent(const Method method);
+
 /// @brief Tries to parse request body as a json
 /// and interpret as value of the specified type T.
 /// @throws http::exceptions::BadRequest if json has
@@ -26,7 +30,8 @@ T Parse(const Request& request) {
     }
 }
 
-/// @brief Get map of http request params.
+/// @brief Get map of http request params. Copies the target and every
+/// parameter, prefer http::RequestView on the request path.
 std::unordered_map<std::string, std::string> GetParams(const Request& request);
 
 } // namespace http::utils
\ No newline at end of file
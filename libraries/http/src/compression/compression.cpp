@@ -0,0 +1,298 @@
+#include <http/include/compression.hpp>
+
+#include <time.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <optional>
+#include <stdexcept>
+
+namespace http::compression {
+
+namespace {
+
+namespace boost_http = boost::beast::http;
+
+constexpr int kMaxWindowBits = 15;
+// adding 16 to the window bits makes zlib write the gzip wrapper
+constexpr int kGzipWindowBits = kMaxWindowBits + 16;
+constexpr int kMemoryLevel = 8;
+constexpr size_t kOutputStepSize = 16 * 1024;
+
+std::string_view Trim(std::string_view value) {
+    const auto begin = value.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    const auto end = value.find_last_not_of(" \t");
+    return value.substr(begin, end - begin + 1);
+}
+
+bool IsEqualNoCase(std::string_view left, std::string_view right) {
+    return std::equal(left.begin(), left.end(), right.begin(), right.end(),
+                      [](char left_char, char right_char) {
+                          return std::tolower(left_char) == std::tolower(right_char);
+                      });
+}
+
+/// @brief Parses the quality value of an Accept-Encoding item parameters,
+/// e.g. ";q=0.5". Returns 1 if there is no valid one.
+double ParseQuality(std::string_view params) {
+    while (!params.empty()) {
+        const auto separator = params.find(';');
+        const auto param = Trim(params.substr(0, separator));
+        params = separator == std::string_view::npos ?
+            std::string_view{} : params.substr(separator + 1);
+        if (param.size() < 2 || std::tolower(param[0]) != 'q' || param[1] != '=') {
+            continue;
+        }
+        double quality = 1.0;
+        const auto value = param.substr(2);
+        const auto result = std::from_chars(value.data(), value.data() + value.size(), quality);
+        if (result.ec == std::errc{}) {
+            return quality;
+        }
+    }
+    return 1.0;
+}
+
+std::chrono::nanoseconds GetThreadCpuTime() {
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+}
+
+/// @brief Measures the CPU time of the current thread since the construction.
+class CpuTimer {
+public:
+    CpuTimer() : started_at_{GetThreadCpuTime()} {}
+
+    std::chrono::nanoseconds GetElapsed() const {
+        return GetThreadCpuTime() - started_at_;
+    }
+
+private:
+    std::chrono::nanoseconds started_at_;
+};
+
+void SetContentEncoding(Response& response, Encoding encoding) {
+    const auto value = ToString(encoding);
+    response.set(boost_http::field::content_encoding,
+                 boost::beast::string_view(value.data(), value.size()));
+    // the encoded body is not byte to byte equal to the identity one,
+    // so a strong entity tag is weakened
+    const auto etag_it = response.find(boost_http::field::etag);
+    if (etag_it != response.end() && !etag_it->value().starts_with("W/")) {
+        response.set(boost_http::field::etag, "W/" + etag_it->value().to_string());
+    }
+}
+
+bool HasBody(const Response& response) {
+    const auto status = response.result_int();
+    return status >= 200 && response.result() != Status::no_content &&
+           response.result() != Status::not_modified;
+}
+
+void CompressBody(Response& response, Encoding encoding, const CompressionSettings& settings,
+                  CompressionMetrics& metrics) {
+    auto& body = response.body();
+    const CpuTimer timer{};
+    std::string output{};
+    output.reserve(body.size() / 2);
+    Compressor compressor(encoding, settings.level);
+    compressor.Compress(body, output);
+    compressor.Finish(output);
+    metrics.AddResponse();
+    metrics.Add(body.size(), output.size(), timer.GetElapsed());
+
+    // incompressible data is not worth the decompression on the client side
+    if (output.size() >= body.size()) {
+        return;
+    }
+    body = std::move(output);
+    SetContentEncoding(response, encoding);
+}
+
+void CompressChunks(Response& response, Encoding encoding, const CompressionSettings& settings,
+                    const std::shared_ptr<CompressionMetrics>& metrics_ptr) {
+    metrics_ptr->AddResponse();
+    // the generator has to be copyable, the compressor is shared by the copies
+    auto compressor_ptr = std::make_shared<Compressor>(encoding, settings.level);
+    response.SetChunkGenerator(
+        [generator = std::move(response.GetChunkGenerator()), compressor_ptr, metrics_ptr,
+         input = std::string{}, is_finished = false](std::string& chunk) mutable {
+            if (is_finished) {
+                return false;
+            }
+            input.clear();
+            const bool has_more = generator(input);
+
+            const CpuTimer timer{};
+            if (has_more) {
+                compressor_ptr->Compress(input, chunk);
+            } else {
+                // the last chunk carries the rest of the stream
+                compressor_ptr->Finish(chunk);
+                is_finished = true;
+            }
+            metrics_ptr->Add(input.size(), chunk.size(), timer.GetElapsed());
+            return true;
+        });
+    SetContentEncoding(response, encoding);
+}
+
+} // namespace
+
+Encoding ChooseEncoding(std::string_view accept_encoding) {
+    std::optional<double> gzip_quality{};
+    std::optional<double> deflate_quality{};
+    std::optional<double> any_quality{};
+    while (!accept_encoding.empty()) {
+        const auto separator = accept_encoding.find(',');
+        const auto item = accept_encoding.substr(0, separator);
+        accept_encoding = separator == std::string_view::npos ?
+            std::string_view{} : accept_encoding.substr(separator + 1);
+
+        const auto params_begin = item.find(';');
+        const auto name = Trim(item.substr(0, params_begin));
+        const auto quality = params_begin == std::string_view::npos ?
+            1.0 : ParseQuality(item.substr(params_begin + 1));
+        if (IsEqualNoCase(name, "gzip") || IsEqualNoCase(name, "x-gzip")) {
+            gzip_quality = quality;
+        } else if (IsEqualNoCase(name, "deflate")) {
+            deflate_quality = quality;
+        } else if (name == "*") {
+            any_quality = quality;
+        }
+    }
+
+    const auto gzip = gzip_quality.value_or(any_quality.value_or(0.0));
+    const auto deflate = deflate_quality.value_or(any_quality.value_or(0.0));
+    if (gzip > 0.0 && gzip >= deflate) {
+        return Encoding::Gzip;
+    }
+    if (deflate > 0.0) {
+        return Encoding::Deflate;
+    }
+    return Encoding::Identity;
+}
+
+std::string_view ToString(Encoding encoding) {
+    switch (encoding) {
+    case Encoding::Gzip:
+        return "gzip";
+    case Encoding::Deflate:
+        return "deflate";
+    case Encoding::Identity:
+        break;
+    }
+    return "identity";
+}
+
+void to_json(common::json::json& json, const CompressionStats& stats) {
+    json = common::json::json{
+        {"responses", stats.responses},
+        {"input_bytes", stats.input_bytes},
+        {"output_bytes", stats.output_bytes},
+        {"cpu_time_us", stats.cpu_time_us},
+    };
+}
+
+CompressionMetrics::CompressionMetrics()
+    : responses_{0}, input_bytes_{0}, output_bytes_{0}, cpu_time_ns_{0} {}
+
+void CompressionMetrics::AddResponse() {
+    responses_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CompressionMetrics::Add(size_t input_bytes, size_t output_bytes,
+                             std::chrono::nanoseconds cpu_time) {
+    input_bytes_.fetch_add(input_bytes, std::memory_order_relaxed);
+    output_bytes_.fetch_add(output_bytes, std::memory_order_relaxed);
+    cpu_time_ns_.fetch_add(cpu_time.count(), std::memory_order_relaxed);
+}
+
+CompressionStats CompressionMetrics::GetStats() const {
+    return CompressionStats{
+        responses_.load(std::memory_order_relaxed),            // responses
+        input_bytes_.load(std::memory_order_relaxed),          // input_bytes
+        output_bytes_.load(std::memory_order_relaxed),         // output_bytes
+        cpu_time_ns_.load(std::memory_order_relaxed) / 1000,   // cpu_time_us
+    };
+}
+
+Compressor::Compressor(Encoding encoding, int level)
+    : stream_ptr_{std::make_unique<z_stream_s>()} {
+    if (encoding == Encoding::Identity) {
+        throw std::logic_error("Identity encoding needs no compressor");
+    }
+    const auto window_bits = encoding == Encoding::Gzip ? kGzipWindowBits : kMaxWindowBits;
+    const auto result = deflateInit2(stream_ptr_.get(), std::clamp(level, 1, 9), Z_DEFLATED,
+                                     window_bits, kMemoryLevel, Z_DEFAULT_STRATEGY);
+    if (result != Z_OK) {
+        stream_ptr_.reset();
+        throw std::runtime_error("Cannot initialize zlib stream");
+    }
+}
+
+Compressor::~Compressor() {
+    if (stream_ptr_ != nullptr) {
+        deflateEnd(stream_ptr_.get());
+    }
+}
+
+void Compressor::Compress(std::string_view input, std::string& output) {
+    Deflate(input, Z_NO_FLUSH, output);
+}
+
+void Compressor::Finish(std::string& output) {
+    Deflate(std::string_view{}, Z_FINISH, output);
+}
+
+void Compressor::Deflate(std::string_view input, int flush, std::string& output) {
+    auto& stream = *stream_ptr_;
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    do {
+        // zlib writes right into the output string
+        const auto output_size = output.size();
+        const auto step_size = std::max<size_t>(
+            kOutputStepSize, deflateBound(&stream, stream.avail_in) / 4);
+        output.resize(output_size + step_size);
+        stream.next_out = reinterpret_cast<Bytef*>(output.data() + output_size);
+        stream.avail_out = static_cast<uInt>(step_size);
+
+        const auto result = deflate(&stream, flush);
+        output.resize(output.size() - stream.avail_out);
+        if (result == Z_STREAM_ERROR) {
+            throw std::runtime_error("zlib stream error");
+        }
+        if (result == Z_STREAM_END) {
+            return;
+        }
+    } while (stream.avail_out == 0 || stream.avail_in != 0 || flush == Z_FINISH);
+}
+
+void CompressResponse(Response& response, Encoding encoding,
+                      const CompressionSettings& settings,
+                      const std::shared_ptr<CompressionMetrics>& metrics_ptr) {
+    if (encoding == Encoding::Identity || !HasBody(response) || response.HasFileRange() ||
+        response.find(boost_http::field::content_encoding) != response.end()) {
+        return;
+    }
+    // the body depends on the request headers, caches have to know
+    response.set(boost_http::field::vary, "Accept-Encoding");
+
+    if (response.IsChunked()) {
+        CompressChunks(response, encoding, settings, metrics_ptr);
+        return;
+    }
+    if (response.body().size() < settings.min_size) {
+        return;
+    }
+    CompressBody(response, encoding, settings, *metrics_ptr);
+}
+
+} // namespace http::compression
@@ -0,0 +1,153 @@
+#include <http/include/conditional.hpp>
+
+#include <time.h>
+
+#include <ctime>
+#include <iomanip>
+#include <locale>
+#include <sstream>
+
+#include <common/include/format.hpp>
+
+namespace http::conditional {
+
+namespace {
+
+namespace boost_http = boost::beast::http;
+
+constexpr std::string_view kHttpDateFormat = "%a, %d %b %Y %H:%M:%S GMT";
+constexpr std::string_view kWeakPrefix = "W/";
+
+std::string_view ToStringView(boost::beast::string_view value) {
+    return std::string_view(value.data(), value.size());
+}
+
+/// @brief Strips the weak prefix, so the tags are compared weakly.
+std::string_view ToOpaqueTag(std::string_view etag) {
+    if (etag.substr(0, kWeakPrefix.size()) == kWeakPrefix) {
+        etag.remove_prefix(kWeakPrefix.size());
+    }
+    return etag;
+}
+
+/// @brief Checks the If-None-Match list of the entity tags against
+/// the current one. The opaque tags may contain commas, so the list
+/// is split by the quotes.
+bool IsETagMatched(std::string_view if_none_match, std::string_view etag) {
+    const auto current = ToOpaqueTag(etag);
+    while (!if_none_match.empty()) {
+        const auto begin = if_none_match.find_first_not_of(" \t,");
+        if (begin == std::string_view::npos) {
+            break;
+        }
+        if_none_match.remove_prefix(begin);
+        if (if_none_match.front() == '*') {
+            return true;
+        }
+        const auto quote = if_none_match.find('"');
+        const auto end = quote == std::string_view::npos ?
+            std::string_view::npos : if_none_match.find('"', quote + 1);
+        if (end == std::string_view::npos) {
+            // a broken list matches nothing
+            return false;
+        }
+        if (ToOpaqueTag(if_none_match.substr(0, end + 1)) == current) {
+            return true;
+        }
+        if_none_match.remove_prefix(end + 1);
+    }
+    return false;
+}
+
+} // namespace
+
+std::string MakeETag(std::string_view tag, bool is_weak) {
+    return common::format::Format("{}\"{}\"", is_weak ? kWeakPrefix : std::string_view{}, tag);
+}
+
+std::string ToHttpDate(TimePoint time) {
+    return common::format::TimePointToString(time, kHttpDateFormat);
+}
+
+std::optional<TimePoint> ParseHttpDate(std::string_view value) {
+    std::istringstream stream{std::string(value)};
+    // the day and month names are English whatever the locale is
+    stream.imbue(std::locale::classic());
+    std::tm time{};
+    stream >> std::get_time(&time, kHttpDateFormat.data());
+    if (stream.fail()) {
+        return std::nullopt;
+    }
+    const auto raw_time = timegm(&time);
+    if (raw_time == -1) {
+        return std::nullopt;
+    }
+    return std::chrono::system_clock::from_time_t(raw_time);
+}
+
+bool IsNotModified(const RequestHeader& request, const Validators& validators) {
+    if (request.method() != Method::get && request.method() != Method::head) {
+        return false;
+    }
+
+    const auto [if_none_match_begin, if_none_match_end] =
+        request.equal_range(boost_http::field::if_none_match);
+    if (if_none_match_begin != if_none_match_end) {
+        if (!validators.etag.has_value()) {
+            return false;
+        }
+        for (auto it = if_none_match_begin; it != if_none_match_end; it++) {
+            if (IsETagMatched(ToStringView(it->value()), validators.etag.value())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const auto if_modified_since_it = request.find(boost_http::field::if_modified_since);
+    if (if_modified_since_it == request.end() || !validators.last_modified.has_value()) {
+        return false;
+    }
+    const auto since_opt = ParseHttpDate(ToStringView(if_modified_since_it->value()));
+    if (!since_opt.has_value()) {
+        return false;
+    }
+    const auto last_modified = std::chrono::floor<std::chrono::seconds>(
+        validators.last_modified.value());
+    return last_modified <= since_opt.value();
+}
+
+void SetValidators(Response& response, const Validators& validators) {
+    if (validators.etag.has_value()) {
+        response.set(boost_http::field::etag, validators.etag.value());
+    }
+    if (validators.last_modified.has_value()) {
+        response.set(boost_http::field::last_modified,
+                     ToHttpDate(validators.last_modified.value()));
+    }
+}
+
+Response NotModifiedResponse(unsigned version, const Validators& validators) {
+    Response response{Status::not_modified, version};
+    SetValidators(response, validators);
+    return response;
+}
+
+HttpHandler MakeConditionalHandler(const ValidatorsProvider& provider,
+                                   const HttpHandler& handler) {
+    return [provider, handler](Request&& request) {
+        // the resource may change until the handler reads it, then the
+        // validators are outdated and the next request is not matched
+        const auto validators = provider(request);
+        if (IsNotModified(request, validators)) {
+            return NotModifiedResponse(request.version(), validators);
+        }
+        auto response = handler(std::move(request));
+        if (response.result_int() / 100 == 2) {
+            SetValidators(response, validators);
+        }
+        return response;
+    };
+}
+
+} // namespace http::conditional
@@ -0,0 +1,21 @@
+#include <http/include/default_handlers.hpp>
+
+#include <common/include/json.hpp>
+#include <http/include/exceptions.hpp>
+
+namespace http::handlers {
+
+HttpHandler MakeCompressionStatsHandler(std::weak_ptr<const server::HttpServer> server_ptr) {
+    return [server_ptr](Request&&) {
+        const auto locked_server_ptr = server_ptr.lock();
+        if (locked_server_ptr == nullptr) {
+            throw exceptions::ServiceUnavailable("Server is stopped");
+        }
+        common::json::json data = locked_server_ptr->GetCompressionStats();
+        http::Response response{};
+        response.body() = data.dump();
+        return response;
+    };
+}
+
+} // namespace http::handlers
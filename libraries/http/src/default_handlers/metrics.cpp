@@ -0,0 +1,20 @@
+#include <http/include/default_handlers.hpp>
+
+#include <common/include/metrics.hpp>
+
+namespace http::handlers {
+
+namespace {
+
+constexpr boost::beast::string_view kExpositionContentType = "text/plain; version=0.0.4";
+
+} // namespace
+
+Response handle_metrics(Request&&) {
+    http::Response response{};
+    response.set(boost::beast::http::field::content_type, kExpositionContentType);
+    response.body() = common::metrics::Registry::GetInstance().Render();
+    return response;
+}
+
+} // namespace http::handlers
@@ -0,0 +1,387 @@
+#include "balanced_client.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <stdexcept>
+
+#include <boost/asio/steady_timer.hpp>
+
+#include <common/include/format.hpp>
+#include <common/include/hdr_histogram.hpp>
+#include <common/include/logging.hpp>
+#include <http/include/utils.hpp>
+
+namespace http::client {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// latencies are tracked in microseconds from 1us up to a minute
+constexpr int64_t kMaxLatencyUs = 60 * 1000 * 1000;
+constexpr int kLatencyDigits = 2;
+
+/// @struct Request sent to one endpoint or to two of them if hedged.
+/// The first of the attempts to respond or the last one to fail completes it.
+struct Call {
+    Call(boost::asio::io_context& context, http::Request&& request, RequestCallback&& callback)
+        : request{std::move(request)}, callback{std::move(callback)}, hedge_timer{context},
+          mutex{}, pending_count{0}, is_done{false} {}
+
+    const http::Request request;
+    RequestCallback callback;
+    boost::asio::steady_timer hedge_timer;
+    std::mutex mutex;
+    size_t pending_count;
+    bool is_done;
+};
+
+} // namespace
+
+/// @struct State shared by the client and its requests in flight.
+struct BalancedClient::State {
+    struct EndpointState {
+        Endpoint endpoint{};
+        std::unique_ptr<HttpClient> client_ptr{};
+        size_t outstanding{};
+        size_t requests{};
+        size_t failures{};
+        size_t consecutive_failures{};
+        size_t ejections{};
+        size_t samples{};
+        double latency_ewma_us{};
+        std::optional<Clock::time_point> ejected_until{};
+    };
+
+    State(std::shared_ptr<boost::asio::io_context> context_ptr,
+          const std::vector<Endpoint>& endpoints, const BalancerSettings& settings)
+        : settings{settings}, context{*context_ptr}, mutex{}, endpoints{},
+          random{std::random_device{}()}, next_index{0},
+          latency_histogram{1, kMaxLatencyUs, kLatencyDigits},
+          hedge_delay{}, hedges{0}, hedge_wins{0} {
+        if (endpoints.empty()) {
+            throw std::invalid_argument("No endpoints to balance");
+        }
+        for (const auto& endpoint : endpoints) {
+            auto& state = this->endpoints.emplace_back();
+            state.endpoint = endpoint;
+            state.client_ptr = std::make_unique<HttpClient>(
+                context_ptr, endpoint.host, endpoint.port, settings.client);
+        }
+    }
+
+    /// @brief Chooses the endpoint and counts the request in flight.
+    /// @returns index of the endpoint or std::nullopt if there are no
+    /// endpoints available except for the excluded one
+    std::optional<size_t> Select(std::optional<size_t> excluded_index) {
+        std::lock_guard lock(mutex);
+        const auto now = Clock::now();
+        std::vector<size_t> candidates{};
+        candidates.reserve(endpoints.size());
+        for (size_t i = 0; i < endpoints.size(); i++) {
+            auto& endpoint = endpoints[i];
+            if (endpoint.ejected_until.has_value() && endpoint.ejected_until.value() <= now) {
+                Readmit(i);
+            }
+            if (!endpoint.ejected_until.has_value() && excluded_index != i) {
+                candidates.push_back(i);
+            }
+        }
+        if (candidates.empty()) {
+            return std::nullopt;
+        }
+
+        size_t chosen_index = candidates.front();
+        if (settings.balancing == Balancing::LeastOutstanding) {
+            // the candidates are scanned from the next one in turn,
+            // so the ties are broken round-robin
+            const auto start = std::lower_bound(candidates.begin(), candidates.end(),
+                                                next_index % endpoints.size());
+            std::rotate(candidates.begin(), start, candidates.end());
+            for (const auto index : candidates) {
+                if (endpoints[index].outstanding < endpoints[chosen_index].outstanding) {
+                    chosen_index = index;
+                }
+            }
+            chosen_index = *std::find_if(candidates.begin(), candidates.end(),
+                [this, chosen_index](size_t index) {
+                    return endpoints[index].outstanding == endpoints[chosen_index].outstanding;
+                });
+            next_index = chosen_index + 1;
+        } else if (candidates.size() > 1) {
+            std::uniform_int_distribution<size_t> distribution(0, candidates.size() - 1);
+            const auto first = distribution(random);
+            auto second = distribution(random);
+            while (second == first) {
+                second = distribution(random);
+            }
+            chosen_index = GetCost(candidates[second]) < GetCost(candidates[first]) ?
+                candidates[second] : candidates[first];
+        }
+
+        auto& chosen = endpoints[chosen_index];
+        chosen.outstanding++;
+        chosen.requests++;
+        return chosen_index;
+    }
+
+    void OnResponse(size_t index, Clock::duration latency, bool is_failure) {
+        std::lock_guard lock(mutex);
+        auto& endpoint = endpoints[index];
+        endpoint.outstanding--;
+        if (is_failure) {
+            endpoint.failures++;
+            endpoint.consecutive_failures++;
+            if (endpoint.consecutive_failures >= settings.ejection_failures) {
+                TryEject(index, "consecutive failures");
+            }
+            return;
+        }
+
+        const auto latency_us = std::chrono::duration_cast<std::chrono::microseconds>(latency);
+        endpoint.consecutive_failures = 0;
+        endpoint.latency_ewma_us = endpoint.samples == 0 ?
+            static_cast<double>(latency_us.count()) :
+            settings.ewma_smoothing * latency_us.count() +
+                (1.0 - settings.ewma_smoothing) * endpoint.latency_ewma_us;
+        endpoint.samples++;
+
+        latency_histogram.Record(latency_us.count());
+        if (latency_histogram.GetTotalCount() >= settings.hedge_window_size) {
+            hedge_delay = std::max<std::chrono::microseconds>(
+                settings.min_hedge_delay, std::chrono::microseconds(
+                    latency_histogram.GetValueAtPercentile(settings.hedge_percentile)));
+            latency_histogram.Reset();
+        }
+
+        if (endpoint.samples >= settings.ejection_min_samples) {
+            const auto median_us = GetMedianLatency(index);
+            if (median_us.has_value() &&
+                    endpoint.latency_ewma_us > settings.ejection_latency_factor * median_us.value()) {
+                TryEject(index, "latency");
+            }
+        }
+    }
+
+    std::optional<std::chrono::microseconds> GetHedgeDelay() const {
+        std::lock_guard lock(mutex);
+        return endpoints.size() > 1 ? hedge_delay : std::nullopt;
+    }
+
+    void OnHedged(bool is_won) {
+        std::lock_guard lock(mutex);
+        if (is_won) {
+            hedge_wins++;
+        } else {
+            hedges++;
+        }
+    }
+
+    BalancerStats GetStats() const {
+        std::lock_guard lock(mutex);
+        BalancerStats stats{
+            hedges,                                 // hedges
+            hedge_wins,                             // hedge_wins
+            hedge_delay.value_or(std::chrono::microseconds::zero()),  // hedge_delay
+            {},                                     // endpoints
+        };
+        for (const auto& endpoint : endpoints) {
+            stats.endpoints.push_back(EndpointStats{
+                endpoint.endpoint,                      // endpoint
+                endpoint.outstanding,                   // outstanding
+                endpoint.requests,                      // requests
+                endpoint.failures,                      // failures
+                endpoint.ejections,                     // ejections
+                endpoint.latency_ewma_us / 1000.0,      // latency_ewma_ms
+                endpoint.ejected_until.has_value(),     // is_ejected
+            });
+        }
+        return stats;
+    }
+
+    /// @brief Sends an attempt of the call to the endpoint chosen by Select.
+    static void Send(const std::shared_ptr<State>& state_ptr, const std::shared_ptr<Call>& call_ptr,
+                     size_t index, bool is_hedge) {
+        {
+            std::lock_guard lock(call_ptr->mutex);
+            call_ptr->pending_count++;
+        }
+        const auto started_at = Clock::now();
+        state_ptr->endpoints[index].client_ptr->AsyncRequest(call_ptr->request,
+            [state_ptr, call_ptr, index, is_hedge, started_at](
+                    std::exception_ptr error_ptr, Response&& response) {
+                const auto is_failure = error_ptr != nullptr || response.result_int() >= 500;
+                state_ptr->OnResponse(index, Clock::now() - started_at, is_failure);
+                {
+                    std::lock_guard lock(call_ptr->mutex);
+                    call_ptr->pending_count--;
+                    // an error waits for the other attempt
+                    if (call_ptr->is_done || (error_ptr != nullptr && call_ptr->pending_count > 0)) {
+                        return;
+                    }
+                    call_ptr->is_done = true;
+                    call_ptr->hedge_timer.cancel();
+                }
+                if (is_hedge && error_ptr == nullptr) {
+                    state_ptr->OnHedged(true);
+                }
+                call_ptr->callback(error_ptr, std::move(response));
+            });
+    }
+
+    const BalancerSettings settings;
+    boost::asio::io_context& context;
+    mutable std::mutex mutex;
+    std::vector<EndpointState> endpoints;
+    std::mt19937 random;
+    size_t next_index;
+    // latencies of the current hedge window of all of the endpoints
+    common::metrics::HdrHistogram latency_histogram;
+    std::optional<std::chrono::microseconds> hedge_delay;
+    size_t hedges;
+    size_t hedge_wins;
+
+private:
+    /// @brief Cost of an endpoint for the power of two choices,
+    /// an endpoint with no latency samples yet is preferred.
+    double GetCost(size_t index) const {
+        const auto& endpoint = endpoints[index];
+        return endpoint.latency_ewma_us * (endpoint.outstanding + 1);
+    }
+
+    /// @returns median latency EWMA of the available endpoints except for the one
+    std::optional<double> GetMedianLatency(size_t excluded_index) const {
+        std::vector<double> latencies{};
+        for (size_t i = 0; i < endpoints.size(); i++) {
+            const auto& endpoint = endpoints[i];
+            if (i != excluded_index && !endpoint.ejected_until.has_value() && endpoint.samples > 0) {
+                latencies.push_back(endpoint.latency_ewma_us);
+            }
+        }
+        if (latencies.empty()) {
+            return std::nullopt;
+        }
+        const auto middle = latencies.begin() + latencies.size() / 2;
+        std::nth_element(latencies.begin(), middle, latencies.end());
+        return *middle;
+    }
+
+    void TryEject(size_t index, std::string_view reason) {
+        auto& endpoint = endpoints[index];
+        if (endpoint.ejected_until.has_value()) {
+            return;
+        }
+        const auto ejected_count = std::count_if(endpoints.begin(), endpoints.end(),
+            [](const EndpointState& state) { return state.ejected_until.has_value(); });
+        const auto max_ejected_count = std::min<size_t>(
+            endpoints.size() - 1,
+            static_cast<size_t>(std::floor(settings.max_ejected_share * endpoints.size())));
+        if (static_cast<size_t>(ejected_count) >= max_ejected_count) {
+            return;
+        }
+
+        LOG_WARNING() << common::format::Format("Endpoint {}:{} is ejected for {}ms: {}",
+            endpoint.endpoint.host, endpoint.endpoint.port,
+            settings.ejection_time.count(), reason);
+        endpoint.ejected_until = Clock::now() + settings.ejection_time;
+        endpoint.ejections++;
+    }
+
+    /// @brief Returns the endpoint with the latency of a typical one,
+    /// so the stale EWMA does not eject it right away.
+    void Readmit(size_t index) {
+        auto& endpoint = endpoints[index];
+        LOG_INFO() << common::format::Format("Endpoint {}:{} is readmitted",
+            endpoint.endpoint.host, endpoint.endpoint.port);
+        endpoint.ejected_until.reset();
+        endpoint.consecutive_failures = 0;
+        endpoint.samples = 0;
+        endpoint.latency_ewma_us = GetMedianLatency(index).value_or(0.0);
+    }
+};
+
+BalancedClient::BalancedClient(const std::vector<Endpoint>& endpoints,
+                               const BalancerSettings& settings)
+    : BalancedClient(std::make_shared<boost::asio::io_context>(1), endpoints, settings) {
+    work_guard_ptr_ = std::make_unique<WorkGuard>(context_ptr_->get_executor());
+    context_thread_ = std::thread([context_ptr = context_ptr_] { context_ptr->run(); });
+}
+
+BalancedClient::BalancedClient(std::shared_ptr<boost::asio::io_context> context_ptr,
+                               const std::vector<Endpoint>& endpoints,
+                               const BalancerSettings& settings)
+    : context_ptr_{context_ptr},
+      state_ptr_{std::make_shared<State>(context_ptr, endpoints, settings)},
+      work_guard_ptr_{}, context_thread_{} {}
+
+BalancedClient::~BalancedClient() {
+    if (context_thread_.joinable()) {
+        work_guard_ptr_.reset();
+        context_ptr_->stop();
+        context_thread_.join();
+    }
+    // the clients are bound to the context
+    state_ptr_.reset();
+}
+
+Response BalancedClient::Request(const http::Request& request) {
+    if (context_ptr_->get_executor().running_in_this_thread()) {
+        throw std::logic_error("Blocking request from a thread of the client context");
+    }
+    return AsyncRequest(request).get();
+}
+
+void BalancedClient::AsyncRequest(http::Request request, RequestCallback&& callback) {
+    const auto index = state_ptr_->Select(std::nullopt);
+    auto call_ptr = std::make_shared<Call>(*context_ptr_, std::move(request), std::move(callback));
+
+    const auto hedge_delay = state_ptr_->settings.hedging &&
+        http::utils::IsIdempotent(call_ptr->request.method()) ?
+            state_ptr_->GetHedgeDelay() : std::nullopt;
+    if (hedge_delay.has_value()) {
+        // the timer is set up ahead of the first attempt, which may cancel it
+        call_ptr->hedge_timer.expires_after(hedge_delay.value());
+        call_ptr->hedge_timer.async_wait(
+            [state_ptr = state_ptr_, call_ptr, index](const boost::system::error_code& error_code) {
+                if (error_code) {
+                    return;
+                }
+                {
+                    std::lock_guard lock(call_ptr->mutex);
+                    if (call_ptr->is_done) {
+                        return;
+                    }
+                }
+                const auto hedge_index = state_ptr->Select(index);
+                if (!hedge_index.has_value()) {
+                    return;
+                }
+                state_ptr->OnHedged(false);
+                State::Send(state_ptr, call_ptr, hedge_index.value(), true);
+            });
+    }
+    State::Send(state_ptr_, call_ptr, index.value(), false);
+}
+
+std::future<Response> BalancedClient::AsyncRequest(http::Request request) {
+    auto promise_ptr = std::make_shared<std::promise<Response>>();
+    auto future = promise_ptr->get_future();
+    AsyncRequest(std::move(request),
+        [promise_ptr](std::exception_ptr error_ptr, Response&& response) {
+            if (error_ptr != nullptr) {
+                promise_ptr->set_exception(error_ptr);
+            } else {
+                promise_ptr->set_value(std::move(response));
+            }
+        });
+    return future;
+}
+
+BalancerStats BalancedClient::GetStats() const {
+    return state_ptr_->GetStats();
+}
+
+} // namespace http::client
@@ -0,0 +1,121 @@
+#include "connection_pool.hpp"
+
+#include <poll.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace http::client {
+
+Connection::Connection(boost::asio::io_context& context)
+    : stream{context}, buffer{}, idle_since{} {}
+
+ConnectionPool::ConnectionPool(const ClientSettings& settings)
+    : settings_{settings}, mutex_{}, pending_callbacks_{}, idle_connections_{},
+      active_count_{0}, connects_count_{0}, reuses_count_{0} {}
+
+ConnectionPool::~ConnectionPool() {}
+
+void ConnectionPool::Acquire(AcquireCallback&& callback) {
+    {
+        std::lock_guard lock(mutex_);
+        if (active_count_ >= settings_.max_connections) {
+            pending_callbacks_.push_back(std::move(callback));
+            return;
+        }
+        active_count_++;
+    }
+    callback(TakeIdleConnection());
+}
+
+void ConnectionPool::Release(ConnectionPtr&& connection_ptr) {
+    ConnectionPtr dropped_ptr{};
+    AcquireCallback pending_callback{};
+    {
+        std::lock_guard lock(mutex_);
+        if (connection_ptr != nullptr &&
+                idle_connections_.size() < settings_.max_idle_connections) {
+            connection_ptr->idle_since = Connection::Clock::now();
+            idle_connections_.push_back(std::move(connection_ptr));
+        } else {
+            dropped_ptr = std::move(connection_ptr);
+        }
+
+        if (pending_callbacks_.empty()) {
+            active_count_--;
+        } else {
+            // the slot is passed as is
+            pending_callback = std::move(pending_callbacks_.front());
+            pending_callbacks_.pop_front();
+        }
+    }
+    if (pending_callback) {
+        pending_callback(TakeIdleConnection());
+    }
+}
+
+ConnectionPtr ConnectionPool::TakeIdleConnection() {
+    std::vector<ConnectionPtr> expired_connections{};
+    ConnectionPtr connection_ptr{};
+    {
+        std::lock_guard lock(mutex_);
+        const auto expired_at = Connection::Clock::now() - settings_.idle_timeout;
+        const auto expired_end = std::find_if(
+            idle_connections_.begin(), idle_connections_.end(),
+            [expired_at](const ConnectionPtr& idle_ptr) {
+                return idle_ptr->idle_since > expired_at;
+            });
+        std::move(idle_connections_.begin(), expired_end,
+                  std::back_inserter(expired_connections));
+        idle_connections_.erase(idle_connections_.begin(), expired_end);
+
+        if (!idle_connections_.empty()) {
+            connection_ptr = std::move(idle_connections_.back());
+            idle_connections_.pop_back();
+        }
+    }
+
+    // the expired connections are closed out of the lock
+    expired_connections.clear();
+    while (connection_ptr != nullptr && !IsHealthy(*connection_ptr)) {
+        connection_ptr.reset();
+        std::lock_guard lock(mutex_);
+        if (!idle_connections_.empty()) {
+            connection_ptr = std::move(idle_connections_.back());
+            idle_connections_.pop_back();
+        }
+    }
+    if (connection_ptr != nullptr) {
+        std::lock_guard lock(mutex_);
+        reuses_count_++;
+    }
+    return connection_ptr;
+}
+
+void ConnectionPool::OnConnected() {
+    std::lock_guard lock(mutex_);
+    connects_count_++;
+}
+
+PoolStats ConnectionPool::GetStats() const {
+    std::lock_guard lock(mutex_);
+    return PoolStats{
+        connects_count_,            // connects
+        reuses_count_,              // reuses
+        active_count_,              // active
+        idle_connections_.size(),   // idle
+    };
+}
+
+bool ConnectionPool::IsHealthy(Connection& connection) {
+    auto& socket = connection.stream.socket();
+    if (!socket.is_open()) {
+        return false;
+    }
+    // an idle connection is not expected to get anything, so a readable
+    // socket is either closed by the server or out of the protocol sync
+    pollfd descriptor{socket.native_handle(), POLLIN | POLLRDHUP, 0};
+    return ::poll(&descriptor, 1, 0) == 0 && connection.buffer.size() == 0;
+}
+
+} // namespace http::client
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/core/noncopyable.hpp>
+
+#include <http/include/http_client.hpp>
+
+namespace http::client {
+
+/// @struct Keep-alive connection to the client host along with
+/// the read buffer, which may hold the bytes of the next response.
+struct Connection {
+    using Clock = std::chrono::steady_clock;
+
+    explicit Connection(boost::asio::io_context& context);
+
+    boost::beast::tcp_stream stream;
+    boost::beast::flat_buffer buffer;
+    Clock::time_point idle_since;
+};
+
+using ConnectionPtr = std::unique_ptr<Connection>;
+using AcquireCallback = std::function<void(ConnectionPtr&&)>;
+
+/**
+ * @class Thread-safe pool of the connections to a single host. A request
+ * takes a slot of max_connections along with an idle connection if there
+ * is a healthy one, otherwise it opens a new connection in the slot.
+ * The requests over the limit are queued and take the slots in order
+ * as they are released. The most recently used connections are reused
+ * first, so the rest of them expire by the idle timeout while the load
+ * is low.
+ */
+class ConnectionPool : private boost::noncopyable {
+public:
+    explicit ConnectionPool(const ClientSettings& settings);
+    ~ConnectionPool();
+
+    /// @brief Takes a slot and invokes the callback with an idle connection
+    /// or nullptr if a new one is to be opened. If all of the slots are taken
+    /// the callback is queued and invoked by the Release of one of them.
+    void Acquire(AcquireCallback&& callback);
+
+    /// @brief Releases the slot or passes it to the first queued callback.
+    /// The connection is kept for reuse if it is specified and the idle
+    /// connections limit allows.
+    void Release(ConnectionPtr&& connection_ptr);
+
+    /// @brief Counts a new connection opened in a slot.
+    void OnConnected();
+
+    PoolStats GetStats() const;
+
+private:
+    /// @brief Takes the most recently used healthy connection
+    /// and drops the expired ones.
+    ConnectionPtr TakeIdleConnection();
+
+    /// @brief Checks an idle connection was not closed by the server.
+    static bool IsHealthy(Connection& connection);
+
+    const ClientSettings settings_;
+    mutable std::mutex mutex_;
+    std::deque<AcquireCallback> pending_callbacks_;
+    // ordered by the idle time, the most recently used one is the last
+    std::vector<ConnectionPtr> idle_connections_;
+    size_t active_count_;
+    size_t connects_count_;
+    size_t reuses_count_;
+};
+
+} // namespace http::client
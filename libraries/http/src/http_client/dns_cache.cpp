@@ -0,0 +1,178 @@
+#include "dns_cache.hpp"
+
+#include <future>
+#include <stdexcept>
+
+#include <common/include/format.hpp>
+#include <common/include/logging.hpp>
+
+namespace http::client {
+
+namespace {
+
+std::string MakeKey(const std::string& host, const std::string& port) {
+    return host + ':' + port;
+}
+
+} // namespace
+
+Endpoints SystemResolve(const std::string& host, const std::string& port) {
+    boost::asio::io_context context{};
+    boost::asio::ip::tcp::resolver resolver(context);
+    try {
+        Endpoints endpoints{};
+        for (const auto& entry : resolver.resolve(host, port)) {
+            endpoints.push_back(entry.endpoint());
+        }
+        return endpoints;
+    } catch (const boost::system::system_error& ex) {
+        LOG_DEBUG() << ex.what();
+        throw std::runtime_error(common::format::Format(
+            "Cannot resolve host \'{}\': {}", host, ex.what()));
+    }
+}
+
+DnsCache& DnsCache::GetInstance() {
+    static DnsCache cache{};
+    return cache;
+}
+
+DnsCache::DnsCache(const DnsCacheSettings& settings, ResolveFunction resolve)
+    : settings_{settings}, resolve_{std::move(resolve)}, mutex_{}, entries_{}, stats_{},
+      resolver_pool_{settings.resolver_threads, settings.max_queue_size} {
+    resolver_pool_.Run();
+}
+
+DnsCache::~DnsCache() {
+    resolver_pool_.Stop();
+}
+
+void DnsCache::Resolve(const std::string& host, const std::string& port, Callback&& callback) {
+    Endpoints endpoints{};
+    std::exception_ptr error_ptr{};
+    std::vector<Callback> failed_callbacks{};
+    {
+        std::lock_guard lock(mutex_);
+        auto& entry = entries_[MakeKey(host, port)];
+        const auto now = Clock::now();
+        if (now < entry.expires_at) {
+            stats_.hits++;
+            endpoints = entry.endpoints;
+            error_ptr = entry.error_ptr;
+        } else if (now < entry.stale_until && !entry.endpoints.empty()) {
+            stats_.stale_hits++;
+            endpoints = entry.endpoints;
+            if (!entry.is_resolving && !StartResolution(host, port, entry)) {
+                LOG_WARNING() << common::format::Format(
+                    "Refresh of the host \'{}\' is skipped: resolver queue is full", host);
+            }
+        } else {
+            stats_.misses++;
+            entry.callbacks.push_back(std::move(callback));
+            if (entry.is_resolving || StartResolution(host, port, entry)) {
+                return;
+            }
+            error_ptr = std::make_exception_ptr(std::runtime_error(common::format::Format(
+                "Cannot resolve host \'{}\': resolver queue is full", host)));
+            failed_callbacks = std::move(entry.callbacks);
+            entry.callbacks.clear();
+        }
+    }
+
+    if (!failed_callbacks.empty()) {
+        for (auto& failed_callback : failed_callbacks) {
+            failed_callback(error_ptr, endpoints);
+        }
+        return;
+    }
+    callback(error_ptr, endpoints);
+}
+
+Endpoints DnsCache::Resolve(const std::string& host, const std::string& port) {
+    std::promise<Endpoints> promise{};
+    auto future = promise.get_future();
+    Resolve(host, port, [&promise](std::exception_ptr error_ptr, const Endpoints& endpoints) {
+        if (error_ptr != nullptr) {
+            promise.set_exception(error_ptr);
+        } else {
+            promise.set_value(endpoints);
+        }
+    });
+    return future.get();
+}
+
+void DnsCache::Clear() {
+    std::lock_guard lock(mutex_);
+    // the pending callbacks are left to the resolutions in flight
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second.is_resolving) {
+            it->second.endpoints.clear();
+            it->second.stale_until = it->second.expires_at = Clock::time_point{};
+            it++;
+        } else {
+            it = entries_.erase(it);
+        }
+    }
+}
+
+DnsCacheStats DnsCache::GetStats() const {
+    std::lock_guard lock(mutex_);
+    return stats_;
+}
+
+bool DnsCache::StartResolution(const std::string& host, const std::string& port, Entry& entry) {
+    entry.is_resolving = true;
+    const auto is_posted = resolver_pool_.TryPost([this, host, port] {
+        Endpoints endpoints{};
+        std::exception_ptr error_ptr{};
+        try {
+            endpoints = resolve_(host, port);
+        } catch (const std::exception&) {
+            error_ptr = std::current_exception();
+        }
+        OnResolved(host, port, std::move(endpoints), error_ptr);
+    });
+    entry.is_resolving = is_posted;
+    return is_posted;
+}
+
+void DnsCache::OnResolved(const std::string& host, const std::string& port,
+                          Endpoints&& endpoints, std::exception_ptr error_ptr) {
+    std::vector<Callback> callbacks{};
+    {
+        std::lock_guard lock(mutex_);
+        auto& entry = entries_[MakeKey(host, port)];
+        const auto now = Clock::now();
+        entry.is_resolving = false;
+        callbacks = std::move(entry.callbacks);
+        entry.callbacks.clear();
+        stats_.resolutions++;
+
+        if (error_ptr == nullptr) {
+            entry.endpoints = std::move(endpoints);
+            entry.error_ptr = nullptr;
+            entry.expires_at = now + settings_.ttl;
+            entry.stale_until = entry.expires_at + settings_.max_stale;
+        } else {
+            stats_.failures++;
+            entry.expires_at = now + settings_.negative_ttl;
+            if (now < entry.stale_until && !entry.endpoints.empty()) {
+                // the stale addresses are kept, the refresh is retried later
+                LOG_WARNING() << common::format::Format(
+                    "Refresh of the host \'{}\' failed, the stale addresses are kept", host);
+            } else {
+                entry.endpoints.clear();
+                entry.error_ptr = error_ptr;
+                entry.stale_until = entry.expires_at;
+            }
+        }
+        endpoints = entry.endpoints;
+        error_ptr = entry.error_ptr;
+    }
+
+    for (auto& callback : callbacks) {
+        callback(error_ptr, endpoints);
+    }
+}
+
+} // namespace http::client
@@ -1,40 +1,325 @@
 #include "http_client.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+
 #include <boost/asio/connect.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
 
 #include <common/include/format.hpp>
 #include <common/include/logging.hpp>
+#include <http/include/consts.hpp>
+#include <http/include/dns_cache.hpp>
 #include <http/include/utils.hpp>
 
+#include <http_client/connection_pool.hpp>
+
 namespace http::client {
 
+/// @class Liveness of the client context for the callbacks invoked by the
+/// resolver threads. The context is not destroyed while the lock is held.
+class ContextGuard {
+public:
+    ContextGuard() : mutex_{}, is_alive_{true} {}
+
+    /// @brief Invokes the function unless the context is gone.
+    template<typename Function>
+    void Run(Function&& function) {
+        std::lock_guard lock(mutex_);
+        if (is_alive_) {
+            function();
+        }
+    }
+
+    void Reset() {
+        std::lock_guard lock(mutex_);
+        is_alive_ = false;
+    }
+
+private:
+    std::mutex mutex_;
+    bool is_alive_;
+};
+
 namespace {
 
-auto ResolveHost(boost::asio::io_context& context,
-                 const std::string& host, const std::string& port) {
-    boost::asio::ip::tcp::resolver resolver(context);
-    try {
-        return resolver.resolve(host, port);
-    } catch (const boost::system::system_error& ex) {
-        LOG_DEBUG() << ex.what();
-        throw std::runtime_error(common::format::Format(
-            "Cannot resolve host \'{}\': {}", host, ex.what()));
+/// @class Asynchronous request owned by its pending handlers. Takes a slot
+/// of the pool, reuses the idle connection or opens a new one, exchanges
+/// the messages and returns the slot before the callback is invoked.
+/// Every phase is limited by the deadline, the handlers are serialized
+/// by a strand, so the deadline timer never races with them.
+class RequestOperation : public std::enable_shared_from_this<RequestOperation> {
+public:
+    using Clock = http::Request::Clock;
+
+    RequestOperation(boost::asio::io_context& context,
+                     std::shared_ptr<ContextGuard> context_guard_ptr,
+                     std::shared_ptr<ConnectionPool> pool_ptr,
+                     std::shared_ptr<DnsCache> dns_cache_ptr,
+                     const std::string& host, const std::string& port,
+                     std::chrono::milliseconds timeout,
+                     http::Request&& request, RequestCallback&& callback)
+        : context_{context}, context_guard_ptr_{std::move(context_guard_ptr)},
+          strand_{boost::asio::make_strand(context)},
+          deadline_timer_{strand_}, pool_ptr_{std::move(pool_ptr)},
+          dns_cache_ptr_{std::move(dns_cache_ptr)},
+          host_{host}, port_{port}, request_{std::move(request)},
+          response_{}, callback_{std::move(callback)},
+          connection_ptr_{}, deadline_{Clock::now() + timeout},
+          phase_{Phase::Acquiring}, has_slot_{false}, is_reused_{false} {
+        const auto& request_deadline = request_.GetDeadline();
+        if (request_deadline.has_value() && request_deadline.value() < deadline_) {
+            deadline_ = request_deadline.value();
+        }
+    }
+
+    void Start() {
+        LOG_DEBUG() << common::format::Format(
+            "Requesting {} {}:{}{}\n{}", http::utils::ToString(request_.method()),
+            host_, port_, request_.target().to_string(), request_.body());
+
+        deadline_timer_.expires_at(deadline_);
+        deadline_timer_.async_wait(
+            [self = shared_from_this()](const boost::system::error_code& error_code) {
+                if (!error_code) {
+                    self->OnDeadline();
+                }
+            });
+
+        pool_ptr_->Acquire([self = shared_from_this()](ConnectionPtr&& connection_ptr) {
+            // the slot may be passed by the completion of another request
+            boost::asio::post(self->strand_,
+                [self, connection_ptr = std::move(connection_ptr)]() mutable {
+                    self->OnAcquired(std::move(connection_ptr));
+                });
+        });
+    }
+
+private:
+    enum class Phase {
+        Acquiring,
+        Resolving,
+        Exchanging,
+        Finished,
+    };
+
+    void OnAcquired(ConnectionPtr&& connection_ptr) {
+        if (phase_ == Phase::Finished) {
+            // the deadline has passed while waiting for the slot
+            pool_ptr_->Release(std::move(connection_ptr));
+            return;
+        }
+        has_slot_ = true;
+        connection_ptr_ = std::move(connection_ptr);
+        if (connection_ptr_ != nullptr) {
+            is_reused_ = true;
+            Write();
+        } else {
+            Connect();
+        }
+    }
+
+    void Connect() {
+        phase_ = Phase::Resolving;
+        // Invoked in place or by a resolver thread, which may outlive the client
+        // and its context. The operation is kept alive by the deadline wait
+        // meanwhile, so it is released within the context only.
+        dns_cache_ptr_->Resolve(host_, port_,
+            [weak_ptr = weak_from_this(), context_guard_ptr = context_guard_ptr_](
+                    std::exception_ptr error_ptr, const Endpoints& endpoints) {
+                context_guard_ptr->Run([&weak_ptr, &error_ptr, &endpoints] {
+                    auto self = weak_ptr.lock();
+                    if (self == nullptr) {
+                        return;
+                    }
+                    boost::asio::post(self->strand_, [self, error_ptr, endpoints] {
+                        if (self->phase_ != Phase::Resolving) {
+                            return;
+                        }
+                        if (error_ptr != nullptr) {
+                            self->Finish(error_ptr);
+                            return;
+                        }
+                        self->OnResolved(endpoints);
+                    });
+                });
+            });
+    }
+
+    void OnResolved(const Endpoints& endpoints) {
+        LOG_TRACE() << common::format::Format("Connecting to the host {}", host_);
+        phase_ = Phase::Exchanging;
+        connection_ptr_ = std::make_unique<Connection>(context_);
+        connection_ptr_->stream.expires_at(deadline_);
+        connection_ptr_->stream.async_connect(endpoints, boost::asio::bind_executor(strand_,
+            [self = shared_from_this()](const boost::system::error_code& error_code,
+                                        const boost::asio::ip::tcp::endpoint&) {
+                if (error_code) {
+                    self->connection_ptr_.reset();
+                    self->Finish(std::make_exception_ptr(
+                        boost::system::system_error(error_code)));
+                    return;
+                }
+                boost::system::error_code ignored{};
+                self->connection_ptr_->stream.socket().set_option(
+                    boost::asio::ip::tcp::no_delay(true), ignored);
+                self->pool_ptr_->OnConnected();
+                self->Write();
+            }));
+    }
+
+    void Write() {
+        phase_ = Phase::Exchanging;
+        // the server drops the request once the caller stops waiting for it
+        const auto timeout = std::chrono::ceil<std::chrono::milliseconds>(deadline_ - Clock::now());
+        request_.set(consts::kTimeoutHeader, std::to_string(std::max<int64_t>(timeout.count(), 0)));
+
+        // the expiration applies to the both of the write and the read
+        connection_ptr_->stream.expires_at(deadline_);
+        boost::beast::http::async_write(connection_ptr_->stream, request_,
+            boost::asio::bind_executor(strand_,
+                [self = shared_from_this()](const boost::system::error_code& error_code, size_t) {
+                    if (error_code) {
+                        self->OnExchangeError(error_code);
+                        return;
+                    }
+                    self->Read();
+                }));
+    }
+
+    void Read() {
+        LOG_TRACE() << "Waiting for response...";
+        response_ = Response{};
+        boost::beast::http::async_read(connection_ptr_->stream, connection_ptr_->buffer, response_,
+            boost::asio::bind_executor(strand_,
+                [self = shared_from_this()](const boost::system::error_code& error_code, size_t) {
+                    if (error_code) {
+                        self->OnExchangeError(error_code);
+                        return;
+                    }
+                    self->Finish(nullptr);
+                }));
     }
-}
+
+    void OnExchangeError(const boost::system::error_code& error_code) {
+        connection_ptr_.reset();
+        // the server may close an idle connection right as it is reused
+        if (is_reused_ && http::utils::IsIdempotent(request_.method()) &&
+                error_code != boost::beast::error::timeout) {
+            LOG_DEBUG() << common::format::Format(
+                "Reused connection to {}:{} failed, retrying: {}",
+                host_, port_, error_code.message());
+            is_reused_ = false;
+            Connect();
+            return;
+        }
+        Finish(std::make_exception_ptr(boost::system::system_error(error_code)));
+    }
+
+    void OnDeadline() {
+        // the connection is expired by the stream itself
+        if (phase_ == Phase::Acquiring || phase_ == Phase::Resolving) {
+            LOG_DEBUG() << common::format::Format(
+                "Request to {}:{} timed out before the connection", host_, port_);
+            Finish(std::make_exception_ptr(
+                boost::system::system_error(boost::beast::error::timeout)));
+        }
+    }
+
+    void Finish(std::exception_ptr error_ptr) {
+        phase_ = Phase::Finished;
+        deadline_timer_.cancel();
+        if (connection_ptr_ != nullptr) {
+            if (!request_.keep_alive() || response_.need_eof()) {
+                boost::system::error_code ignored{};
+                connection_ptr_->stream.socket().shutdown(
+                    boost::asio::ip::tcp::socket::shutdown_both, ignored);
+                connection_ptr_.reset();
+            } else {
+                connection_ptr_->stream.expires_never();
+            }
+        }
+        if (has_slot_) {
+            pool_ptr_->Release(std::move(connection_ptr_));
+        }
+
+        if (error_ptr == nullptr) {
+            LOG_DEBUG() << common::format::Format(
+                "{} {}", response_.result_int(), response_.body());
+        }
+        callback_(error_ptr, std::move(response_));
+    }
+
+    boost::asio::io_context& context_;
+    std::shared_ptr<ContextGuard> context_guard_ptr_;
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+    boost::asio::steady_timer deadline_timer_;
+    std::shared_ptr<ConnectionPool> pool_ptr_;
+    std::shared_ptr<DnsCache> dns_cache_ptr_;
+    const std::string host_;
+    const std::string port_;
+    http::Request request_;
+    Response response_;
+    RequestCallback callback_;
+    ConnectionPtr connection_ptr_;
+    Clock::time_point deadline_;
+    Phase phase_;
+    bool has_slot_;
+    bool is_reused_;
+};
+
+/// @struct Shared state of the RequestAll fan-out.
+struct FanOut {
+    std::vector<std::promise<Response>> promises;
+    std::vector<std::future<Response>> futures;
+    std::atomic<size_t> remaining_count;
+    RequestAllCallback callback;
+};
 
 } // namespace
 
-HttpClient::HttpClient(const std::string& host, int port) 
-    : host_{host}, port_{std::to_string(port)} {
-    context_ptr_ = std::make_shared<boost::asio::io_context>();
+HttpClient::HttpClient(const std::string& host, int port, const ClientSettings& settings)
+    : HttpClient(std::make_shared<boost::asio::io_context>(1), host, port, settings) {
+    work_guard_ptr_ = std::make_unique<WorkGuard>(context_ptr_->get_executor());
+    context_thread_ = std::thread([context_ptr = context_ptr_] { context_ptr->run(); });
+}
+
+HttpClient::HttpClient(std::shared_ptr<boost::asio::io_context> context_ptr,
+                       const std::string& host, int port, const ClientSettings& settings)
+    : host_{host}, port_{std::to_string(port)}, context_ptr_{std::move(context_ptr)},
+      context_guard_ptr_{std::make_shared<ContextGuard>()},
+      pool_ptr_{std::make_shared<ConnectionPool>(settings)},
+      dns_cache_ptr_{settings.dns_cache_ptr}, timeout_{settings.timeout},
+      work_guard_ptr_{}, context_thread_{} {
+    if (dns_cache_ptr_ == nullptr) {
+        // the process-wide cache is not owned
+        dns_cache_ptr_ = std::shared_ptr<DnsCache>(std::shared_ptr<DnsCache>{},
+                                                   &DnsCache::GetInstance());
+    }
 }
 
 HttpClient::HttpClient(HttpClient&& client) {
     Swap(std::move(client));
 }
 
-HttpClient::~HttpClient() {}
+HttpClient::~HttpClient() {
+    if (context_thread_.joinable()) {
+        // the private context is destroyed next, the pending resolutions are dropped,
+        // while a context of the caller outlives the client and completes them
+        context_guard_ptr_->Reset();
+        work_guard_ptr_.reset();
+        context_ptr_->stop();
+        context_thread_.join();
+    }
+    // the pooled connections are bound to the context
+    pool_ptr_.reset();
+}
 
 HttpClient& HttpClient::operator=(HttpClient&& client) {
     Swap(std::move(client));
@@ -44,42 +329,91 @@ HttpClient& HttpClient::operator=(HttpClient&& client) {
 void HttpClient::Swap(HttpClient&& other) {
     std::swap(host_, other.host_);
     std::swap(port_, other.port_);
-    std::swap(buffer_, other.buffer_);
     other.context_ptr_.swap(context_ptr_);
+    other.context_guard_ptr_.swap(context_guard_ptr_);
+    other.pool_ptr_.swap(pool_ptr_);
+    other.dns_cache_ptr_.swap(dns_cache_ptr_);
+    std::swap(timeout_, other.timeout_);
+    other.work_guard_ptr_.swap(work_guard_ptr_);
+    other.context_thread_.swap(context_thread_);
 }
 
 Response HttpClient::Request(const http::Request& request) {
     if (context_ptr_ == nullptr) {
         throw std::runtime_error("IO context was not initialized");
     }
+    if (context_ptr_->get_executor().running_in_this_thread()) {
+        throw std::logic_error("Blocking request from a thread of the client context");
+    }
+    return AsyncRequest(request).get();
+}
 
-    LOG_DEBUG() << common::format::Format(
-        "Requesting {} {}:{}{}\n{}", http::utils::ToString(request.method()),
-        host_, port_, request.target().to_string(), request.body());
+void HttpClient::AsyncRequest(http::Request request, RequestCallback&& callback) {
+    if (context_ptr_ == nullptr) {
+        throw std::runtime_error("IO context was not initialized");
+    }
+    std::make_shared<RequestOperation>(
+        *context_ptr_, context_guard_ptr_, pool_ptr_, dns_cache_ptr_, host_, port_, timeout_,
+        std::move(request), std::move(callback))->Start();
+}
 
-    auto& context = *context_ptr_;
-    auto const resolved_host = ResolveHost(context, host_, port_);
+std::future<Response> HttpClient::AsyncRequest(http::Request request) {
+    auto promise_ptr = std::make_shared<std::promise<Response>>();
+    auto future = promise_ptr->get_future();
+    AsyncRequest(std::move(request),
+        [promise_ptr](std::exception_ptr error_ptr, Response&& response) {
+            if (error_ptr != nullptr) {
+                promise_ptr->set_exception(error_ptr);
+            } else {
+                promise_ptr->set_value(std::move(response));
+            }
+        });
+    return future;
+}
 
-    LOG_TRACE() << common::format::Format("Conntecting to the host {}", host_);
-    boost::beast::tcp_stream stream(context);
-    stream.connect(resolved_host);
-    boost::beast::http::write(stream, request);
+PoolStats HttpClient::GetPoolStats() const {
+    return pool_ptr_->GetStats();
+}
 
-    LOG_TRACE() << "Waiting for response...";
-    Response result{};
-    boost::beast::http::read(stream, buffer_, result);
+void RequestAll(std::vector<ClientRequest>&& requests, RequestAllCallback&& callback) {
+    if (requests.empty()) {
+        callback({});
+        return;
+    }
 
-    boost::beast::error_code ec{};
-    stream.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
-    if(ec && ec != boost::beast::errc::not_connected) {
-        throw std::runtime_error{
-            common::format::Format("Socket closure error: {}", ec.message())};
+    auto fan_out_ptr = std::make_shared<FanOut>();
+    fan_out_ptr->promises.resize(requests.size());
+    fan_out_ptr->futures.reserve(requests.size());
+    for (auto& promise : fan_out_ptr->promises) {
+        fan_out_ptr->futures.push_back(promise.get_future());
     }
+    fan_out_ptr->remaining_count = requests.size();
+    fan_out_ptr->callback = std::move(callback);
 
-    LOG_DEBUG() << common::format::Format(
-        "{} {}", result.result_int(), result.body());
+    for (size_t i = 0; i < requests.size(); i++) {
+        requests[i].client_ptr->AsyncRequest(std::move(requests[i].request),
+            [fan_out_ptr, i](std::exception_ptr error_ptr, Response&& response) {
+                auto& promise = fan_out_ptr->promises[i];
+                if (error_ptr != nullptr) {
+                    promise.set_exception(error_ptr);
+                } else {
+                    promise.set_value(std::move(response));
+                }
+                if (--fan_out_ptr->remaining_count == 0) {
+                    fan_out_ptr->callback(std::move(fan_out_ptr->futures));
+                }
+            });
+    }
+}
 
-    return result;
+std::vector<std::future<Response>> RequestAll(std::vector<ClientRequest>&& requests) {
+    std::vector<std::future<Response>> futures{};
+    futures.reserve(requests.size());
+    for (auto& client_request : requests) {
+        futures.push_back(
+            client_request.client_ptr->AsyncRequest(std::move(client_request.request)));
+    }
+    return futures;
 }
 
-} // namespace http::client
\ No newline at end of file
+} // namespace http::client
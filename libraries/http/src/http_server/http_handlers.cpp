@@ -0,0 +1,306 @@
+#include "http_server.hpp"
+
+#include <algorithm>
+
+#include <common/include/format.hpp>
+
+namespace http::server {
+
+namespace {
+
+constexpr char kParamBegin = '{';
+constexpr char kParamEnd = '}';
+constexpr char kSegmentDelimiter = '/';
+
+size_t CommonPrefixSize(std::string_view lhs, std::string_view rhs) {
+    const auto [lhs_it, _] = std::mismatch(
+        lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    return static_cast<size_t>(std::distance(lhs.begin(), lhs_it));
+}
+
+} // namespace
+
+/// @struct Radix tree node. A static node matches its label as is,
+/// a parameter node matches a single non-empty path segment.
+struct HttpHandlers::Node {
+    std::string label{};
+    bool is_param{};
+    std::string indices{};            // first label chars of the static children, sorted
+    std::vector<NodePtr> children{};  // static children in the indices order
+    NodePtr param_child{};
+    std::vector<Route> routes{};
+
+    NodePtr Clone() const {
+        auto node_ptr = std::make_unique<Node>();
+        node_ptr->label = label;
+        node_ptr->is_param = is_param;
+        node_ptr->routes = routes;
+        node_ptr->indices = indices;
+        node_ptr->children.reserve(children.size());
+        for (const auto& child_ptr : children) {
+            node_ptr->children.push_back(child_ptr->Clone());
+        }
+        if (param_child != nullptr) {
+            node_ptr->param_child = param_child->Clone();
+        }
+        return node_ptr;
+    }
+
+    /// @brief Returns index of the first child with label starting from
+    /// the char not less than the specified one. Looks up only the indices
+    /// string to keep the children out of the cache until one is matched.
+    size_t LowerBound(char first) const {
+        return static_cast<size_t>(std::distance(
+            indices.cbegin(), std::lower_bound(indices.cbegin(), indices.cend(), first)));
+    }
+
+    const Node* FindChild(char first) const {
+        const auto index = LowerBound(first);
+        if (index != indices.size() && indices[index] == first) {
+            return children[index].get();
+        }
+        return nullptr;
+    }
+
+    const Route* FindRoute(Method method) const {
+        for (const auto& route : routes) {
+            if (route.method == method) {
+                return &route;
+            }
+        }
+        return nullptr;
+    }
+
+    /// @brief Inserts the rest of the pattern starting from pos below this node.
+    /// @returns node which corresponds to the whole pattern
+    Node& Insert(const std::string& pattern, size_t pos) {
+        if (pos == pattern.size()) {
+            return *this;
+        }
+
+        if (pattern[pos] == kParamBegin) {
+            const auto end = pattern.find(kParamEnd, pos);
+            if (end == std::string::npos || end == pos + 1) {
+                throw std::logic_error(common::format::Format(
+                    "invalid path parameter in uri '{}'", pattern));
+            }
+            if ((pos != 0 && pattern[pos - 1] != kSegmentDelimiter) ||
+                (end + 1 != pattern.size() && pattern[end + 1] != kSegmentDelimiter)) {
+                throw std::logic_error(common::format::Format(
+                    "path parameter must occupy the whole segment in uri '{}'", pattern));
+            }
+
+            auto name = pattern.substr(pos + 1, end - pos - 1);
+            if (param_child == nullptr) {
+                param_child = std::make_unique<Node>();
+                param_child->label = std::move(name);
+                param_child->is_param = true;
+            } else if (param_child->label != name) {
+                throw std::logic_error(common::format::Format(
+                    "path parameter '{}' in uri '{}' conflicts with '{}'",
+                    name, pattern, param_child->label));
+            }
+            return param_child->Insert(pattern, end + 1);
+        }
+
+        const auto static_end = std::min(pattern.find(kParamBegin, pos), pattern.size());
+        const auto label = std::string_view(pattern).substr(pos, static_end - pos);
+        const auto index = LowerBound(label.front());
+        if (index == indices.size() || indices[index] != label.front()) {
+            auto child_ptr = std::make_unique<Node>();
+            child_ptr->label = std::string(label);
+            indices.insert(indices.begin() + index, label.front());
+            auto& child = *children.insert(children.begin() + index, std::move(child_ptr));
+            return child->Insert(pattern, static_end);
+        }
+
+        auto& child_ptr = children[index];
+        const auto common_size = CommonPrefixSize(child_ptr->label, label);
+        if (common_size < child_ptr->label.size()) {
+            // split the edge
+            auto split_ptr = std::make_unique<Node>();
+            split_ptr->label = child_ptr->label.substr(0, common_size);
+            child_ptr->label.erase(0, common_size);
+            split_ptr->indices.push_back(child_ptr->label.front());
+            split_ptr->children.push_back(std::move(child_ptr));
+            child_ptr = std::move(split_ptr);
+        }
+        return child_ptr->Insert(pattern, pos + common_size);
+    }
+
+    /// @brief Finds node corresponding to the pattern as is.
+    Node* Find(std::string_view pattern) {
+        if (pattern.empty()) {
+            return this;
+        }
+
+        if (pattern.front() == kParamBegin) {
+            const auto end = pattern.find(kParamEnd);
+            if (param_child == nullptr || end == std::string_view::npos ||
+                pattern.substr(1, end - 1) != param_child->label) {
+                return nullptr;
+            }
+            return param_child->Find(pattern.substr(end + 1));
+        }
+
+        const auto index = LowerBound(pattern.front());
+        if (index == indices.size() || indices[index] != pattern.front()) {
+            return nullptr;
+        }
+        auto& child_ptr = children[index];
+        if (pattern.compare(0, child_ptr->label.size(), child_ptr->label) != 0) {
+            return nullptr;
+        }
+        return child_ptr->Find(pattern.substr(child_ptr->label.size()));
+    }
+
+    /// @brief Matches the path starting from pos against this node's subtree.
+    const Route* Match(std::string_view path, size_t pos,
+                       Method method, PathParams* params) const {
+        bool param_captured = false;
+        if (is_param) {
+            const auto end = std::min(path.find(kSegmentDelimiter, pos), path.size());
+            if (end == pos) {
+                return nullptr;
+            }
+            if (params != nullptr) {
+                if (!params->Push(label, pos, end - pos)) {
+                    return nullptr;
+                }
+                param_captured = true;
+            }
+            pos = end;
+        } else {
+            if (path.compare(pos, label.size(), label) != 0) {
+                return nullptr;
+            }
+            pos += label.size();
+        }
+
+        const Route* route_ptr = nullptr;
+        if (pos == path.size()) {
+            route_ptr = FindRoute(method);
+        } else {
+            if (const auto child_ptr = FindChild(path[pos]); child_ptr != nullptr) {
+                route_ptr = child_ptr->Match(path, pos, method, params);
+            }
+            if (route_ptr == nullptr && param_child != nullptr) {
+                route_ptr = param_child->Match(path, pos, method, params);
+            }
+        }
+
+        if (route_ptr == nullptr && param_captured) {
+            params->Pop();
+        }
+        return route_ptr;
+    }
+};
+
+HttpHandlers::HttpHandlers() : root_{std::make_unique<Node>()} {}
+
+HttpHandlers::HttpHandlers(const HttpHandlers& other)
+    : root_(other.root_->Clone()) {}
+
+HttpHandlers::HttpHandlers(HttpHandlers&& other)
+    : root_(std::make_unique<Node>()) {
+    std::swap(root_, other.root_);
+}
+
+HttpHandlers& HttpHandlers::operator=(const HttpHandlers& other) {
+    root_ = other.root_->Clone();
+    return *this;
+}
+
+HttpHandlers& HttpHandlers::operator=(HttpHandlers&& other) {
+    std::swap(root_, other.root_);
+    return *this;
+}
+
+HttpHandlers::~HttpHandlers() {}
+
+void HttpHandlers::AddHandler(const std::string& uri,
+                              const Method method,
+                              const HttpHandler& handler,
+                              const Execution execution) {
+    AddRoute(Route{
+        uri,        // pattern
+        method,     // method
+        handler,    // handler
+        nullptr,    // async_handler
+        execution,  // execution
+        std::make_shared<RouteMetrics>(uri, method),  // metrics_ptr
+        nullptr,    // sink_factory
+        std::nullopt,  // body_limit
+    });
+}
+
+void HttpHandlers::AddHandler(const std::string& uri,
+                              const Method method,
+                              const AsyncHttpHandler& handler) {
+    AddRoute(Route{
+        uri,                    // pattern
+        method,                 // method
+        nullptr,                // handler
+        handler,                // async_handler
+        Execution::Reactor,     // execution
+        std::make_shared<RouteMetrics>(uri, method),  // metrics_ptr
+        nullptr,                // sink_factory
+        std::nullopt,           // body_limit
+    });
+}
+
+void HttpHandlers::AddHandler(const std::string& uri,
+                              const Method method,
+                              const BodySinkFactory& factory,
+                              const uint64_t body_limit,
+                              const Execution execution) {
+    // the body is already consumed by the sink once the request is routed
+    auto finish_handler = [](Request&& request) {
+        const auto sink_ptr = request.GetBodySink();
+        if (sink_ptr == nullptr) {
+            throw std::logic_error("Request body sink is missing");
+        }
+        return sink_ptr->Finish(std::move(request));
+    };
+    AddRoute(Route{
+        uri,              // pattern
+        method,           // method
+        finish_handler,   // handler
+        nullptr,          // async_handler
+        execution,        // execution
+        std::make_shared<RouteMetrics>(uri, method),  // metrics_ptr
+        factory,          // sink_factory
+        body_limit,       // body_limit
+    });
+}
+
+void HttpHandlers::AddRoute(Route&& route) {
+    auto& node = root_->Insert(route.pattern, 0);
+    for (auto& node_route : node.routes) {
+        if (node_route.method == route.method) {
+            node_route = std::move(route);
+            return;
+        }
+    }
+    node.routes.push_back(std::move(route));
+}
+
+void HttpHandlers::RemoveHandler(const std::string& uri, const Method method) {
+    if (auto node_ptr = root_->Find(uri); node_ptr != nullptr) {
+        auto& routes = node_ptr->routes;
+        routes.erase(
+            std::remove_if(routes.begin(), routes.end(),
+                           [method](const auto& route) { return route.method == method; }),
+            routes.end());
+    }
+}
+
+const Route* HttpHandlers::Match(std::string_view path, const Method method,
+                                 PathParams* params) const {
+    if (params != nullptr) {
+        params->Clear();
+    }
+    return root_->Match(path, 0, method, params);
+}
+
+} // namespace http::server
@@ -1,12 +1,20 @@
 #include "http_server.hpp"
 
+#include <poll.h>
+
+#include <atomic>
+#include <charconv>
+
+#include <boost/asio/post.hpp>
 #include <boost/asio/strand.hpp>
+#include <boost/asio/write.hpp>
 
 #include <common/include/logging.hpp>
 #include <common/include/format.hpp>
 
 #include <consts.hpp>
 #include <exceptions.hpp>
+#include <tcp_session/io_uring.hpp>
 #include <tcp_session/tcp_session.hpp>
 
 namespace http::server {
@@ -18,18 +26,28 @@ namespace format = common::format;
 
 using ErrorCode = boost::beast::error_code;
 
+#ifdef SO_REUSEPORT
+using ReusePort = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+
 constexpr boost::string_view kServerVersion = "SelfMadeZoo Http 0.1";
 constexpr boost::string_view kContentText = "application/json";
+constexpr std::string_view kConnectionRejectedResponse =
+    "HTTP/1.1 503 Service Unavailable\r\n"
+    "Content-Length: 0\r\n"
+    "Connection: close\r\n\r\n";
 
 /// @brief returns request path without params
-std::string GetPath(const Request& request) {
+std::string_view GetPath(const RequestHeader& request) {
     static const char kPathArgumentsPrefix = '?';
-    auto path = std::string(request.target());
-    if (auto it = std::find(path.begin(), path.end(), kPathArgumentsPrefix);
-        it != path.end()) {
-        return std::string(path.begin(), it);
-    }
-    return path;
+    const auto target = request.target();
+    const auto path = std::string_view(target.data(), target.size());
+    return path.substr(0, path.find(kPathArgumentsPrefix));
+}
+
+std::string_view GetHeader(const RequestHeader& request, boost_http::field field) {
+    const auto value = request[field];
+    return std::string_view(value.data(), value.size());
 }
 
 Response MakeBaseResponse(const unsigned version,
@@ -62,167 +80,707 @@ Response ResponseFromHttpError(unsigned int version,
     return response;
 }
 
+Response PayloadTooLargeResponse(unsigned int version) {
+    auto response = MakeBaseResponse(version, boost_http::status::payload_too_large);
+    response.body() = "Payload too large.";
+    return response;
+};
+
+Response ServiceUnavailableResponse(unsigned int version) {
+    auto response = MakeBaseResponse(version, boost_http::status::service_unavailable);
+    response.body() = "Service unavailable.";
+    return response;
+};
+
+Response DeadlineExceededResponse(unsigned int version) {
+    auto response = MakeBaseResponse(version, boost_http::status::gateway_timeout);
+    response.body() = "Deadline exceeded.";
+    return response;
+};
+
+/// @brief Sets the request deadline by the timeout header of the caller.
+void SetDeadline(Request& request) {
+    // an absurd timeout is cut to keep the time point in range
+    static constexpr uint64_t kMaxTimeoutMs = 24 * 60 * 60 * 1000;
+
+    const auto it = request.find(consts::kTimeoutHeader);
+    if (it == request.end()) {
+        return;
+    }
+    const auto value = it->value();
+    uint64_t timeout_ms{};
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(),
+                                              timeout_ms);
+    if (error != std::errc{} || end != value.data() + value.size()) {
+        LOG_DEBUG() << format::Format("Invalid {} header: {}",
+                                      consts::kTimeoutHeader, value.to_string());
+        return;
+    }
+    request.SetDeadline(Request::Clock::now() +
+                        std::chrono::milliseconds(std::min(timeout_ms, kMaxTimeoutMs)));
+}
+
 void PrepareResponse(Response& response, bool keep_alive) {
     response.set(boost_http::field::server, kServerVersion);
-    response.set(boost_http::field::content_type, kContentText);
+    if (response.find(boost_http::field::content_type) == response.end()) {
+        response.set(boost_http::field::content_type, kContentText);
+    }
     response.version(consts::kVersion);
     response.keep_alive(keep_alive);
-    response.prepare_payload();
+    if (response.IsChunked()) {
+        response.chunked(true);
+    } else if (response.HasFileRange()) {
+        response.content_length(response.GetFileRange()->GetSize());
+    } else {
+        response.prepare_payload();
+    }
 }
 
-} // namespace
-
-HttpHandlers::HttpHandlers() : handlers_{} {}
+/// @brief Moves the response into a pooled arena unless it is there
+/// already, so the standard fields do not hit the heap.
+Response ToArenaResponse(Response&& response, common::memory::ArenaPool& arena_pool) {
+    if (response.get_allocator().IsArenaBacked()) {
+        return std::move(response);
+    }
+    Response result(std::piecewise_construct,
+                    std::make_tuple(std::move(response.body())),
+                    std::make_tuple(arena_pool.Acquire()));
+    result.base() = response.base();
+    if (response.IsChunked()) {
+        result.SetChunkGenerator(std::move(response.GetChunkGenerator()));
+        result.SetChunkExecutor(Response::ChunkExecutor(response.GetChunkExecutor()));
+    }
+    result.SetFileRange(response.GetFileRange());
+    return result;
+}
 
-HttpHandlers::HttpHandlers(const HttpHandlers& other) 
-    : handlers_(other.handlers_) {}
+/// @brief Invokes a synchronous handler and converts
+/// thrown exceptions to the error responses.
+Response InvokeHandler(const Route& route, Request&& request) {
+    const auto version = request.version();
+    try {
+        return route.handler(std::move(request));
+    } catch (const exceptions::HttpError& error) {
+        return ResponseFromHttpError(version, error);
+    } catch (const std::exception& ex) {
+        LOG_ERROR() << format::Format("Not handled exception in {} {}: {}",
+                                      boost_http::to_string(route.method).to_string(),
+                                      route.pattern, ex);
+        return ServerErrorResponse(version);
+    }
+}
 
-HttpHandlers::HttpHandlers(HttpHandlers&& other) 
-    : handlers_(std::move(other.handlers_)) {}
+/// @class Sink of a route executed on the worker pool. The session makes
+/// and writes it via the pool, the release is moved there too, as an
+/// unfinished sink may release its data right from the I/O thread,
+/// e.g. along with a request rejected by the admission control.
+class WorkerPoolSink : public BodySink {
+public:
+    WorkerPoolSink(BodySinkPtr sink_ptr, common::threading::WorkerPool& worker_pool)
+        : sink_ptr_{std::move(sink_ptr)}, worker_pool_{worker_pool}, is_finished_{false} {}
+
+    ~WorkerPoolSink() override {
+        if (is_finished_) {
+            return;
+        }
+        // released right here if the pool has no room
+        auto release = [sink_ptr = std::move(sink_ptr_)]() mutable {
+            sink_ptr.reset();
+        };
+        worker_pool_.TryPost(std::move(release));
+    }
 
-HttpHandlers& HttpHandlers::operator=(const HttpHandlers& other) {
-    handlers_ = other.handlers_;
-    return *this;
-}
+    void Write(std::string_view data) override {
+        sink_ptr_->Write(data);
+    }
 
-HttpHandlers& HttpHandlers::operator=(HttpHandlers&& other) {
-    std::swap(handlers_, other.handlers_);
-    return *this;
-}
+    Response Finish(Request&& request) override {
+        is_finished_ = true;
+        return sink_ptr_->Finish(std::move(request));
+    }
 
-HttpHandlers::~HttpHandlers() {}
+private:
+    BodySinkPtr sink_ptr_;
+    common::threading::WorkerPool& worker_pool_;
+    bool is_finished_;
+};
 
-void HttpHandlers::AddHandler(const std::string& uri,
-                              const Method method,
-                              const HttpHandler& handler) {
-    handlers_[uri][method] = handler;
-}
+} // namespace
 
-void HttpHandlers::RemoveHandler(const std::string& uri, const Method method) {
-    const auto uri_it = handlers_.find(uri);
-    if (uri_it != handlers_.end()) {
-        const auto items_erased = uri_it->second.erase(method);
-        if (items_erased != 0 && uri_it->second.empty()) {
-            handlers_.erase(uri);
+/// @struct Accept of a connection via the io_uring of the acceptor context.
+/// Keeps the server alive while in flight, like an asio operation does.
+struct HttpServer::UringAcceptOperation : public tcp::IoUring::Operation {
+    UringAcceptOperation(tcp::IoUring& uring, size_t acceptor_index)
+        : uring{uring}, acceptor_index{acceptor_index}, server_ptr{}, is_polled{false} {}
+
+    /// @returns an error if the accept is not queued, the server is not kept then
+    std::error_code Start(std::shared_ptr<HttpServer> server, int fd) {
+        server_ptr = std::move(server);
+        acceptor_fd = fd;
+        is_polled = false;
+        auto error = uring.Accept(fd, *this);
+        if (error) {
+            server_ptr.reset();
         }
+        return error;
     }
-}
 
-std::optional<HttpHandler> HttpHandlers::GetHandler(
-        const std::string& uri, const Method method) const {
-    const auto uri_it = handlers_.find(uri);
-    if (uri_it != handlers_.end()) {
-        const auto handler_it = uri_it->second.find(method);
-        if (handler_it != uri_it->second.end()) {
-            return handler_it->second;
+    void Complete(int result) override {
+        std::error_code submit_error{};
+        if (result == -EAGAIN && !is_polled) {
+            // the listening socket is non-blocking, wait for a connection
+            is_polled = true;
+            submit_error = uring.Poll(acceptor_fd, POLLIN, *this);
+            if (!submit_error) {
+                return;
+            }
+        } else if (is_polled && result >= 0) {
+            is_polled = false;
+            submit_error = uring.Accept(acceptor_fd, *this);
+            if (!submit_error) {
+                return;
+            }
         }
+        if (submit_error) {
+            // reported as a failed accept, the next one may go via the reactor
+            result = -submit_error.value();
+        }
+
+        auto server = std::move(server_ptr);
+        auto& io_context = *server->acceptors_[acceptor_index].io_context_ptr;
+        // the same executors as the asio acceptor would give the sessions
+        boost::asio::ip::tcp::socket socket{server->reuse_port_ ?
+            boost::asio::any_io_executor(io_context.get_executor()) :
+            boost::asio::any_io_executor(boost::asio::make_strand(io_context))};
+        ErrorCode error_code{};
+        if (result < 0) {
+            error_code.assign(-result, boost::system::system_category());
+        } else {
+            socket.assign(server->endpoint_.protocol(), result, error_code);
+        }
+        server->OnConnectionAccepted(acceptor_index, error_code, std::move(socket));
     }
-    return std::nullopt;
-}
+
+    void Abandon() override {
+        server_ptr.reset();
+    }
+
+    tcp::IoUring& uring;
+    const size_t acceptor_index;
+    std::shared_ptr<HttpServer> server_ptr;
+    int acceptor_fd{-1};
+    bool is_polled;
+};
 
 HttpServer::HttpServer(std::shared_ptr<boost::asio::io_context> io_context_ptr,
-                       const std::string& address, const unsigned short port) :
-    io_context_ptr_{io_context_ptr},
-    acceptor_{*io_context_ptr_,
-        boost::asio::ip::tcp::endpoint{boost::asio::ip::make_address(address), port}} {}
+                       const std::string& address, const unsigned short port,
+                       const ServerSettings& settings)
+    : acceptors_{}, endpoint_{boost::asio::ip::make_address(address), port},
+      reuse_port_{false}, handlers_{}, has_body_routes_{false}, settings_{settings},
+      worker_pool_ptr_{},
+      limiter_ptr_{std::make_shared<ConcurrencyLimiter>(settings.limiter)},
+      arena_pool_ptr_{common::memory::ArenaPool::Create()},
+      compression_metrics_ptr_{std::make_shared<compression::CompressionMetrics>()},
+      unmatched_metrics_ptr_{std::make_shared<RouteMetrics>(kUnmatchedRoute, Method::unknown)} {
+    acceptors_.push_back(Acceptor{
+        io_context_ptr,                                     // io_context_ptr
+        boost::asio::ip::tcp::acceptor{*io_context_ptr},    // acceptor
+        common::threading::TimingWheel::Create(io_context_ptr),  // timing_wheel_ptr
+    });
+}
 
-HttpServer::HttpServer(HttpServer&& other) : acceptor_(std::move(other.acceptor_)) {
-    std::swap(io_context_ptr_, other.io_context_ptr_);
+HttpServer::HttpServer(
+    const std::vector<std::shared_ptr<boost::asio::io_context>>& io_context_ptrs,
+    const std::string& address, const unsigned short port,
+    const ServerSettings& settings)
+    : acceptors_{}, endpoint_{boost::asio::ip::make_address(address), port},
+      reuse_port_{true}, handlers_{}, has_body_routes_{false}, settings_{settings},
+      worker_pool_ptr_{},
+      limiter_ptr_{std::make_shared<ConcurrencyLimiter>(settings.limiter)},
+      arena_pool_ptr_{common::memory::ArenaPool::Create()},
+      compression_metrics_ptr_{std::make_shared<compression::CompressionMetrics>()},
+      unmatched_metrics_ptr_{std::make_shared<RouteMetrics>(kUnmatchedRoute, Method::unknown)} {
+    if (io_context_ptrs.empty()) {
+        throw std::logic_error("HttpServer requires at least one I/O context");
+    }
+    acceptors_.reserve(io_context_ptrs.size());
+    for (const auto& io_context_ptr : io_context_ptrs) {
+        acceptors_.push_back(Acceptor{
+            io_context_ptr,                                     // io_context_ptr
+            boost::asio::ip::tcp::acceptor{*io_context_ptr},    // acceptor
+            common::threading::TimingWheel::Create(io_context_ptr),  // timing_wheel_ptr
+        });
+    }
+}
+
+HttpServer::HttpServer(HttpServer&& other)
+    : acceptors_(std::move(other.acceptors_)), endpoint_(other.endpoint_),
+      reuse_port_(other.reuse_port_), has_body_routes_(other.has_body_routes_),
+      settings_(other.settings_),
+      worker_pool_ptr_(std::move(other.worker_pool_ptr_)),
+      limiter_ptr_(std::move(other.limiter_ptr_)),
+      arena_pool_ptr_(std::move(other.arena_pool_ptr_)),
+      compression_metrics_ptr_(std::move(other.compression_metrics_ptr_)),
+      unmatched_metrics_ptr_(std::move(other.unmatched_metrics_ptr_)) {
     std::swap(handlers_, other.handlers_);
 }
 
 HttpServer::~HttpServer() {}
 
 HttpServer& HttpServer::operator=(HttpServer&& other) {
-    std::swap(io_context_ptr_, other.io_context_ptr_);
-    std::swap(acceptor_, other.acceptor_);
+    std::swap(acceptors_, other.acceptors_);
+    std::swap(endpoint_, other.endpoint_);
+    std::swap(reuse_port_, other.reuse_port_);
     std::swap(handlers_, other.handlers_);
+    std::swap(has_body_routes_, other.has_body_routes_);
+    std::swap(settings_, other.settings_);
+    std::swap(worker_pool_ptr_, other.worker_pool_ptr_);
+    std::swap(limiter_ptr_, other.limiter_ptr_);
+    std::swap(arena_pool_ptr_, other.arena_pool_ptr_);
+    std::swap(compression_metrics_ptr_, other.compression_metrics_ptr_);
+    std::swap(unmatched_metrics_ptr_, other.unmatched_metrics_ptr_);
     return *this;
 }
 
 void HttpServer::AddListener(const std::string& uri, const Method verb,
-                             const HttpHandler& handler) {
+                             const HttpHandler& handler,
+                             const Execution execution) {
     LOG_DEBUG() << "Setup handler " << uri;
+    handlers_.AddHandler(uri, verb, handler, execution);
+    if (execution == Execution::WorkerPool) {
+        StartWorkerPool();
+    }
+}
+
+void HttpServer::AddListener(const std::string& uri, const Method verb,
+                             const HttpHandler& handler,
+                             const conditional::ValidatorsProvider& validators,
+                             const Execution execution) {
+    AddListener(uri, verb, conditional::MakeConditionalHandler(validators, handler), execution);
+}
+
+void HttpServer::AddListener(const std::string& uri, const Method verb,
+                             const AsyncHttpHandler& handler) {
+    LOG_DEBUG() << "Setup async handler " << uri;
     handlers_.AddHandler(uri, verb, handler);
 }
 
+void HttpServer::AddListener(const std::string& uri, const Method verb,
+                             const BodySinkFactory& factory, const uint64_t body_limit,
+                             const Execution execution) {
+    LOG_DEBUG() << "Setup streaming handler " << uri;
+    handlers_.AddHandler(uri, verb, factory, body_limit, execution);
+    has_body_routes_ = true;
+    if (execution == Execution::WorkerPool) {
+        StartWorkerPool();
+    }
+}
+
+void HttpServer::StartWorkerPool() {
+    if (worker_pool_ptr_ != nullptr) {
+        return;
+    }
+    worker_pool_ptr_ = std::make_unique<common::threading::WorkerPool>(
+        settings_.worker_pool_size, settings_.worker_queue_max_size);
+    worker_pool_ptr_->Run();
+}
+
+LimiterState HttpServer::GetLimiterState() const {
+    return limiter_ptr_->GetState();
+}
+
+compression::CompressionStats HttpServer::GetCompressionStats() const {
+    return compression_metrics_ptr_->GetStats();
+}
+
+Transport HttpServer::GetTransport() const {
+    return settings_.transport;
+}
+
+void HttpServer::SetupTransport() {
+    if (settings_.transport != Transport::IoUring) {
+        return;
+    }
+    if (!tcp::IoUring::IsSupported()) {
+        LOG_WARNING() << "io_uring is not supported, falling back to the asio transport";
+        settings_.transport = Transport::Asio;
+        return;
+    }
+    for (auto& acceptor : acceptors_) {
+        auto& uring = boost::asio::use_service<tcp::IoUring>(*acceptor.io_context_ptr);
+        if (uring.GetError()) {
+            LOG_WARNING() << "io_uring is not available, falling back to the asio transport";
+            settings_.transport = Transport::Asio;
+            break;
+        }
+    }
+    for (size_t i = 0; i < acceptors_.size(); i++) {
+        auto& acceptor = acceptors_[i];
+        acceptor.uring_accept_ptr = settings_.transport == Transport::IoUring ?
+            std::make_shared<UringAcceptOperation>(
+                boost::asio::use_service<tcp::IoUring>(*acceptor.io_context_ptr), i) :
+            nullptr;
+    }
+}
+
 void HttpServer::Listen() {
+    SetupTransport();
+    for (auto& acceptor : acceptors_) {
+        OpenAcceptor(acceptor.acceptor);
+        // all of the reactors have to share the same port
+        // even if an ephemeral one was requested
+        endpoint_.port(acceptor.acceptor.local_endpoint().port());
+    }
+
+    LOG_INFO() << "HttpServer is listening for incoming connections on port " 
+               << endpoint_.port() << " with " << acceptors_.size() << " acceptor(s)";
+
+    for (size_t i = 0; i < acceptors_.size(); i++) {
+        AsyncAcceptNextConnection(i);
+    }
+}
+
+void HttpServer::Stop() {
+    for (auto& [_, acceptor, timing_wheel_ptr, uring_accept_ptr] : acceptors_) {
+        boost::asio::post(acceptor.get_executor(),
+                          [&acceptor, uring_accept_ptr = uring_accept_ptr,
+                           self = shared_from_this()] {
+            // closing the descriptor does not abort the ring operation
+            if (uring_accept_ptr != nullptr) {
+                const auto error = uring_accept_ptr->uring.Cancel(*uring_accept_ptr);
+                if (error) {
+                    LOG_ERROR() << "HttpServer cannot cancel the io_uring accept: "
+                                << error.message();
+                }
+            }
+            ErrorCode error_code{};
+            acceptor.close(error_code);
+        });
+    }
+}
+
+unsigned short HttpServer::GetPort() const {
+    return endpoint_.port();
+}
+
+void HttpServer::OpenAcceptor(boost::asio::ip::tcp::acceptor& acceptor) {
     ErrorCode error_code{};
-    acceptor_.set_option(boost::asio::socket_base::reuse_address(true), error_code);
+    acceptor.open(endpoint_.protocol(), error_code);
     if (error_code) {
         throw std::runtime_error(error_code.message());
     }
-    
-    acceptor_.listen(boost::asio::socket_base::max_listen_connections, error_code);
+
+    acceptor.set_option(boost::asio::socket_base::reuse_address(true), error_code);
     if (error_code) {
         throw std::runtime_error(error_code.message());
     }
 
-    LOG_INFO() << "HttpServer is listening for incoming connections on port " 
-               << acceptor_.local_endpoint().port();
+    if (reuse_port_) {
+#ifdef SO_REUSEPORT
+        acceptor.set_option(ReusePort(true), error_code);
+        if (error_code) {
+            throw std::runtime_error(error_code.message());
+        }
+#else
+        throw std::runtime_error("SO_REUSEPORT is not supported on this platform");
+#endif
+    }
 
-    AsyncAcceptNextConnection();
+    acceptor.bind(endpoint_, error_code);
+    if (error_code) {
+        throw std::runtime_error(error_code.message());
+    }
+
+    acceptor.listen(boost::asio::socket_base::max_listen_connections, error_code);
+    if (error_code) {
+        throw std::runtime_error(error_code.message());
+    }
 }
 
-void HttpServer::AsyncAcceptNextConnection() {
-    acceptor_.async_accept(
-        boost::asio::make_strand(*io_context_ptr_),
+void HttpServer::AsyncAcceptNextConnection(size_t acceptor_index) {
+    auto& [io_context_ptr, acceptor, timing_wheel_ptr, uring_accept_ptr] =
+        acceptors_[acceptor_index];
+    if (uring_accept_ptr != nullptr) {
+        if (!acceptor.is_open()) {
+            return;
+        }
+        const auto error = uring_accept_ptr->Start(shared_from_this(), acceptor.native_handle());
+        if (!error) {
+            return;
+        }
+        // the ring is full, this connection is accepted via the reactor
+        LOG_WARNING() << "HttpServer cannot accept via io_uring: " << error.message();
+    }
+    // A shared context is run by several threads, so each session needs
+    // a strand. A reactor is single-threaded and needs no synchronization.
+    auto executor = reuse_port_ ?
+        boost::asio::any_io_executor(io_context_ptr->get_executor()) :
+        boost::asio::any_io_executor(boost::asio::make_strand(*io_context_ptr));
+    acceptor.async_accept(
+        executor,
         boost::beast::bind_front_handler(
             &HttpServer::OnConnectionAccepted,
-            shared_from_this()));
+            shared_from_this(), acceptor_index));
 }
 
 void HttpServer::OnConnectionAccepted(
-    const ErrorCode error_code, boost::asio::ip::tcp::socket socket) {
+    size_t acceptor_index, const ErrorCode error_code,
+    boost::asio::ip::tcp::socket socket) {
 
-    if (!error_code) {
-        auto on_request_ready = [this](Request&& request) {
-            return this->HandleRequest(std::move(request));
+    if (error_code == boost::asio::error::operation_aborted) {
+        LOG_DEBUG() << "HttpServer acceptor is closed";
+        return;
+    }
+
+    if (!error_code && !limiter_ptr_->TryAcquireConnection()) {
+        RejectConnection(socket);
+    } else if (!error_code) {
+        // the connection slot is released along with the session
+        std::shared_ptr<void> connection_guard(
+            nullptr, [limiter_ptr = limiter_ptr_](void*) {
+                limiter_ptr->ReleaseConnection();
+            });
+        auto on_header_ready = [this](const RequestHeader& header,
+                                      std::optional<uint64_t> content_length) {
+            return this->HandleHeader(header, content_length);
+        };
+        auto on_request_ready = [this, connection_guard, executor = socket.get_executor()](
+                                    Request&& request, ResponseCallback&& callback) {
+            this->HandleRequest(std::move(request), std::move(callback), executor);
+        };
+        const tcp::TcpSession::Settings session_settings{
+            settings_.pipeline_depth,  // pipeline_depth
+            settings_.idle_timeout,    // idle_timeout
+            settings_.active_timeout,  // active_timeout
         };
-        std::make_shared<tcp::TcpSession>(on_request_ready, std::move(socket))->Run();
+        auto& acceptor = acceptors_[acceptor_index];
+        auto uring_ptr = acceptor.uring_accept_ptr != nullptr ?
+            &acceptor.uring_accept_ptr->uring : nullptr;
+        // sessions memory is recycled by the reactor threads
+        std::allocate_shared<tcp::TcpSession>(
+            common::memory::RecyclingAllocator<tcp::TcpSession>{},
+            on_header_ready, on_request_ready, std::move(socket), session_settings,
+            arena_pool_ptr_, acceptor.timing_wheel_ptr, uring_ptr)->Run();
     } else {
         LOG_ERROR() << "error on accepting new connection: " << error_code.message();
     }
 
     // Accept another connection
-    AsyncAcceptNextConnection();
+    AsyncAcceptNextConnection(acceptor_index);
 }
 
-Response HttpServer::HandleRequest(Request&& request) {
-    LOG_DEBUG() << common::format::Format(">>> HTTP/{} {} {} {}",
-        request.version(), request.method_string().to_string(),
-        request.target().to_string(), request.body());
+void HttpServer::RejectConnection(boost::asio::ip::tcp::socket& socket) {
+    LOG_WARNING() << "Too many connections, new connection rejected";
+    // the socket send buffer of a new connection is empty,
+    // so such a short response does not block
+    ErrorCode error_code{};
+    boost::asio::write(socket, boost::asio::buffer(kConnectionRejectedResponse), error_code);
+    socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, error_code);
+    socket.close(error_code);
+}
 
-    const auto version = request.version();
-    const auto keep_alive = request.keep_alive();
-    Response response{};
+tcp::BodyPolicy HttpServer::HandleHeader(const RequestHeader& header,
+                                         std::optional<uint64_t> content_length) {
+    // most of the servers have no routes to look up by the header
+    const auto route_ptr = has_body_routes_ ?
+        handlers_.Match(GetPath(header), header.method()) : nullptr;
+    tcp::BodyPolicy policy{
+        route_ptr != nullptr && route_ptr->body_limit.has_value() ?
+            route_ptr->body_limit.value() : settings_.max_body_size,  // body_limit
+        nullptr,       // sink_ptr
+        std::nullopt,  // rejection
+    };
+
+    if (content_length.has_value() && content_length.value() > policy.body_limit) {
+        LOG_WARNING() << format::Format("Body of {} bytes is over the limit, {} rejected",
+                                        content_length.value(), GetPath(header));
+        policy.rejection = RejectHeader(header, route_ptr,
+                                        PayloadTooLargeResponse(header.version()));
+        return policy;
+    }
+
+    if (route_ptr == nullptr || !route_ptr->sink_factory) {
+        return policy;
+    }
+    if (route_ptr->execution == Execution::WorkerPool) {
+        // the sink may block as the handler does, so it is made
+        // and written on the workers, its session waits meanwhile
+        policy.sink_executor = [worker_pool_ptr = worker_pool_ptr_.get()](
+                                   std::function<void()>&& task) {
+            return worker_pool_ptr->TryPost(std::move(task));
+        };
+        policy.deferred = [this, route_ptr, &header, content_length, policy]() mutable {
+            MakeBodySink(*route_ptr, header, content_length, policy);
+            if (policy.sink_ptr != nullptr) {
+                policy.sink_ptr = std::make_shared<WorkerPoolSink>(std::move(policy.sink_ptr),
+                                                                   *worker_pool_ptr_);
+            }
+            return policy;
+        };
+        return policy;
+    }
+    MakeBodySink(*route_ptr, header, content_length, policy);
+    return policy;
+}
+
+void HttpServer::MakeBodySink(const Route& route, const RequestHeader& header,
+                              std::optional<uint64_t> content_length,
+                              tcp::BodyPolicy& policy) {
     try {
-        response = RouteRequest(std::move(request));
+        policy.sink_ptr = route.sink_factory(header, content_length);
     } catch (const exceptions::HttpError& error) {
-        response = ResponseFromHttpError(version, error);
+        policy.rejection = RejectHeader(header, &route,
+                                        ResponseFromHttpError(header.version(), error));
     } catch (const std::exception& ex) {
-        LOG_ERROR() << format::Format("Not handled exception in {} {}: {}",
-                                      request.method_string().to_string(),
-                                      request.target().to_string(), ex);
-        response = ServerErrorResponse(version);
+        LOG_ERROR() << format::Format("Not handled exception in {} {} body sink: {}",
+                                      boost_http::to_string(route.method).to_string(),
+                                      route.pattern, ex);
+        policy.rejection = RejectHeader(header, &route, ServerErrorResponse(header.version()));
     }
-    PrepareResponse(response, keep_alive);
+}
 
-    LOG_DEBUG() << common::format::Format("<<< HTTP/{} {} {}",
-        response.version(), response.result_int(), response.body());
+Response HttpServer::RejectHeader(const RequestHeader& header, const Route* route_ptr,
+                                  Response&& handler_response) {
+    // the rejected request body is never read, so the connection is closed
+    if (route_ptr == nullptr) {
+        route_ptr = handlers_.Match(GetPath(header), header.method());
+    }
+    const auto route_metrics_ptr = route_ptr != nullptr ?
+        route_ptr->metrics_ptr.get() : unmatched_metrics_ptr_.get();
+    auto response = ToArenaResponse(std::move(handler_response), *arena_pool_ptr_);
+    PrepareResponse(response, false);
+    route_metrics_ptr->Record(response.result_int(), RouteMetrics::Clock::duration{});
     return response;
 }
 
-Response HttpServer::RouteRequest(Request&& request) {
-    auto method = request.method();
-    auto path = GetPath(request);
-    auto handler = handlers_.GetHandler(path, method);
-    if (!handler.has_value()) {
+void HttpServer::HandleRequest(Request&& request, ResponseCallback&& callback,
+                               const ConcurrencyLimiter::Executor& executor) {
+    LOG_DEBUG() << common::format::Format(">>> HTTP/{} {} {} {}",
+        request.version(), request.method_string().to_string(),
+        request.target().to_string(), request.body());
+    SetDeadline(request);
+
+    // the route is matched ahead of the admission, so the rejected
+    // requests are accounted to their routes too
+    const auto route_ptr = handlers_.Match(GetPath(request), request.method(),
+                                           &request.GetPathParams());
+    const auto route_metrics_ptr = route_ptr != nullptr ?
+        route_ptr->metrics_ptr.get() : unmatched_metrics_ptr_.get();
+    const auto encoding = settings_.compression.enabled ?
+        compression::ChooseEncoding(GetHeader(request, boost_http::field::accept_encoding)) :
+        compression::Encoding::Identity;
+    // a blocking handler makes a blocking chunk generator as well
+    const auto worker_pool_ptr = route_ptr != nullptr &&
+        route_ptr->execution == Execution::WorkerPool ? worker_pool_ptr_.get() : nullptr;
+    auto on_response = [keep_alive = request.keep_alive(), arena_pool_ptr = arena_pool_ptr_,
+                        encoding, compression_settings = settings_.compression,
+                        compression_metrics_ptr = compression_metrics_ptr_,
+                        route_metrics_ptr, worker_pool_ptr, started_at = RouteMetrics::Clock::now(),
+                        callback = std::move(callback)](Response&& handler_response) {
+        auto response = ToArenaResponse(std::move(handler_response), *arena_pool_ptr);
+        compression::CompressResponse(response, encoding, compression_settings,
+                                      compression_metrics_ptr);
+        if (worker_pool_ptr != nullptr && response.IsChunked() &&
+            !response.GetChunkExecutor()) {
+            response.SetChunkExecutor([worker_pool_ptr](std::function<void()>&& task) {
+                return worker_pool_ptr->TryPost(std::move(task));
+            });
+        }
+        PrepareResponse(response, keep_alive);
+        route_metrics_ptr->Record(response.result_int(),
+                                  RouteMetrics::Clock::now() - started_at);
+        LOG_DEBUG() << common::format::Format("<<< HTTP/{} {} {}",
+            response.version(), response.result_int(), response.body());
+        callback(std::move(response));
+    };
+
+    if (!limiter_ptr_->IsRequestsLimited()) {
+        RouteRequest(route_ptr, std::move(request), std::move(on_response));
+        return;
+    }
+
+    limiter_ptr_->Acquire(
+        [this, route_ptr, request = std::move(request),
+         on_response = std::move(on_response)](bool is_admitted) mutable {
+            if (!is_admitted) {
+                LOG_WARNING() << format::Format("Too many requests, {} rejected",
+                                                GetPath(request));
+                on_response(ServiceUnavailableResponse(request.version()));
+                return;
+            }
+
+            auto on_handled = [limiter_ptr = limiter_ptr_,
+                               started_at = ConcurrencyLimiter::Clock::now(),
+                               on_response = std::move(on_response)](Response&& response) {
+                limiter_ptr->Release(ConcurrencyLimiter::Clock::now() - started_at);
+                on_response(std::move(response));
+            };
+            RouteRequest(route_ptr, std::move(request), std::move(on_handled));
+        },
+        executor);
+}
+
+void HttpServer::RouteRequest(const Route* route_ptr, Request&& request,
+                              ResponseCallback&& callback) {
+    if (route_ptr == nullptr) {
         LOG_INFO() << format::Format("Handler for {} {} not found",
-                                     request.method_string().to_string(), path);
-        return NotFoundResponse(std::move(request));
+                                     request.method_string().to_string(), GetPath(request));
+        callback(NotFoundResponse(std::move(request)));
+        return;
     }
-    return handler.value()(std::move(request));
+
+    // the caller does not wait for the response anymore, e.g. the request
+    // has spent its time waiting for an admission
+    if (request.IsExpired()) {
+        LOG_INFO() << format::Format("Deadline of {} exceeded, dropped", GetPath(request));
+        callback(DeadlineExceededResponse(request.version()));
+        return;
+    }
+
+    const auto version = request.version();
+    if (route_ptr->async_handler) {
+        // the handler may call back and throw afterwards, the error response
+        // is sent only if the handler has not responded
+        ResponseCallback once_callback =
+            [callback, is_called_ptr = std::make_shared<std::atomic<bool>>(false)](
+                Response&& response) {
+                if (!is_called_ptr->exchange(true)) {
+                    callback(std::move(response));
+                }
+            };
+        try {
+            route_ptr->async_handler(std::move(request), ResponseCallback(once_callback));
+        } catch (const exceptions::HttpError& error) {
+            once_callback(ResponseFromHttpError(version, error));
+        } catch (const std::exception& ex) {
+            LOG_ERROR() << format::Format("Not handled exception in {} {}: {}",
+                                          boost_http::to_string(route_ptr->method).to_string(),
+                                          route_ptr->pattern, ex);
+            once_callback(ServerErrorResponse(version));
+        }
+        return;
+    }
+
+    if (route_ptr->execution == Execution::WorkerPool) {
+        const auto is_posted = worker_pool_ptr_->TryPost(
+            [route_ptr, request = std::move(request), callback]() mutable {
+                if (request.IsExpired()) {
+                    LOG_INFO() << format::Format("Deadline of {} exceeded in the worker queue, "
+                                                 "dropped", GetPath(request));
+                    callback(DeadlineExceededResponse(request.version()));
+                    return;
+                }
+                callback(InvokeHandler(*route_ptr, std::move(request)));
+            });
+        if (!is_posted) {
+            LOG_WARNING() << format::Format("Worker pool is overloaded, {} rejected",
+                                            route_ptr->pattern);
+            callback(ServiceUnavailableResponse(version));
+        }
+        return;
+    }
+
+    callback(InvokeHandler(*route_ptr, std::move(request)));
 }
 
 } // namespace http::server
\ No newline at end of file
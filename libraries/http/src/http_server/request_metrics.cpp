@@ -0,0 +1,50 @@
+#include "request_metrics.hpp"
+
+#include <algorithm>
+
+namespace http::server {
+
+namespace {
+
+constexpr const char* kRequestsName = "http_requests_total";
+constexpr const char* kRequestsHelp = "Number of the handled HTTP requests.";
+constexpr const char* kLatencyName = "http_request_duration_seconds";
+constexpr const char* kLatencyHelp = "Time from a request read till its response is ready.";
+
+std::string ToString(Method method) {
+    const auto name = boost::beast::http::to_string(method);
+    return std::string(name.data(), name.size());
+}
+
+} // namespace
+
+RouteMetrics::RouteMetrics(const std::string& route, Method method)
+    : route_{route}, method_{ToString(method)},
+      latency_{common::metrics::Registry::GetInstance().GetHistogram(
+          kLatencyName, kLatencyHelp, {{"route", route_}, {"method", method_}})},
+      statuses_{} {
+    for (auto& counter_ptr : statuses_) {
+        counter_ptr.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+void RouteMetrics::Record(unsigned int status, Clock::duration latency) {
+    GetStatusCounter(status).Add();
+    latency_.Observe(std::chrono::duration<double>(latency).count());
+}
+
+common::metrics::Counter& RouteMetrics::GetStatusCounter(unsigned int status) {
+    status = std::clamp(status, kMinStatus, kMaxStatus);
+    auto& counter_ptr = statuses_[status - kMinStatus];
+    if (auto cached_ptr = counter_ptr.load(std::memory_order_acquire); cached_ptr != nullptr) {
+        return *cached_ptr;
+    }
+    // the registry returns the same counter to the racing threads
+    auto& counter = common::metrics::Registry::GetInstance().GetCounter(
+        kRequestsName, kRequestsHelp,
+        {{"route", route_}, {"method", method_}, {"status", std::to_string(status)}});
+    counter_ptr.store(&counter, std::memory_order_release);
+    return counter;
+}
+
+} // namespace http::server
@@ -0,0 +1,226 @@
+#include <http/include/concurrency_limiter.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+#include <boost/asio/post.hpp>
+
+namespace http::server {
+
+namespace {
+
+// windows count of the long-term latency moving average
+constexpr double kLongWindowsCount = 20.0;
+// long-term latency decays quickly once the load is gone
+constexpr double kLongLatencyDecay = 0.95;
+constexpr double kMinGradient = 0.5;
+
+double ToMilliseconds(ConcurrencyLimiter::Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // namespace
+
+void to_json(common::json::json& json, const LimiterState& state) {
+    json = common::json::json{
+        {"connections", state.connections},
+        {"max_connections", state.max_connections},
+        {"in_flight", state.in_flight},
+        {"in_flight_limit", state.in_flight_limit},
+        {"queue_size", state.queue_size},
+        {"rejected_connections", state.rejected_connections},
+        {"rejected_requests", state.rejected_requests},
+        {"latency_ms", state.latency_ms},
+    };
+}
+
+ConcurrencyLimiter::ConcurrencyLimiter(const LimiterSettings& settings)
+    : settings_{settings}, connections_{0}, rejected_connections_{0},
+      mutex_{}, queue_{}, in_flight_{0},
+      in_flight_limit_{static_cast<double>(settings.max_in_flight)},
+      rejected_requests_{0}, window_latency_sum_{0}, window_samples_count_{0},
+      long_latency_{0} {
+    if (settings_.adaptive) {
+        in_flight_limit_ = std::clamp(
+            in_flight_limit_,
+            static_cast<double>(settings_.min_in_flight),
+            static_cast<double>(settings_.max_in_flight_adaptive));
+    }
+}
+
+bool ConcurrencyLimiter::TryAcquireConnection() {
+    const auto connections = ++connections_;
+    if (settings_.max_connections != 0 && connections > settings_.max_connections) {
+        --connections_;
+        ++rejected_connections_;
+        return false;
+    }
+    return true;
+}
+
+void ConcurrencyLimiter::ReleaseConnection() {
+    --connections_;
+}
+
+bool ConcurrencyLimiter::IsRequestsLimited() const {
+    return settings_.adaptive || settings_.max_in_flight != 0;
+}
+
+void ConcurrencyLimiter::Acquire(Task&& task, const Executor& executor) {
+    if (!IsRequestsLimited()) {
+        task(true);
+        return;
+    }
+
+    bool is_admitted = false;
+    {
+        std::lock_guard lock(mutex_);
+        if (in_flight_ < static_cast<size_t>(in_flight_limit_)) {
+            in_flight_++;
+            is_admitted = true;
+        } else if (queue_.size() < settings_.max_queue_size) {
+            auto timer_ptr = std::make_shared<boost::asio::steady_timer>(
+                executor, settings_.max_queue_wait);
+            auto on_expired = [weak_ptr = weak_from_this(), timer_ptr](
+                                  const boost::system::error_code& error_code) {
+                auto self_ptr = weak_ptr.lock();
+                if (error_code || self_ptr == nullptr) {
+                    return;
+                }
+                self_ptr->OnQueueWaitExpired(timer_ptr);
+            };
+            timer_ptr->async_wait(std::move(on_expired));
+            queue_.push_back(QueuedTask{
+                std::move(task),        // task
+                executor,               // executor
+                Clock::now(),           // enqueued_at
+                std::move(timer_ptr),   // timer_ptr
+            });
+            return;
+        } else {
+            rejected_requests_++;
+        }
+    }
+    task(is_admitted);
+}
+
+void ConcurrencyLimiter::Release(Clock::duration latency) {
+    if (!IsRequestsLimited()) {
+        return;
+    }
+
+    // tasks are posted out of the lock
+    std::vector<QueuedTask> expired_tasks{};
+    std::optional<QueuedTask> next_task{};
+    {
+        std::lock_guard lock(mutex_);
+        in_flight_--;
+        if (settings_.adaptive) {
+            UpdateLimit(latency);
+        }
+
+        const auto now = Clock::now();
+        while (!queue_.empty() && in_flight_ < static_cast<size_t>(in_flight_limit_)) {
+            auto queued = std::move(queue_.front());
+            queue_.pop_front();
+            if (now - queued.enqueued_at > settings_.max_queue_wait) {
+                rejected_requests_++;
+                expired_tasks.push_back(std::move(queued));
+                continue;
+            }
+            in_flight_++;
+            next_task = std::move(queued);
+            break;
+        }
+    }
+
+    // timers are cancelled on their own executors
+    for (auto& expired : expired_tasks) {
+        boost::asio::post(expired.executor,
+            [task = std::move(expired.task), timer_ptr = std::move(expired.timer_ptr)] {
+                timer_ptr->cancel();
+                task(false);
+            });
+    }
+    if (next_task.has_value()) {
+        boost::asio::post(next_task->executor,
+            [task = std::move(next_task->task), timer_ptr = std::move(next_task->timer_ptr)] {
+                timer_ptr->cancel();
+                task(true);
+            });
+    }
+}
+
+void ConcurrencyLimiter::OnQueueWaitExpired(const TimerPtr& timer_ptr) {
+    Task task{};
+    {
+        std::lock_guard lock(mutex_);
+        const auto iter = std::find_if(queue_.begin(), queue_.end(),
+            [&timer_ptr](const QueuedTask& queued) { return queued.timer_ptr == timer_ptr; });
+        if (iter == queue_.end()) {
+            // the task has left the queue already
+            return;
+        }
+        task = std::move(iter->task);
+        queue_.erase(iter);
+        rejected_requests_++;
+    }
+    task(false);
+}
+
+void ConcurrencyLimiter::UpdateLimit(Clock::duration latency) {
+    window_latency_sum_ += ToMilliseconds(latency);
+    window_samples_count_++;
+    if (window_samples_count_ < settings_.adaptive_window_size) {
+        return;
+    }
+
+    const auto short_latency = window_latency_sum_ / window_samples_count_;
+    window_latency_sum_ = 0;
+    window_samples_count_ = 0;
+
+    if (long_latency_ == 0) {
+        long_latency_ = short_latency;
+    } else {
+        long_latency_ += (short_latency - long_latency_) / kLongWindowsCount;
+    }
+    if (long_latency_ > 2 * short_latency) {
+        long_latency_ *= kLongLatencyDecay;
+    }
+    if (short_latency <= 0) {
+        return;
+    }
+
+    // the limit is not grown while it is not reached, e.g. under a low load
+    if (in_flight_ < in_flight_limit_ / 2) {
+        return;
+    }
+
+    const auto gradient = std::clamp(
+        settings_.adaptive_tolerance * long_latency_ / short_latency, kMinGradient, 1.0);
+    // a small headroom lets the limit grow while the latency stays flat
+    const auto new_limit = in_flight_limit_ * gradient + std::sqrt(in_flight_limit_);
+    in_flight_limit_ = std::clamp(
+        in_flight_limit_ * (1 - settings_.adaptive_smoothing) +
+            new_limit * settings_.adaptive_smoothing,
+        static_cast<double>(settings_.min_in_flight),
+        static_cast<double>(settings_.max_in_flight_adaptive));
+}
+
+LimiterState ConcurrencyLimiter::GetState() const {
+    std::lock_guard lock(mutex_);
+    return LimiterState{
+        connections_.load(),                        // connections
+        settings_.max_connections,                  // max_connections
+        in_flight_,                                 // in_flight
+        static_cast<size_t>(in_flight_limit_),      // in_flight_limit
+        queue_.size(),                              // queue_size
+        rejected_connections_.load(),               // rejected_connections
+        rejected_requests_,                         // rejected_requests
+        long_latency_,                              // latency_ms
+    };
+}
+
+} // namespace http::server
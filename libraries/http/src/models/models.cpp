@@ -0,0 +1,141 @@
+#include <http/include/models.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <system_error>
+
+namespace http {
+
+PathParams::PathParams() : params_{}, size_(0) {}
+
+bool PathParams::Push(std::string_view name, size_t offset, size_t size) {
+    if (size_ == kMaxSize) {
+        return false;
+    }
+    params_[size_++] = Param{
+        name,    // name
+        offset,  // offset
+        size,    // size
+    };
+    return true;
+}
+
+void PathParams::Pop() {
+    if (size_ != 0) {
+        size_--;
+    }
+}
+
+void PathParams::Clear() {
+    size_ = 0;
+}
+
+size_t PathParams::Size() const {
+    return size_;
+}
+
+std::optional<std::string_view> PathParams::Get(std::string_view target,
+                                                std::string_view name) const {
+    for (size_t i = 0; i < size_; i++) {
+        const auto& param = params_[i];
+        if (param.name == name && param.offset + param.size <= target.size()) {
+            return target.substr(param.offset, param.size);
+        }
+    }
+    return std::nullopt;
+}
+
+Request::Request(Base&& base)
+    : Base(std::move(base)), path_params_{}, body_sink_ptr_{}, deadline_{} {}
+
+std::optional<std::string_view> Request::GetPathParam(std::string_view name) const {
+    const auto target = this->target();
+    return path_params_.Get(std::string_view(target.data(), target.size()), name);
+}
+
+PathParams& Request::GetPathParams() {
+    return path_params_;
+}
+
+const PathParams& Request::GetPathParams() const {
+    return path_params_;
+}
+
+void Request::SetBodySink(std::shared_ptr<BodySink> sink_ptr) {
+    body_sink_ptr_ = std::move(sink_ptr);
+}
+
+const std::shared_ptr<BodySink>& Request::GetBodySink() const {
+    return body_sink_ptr_;
+}
+
+void Request::SetDeadline(std::optional<Clock::time_point> deadline) {
+    deadline_ = deadline;
+}
+
+const std::optional<Request::Clock::time_point>& Request::GetDeadline() const {
+    return deadline_;
+}
+
+bool Request::IsExpired() const {
+    return deadline_.has_value() && deadline_.value() <= Clock::now();
+}
+
+FileRange::FileRange(const std::filesystem::path& path, uint64_t offset, uint64_t size)
+    : descriptor_{::open(path.c_str(), O_RDONLY | O_CLOEXEC)}, offset_{offset}, size_{size} {
+    if (descriptor_ < 0) {
+        throw std::system_error(errno, std::generic_category(), path.string());
+    }
+}
+
+FileRange::~FileRange() {
+    ::close(descriptor_);
+}
+
+int FileRange::GetDescriptor() const {
+    return descriptor_;
+}
+
+uint64_t FileRange::GetOffset() const {
+    return offset_;
+}
+
+uint64_t FileRange::GetSize() const {
+    return size_;
+}
+
+void Response::SetChunkGenerator(ChunkGenerator&& generator) {
+    chunk_generator_ = std::move(generator);
+}
+
+bool Response::IsChunked() const {
+    return static_cast<bool>(chunk_generator_);
+}
+
+Response::ChunkGenerator& Response::GetChunkGenerator() {
+    return chunk_generator_;
+}
+
+void Response::SetChunkExecutor(ChunkExecutor&& executor) {
+    chunk_executor_ = std::move(executor);
+}
+
+const Response::ChunkExecutor& Response::GetChunkExecutor() const {
+    return chunk_executor_;
+}
+
+void Response::SetFileRange(FileRangePtr file_range_ptr) {
+    file_range_ptr_ = std::move(file_range_ptr);
+}
+
+bool Response::HasFileRange() const {
+    return file_range_ptr_ != nullptr;
+}
+
+const FileRangePtr& Response::GetFileRange() const {
+    return file_range_ptr_;
+}
+
+} // namespace http
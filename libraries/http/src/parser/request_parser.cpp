@@ -0,0 +1,390 @@
+#include <http/include/request_parser.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include <common/include/format.hpp>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HTTP_PARSER_X86
+#include <immintrin.h>
+#endif
+
+namespace http::parser {
+
+namespace {
+
+using Table = std::array<bool, 256>;
+
+constexpr bool IsTokenChar(unsigned char c) {
+    if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+        return true;
+    }
+    switch (c) {
+        case '!': case '#': case '$': case '%': case '&': case '\'': case '*':
+        case '+': case '-': case '.': case '^': case '_': case '`': case '|': case '~':
+            return true;
+        default:
+            return false;
+    }
+}
+
+constexpr bool IsTargetChar(unsigned char c) {
+    return c > ' ' && c != 0x7f;
+}
+
+/// @brief Visible chars, spaces and obs-text.
+constexpr bool IsFieldValueChar(unsigned char c) {
+    return c == '\t' || (c >= ' ' && c != 0x7f);
+}
+
+template<bool (*kPredicate)(unsigned char)>
+constexpr Table MakeTable() {
+    Table table{};
+    for (size_t i = 0; i < table.size(); i++) {
+        table[i] = kPredicate(static_cast<unsigned char>(i));
+    }
+    return table;
+}
+
+constexpr Table kTokenTable = MakeTable<IsTokenChar>();
+constexpr Table kTargetTable = MakeTable<IsTargetChar>();
+constexpr Table kFieldValueTable = MakeTable<IsFieldValueChar>();
+
+/// @brief Returns the first byte not allowed by the table or the end.
+template<const Table& kTable>
+const char* ScanScalar(const char* it, const char* end) {
+    while (it != end && kTable[static_cast<unsigned char>(*it)]) {
+        ++it;
+    }
+    return it;
+}
+
+struct ScalarScanner {
+    static const char* Token(const char* it, const char* end) {
+        return ScanScalar<kTokenTable>(it, end);
+    }
+    static const char* Target(const char* it, const char* end) {
+        return ScanScalar<kTargetTable>(it, end);
+    }
+    static const char* FieldValue(const char* it, const char* end) {
+        return ScanScalar<kFieldValueTable>(it, end);
+    }
+};
+
+#ifdef HTTP_PARSER_X86
+
+// Pairs of the bounds of the not allowed bytes. The ranges compare takes
+// 8 pairs at most, so '{' to 0xff covers '|' and '~' which are rechecked.
+alignas(16) constexpr char kTokenRanges[16] = {
+    '\x00', ' ', '"', '"', '(', ')', ',', ',', '/', '/', ':', '@', '[', ']', '{', '\xff'};
+alignas(16) constexpr char kTargetRanges[16] = {'\x00', ' ', '\x7f', '\x7f'};
+alignas(16) constexpr char kFieldValueRanges[16] = {
+    '\x00', '\x08', '\x0a', '\x1f', '\x7f', '\x7f'};
+
+template<const Table& kTable>
+__attribute__((target("sse4.2")))
+const char* ScanSse42(const char* it, const char* end, const char* ranges, int ranges_size) {
+    const auto ranges16 = _mm_load_si128(reinterpret_cast<const __m128i*>(ranges));
+    while (end - it >= 16) {
+        const auto data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        const auto index = _mm_cmpestri(
+            ranges16, ranges_size, data, 16,
+            _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+        if (index == 16) {
+            it += 16;
+            continue;
+        }
+        it += index;
+        if (!kTable[static_cast<unsigned char>(*it)]) {
+            return it;
+        }
+        ++it;
+    }
+    return ScanScalar<kTable>(it, end);
+}
+
+struct Sse42Scanner {
+    static const char* Token(const char* it, const char* end) {
+        return ScanSse42<kTokenTable>(it, end, kTokenRanges, 16);
+    }
+    static const char* Target(const char* it, const char* end) {
+        return ScanSse42<kTargetTable>(it, end, kTargetRanges, 4);
+    }
+    static const char* FieldValue(const char* it, const char* end) {
+        return ScanSse42<kFieldValueTable>(it, end, kFieldValueRanges, 6);
+    }
+};
+
+/// @brief Marks the bytes not greater than the bound, as unsigned.
+__attribute__((target("avx2")))
+inline __m256i IsNotGreater(__m256i data, char bound) {
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(data, _mm256_set1_epi8(bound)), data);
+}
+
+__attribute__((target("avx2")))
+inline __m256i IsEqual(__m256i data, char value) {
+    return _mm256_cmpeq_epi8(data, _mm256_set1_epi8(value));
+}
+
+struct TargetClassifier {
+    __attribute__((target("avx2")))
+    static __m256i GetInvalid(__m256i data) {
+        return _mm256_or_si256(IsNotGreater(data, ' '), IsEqual(data, '\x7f'));
+    }
+
+    static const char* ScanTail(const char* it, const char* end) {
+        return Sse42Scanner::Target(it, end);
+    }
+};
+
+struct FieldValueClassifier {
+    __attribute__((target("avx2")))
+    static __m256i GetInvalid(__m256i data) {
+        const auto is_control = _mm256_andnot_si256(IsEqual(data, '\t'),
+                                                    IsNotGreater(data, '\x1f'));
+        return _mm256_or_si256(is_control, IsEqual(data, '\x7f'));
+    }
+
+    static const char* ScanTail(const char* it, const char* end) {
+        return Sse42Scanner::FieldValue(it, end);
+    }
+};
+
+/// @brief Scans 32 bytes at a time, the invalid bytes are marked by
+/// the classifier. Most of the values are short, so the tail is scanned
+/// 16 bytes at a time still.
+template<typename Classifier>
+__attribute__((target("avx2")))
+const char* ScanAvx2(const char* it, const char* end) {
+    while (end - it >= 32) {
+        const auto data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it));
+        const auto mask = static_cast<uint32_t>(
+            _mm256_movemask_epi8(Classifier::GetInvalid(data)));
+        if (mask != 0) {
+            return it + __builtin_ctz(mask);
+        }
+        it += 32;
+    }
+    return Classifier::ScanTail(it, end);
+}
+
+struct Avx2Scanner {
+    // the tokens are short and the set is irregular, the ranges suit it better
+    static const char* Token(const char* it, const char* end) {
+        return Sse42Scanner::Token(it, end);
+    }
+    static const char* Target(const char* it, const char* end) {
+        return ScanAvx2<TargetClassifier>(it, end);
+    }
+    static const char* FieldValue(const char* it, const char* end) {
+        return ScanAvx2<FieldValueClassifier>(it, end);
+    }
+};
+
+#endif // HTTP_PARSER_X86
+
+ParseResult Incomplete() {
+    return ParseResult{ParseStatus::Incomplete, 0};
+}
+
+ParseResult Invalid() {
+    return ParseResult{ParseStatus::Invalid, 0};
+}
+
+/// @brief Matches the literal, moves the iterator past it if matched.
+/// @returns Incomplete if the buffer ends with a prefix of the literal
+ParseStatus ExpectLiteral(const char*& it, const char* end, std::string_view literal) {
+    const auto available = std::min(literal.size(), static_cast<size_t>(end - it));
+    if (std::string_view(it, available) != literal.substr(0, available)) {
+        return ParseStatus::Invalid;
+    }
+    if (available < literal.size()) {
+        return ParseStatus::Incomplete;
+    }
+    it += available;
+    return ParseStatus::Complete;
+}
+
+bool IsWhitespace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+template<typename Scanner>
+ParseResult Parse(std::string_view buffer, RequestHead& head) {
+    const char* const begin = buffer.data();
+    const char* const end = begin + buffer.size();
+    const char* it = begin;
+
+    // RFC 7230 section 3.5, empty lines before the request line are ignored
+    while (it != end && *it == '\r') {
+        if (const auto status = ExpectLiteral(it, end, "\r\n"); status != ParseStatus::Complete) {
+            return ParseResult{status, 0};
+        }
+    }
+
+    const auto method_end = Scanner::Token(it, end);
+    if (method_end == end) {
+        return Incomplete();
+    }
+    if (method_end == it || *method_end != ' ') {
+        return Invalid();
+    }
+    head.method = std::string_view(it, method_end - it);
+    it = method_end + 1;
+
+    const auto target_end = Scanner::Target(it, end);
+    if (target_end == end) {
+        return Incomplete();
+    }
+    if (target_end == it || *target_end != ' ') {
+        return Invalid();
+    }
+    head.target = std::string_view(it, target_end - it);
+    it = target_end + 1;
+
+    if (const auto status = ExpectLiteral(it, end, "HTTP/1."); status != ParseStatus::Complete) {
+        return ParseResult{status, 0};
+    }
+    if (it == end) {
+        return Incomplete();
+    }
+    if (*it != '0' && *it != '1') {
+        return Invalid();
+    }
+    head.version = 10 + (*it - '0');
+    ++it;
+    if (const auto status = ExpectLiteral(it, end, "\r\n"); status != ParseStatus::Complete) {
+        return ParseResult{status, 0};
+    }
+
+    head.headers_count = 0;
+    while (true) {
+        if (it == end) {
+            return Incomplete();
+        }
+        if (*it == '\r') {
+            const auto status = ExpectLiteral(it, end, "\r\n");
+            return ParseResult{status, status == ParseStatus::Complete ?
+                static_cast<size_t>(it - begin) : 0};
+        }
+        // obsolete line folding is rejected as RFC 7230 section 3.2.4 allows
+        if (IsWhitespace(*it) || head.headers_count == RequestHead::kMaxHeaders) {
+            return Invalid();
+        }
+
+        const auto name_end = Scanner::Token(it, end);
+        if (name_end == end) {
+            return Incomplete();
+        }
+        if (name_end == it || *name_end != ':') {
+            return Invalid();
+        }
+        auto& header = head.headers[head.headers_count];
+        header.name = std::string_view(it, name_end - it);
+        it = name_end + 1;
+
+        while (it != end && IsWhitespace(*it)) {
+            ++it;
+        }
+        const auto value_end = Scanner::FieldValue(it, end);
+        if (value_end == end) {
+            return Incomplete();
+        }
+        if (*value_end != '\r') {
+            return Invalid();
+        }
+        auto trimmed_end = value_end;
+        while (trimmed_end != it && IsWhitespace(*(trimmed_end - 1))) {
+            --trimmed_end;
+        }
+        header.value = std::string_view(it, trimmed_end - it);
+        it = value_end;
+        if (const auto status = ExpectLiteral(it, end, "\r\n"); status != ParseStatus::Complete) {
+            return ParseResult{status, 0};
+        }
+        head.headers_count++;
+    }
+}
+
+Isa DetectIsa() {
+#ifdef HTTP_PARSER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("sse4.2")) {
+        return Isa::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return Isa::Sse42;
+    }
+#endif
+    return Isa::Scalar;
+}
+
+boost::beast::string_view ToBeastView(std::string_view value) {
+    return boost::beast::string_view(value.data(), value.size());
+}
+
+} // namespace
+
+Isa GetSupportedIsa() {
+    static const Isa kIsa = DetectIsa();
+    return kIsa;
+}
+
+std::string_view ToString(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar:
+            return "scalar";
+        case Isa::Sse42:
+            return "sse4.2";
+        case Isa::Avx2:
+            return "avx2";
+    }
+    return "unknown";
+}
+
+std::optional<std::string_view> RequestHead::FindHeader(std::string_view name) const {
+    for (size_t i = 0; i < headers_count; i++) {
+        if (boost::beast::iequals(ToBeastView(headers[i].name), ToBeastView(name))) {
+            return headers[i].value;
+        }
+    }
+    return std::nullopt;
+}
+
+ParseResult ParseRequestHead(std::string_view buffer, RequestHead& head, Isa isa) {
+#ifdef HTTP_PARSER_X86
+    // an instruction set the CPU lacks would crash
+    switch (std::min(isa, GetSupportedIsa())) {
+        case Isa::Avx2:
+            return Parse<Avx2Scanner>(buffer, head);
+        case Isa::Sse42:
+            return Parse<Sse42Scanner>(buffer, head);
+        case Isa::Scalar:
+            break;
+    }
+#endif
+    return Parse<ScalarScanner>(buffer, head);
+}
+
+Request ToRequest(const RequestHead& head, std::string_view body,
+                  const FieldsAllocator& allocator) {
+    Request request(std::piecewise_construct, std::make_tuple(body),
+                    std::make_tuple(allocator));
+    const auto method = boost::beast::http::string_to_verb(ToBeastView(head.method));
+    if (method == Method::unknown) {
+        throw std::invalid_argument(common::format::Format(
+            "Unknown method \'{}\'", head.method));
+    }
+    request.method(method);
+    request.target(ToBeastView(head.target));
+    request.version(head.version);
+    for (size_t i = 0; i < head.headers_count; i++) {
+        request.insert(ToBeastView(head.headers[i].name), ToBeastView(head.headers[i].value));
+    }
+    return request;
+}
+
+} // namespace http::parser
@@ -0,0 +1,469 @@
+#include "io_uring.hpp"
+
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <boost/asio/post.hpp>
+
+#include <common/include/logging.hpp>
+
+namespace http::tcp {
+
+namespace {
+
+// the transport relies on the internal polling of the sockets
+// and on the completions not being dropped on the ring overflow
+constexpr unsigned kRequiredFeatures = IORING_FEAT_FAST_POLL | IORING_FEAT_NODROP;
+
+std::system_error MakeError(const char* what) {
+    return std::system_error(errno, std::system_category(), what);
+}
+
+int Setup(unsigned entries, io_uring_params& params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+}
+
+int Enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+                                    flags, nullptr, 0));
+}
+
+int Register(int fd, unsigned opcode, const void* arg, unsigned args_count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, args_count));
+}
+
+unsigned LoadAcquire(const unsigned* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+void StoreRelease(unsigned* ptr, unsigned value) {
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+template<typename T>
+T* Offset(void* base, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+} // namespace
+
+boost::asio::io_context::id IoUring::id;
+
+/// @struct Memory shared with the kernel.
+struct IoUring::Ring {
+    int fd{-1};
+    void* sq_ptr{MAP_FAILED};
+    size_t sq_size{};
+    void* cq_ptr{MAP_FAILED};
+    size_t cq_size{};
+    io_uring_sqe* sqes{static_cast<io_uring_sqe*>(MAP_FAILED)};
+    size_t sqes_size{};
+
+    unsigned* sq_head{};
+    unsigned* sq_tail{};
+    unsigned* sq_flags{};
+    unsigned* sq_array{};
+    unsigned sq_mask{};
+    unsigned sq_entries{};
+    // the next entry to fill, published to the kernel on submission
+    unsigned sq_local_tail{};
+
+    unsigned* cq_head{};
+    unsigned* cq_tail{};
+    io_uring_cqe* cqes{};
+    unsigned cq_mask{};
+
+    ~Ring() {
+        if (sqes != MAP_FAILED) {
+            munmap(sqes, sqes_size);
+        }
+        if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr) {
+            munmap(cq_ptr, cq_size);
+        }
+        if (sq_ptr != MAP_FAILED) {
+            munmap(sq_ptr, sq_size);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    /// @throws std::system_error
+    void Init(unsigned entries) {
+        io_uring_params params{};
+        fd = Setup(entries, params);
+        if (fd < 0) {
+            throw MakeError("io_uring_setup");
+        }
+        if ((params.features & kRequiredFeatures) != kRequiredFeatures) {
+            throw std::system_error(std::make_error_code(std::errc::not_supported),
+                                    "io_uring features");
+        }
+
+        sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool is_single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (is_single_mmap) {
+            sq_size = cq_size = std::max(sq_size, cq_size);
+        }
+        sq_ptr = mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_SQ_RING);
+        if (sq_ptr == MAP_FAILED) {
+            throw MakeError("mmap");
+        }
+        cq_ptr = is_single_mmap ? sq_ptr :
+            mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                 fd, IORING_OFF_CQ_RING);
+        if (cq_ptr == MAP_FAILED) {
+            throw MakeError("mmap");
+        }
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, fd,
+                                               IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) {
+            throw MakeError("mmap");
+        }
+
+        sq_head = Offset<unsigned>(sq_ptr, params.sq_off.head);
+        sq_tail = Offset<unsigned>(sq_ptr, params.sq_off.tail);
+        sq_flags = Offset<unsigned>(sq_ptr, params.sq_off.flags);
+        sq_array = Offset<unsigned>(sq_ptr, params.sq_off.array);
+        sq_mask = *Offset<unsigned>(sq_ptr, params.sq_off.ring_mask);
+        sq_entries = *Offset<unsigned>(sq_ptr, params.sq_off.ring_entries);
+        sq_local_tail = *sq_tail;
+
+        cq_head = Offset<unsigned>(cq_ptr, params.cq_off.head);
+        cq_tail = Offset<unsigned>(cq_ptr, params.cq_off.tail);
+        cqes = Offset<io_uring_cqe>(cq_ptr, params.cq_off.cqes);
+        cq_mask = *Offset<unsigned>(cq_ptr, params.cq_off.ring_mask);
+    }
+
+    /// @brief Passes the filled entries to the kernel.
+    /// @returns false if the kernel cannot take them at the moment
+    bool Submit(unsigned min_complete = 0, unsigned flags = 0) {
+        StoreRelease(sq_tail, sq_local_tail);
+        const auto to_submit = sq_local_tail - LoadAcquire(sq_head);
+        if (to_submit == 0 && flags == 0) {
+            return true;
+        }
+        while (Enter(fd, to_submit, min_complete, flags) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // the completions ring is overflown, the entries are kept
+            if (errno == EBUSY || errno == EAGAIN) {
+                return false;
+            }
+            throw MakeError("io_uring_enter");
+        }
+        return true;
+    }
+
+    bool IsFull() const {
+        return sq_local_tail - LoadAcquire(sq_head) == sq_entries;
+    }
+
+    io_uring_sqe& NextEntry() {
+        const auto index = sq_local_tail & sq_mask;
+        sq_array[index] = index;
+        sq_local_tail++;
+        auto& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        return sqe;
+    }
+};
+
+bool IoUring::IsSupported() {
+    static const bool is_supported = [] {
+        try {
+            Ring ring{};
+            ring.Init(2);
+            return true;
+        } catch (const std::system_error& ex) {
+            LOG_DEBUG() << "io_uring is not supported: " << ex.what();
+            return false;
+        }
+    }();
+    return is_supported;
+}
+
+IoUring::IoUring(boost::asio::io_context& io_context)
+    : boost::asio::io_context::service(io_context), io_context_{io_context},
+      ring_ptr_{}, error_{}, event_descriptor_{io_context}, event_value_{0}, mutex_{},
+      in_flight_ptr_{nullptr}, in_flight_count_{0}, is_waiting_{false},
+      is_flush_scheduled_{false}, is_reaping_{false}, stats_{} {
+    try {
+        auto ring_ptr = std::make_unique<Ring>();
+        ring_ptr->Init(kDefaultEntries);
+        const int event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (event_fd < 0) {
+            throw MakeError("eventfd");
+        }
+        // the descriptor owns the eventfd from now on
+        event_descriptor_.assign(event_fd);
+        if (Register(ring_ptr->fd, IORING_REGISTER_EVENTFD, &event_fd, 1) < 0) {
+            throw MakeError("io_uring_register");
+        }
+        ring_ptr_ = std::move(ring_ptr);
+    } catch (const std::system_error& ex) {
+        LOG_ERROR() << "Cannot set up io_uring: " << ex.what();
+        error_ = ex.code();
+    }
+}
+
+IoUring::~IoUring() {}
+
+std::error_code IoUring::GetError() const {
+    return error_;
+}
+
+std::error_code IoUring::Accept(int fd, Operation& operation) {
+    return Submit(&operation, [fd](io_uring_sqe& sqe) {
+        sqe.opcode = IORING_OP_ACCEPT;
+        sqe.fd = fd;
+        sqe.accept_flags = SOCK_CLOEXEC;
+    });
+}
+
+std::error_code IoUring::Recv(int fd, void* data, size_t size, Operation& operation) {
+    return Submit(&operation, [fd, data, size](io_uring_sqe& sqe) {
+        sqe.opcode = IORING_OP_RECV;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(data);
+        sqe.len = static_cast<uint32_t>(size);
+    });
+}
+
+std::error_code IoUring::SendMsg(int fd, const msghdr* message, Operation& operation) {
+    return Submit(&operation, [fd, message](io_uring_sqe& sqe) {
+        sqe.opcode = IORING_OP_SENDMSG;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(message);
+        sqe.len = 1;
+        // a peer reset must not kill the process
+        sqe.msg_flags = MSG_NOSIGNAL;
+    });
+}
+
+std::error_code IoUring::Poll(int fd, short events, Operation& operation) {
+    return Submit(&operation, [fd, events](io_uring_sqe& sqe) {
+        sqe.opcode = IORING_OP_POLL_ADD;
+        sqe.fd = fd;
+        sqe.poll32_events = static_cast<uint16_t>(events);
+    });
+}
+
+std::error_code IoUring::Cancel(Operation& operation) {
+    // the completion of the cancellation itself is skipped
+    return Submit(nullptr, [operation_ptr = &operation](io_uring_sqe& sqe) {
+        sqe.opcode = IORING_OP_ASYNC_CANCEL;
+        sqe.fd = -1;
+        sqe.addr = reinterpret_cast<uint64_t>(operation_ptr);
+    });
+}
+
+IoUring::Stats IoUring::GetStats() const {
+    std::lock_guard lock(mutex_);
+    return stats_;
+}
+
+template<typename Prepare>
+std::error_code IoUring::Submit(Operation* operation_ptr, Prepare&& prepare) {
+    if (ring_ptr_ == nullptr) {
+        return error_;
+    }
+    bool is_flush_needed = false;
+    {
+        std::lock_guard lock(mutex_);
+        auto& ring = *ring_ptr_;
+        if (ring.IsFull()) {
+            SubmitPending();
+            if (ring.IsFull()) {
+                // the kernel takes no more entries until the completions are reaped
+                return std::make_error_code(std::errc::resource_unavailable_try_again);
+            }
+        }
+        auto& sqe = ring.NextEntry();
+        prepare(sqe);
+        sqe.user_data = reinterpret_cast<uint64_t>(operation_ptr);
+
+        if (operation_ptr != nullptr) {
+            operation_ptr->prev_ptr_ = nullptr;
+            operation_ptr->next_ptr_ = in_flight_ptr_;
+            if (in_flight_ptr_ != nullptr) {
+                in_flight_ptr_->prev_ptr_ = operation_ptr;
+            }
+            in_flight_ptr_ = operation_ptr;
+            in_flight_count_++;
+            stats_.operations++;
+        }
+        // a single thread reaps the completions at a time, the reaping one waits afterwards
+        if (!is_waiting_ && !is_reaping_) {
+            is_waiting_ = true;
+            AsyncWaitCompletions();
+        }
+        // the entries queued by the handlers being run are submitted at once afterwards
+        if (!is_flush_scheduled_ && !is_reaping_) {
+            is_flush_scheduled_ = true;
+            is_flush_needed = true;
+        }
+    }
+    if (is_flush_needed) {
+        boost::asio::post(io_context_, [this] { Flush(); });
+    }
+    return {};
+}
+
+void IoUring::Flush() {
+    std::lock_guard lock(mutex_);
+    is_flush_scheduled_ = false;
+    SubmitPending();
+}
+
+void IoUring::SubmitPending() {
+    auto& ring = *ring_ptr_;
+    if (ring.sq_local_tail == LoadAcquire(ring.sq_head)) {
+        return;
+    }
+    stats_.submit_calls++;
+    try {
+        ring.Submit();
+    } catch (const std::system_error& ex) {
+        // the entries stay queued and are submitted along with the next ones
+        LOG_ERROR() << "Cannot submit io_uring entries: " << ex.what();
+    }
+}
+
+void IoUring::AsyncWaitCompletions() {
+    event_descriptor_.async_read_some(
+        boost::asio::buffer(&event_value_, sizeof(event_value_)),
+        [this](const boost::system::error_code& error_code, size_t) {
+            OnCompletions(error_code);
+        });
+}
+
+void IoUring::OnCompletions(const boost::system::error_code& error_code) {
+    if (error_code == boost::asio::error::operation_aborted) {
+        return;
+    }
+    if (error_code) {
+        LOG_ERROR() << "io_uring eventfd error: " << error_code.message();
+    }
+    {
+        std::lock_guard lock(mutex_);
+        is_waiting_ = false;
+        is_reaping_ = true;
+        stats_.wakeups++;
+    }
+
+    ReapCompletions();
+
+    std::lock_guard lock(mutex_);
+    is_reaping_ = false;
+    SubmitPending();
+    if (in_flight_count_ != 0 && !is_waiting_) {
+        is_waiting_ = true;
+        AsyncWaitCompletions();
+    }
+}
+
+void IoUring::ReapCompletions() {
+    auto& ring = *ring_ptr_;
+    while (true) {
+        auto head = *ring.cq_head;
+        const auto tail = LoadAcquire(ring.cq_tail);
+        if (head == tail) {
+            // the overflown completions are moved to the ring by the kernel on enter
+            if ((LoadAcquire(ring.sq_flags) & IORING_SQ_CQ_OVERFLOW) != 0) {
+                std::lock_guard lock(mutex_);
+                try {
+                    ring.Submit(0, IORING_ENTER_GETEVENTS);
+                } catch (const std::system_error& ex) {
+                    LOG_ERROR() << "Cannot flush io_uring completions: " << ex.what();
+                    return;
+                }
+                continue;
+            }
+            return;
+        }
+
+        for (; head != tail; head++) {
+            const auto& cqe = ring.cqes[head & ring.cq_mask];
+            auto operation_ptr = reinterpret_cast<Operation*>(cqe.user_data);
+            const auto result = cqe.res;
+            StoreRelease(ring.cq_head, head + 1);
+            if (operation_ptr == nullptr) {
+                continue;
+            }
+            {
+                std::lock_guard lock(mutex_);
+                if (operation_ptr->prev_ptr_ != nullptr) {
+                    operation_ptr->prev_ptr_->next_ptr_ = operation_ptr->next_ptr_;
+                } else {
+                    in_flight_ptr_ = operation_ptr->next_ptr_;
+                }
+                if (operation_ptr->next_ptr_ != nullptr) {
+                    operation_ptr->next_ptr_->prev_ptr_ = operation_ptr->prev_ptr_;
+                }
+                in_flight_count_--;
+            }
+            // the operation may start a new one and free itself
+            operation_ptr->Complete(result);
+        }
+    }
+}
+
+void IoUring::shutdown() {
+    if (ring_ptr_ == nullptr) {
+        return;
+    }
+    auto& ring = *ring_ptr_;
+    std::vector<Operation*> abandoned{};
+    {
+        std::lock_guard lock(mutex_);
+        for (auto operation_ptr = in_flight_ptr_; operation_ptr != nullptr;
+             operation_ptr = operation_ptr->next_ptr_) {
+            abandoned.push_back(operation_ptr);
+        }
+    }
+    // the kernel must be done with the operations memory before it is freed
+    for (const auto operation_ptr : abandoned) {
+        if (ring.IsFull()) {
+            ring.Submit();
+        }
+        auto& sqe = ring.NextEntry();
+        sqe.opcode = IORING_OP_ASYNC_CANCEL;
+        sqe.fd = -1;
+        sqe.addr = reinterpret_cast<uint64_t>(operation_ptr);
+    }
+    size_t pending_count = abandoned.size();
+    while (pending_count != 0) {
+        ring.Submit(1, IORING_ENTER_GETEVENTS);
+        auto head = *ring.cq_head;
+        const auto tail = LoadAcquire(ring.cq_tail);
+        for (; head != tail; head++) {
+            if (ring.cqes[head & ring.cq_mask].user_data != 0) {
+                pending_count--;
+            }
+        }
+        StoreRelease(ring.cq_head, head);
+    }
+
+    in_flight_ptr_ = nullptr;
+    in_flight_count_ = 0;
+    for (const auto operation_ptr : abandoned) {
+        operation_ptr->Abandon();
+    }
+}
+
+} // namespace http::tcp
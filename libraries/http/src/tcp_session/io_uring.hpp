@@ -0,0 +1,114 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <system_error>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+
+namespace http::tcp {
+
+/**
+ * @class io_uring instance of an I/O context, created on the first use via
+ * boost::asio::use_service. Operations of the context sessions are queued
+ * into the submission ring and submitted by a single system call once the
+ * current batch of handlers is done. Completions are reaped in batches once
+ * the ring eventfd is signalled, so a single epoll wakeup of the context
+ * serves all of the operations completed meanwhile.
+ * Submission is thread-safe, the lock is never contended within a reactor.
+ * Completions are invoked on a thread running the context.
+ */
+class IoUring : public boost::asio::io_context::service {
+public:
+    static boost::asio::io_context::id id;
+
+    static constexpr unsigned kDefaultEntries = 256;
+
+    /// @class Asynchronous operation of the ring. Must stay alive
+    /// until either completed or abandoned.
+    class Operation {
+    public:
+        virtual ~Operation() = default;
+
+        /// @param result non-negative result of the system call or -errno
+        virtual void Complete(int result) = 0;
+
+        /// @brief Invoked instead of the completion if the context
+        /// is destroyed while the operation is in flight.
+        virtual void Abandon() {}
+
+    private:
+        friend class IoUring;
+
+        // intrusive list of the operations in flight
+        Operation* prev_ptr_{nullptr};
+        Operation* next_ptr_{nullptr};
+    };
+
+    struct Stats {
+        uint64_t operations{};
+        uint64_t submit_calls{};
+        uint64_t wakeups{};
+    };
+
+    /// @brief Checks whether the kernel allows io_uring with the operations
+    /// required by the transport.
+    static bool IsSupported();
+
+    explicit IoUring(boost::asio::io_context& io_context);
+    ~IoUring();
+
+    /// @brief Returns an error if the ring could not be set up,
+    /// no operations may be started then.
+    std::error_code GetError() const;
+
+    /// Operations are started by the functions below. An error is returned
+    /// if the operation cannot be queued, e.g. the ring is full, the operation
+    /// is not completed then.
+    std::error_code Accept(int fd, Operation& operation);
+    std::error_code Recv(int fd, void* data, size_t size, Operation& operation);
+    /// @param message must stay alive until the operation is completed
+    std::error_code SendMsg(int fd, const msghdr* message, Operation& operation);
+    std::error_code Poll(int fd, short events, Operation& operation);
+
+    /// @brief Requests the cancellation of an operation in flight,
+    /// it completes with -ECANCELED then unless completed already.
+    std::error_code Cancel(Operation& operation);
+
+    Stats GetStats() const;
+
+private:
+    struct Ring;
+
+    void shutdown() override;
+
+    /// @brief Fills the next submission entry under the lock.
+    template<typename Prepare>
+    std::error_code Submit(Operation* operation_ptr, Prepare&& prepare);
+    void Flush();
+    void SubmitPending();
+    void AsyncWaitCompletions();
+    void OnCompletions(const boost::system::error_code& error_code);
+    void ReapCompletions();
+
+    boost::asio::io_context& io_context_;
+    std::unique_ptr<Ring> ring_ptr_;
+    std::error_code error_;
+    boost::asio::posix::stream_descriptor event_descriptor_;
+    uint64_t event_value_;
+
+    mutable std::mutex mutex_;
+    Operation* in_flight_ptr_;
+    size_t in_flight_count_;
+    bool is_waiting_;
+    bool is_flush_scheduled_;
+    bool is_reaping_;
+    Stats stats_;
+};
+
+} // namespace http::tcp
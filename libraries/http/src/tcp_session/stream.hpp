@@ -0,0 +1,296 @@
+#pragma once
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <memory>
+#include <type_traits>
+
+#include <boost/asio/associated_allocator.hpp>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/beast/core/bind_handler.hpp>
+
+#include "io_uring.hpp"
+
+namespace http::tcp {
+
+namespace detail {
+
+/// @struct Socket descriptor of a stream shared with its ring operations.
+/// A closed stream hands the descriptor over, so it stays open until the
+/// operations in flight are done and is never reused by another connection
+/// while they might still submit to it.
+struct UringDescriptor {
+    explicit UringDescriptor(int fd) : fd{fd}, is_closed{false}, owned_fd{-1} {}
+
+    ~UringDescriptor() {
+        if (owned_fd >= 0) {
+            ::close(owned_fd);
+        }
+    }
+
+    const int fd;
+    // no operation is submitted once the stream is closed
+    std::atomic<bool> is_closed;
+    // the descriptor released by the socket on close
+    int owned_fd;
+};
+
+using UringDescriptorPtr = std::shared_ptr<UringDescriptor>;
+
+/// @class Stream operation over io_uring owning the completion handler.
+/// The memory is allocated via the handler associated allocator. A read or
+/// a write of a socket not ready yet is retried once the socket is polled.
+/// A wait completes with the error code only. Operations of a closed stream
+/// complete with operation_aborted instead of being (re)submitted.
+template<typename Handler, typename Executor, bool IsWait = false>
+class UringOperation final : public IoUring::Operation {
+public:
+    enum class Kind {
+        Recv,
+        Send,
+        WaitWrite,
+    };
+
+    static constexpr size_t kMaxBuffers = 16;
+
+    template<typename Buffers>
+    static void Start(IoUring& uring, UringDescriptorPtr descriptor_ptr, Kind kind,
+                      const Buffers& buffers, const Executor& executor, Handler&& handler) {
+        auto allocator = Allocator(boost::asio::get_associated_allocator(handler));
+        auto operation_ptr = std::allocator_traits<Allocator>::allocate(allocator, 1);
+        new (operation_ptr) UringOperation(uring, std::move(descriptor_ptr), kind, executor,
+                                           std::move(handler));
+        operation_ptr->SetBuffers(buffers);
+        if (kind != Kind::WaitWrite && operation_ptr->size_ == 0) {
+            // completes with no I/O, but still not within the initiation
+            operation_ptr->Finish(boost::system::error_code{}, 0, true);
+            return;
+        }
+        operation_ptr->Submit();
+    }
+
+    void Complete(int result) override {
+        if (result == -EAGAIN && !is_polled_) {
+            // the socket is non-blocking, wait until it is ready
+            is_polled_ = true;
+            Submit();
+            return;
+        }
+        if (is_polled_ && kind_ != Kind::WaitWrite && result >= 0) {
+            is_polled_ = false;
+            Submit();
+            return;
+        }
+
+        boost::system::error_code error_code{};
+        size_t size = 0;
+        if (result < 0) {
+            error_code.assign(-result, boost::system::system_category());
+        } else if (kind_ == Kind::Recv && result == 0) {
+            error_code = boost::asio::error::eof;
+        } else if (kind_ != Kind::WaitWrite) {
+            size = static_cast<size_t>(result);
+        }
+        Finish(error_code, size);
+    }
+
+    void Abandon() override {
+        Destroy();
+    }
+
+private:
+    using Allocator = typename std::allocator_traits<
+        boost::asio::associated_allocator_t<Handler>>::template rebind_alloc<UringOperation>;
+
+    UringOperation(IoUring& uring, UringDescriptorPtr descriptor_ptr, Kind kind,
+                   const Executor& executor, Handler&& handler)
+        : uring_{uring}, descriptor_ptr_{std::move(descriptor_ptr)}, kind_{kind},
+          executor_{executor}, handler_{std::move(handler)}, buffers_{}, message_{},
+          size_{0}, is_polled_{kind == Kind::WaitWrite} {}
+
+    template<typename Buffers>
+    void SetBuffers(const Buffers& buffers) {
+        size_t count = 0;
+        for (auto it = boost::asio::buffer_sequence_begin(buffers);
+             it != boost::asio::buffer_sequence_end(buffers) && count < kMaxBuffers; ++it) {
+            const auto buffer = boost::asio::buffer(*it);
+            if (buffer.size() == 0) {
+                continue;
+            }
+            buffers_[count].iov_base = const_cast<void*>(static_cast<const void*>(buffer.data()));
+            buffers_[count].iov_len = buffer.size();
+            size_ += buffer.size();
+            count++;
+            // a receive fills a single buffer
+            if (kind_ == Kind::Recv) {
+                break;
+            }
+        }
+        message_.msg_iov = buffers_.data();
+        message_.msg_iovlen = count;
+    }
+
+    /// @brief Submits either the I/O or the poll of the socket readiness.
+    void Submit() {
+        if (descriptor_ptr_->is_closed.load(std::memory_order_acquire)) {
+            Finish(boost::asio::error::operation_aborted, 0, true);
+            return;
+        }
+        const int fd = descriptor_ptr_->fd;
+        std::error_code error{};
+        if (is_polled_) {
+            error = uring_.Poll(fd, kind_ == Kind::Recv ? POLLIN : POLLOUT, *this);
+        } else if (kind_ == Kind::Recv) {
+            error = uring_.Recv(fd, buffers_[0].iov_base, buffers_[0].iov_len, *this);
+        } else {
+            error = uring_.SendMsg(fd, &message_, *this);
+        }
+        if (error) {
+            // the operation is not queued, the reactor is left running
+            Finish(boost::system::error_code(error.value(), boost::system::system_category()),
+                   0, true);
+        }
+    }
+
+    /// @param is_deferred whether the handler must not be invoked inline
+    void Finish(boost::system::error_code error_code, size_t size, bool is_deferred = false) {
+        auto executor = boost::asio::get_associated_executor(handler_, executor_);
+        auto handler = std::move(handler_);
+        // the memory is released before the upcall, so the handler may reuse it
+        Destroy();
+        auto bound_handler = [&handler, error_code, size] {
+            if constexpr (IsWait) {
+                return boost::beast::bind_front_handler(std::move(handler), error_code);
+            } else {
+                return boost::beast::bind_front_handler(std::move(handler), error_code, size);
+            }
+        }();
+        if (is_deferred) {
+            boost::asio::post(executor, std::move(bound_handler));
+        } else {
+            boost::asio::dispatch(executor, std::move(bound_handler));
+        }
+    }
+
+    void Destroy() {
+        auto allocator = Allocator(boost::asio::get_associated_allocator(handler_));
+        this->~UringOperation();
+        std::allocator_traits<Allocator>::deallocate(allocator, this, 1);
+    }
+
+    IoUring& uring_;
+    UringDescriptorPtr descriptor_ptr_;
+    const Kind kind_;
+    Executor executor_;
+    Handler handler_;
+    std::array<iovec, kMaxBuffers> buffers_;
+    msghdr message_;
+    size_t size_;
+    bool is_polled_;
+};
+
+} // namespace detail
+
+/**
+ * @class TCP stream of a session. Does the I/O either via the reactor of
+ * the socket context (epoll) or via the io_uring of the context if one is
+ * specified. Models the asio AsyncReadStream and AsyncWriteStream, so the
+ * beast algorithms work with it in both modes.
+ */
+class Stream {
+public:
+    using Socket = boost::asio::ip::tcp::socket;
+    using executor_type = Socket::executor_type;
+
+    /// @param uring_ptr io_uring of the socket context or nullptr
+    Stream(Socket&& socket, IoUring* uring_ptr)
+        : socket_{std::move(socket)}, uring_ptr_{uring_ptr}, descriptor_ptr_{} {
+        if (uring_ptr_ != nullptr) {
+            descriptor_ptr_ = std::make_shared<detail::UringDescriptor>(socket_.native_handle());
+        }
+    }
+
+    executor_type get_executor() noexcept {
+        return socket_.get_executor();
+    }
+
+    Socket& GetSocket() {
+        return socket_;
+    }
+
+    template<typename MutableBuffers, typename Handler>
+    void async_read_some(const MutableBuffers& buffers, Handler&& handler) {
+        if (uring_ptr_ == nullptr) {
+            socket_.async_read_some(buffers, std::forward<Handler>(handler));
+            return;
+        }
+        StartUring<false>(Kind<Handler, false>::Recv, buffers, std::forward<Handler>(handler));
+    }
+
+    template<typename ConstBuffers, typename Handler>
+    void async_write_some(const ConstBuffers& buffers, Handler&& handler) {
+        if (uring_ptr_ == nullptr) {
+            socket_.async_write_some(buffers, std::forward<Handler>(handler));
+            return;
+        }
+        StartUring<false>(Kind<Handler, false>::Send, buffers, std::forward<Handler>(handler));
+    }
+
+    /// @brief Waits until the socket is ready for writing.
+    template<typename Handler>
+    void AsyncWaitWrite(Handler&& handler) {
+        if (uring_ptr_ == nullptr) {
+            socket_.async_wait(Socket::wait_write, std::forward<Handler>(handler));
+            return;
+        }
+        StartUring<true>(Kind<Handler, true>::WaitWrite, boost::asio::const_buffer{},
+                         std::forward<Handler>(handler));
+    }
+
+    void Shutdown(Socket::shutdown_type type, boost::system::error_code& error_code) {
+        socket_.shutdown(type, error_code);
+    }
+
+    /// @brief Closes the socket, the pending operations complete with an error.
+    void Close(boost::system::error_code& error_code) {
+        if (uring_ptr_ != nullptr && socket_.is_open()) {
+            // closing the descriptor does not abort the ring operations,
+            // shutting the connection down does
+            descriptor_ptr_->is_closed.store(true, std::memory_order_release);
+            ::shutdown(socket_.native_handle(), SHUT_RDWR);
+            // the descriptor is closed once the operations are done with it
+            descriptor_ptr_->owned_fd = socket_.release(error_code);
+            return;
+        }
+        socket_.close(error_code);
+    }
+
+private:
+    template<typename Handler, bool IsWait>
+    using Operation = detail::UringOperation<std::decay_t<Handler>, executor_type, IsWait>;
+    template<typename Handler, bool IsWait>
+    using Kind = typename Operation<Handler, IsWait>::Kind;
+
+    template<bool IsWait, typename Buffers, typename Handler>
+    void StartUring(Kind<Handler, IsWait> kind, const Buffers& buffers, Handler&& handler) {
+        std::decay_t<Handler> handler_copy(std::forward<Handler>(handler));
+        Operation<Handler, IsWait>::Start(*uring_ptr_, descriptor_ptr_, kind, buffers,
+                                          socket_.get_executor(), std::move(handler_copy));
+    }
+
+    Socket socket_;
+    IoUring* uring_ptr_;
+    detail::UringDescriptorPtr descriptor_ptr_;
+};
+
+} // namespace http::tcp
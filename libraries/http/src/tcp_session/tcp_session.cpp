@@ -1,6 +1,15 @@
 #include "tcp_session.hpp"
 
+#include <sys/sendfile.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+#include <string_view>
+#include <tuple>
+
 #include <boost/asio/dispatch.hpp>
+#include <boost/asio/write.hpp>
 
 #include <common/include/logging.hpp>
 
@@ -8,79 +17,704 @@ namespace http::tcp {
 
 namespace {
 
-constexpr std::chrono::seconds kDefaultOperationTimeout(10);
+// a single sendfile call size, a large file does not hold up the other sessions
+constexpr uint64_t kMaxSendFileSize = 1024 * 1024;
+// the body of a streaming route is passed to the sink by parts of this size
+constexpr size_t kBodyChunkSize = 64 * 1024;
+// max size of the rejected request data read out before the connection is closed
+constexpr size_t kMaxDiscardSize = 8 * 1024 * 1024;
+constexpr std::string_view kContinueResponse = "HTTP/1.1 100 Continue\r\n\r\n";
+
+/// @brief Safe methods do not change the server state, so pipelined
+/// requests of such methods may be handled in any order (RFC 7230 6.3.2).
+bool IsSafeMethod(Method method) {
+    return method == Method::get || method == Method::head || method == Method::options;
+}
+
+bool IsContinueExpected(const RequestHeader& header) {
+    const auto expect = header[boost::beast::http::field::expect];
+    return header.version() >= 11 && boost::beast::iequals(expect, "100-continue");
+}
+
+/// @brief Response to a body over the limit found while reading it,
+/// e.g. a chunked one, which has no Content-Length to check ahead.
+Response PayloadTooLargeResponse(unsigned int version) {
+    Response response{Status::payload_too_large, version};
+    response.body() = "Payload too large.";
+    response.keep_alive(false);
+    response.prepare_payload();
+    return response;
+}
+
+/// @brief Response to a body the sink executor has no room for.
+Response ServiceUnavailableResponse(unsigned int version) {
+    Response response{Status::service_unavailable, version};
+    response.body() = "Service unavailable.";
+    response.keep_alive(false);
+    response.prepare_payload();
+    return response;
+}
+
+/// @brief Generates the next non-empty chunk, an empty one would terminate the body.
+ChunkResult GenerateChunk(Response::ChunkGenerator& generator, std::string& chunk) {
+    bool has_more = false;
+    try {
+        do {
+            chunk.clear();
+            has_more = generator(chunk);
+        } while (has_more && chunk.empty());
+    } catch (const std::exception& ex) {
+        LOG_ERROR() << "TcpSession chunk generation error: " << ex.what();
+        return ChunkResult::Error;
+    }
+    return has_more ? ChunkResult::Chunk : ChunkResult::Last;
+}
+
+/// @class Completion handler wrapper making the async operations
+/// allocate their state via the recycling allocator.
+template<typename Handler>
+class RecyclingHandler {
+public:
+    using allocator_type = common::memory::RecyclingAllocator<char>;
+
+    explicit RecyclingHandler(Handler&& handler) : handler_(std::move(handler)) {}
+
+    allocator_type get_allocator() const noexcept {
+        return allocator_type{};
+    }
+
+    template<typename... Args>
+    void operator()(Args&&... args) {
+        handler_(std::forward<Args>(args)...);
+    }
+
+private:
+    Handler handler_;
+};
+
+template<typename... Args>
+auto BindHandler(Args&&... args) {
+    auto handler = boost::beast::bind_front_handler(std::forward<Args>(args)...);
+    return RecyclingHandler<decltype(handler)>(std::move(handler));
+}
 
 } // namespace
 
-TcpSession::TcpSession(const HttpHandler& on_request_ready,
-                       boost::asio::ip::tcp::socket&& socket)
-    : on_request_ready_{on_request_ready}, stream_{std::move(socket)},
-      buffer_{}, request_{}, response_{} {}
+TcpSession::TcpSession(const HeaderHandler& on_header_ready,
+                       const RequestHandler& on_request_ready,
+                       boost::asio::ip::tcp::socket&& socket,
+                       const Settings& settings,
+                       std::shared_ptr<common::memory::ArenaPool> arena_pool_ptr,
+                       std::shared_ptr<common::threading::TimingWheel> timing_wheel_ptr,
+                       IoUring* uring_ptr)
+    : on_header_ready_{on_header_ready}, on_request_ready_{on_request_ready},
+      stream_{std::move(socket), uring_ptr}, buffer_{},
+      arena_pool_ptr_{std::move(arena_pool_ptr)}, parser_{}, stream_parser_{},
+      sink_ptr_{}, sink_executor_{}, body_chunk_{}, is_continue_pending_{false},
+      timing_wheel_ptr_{std::move(timing_wheel_ptr)}, timer_{}, is_timer_armed_{false},
+      settings_{settings}, pipeline_depth_{std::max<size_t>(settings.pipeline_depth, 1)},
+      responses_(pipeline_depth_), first_sequence_number_{0}, responses_count_{0},
+      handling_count_{0}, is_unsafe_handling_{false}, is_header_held_{false},
+      serializer_{}, chunk_{}, file_sent_size_{0}, is_reading_{false},
+      is_writing_{false}, is_read_closed_{false}, is_closed_{false},
+      is_discarding_{false}, discarded_size_{0} {}
 
 void TcpSession::Run() {
+    // the wheel may fire on another thread, while the session is being destroyed
+    timer_.SetCallback([weak_ptr = weak_from_this()] {
+        if (auto self = weak_ptr.lock(); self != nullptr) {
+            boost::asio::dispatch(self->stream_.get_executor(),
+                                  BindHandler(&TcpSession::OnTimeout, self));
+        }
+    });
     // perform async I/O operations within a strand
     boost::asio::dispatch(stream_.get_executor(),
-                          boost::beast::bind_front_handler(
-                              &TcpSession::AsyncRead,
-                              shared_from_this()));
+                          BindHandler(&TcpSession::AsyncRead, shared_from_this()));
+}
+
+std::optional<Response>& TcpSession::GetResponseSlot(size_t sequence_number) {
+    return responses_[sequence_number % pipeline_depth_];
 }
 
 void TcpSession::AsyncRead() {
-    LOG_TRACE() << "TcpSession wait for async read, timeout="
-                << kDefaultOperationTimeout.count();
-    request_.clear();
-    stream_.expires_after(kDefaultOperationTimeout);
+    if (is_reading_ || is_read_closed_ || is_closed_ || is_unsafe_handling_ ||
+        responses_count_ >= pipeline_depth_) {
+        return;
+    }
+
+    LOG_TRACE() << "TcpSession wait for async read";
+    is_reading_ = true;
+    UpdateTimeout();
+    // an idle connection does not hold the buffer memory
+    if (responses_count_ == 0 && buffer_.size() == 0) {
+        buffer_.shrink_to_fit();
+    }
+    // the parser builds the message right in a pooled arena
+    parser_.emplace(std::piecewise_construct, std::make_tuple(),
+                    std::make_tuple(arena_pool_ptr_->Acquire()));
+    // the default limit would reject a large Content-Length within the header,
+    // the limit of the route is applied once the header is checked
+    parser_->body_limit(std::numeric_limits<uint64_t>::max());
+    boost::beast::http::async_read_header(
+        stream_, buffer_, *parser_,
+        BindHandler(&TcpSession::OnReadHeader, shared_from_this()));
+}
+
+void TcpSession::OnReadHeader(boost::beast::error_code error_code,
+                              std::size_t bytes_transferred) {
+    if (is_closed_ || error_code) {
+        OnRead(error_code, bytes_transferred);
+        return;
+    }
+
+    // an unsafe request may depend on the effects of the earlier ones
+    // or change what they see, it is held until they are handled
+    if (!IsSafeMethod(parser_->get().method()) && handling_count_ > 0) {
+        is_header_held_ = true;
+        return;
+    }
+    HandleHeader();
+}
+
+void TcpSession::HandleHeader() {
+    const auto content_length = parser_->content_length();
+    auto policy = on_header_ready_(
+        parser_->get(),
+        content_length.has_value() ? std::make_optional(content_length.value()) : std::nullopt);
+    if (policy.deferred) {
+        AsyncMakeBodyPolicy(std::move(policy));
+        return;
+    }
+    OnBodyPolicy(std::move(policy));
+}
+
+void TcpSession::AsyncMakeBodyPolicy(BodyPolicy&& policy) {
+    // the header stays in the parser untouched until the policy is made,
+    // nothing else is read meanwhile
+    const auto is_posted = policy.sink_executor(
+        [self = shared_from_this(), make_policy = std::move(policy.deferred)] {
+            auto policy = make_policy();
+            boost::asio::dispatch(
+                self->stream_.get_executor(),
+                [self, policy = std::move(policy)]() mutable {
+                    self->OnBodyPolicy(std::move(policy));
+                });
+        });
+    if (!is_posted) {
+        LOG_WARNING() << "TcpSession body sink executor is overloaded";
+        RejectRequest(ServiceUnavailableResponse(parser_->get().version()));
+    }
+}
+
+void TcpSession::OnBodyPolicy(BodyPolicy&& policy) {
+    if (is_closed_) {
+        // the sink made meanwhile is released along with the policy
+        OnRead(boost::asio::error::operation_aborted, 0);
+        return;
+    }
+    if (policy.rejection.has_value()) {
+        RejectRequest(std::move(policy.rejection.value()));
+        return;
+    }
+
+    parser_->body_limit(policy.body_limit);
+    // a client waiting for "100 Continue" sends nothing else until it comes
+    is_continue_pending_ = IsContinueExpected(parser_->get()) && !parser_->is_done();
+    if (policy.sink_ptr != nullptr) {
+        sink_ptr_ = std::move(policy.sink_ptr);
+        sink_executor_ = std::move(policy.sink_executor);
+        // the fields stay in the arena, only the body type changes
+        stream_parser_.emplace(std::move(*parser_));
+        parser_.reset();
+        stream_parser_->body_limit(policy.body_limit);
+    }
+
+    if (is_continue_pending_) {
+        AsyncContinue();
+        return;
+    }
+    AsyncReadBody();
+}
+
+void TcpSession::AsyncContinue() {
+    // the interim response must not get in the middle of another one,
+    // it is sent once the responses in flight are written
+    if (!is_continue_pending_ || is_writing_ || responses_count_ > 0) {
+        return;
+    }
+
+    is_continue_pending_ = false;
+    is_writing_ = true;
+    ArmTimeout(settings_.active_timeout);
+    boost::asio::async_write(
+        stream_, boost::asio::buffer(kContinueResponse.data(), kContinueResponse.size()),
+        BindHandler(&TcpSession::OnContinue, shared_from_this()));
+}
+
+void TcpSession::OnContinue(boost::beast::error_code error_code,
+                            std::size_t /*bytes_transferred*/) {
+    is_writing_ = false;
+    if (error_code) {
+        LOG_ERROR() << "TcpSession write error: " << error_code.message();
+        OnRead(error_code, 0);
+        Close();
+        return;
+    }
+    if (is_closed_) {
+        OnRead(error_code, 0);
+        return;
+    }
+    AsyncReadBody();
+}
+
+void TcpSession::AsyncReadBody() {
+    UpdateTimeout();
+    if (stream_parser_.has_value()) {
+        AsyncReadBodyChunk();
+        return;
+    }
+    if (parser_->is_done()) {
+        OnRead(boost::beast::error_code{}, 0);
+        return;
+    }
     boost::beast::http::async_read(
-        stream_, buffer_, request_,
-        boost::beast::bind_front_handler(
-            &TcpSession::OnRead,
-            shared_from_this()));
+        stream_, buffer_, *parser_,
+        BindHandler(&TcpSession::OnRead, shared_from_this()));
+}
+
+void TcpSession::AsyncReadBodyChunk() {
+    if (stream_parser_->is_done()) {
+        OnStreamRead();
+        return;
+    }
+    // the chunk buffer is allocated only by the sessions streaming the bodies
+    body_chunk_.resize(kBodyChunkSize);
+    auto& body = stream_parser_->get().body();
+    body.data = body_chunk_.data();
+    body.size = body_chunk_.size();
+    body.more = true;
+    boost::beast::http::async_read(
+        stream_, buffer_, *stream_parser_,
+        BindHandler(&TcpSession::OnReadBodyChunk, shared_from_this()));
+}
+
+void TcpSession::OnReadBodyChunk(boost::beast::error_code error_code,
+                                 std::size_t bytes_transferred) {
+    // the chunk buffer is full, the rest of the body is still to be read
+    if (error_code == boost::beast::http::error::need_buffer) {
+        error_code = {};
+    }
+    if (is_closed_ || error_code) {
+        OnRead(error_code, bytes_transferred);
+        return;
+    }
+
+    const auto size = body_chunk_.size() - stream_parser_->get().body().size;
+    if (size > 0 && sink_executor_) {
+        AsyncWriteBodyChunk(size);
+        return;
+    }
+    if (size > 0) {
+        sink_ptr_->Write(std::string_view(body_chunk_.data(), size));
+    }
+    OnWriteBodyChunk();
+}
+
+void TcpSession::AsyncWriteBodyChunk(size_t size) {
+    // the chunk buffer is not touched until the chunk is written
+    const auto is_posted = sink_executor_(
+        [self = shared_from_this(), sink_ptr = sink_ptr_,
+         data = std::string_view(body_chunk_.data(), size)] {
+            sink_ptr->Write(data);
+            boost::asio::dispatch(self->stream_.get_executor(),
+                                  BindHandler(&TcpSession::OnWriteBodyChunk, self));
+        });
+    if (!is_posted) {
+        LOG_WARNING() << "TcpSession body sink executor is overloaded";
+        RejectRequest(ServiceUnavailableResponse(stream_parser_->get().version()));
+    }
+}
+
+void TcpSession::OnWriteBodyChunk() {
+    if (is_closed_) {
+        OnRead(boost::asio::error::operation_aborted, 0);
+        return;
+    }
+    if (!stream_parser_->is_done()) {
+        // a body making progress does not time out
+        UpdateTimeout();
+        AsyncReadBodyChunk();
+        return;
+    }
+    OnStreamRead();
+}
+
+void TcpSession::OnStreamRead() {
+    is_reading_ = false;
+    auto message = stream_parser_->release();
+    stream_parser_.reset();
+    Request request(Request::Base(std::move(message.base())));
+    request.SetBodySink(std::move(sink_ptr_));
+    OnRequestRead(std::move(request));
 }
 
 void TcpSession::OnRead(boost::beast::error_code error_code,
                         std::size_t /*bytes_transferred*/) {
+    is_reading_ = false;
+    if (!is_closed_ && error_code == boost::beast::http::error::body_limit) {
+        LOG_WARNING() << "TcpSession request body is over the limit";
+        const auto version = stream_parser_.has_value() ?
+            stream_parser_->get().version() : parser_->get().version();
+        RejectRequest(PayloadTooLargeResponse(version));
+        return;
+    }
+    if (is_closed_ || error_code) {
+        // an incomplete body is discarded along with its sink
+        parser_.reset();
+        stream_parser_.reset();
+        sink_ptr_.reset();
+        is_continue_pending_ = false;
+    }
+    if (is_closed_) {
+        // the read ahead of a closed session is done, so is its timeout
+        timing_wheel_ptr_->Cancel(timer_);
+        is_timer_armed_ = false;
+        return;
+    }
+
     if (error_code == boost::beast::http::error::end_of_stream) {
         LOG_TRACE() << "TcpSession end of stream";
-        Close();
+        is_read_closed_ = true;
+        if (responses_count_ == 0) {
+            Close();
+        }
         return;
     }
 
     if (error_code) {
         LOG_ERROR() << "TcpSession read error: " << error_code.message();
+        is_read_closed_ = true;
+        return;
+    }
+
+    Request request(parser_->release());
+    parser_.reset();
+    OnRequestRead(std::move(request));
+}
+
+void TcpSession::OnRequestRead(Request&& request) {
+    // the client is not going to send anything after this request
+    is_read_closed_ = request.need_eof();
+    is_unsafe_handling_ = !IsSafeMethod(request.method());
+
+    const auto sequence_number = first_sequence_number_ + responses_count_;
+    responses_count_++;
+    handling_count_++;
+    UpdateTimeout();
+    on_request_ready_(
+        std::move(request),
+        [self = shared_from_this(), sequence_number](Response&& response) {
+            // the response may come from a worker thread
+            boost::asio::dispatch(
+                self->stream_.get_executor(),
+                [self, sequence_number, response = std::move(response)]() mutable {
+                    self->OnResponse(sequence_number, std::move(response));
+                });
+        });
+
+    // read ahead while the request is being handled, unless it is unsafe
+    AsyncRead();
+}
+
+void TcpSession::RejectRequest(Response&& response) {
+    is_reading_ = false;
+    is_continue_pending_ = false;
+    parser_.reset();
+    stream_parser_.reset();
+    sink_ptr_.reset();
+    // the rest of the data is the unread body, not the next request,
+    // it is read out once the response is written
+    is_read_closed_ = true;
+    is_discarding_ = true;
+
+    const auto sequence_number = first_sequence_number_ + responses_count_;
+    responses_count_++;
+    GetResponseSlot(sequence_number) = std::move(response);
+    UpdateTimeout();
+    AsyncWrite();
+}
+
+void TcpSession::OnResponse(size_t sequence_number, Response&& response) {
+    if (is_closed_) {
+        return;
+    }
+    GetResponseSlot(sequence_number) = std::move(response);
+    handling_count_--;
+    AsyncWrite();
+
+    if (handling_count_ > 0) {
+        return;
+    }
+    is_unsafe_handling_ = false;
+    if (is_header_held_) {
+        is_header_held_ = false;
+        HandleHeader();
+        return;
+    }
+    AsyncRead();
+}
+
+void TcpSession::AsyncWrite() {
+    if (is_writing_ || responses_count_ == 0) {
+        return;
+    }
+    auto& slot = GetResponseSlot(first_sequence_number_);
+    if (!slot.has_value()) {
+        return;
+    }
+
+    is_writing_ = true;
+    auto& response = slot.value();
+    const bool close = response.need_eof();
+    ArmTimeout(settings_.active_timeout);
+    if (response.IsChunked()) {
+        serializer_.emplace(response);
+        boost::beast::http::async_write_header(
+            stream_, *serializer_,
+            BindHandler(&TcpSession::OnWriteChunk, shared_from_this(), close));
+        return;
+    }
+    if (response.HasFileRange()) {
+        file_sent_size_ = 0;
+        serializer_.emplace(response);
+        boost::beast::http::async_write_header(
+            stream_, *serializer_,
+            BindHandler(&TcpSession::OnWriteFileHeader, shared_from_this(), close));
         return;
     }
 
-    response_ = on_request_ready_(std::move(request_));
-    const bool close = response_.need_eof();
     boost::beast::http::async_write(
-        stream_, response_,
-        boost::beast::bind_front_handler(
-            &TcpSession::OnWrite,
-            shared_from_this(), close));
+        stream_, response,
+        BindHandler(&TcpSession::OnWrite, shared_from_this(), close));
+}
+
+void TcpSession::AsyncWriteChunk(const bool close) {
+    auto& response = GetResponseSlot(first_sequence_number_).value();
+    const auto& executor = response.GetChunkExecutor();
+    if (!executor) {
+        OnChunkGenerated(close, GenerateChunk(response.GetChunkGenerator(), chunk_));
+        return;
+    }
+
+    // the response and the chunk buffer are not touched until the chunk is generated
+    const auto is_posted = executor(
+        [self = shared_from_this(), close, &generator = response.GetChunkGenerator()] {
+            const auto result = GenerateChunk(generator, self->chunk_);
+            boost::asio::dispatch(self->stream_.get_executor(),
+                                  BindHandler(&TcpSession::OnChunkGenerated, self, close, result));
+        });
+    if (!is_posted) {
+        LOG_ERROR() << "TcpSession chunk executor is overloaded";
+        OnWrite(true, boost::beast::error_code{}, 0);
+    }
+}
+
+void TcpSession::OnChunkGenerated(const bool close, ChunkResult result) {
+    if (result == ChunkResult::Error) {
+        // the status is already sent, the only way to report is to break the body
+        OnWrite(true, boost::beast::error_code{}, 0);
+        return;
+    }
+
+    ArmTimeout(settings_.active_timeout);
+    if (result == ChunkResult::Last) {
+        boost::asio::async_write(
+            stream_, boost::beast::http::make_chunk_last(),
+            BindHandler(&TcpSession::OnWrite, shared_from_this(), close));
+        return;
+    }
+
+    boost::asio::async_write(
+        stream_, boost::beast::http::make_chunk(boost::asio::buffer(chunk_)),
+        BindHandler(&TcpSession::OnWriteChunk, shared_from_this(), close));
+}
+
+void TcpSession::OnWriteChunk(const bool close, boost::beast::error_code error_code,
+                              std::size_t bytes_transferred) {
+    if (error_code) {
+        OnWrite(close, error_code, bytes_transferred);
+        return;
+    }
+    AsyncWriteChunk(close);
+}
+
+void TcpSession::OnWriteFileHeader(const bool close, boost::beast::error_code error_code,
+                                   std::size_t bytes_transferred) {
+    if (error_code) {
+        OnWrite(close, error_code, bytes_transferred);
+        return;
+    }
+    AsyncSendFile(close);
+}
+
+void TcpSession::AsyncSendFile(const bool close) {
+    const auto& file_range = *GetResponseSlot(first_sequence_number_)->GetFileRange();
+    auto& socket = stream_.GetSocket();
+    boost::beast::error_code error_code{};
+    socket.native_non_blocking(true, error_code);
+    if (error_code) {
+        OnWrite(close, error_code, file_sent_size_);
+        return;
+    }
+
+    while (file_sent_size_ < file_range.GetSize()) {
+        off_t offset = file_range.GetOffset() + file_sent_size_;
+        const auto size = std::min(file_range.GetSize() - file_sent_size_, kMaxSendFileSize);
+        const auto sent_size = ::sendfile(socket.native_handle(), file_range.GetDescriptor(),
+                                          &offset, size);
+        if (sent_size > 0) {
+            file_sent_size_ += sent_size;
+            if (file_sent_size_ == file_range.GetSize()) {
+                break;
+            }
+            // let the other sessions of the reactor go before the next part
+            ArmTimeout(settings_.active_timeout);
+            stream_.AsyncWaitWrite(
+                BindHandler(&TcpSession::OnSendFileReady, shared_from_this(), close));
+            return;
+        }
+        if (sent_size == 0) {
+            // the file is shorter than the range, the promised length cannot be sent
+            LOG_ERROR() << "TcpSession file range is out of the file size";
+            OnWrite(true, boost::beast::error_code{}, file_sent_size_);
+            return;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            ArmTimeout(settings_.active_timeout);
+            stream_.AsyncWaitWrite(
+                BindHandler(&TcpSession::OnSendFileReady, shared_from_this(), close));
+            return;
+        }
+        OnWrite(close, boost::beast::error_code(errno, boost::system::system_category()),
+                file_sent_size_);
+        return;
+    }
+    OnWrite(close, boost::beast::error_code{}, file_sent_size_);
+}
+
+void TcpSession::OnSendFileReady(const bool close, boost::beast::error_code error_code) {
+    if (error_code) {
+        OnWrite(close, error_code, file_sent_size_);
+        return;
+    }
+    AsyncSendFile(close);
 }
 
 void TcpSession::OnWrite(const bool close, boost::beast::error_code error_code, 
                          std::size_t /*bytes_transferred*/) {
+    is_writing_ = false;
+    serializer_.reset();
+    // releases the response arena
+    GetResponseSlot(first_sequence_number_).reset();
+    first_sequence_number_++;
+    responses_count_--;
+
     if (error_code) {
         LOG_ERROR() << "TcpSession write error: " << error_code.message();
+        Close();
+        return;
     }
 
-    if (close) {
+    if (close || (is_read_closed_ && responses_count_ == 0)) {
         LOG_TRACE() << "TcpSession eof found on write";
         Close();
         return;
     }
 
+    AsyncWrite();
+    AsyncContinue();
     AsyncRead();
+    UpdateTimeout();
 }
 
 void TcpSession::Close() {
     LOG_TRACE() << "TcpSession close()";
+    is_closed_ = true;
+    timing_wheel_ptr_->Cancel(timer_);
+    is_timer_armed_ = false;
     boost::beast::error_code error;
-    stream_.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_send, error);
+    stream_.Shutdown(boost::asio::ip::tcp::socket::shutdown_send, error);
     if (error) {
         LOG_ERROR() << "TcpSession closure error: " << error.message();
     }
+    if (is_discarding_ && !error) {
+        // closing the socket with unread data resets the connection,
+        // so the client could lose the response being delivered
+        ArmTimeout(settings_.active_timeout);
+        AsyncDiscard();
+    } else if (is_reading_) {
+        // the read ahead keeps the session alive until the peer closes
+        // the connection, it is not waited for longer than the timeout
+        ArmTimeout(settings_.active_timeout);
+    }
+}
+
+void TcpSession::AsyncDiscard() {
+    stream_.async_read_some(
+        buffer_.prepare(kBodyChunkSize),
+        BindHandler(&TcpSession::OnDiscard, shared_from_this()));
+}
+
+void TcpSession::OnDiscard(boost::beast::error_code error_code,
+                           std::size_t bytes_transferred) {
+    discarded_size_ += bytes_transferred;
+    if (is_discarding_ && !error_code && discarded_size_ <= kMaxDiscardSize) {
+        AsyncDiscard();
+        return;
+    }
+    is_discarding_ = false;
+    timing_wheel_ptr_->Cancel(timer_);
+    is_timer_armed_ = false;
+}
+
+void TcpSession::ArmTimeout(std::chrono::milliseconds timeout) {
+    timing_wheel_ptr_->Arm(timer_, timeout);
+    is_timer_armed_ = true;
+}
+
+void TcpSession::UpdateTimeout() {
+    // the response being written has its own timeout
+    if (is_writing_ || is_closed_) {
+        return;
+    }
+    if (responses_count_ == 0) {
+        ArmTimeout(settings_.idle_timeout);
+        return;
+    }
+    // the handlers time is not limited by the connection
+    if (is_timer_armed_) {
+        timing_wheel_ptr_->Cancel(timer_);
+        is_timer_armed_ = false;
+    }
+}
+
+void TcpSession::OnTimeout() {
+    // the timer may have been re-armed or cancelled since it fired
+    if ((is_closed_ && !is_discarding_ && !is_reading_) || !is_timer_armed_ ||
+        timing_wheel_ptr_->IsArmed(timer_)) {
+        return;
+    }
+    is_discarding_ = false;
+    LOG_DEBUG() << "TcpSession timeout, " << (responses_count_ == 0 ? "idle" : "active")
+                << " connection is closed";
+    is_closed_ = true;
+    is_timer_armed_ = false;
+    // the pending operations are aborted
+    boost::beast::error_code error{};
+    stream_.Close(error);
 }
 
 } // namespace http::tcp
@@ -1,37 +1,194 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include <boost/beast/core.hpp>
 #include <boost/asio/ip/tcp.hpp>
 
+#include <common/include/allocators.hpp>
+#include <common/include/timing_wheel.hpp>
 #include <models.hpp>
 
+#include "io_uring.hpp"
+#include "stream.hpp"
+
 
 namespace http::tcp {
 
+/// @brief Outcome of a chunk generation of a chunked response.
+enum class ChunkResult {
+    Chunk,  // the next chunk is ready
+    Last,   // the body is over
+    Error,  // the body cannot be completed
+};
+
+/// @brief Executes a call of a body sink off the I/O thread.
+/// @returns false if the call cannot be scheduled
+using SinkExecutor = std::function<bool(std::function<void()>&&)>;
+
+/// @struct How the body of a request is read, decided once its header is.
+struct BodyPolicy {
+    uint64_t body_limit{};
+    // the body is streamed into the sink instead of the request body
+    BodySinkPtr sink_ptr{};
+    // the request is answered with it right away, the body is not read
+    // and the connection is closed
+    std::optional<Response> rejection{};
+    // the sink is written via it instead of the I/O thread, a chunk at a time
+    SinkExecutor sink_executor{};
+    // makes the actual policy via the sink_executor, so the sink factory
+    // may block, the body is not read until the policy is made
+    std::function<BodyPolicy()> deferred{};
+};
+
 /**
  * @class async TCP session wrapper intended for HTTP requests
- * handling.
+ * handling. Supports HTTP/1.1 pipelining: up to pipeline_depth
+ * requests are read ahead and handled concurrently, while the
+ * responses are written strictly in the order of the requests.
+ * Only the safe methods (GET, HEAD, OPTIONS) are handled concurrently:
+ * an unsafe request waits for the earlier ones to be handled, and
+ * nothing is read ahead of it until it is handled itself.
+ * Steady-state handling avoids the heap: request fields are parsed
+ * into pooled arenas, the buffer and async operations memory is recycled.
+ * Timeouts are served by a timing wheel shared by the sessions of a reactor:
+ * an idle one while there is nothing in flight, an active one per write.
+ * The socket I/O goes either via the context reactor or via its io_uring.
+ * A request header is read first, so an oversized body is rejected before
+ * it is sent, "Expect: 100-continue" is answered only for the accepted
+ * requests, and the body of a streaming route goes into its sink chunk
+ * by chunk instead of the request. A chunked response with an executor
+ * is generated off the I/O thread as well. A sink with an executor is made and
+ * written off the I/O thread, the next chunk is read once the previous
+ * one is written, so a slow sink holds the client back instead of
+ * the buffered data growing.
  */ 
 class TcpSession : public std::enable_shared_from_this<TcpSession>
 {
 public:
-    explicit TcpSession(const HttpHandler& on_request_ready,
-                        boost::asio::ip::tcp::socket&& socket);
+    /// @brief Handles a request and delivers the response via the callback.
+    /// The callback may be invoked from any thread.
+    using RequestHandler = std::function<void(Request&&, ResponseCallback&&)>;
+    /// @brief Decides how the body of a request is read.
+    using HeaderHandler =
+        std::function<BodyPolicy(const RequestHeader&, std::optional<uint64_t> content_length)>;
+
+    struct Settings {
+        size_t pipeline_depth{};
+        std::chrono::milliseconds idle_timeout{};
+        std::chrono::milliseconds active_timeout{};
+    };
+
+    /// @param uring_ptr io_uring of the socket context,
+    /// nullptr to do the I/O via the context reactor
+    explicit TcpSession(const HeaderHandler& on_header_ready,
+                        const RequestHandler& on_request_ready,
+                        boost::asio::ip::tcp::socket&& socket,
+                        const Settings& settings,
+                        std::shared_ptr<common::memory::ArenaPool> arena_pool_ptr,
+                        std::shared_ptr<common::threading::TimingWheel> timing_wheel_ptr,
+                        IoUring* uring_ptr = nullptr);
     void Run();
     
 private:
+    using Buffer = boost::beast::basic_flat_buffer<common::memory::RecyclingAllocator<char>>;
+    using RequestParser = boost::beast::http::request_parser<StringBody, FieldsAllocator>;
+    using StreamParser =
+        boost::beast::http::request_parser<boost::beast::http::buffer_body, FieldsAllocator>;
+    using ResponseSerializer = boost::beast::http::response_serializer<StringBody, Fields>;
+
     void AsyncRead();
+    void OnReadHeader(boost::beast::error_code error_code,
+                      std::size_t bytes_transferred);
+    void HandleHeader();
+    void AsyncMakeBodyPolicy(BodyPolicy&& policy);
+    void OnBodyPolicy(BodyPolicy&& policy);
+    void AsyncContinue();
+    void OnContinue(boost::beast::error_code error_code,
+                    std::size_t bytes_transferred);
+    void AsyncReadBody();
+    void AsyncReadBodyChunk();
+    void OnReadBodyChunk(boost::beast::error_code error_code,
+                         std::size_t bytes_transferred);
+    void AsyncWriteBodyChunk(size_t size);
+    void OnWriteBodyChunk();
     void OnRead(boost::beast::error_code error_code,
                 std::size_t bytes_transferred);
+    void OnStreamRead();
+    void OnRequestRead(Request&& request);
+    void RejectRequest(Response&& response);
+    void OnResponse(size_t sequence_number, Response&& response);
+    void AsyncWrite();
+    void AsyncWriteChunk(const bool close);
+    void OnChunkGenerated(const bool close, ChunkResult result);
+    void OnWriteChunk(const bool close, boost::beast::error_code error_code,
+                      std::size_t bytes_transferred);
+    void OnWriteFileHeader(const bool close, boost::beast::error_code error_code,
+                           std::size_t bytes_transferred);
+    void AsyncSendFile(const bool close);
+    void OnSendFileReady(const bool close, boost::beast::error_code error_code);
     void OnWrite(const bool close, boost::beast::error_code error_code, 
                   std::size_t bytes_transferred);
     void Close();
+    void AsyncDiscard();
+    void OnDiscard(boost::beast::error_code error_code,
+                   std::size_t bytes_transferred);
+
+    void ArmTimeout(std::chrono::milliseconds timeout);
+    void UpdateTimeout();
+    void OnTimeout();
+
+    std::optional<Response>& GetResponseSlot(size_t sequence_number);
+
+    HeaderHandler on_header_ready_;
+    RequestHandler on_request_ready_;
+    Stream stream_;
+    Buffer buffer_;
+    std::shared_ptr<common::memory::ArenaPool> arena_pool_ptr_;
+    std::optional<RequestParser> parser_;
+    // state of the request body being streamed into the sink
+    std::optional<StreamParser> stream_parser_;
+    BodySinkPtr sink_ptr_;
+    SinkExecutor sink_executor_;
+    std::string body_chunk_;
+    // "100 Continue" waits for the responses in flight to be written
+    bool is_continue_pending_;
+    // the wheel has to outlive the timer
+    std::shared_ptr<common::threading::TimingWheel> timing_wheel_ptr_;
+    common::threading::TimingWheel::Timer timer_;
+    bool is_timer_armed_;
 
-    HttpHandler on_request_ready_;
-    boost::beast::tcp_stream stream_;
-    boost::beast::flat_buffer buffer_;
-    Request request_;
-    Response response_;
+    const Settings settings_;
+    const size_t pipeline_depth_;
+    // ring of the responses of the requests in flight in the order of the requests,
+    // the slot of the first one is first_sequence_number_ % pipeline_depth_
+    std::vector<std::optional<Response>> responses_;
+    size_t first_sequence_number_;
+    size_t responses_count_;
+    // number of the requests in flight not handled yet
+    size_t handling_count_;
+    // an unsafe request is being handled, nothing is read ahead of it
+    bool is_unsafe_handling_;
+    // the header of an unsafe request waits for the requests in flight
+    bool is_header_held_;
+    // state of the chunked response being written, the single chunk
+    // buffer is reused so the memory does not depend on the body size
+    std::optional<ResponseSerializer> serializer_;
+    std::string chunk_;
+    // number of bytes of the file range response already sent
+    uint64_t file_sent_size_;
+    bool is_reading_;
+    bool is_writing_;
+    bool is_read_closed_;
+    bool is_closed_;
+    // the unread data of a rejected request is read out before the socket is closed
+    bool is_discarding_;
+    size_t discarded_size_;
 };
 
-} // namespace http::tcp
\ No newline at end of file
+} // namespace http::tcp
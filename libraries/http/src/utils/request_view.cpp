@@ -0,0 +1,129 @@
+#include "http/include/request_view.hpp"
+
+namespace http {
+
+namespace {
+
+int FromHex(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+bool NeedsDecoding(std::string_view value, bool is_plus_space) {
+    // single character searches are vectorized unlike find_first_of
+    return value.find('%') != std::string_view::npos ||
+        (is_plus_space && value.find('+') != std::string_view::npos);
+}
+
+std::optional<std::string_view> Decode(std::string_view name, std::string_view value,
+                                       std::string& buffer, bool is_plus_space) {
+    if (!NeedsDecoding(value, is_plus_space)) {
+        return value;
+    }
+    if (!PercentDecode(value, buffer, is_plus_space)) {
+        throw http::exceptions::BadRequest(common::format::Format(
+            "Parameter \'{}\' is badly encoded", name).c_str());
+    }
+    return std::string_view(buffer);
+}
+
+} // namespace
+
+bool PercentDecode(std::string_view value, std::string& buffer, bool is_plus_space) {
+    buffer.clear();
+    buffer.reserve(value.size());
+    for (size_t i = 0; i < value.size(); i++) {
+        const auto c = value[i];
+        if (c == '+' && is_plus_space) {
+            buffer.push_back(' ');
+        } else if (c == '%') {
+            if (i + 2 >= value.size()) {
+                return false;
+            }
+            const auto high = FromHex(value[i + 1]);
+            const auto low = FromHex(value[i + 2]);
+            if (high < 0 || low < 0) {
+                return false;
+            }
+            buffer.push_back(static_cast<char>(high * 16 + low));
+            i += 2;
+        } else {
+            buffer.push_back(c);
+        }
+    }
+    return true;
+}
+
+RequestView::RequestView(const Request& request)
+    : RequestView(static_cast<const RequestHeader&>(request)) {
+    path_params_ = &request.GetPathParams();
+}
+
+RequestView::RequestView(const RequestHeader& header)
+    : target_{header.target().data(), header.target().size()}, path_params_{nullptr},
+      path_{}, query_{} {
+    const auto query_begin = target_.find('?');
+    path_ = target_.substr(0, query_begin);
+    if (query_begin != std::string_view::npos) {
+        query_ = target_.substr(query_begin + 1);
+    }
+}
+
+std::string_view RequestView::GetPath() const {
+    return path_;
+}
+
+std::string_view RequestView::GetQuery() const {
+    return query_;
+}
+
+std::optional<std::string_view> RequestView::GetRawParam(std::string_view name) const {
+    std::optional<std::string_view> result{};
+    ForEachParam([&result, name](std::string_view param_name, std::string_view value) {
+        if (param_name == name) {
+            result = value;
+        }
+    });
+    return result;
+}
+
+std::optional<std::string_view> RequestView::GetParam(std::string_view name,
+                                                      std::string& buffer) const {
+    const auto value_opt = GetRawParam(name);
+    if (!value_opt.has_value()) {
+        return std::nullopt;
+    }
+    return Decode(name, value_opt.value(), buffer, true);
+}
+
+std::optional<std::string_view> RequestView::GetPathParam(std::string_view name,
+                                                          std::string& buffer) const {
+    const auto value_opt = GetRawPathParam(name);
+    if (!value_opt.has_value()) {
+        return std::nullopt;
+    }
+    // '+' is a literal within a path
+    return Decode(name, value_opt.value(), buffer, false);
+}
+
+std::optional<std::string_view> RequestView::GetRawPathParam(std::string_view name) const {
+    if (path_params_ == nullptr) {
+        return std::nullopt;
+    }
+    return path_params_->Get(target_, name);
+}
+
+void RequestView::ThrowInvalid(std::string_view name) {
+    throw http::exceptions::BadRequest(common::format::Format(
+        "Parameter \'{}\' is invalid", name).c_str());
+}
+
+} // namespace http
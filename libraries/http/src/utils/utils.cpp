@@ -22,6 +22,19 @@ std::string ToString(const Method method) {
     }
 }
 
+bool IsIdempotent(const Method method) {
+    switch (method) {
+        case Method::get:
+        case Method::head:
+        case Method::put:
+        case Method::delete_:
+        case Method::options:
+            return true;
+        default:
+            return false;
+    }
+}
+
 std::unordered_map<std::string, std::string> GetParams(const Request& request) {
     static const char kPathArgumentsPrefix = '?';
     static const char kPathArgumentsDelimiter = '&';
@@ -0,0 +1,247 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <common/include/thread_pool.hpp>
+#include <http/include/balanced_client.hpp>
+#include <http/include/consts.hpp>
+#include <http/include/http_server.hpp>
+#include <http/include/models.hpp>
+
+namespace http::tests::balanced_client {
+
+namespace {
+
+using http::client::BalancedClient;
+using http::client::Balancing;
+using http::client::BalancerSettings;
+
+/// @class Replica of the tests, responds with its name after the delay.
+class Replica {
+public:
+    Replica(common::threading::IoReactorPool& pool, const std::string& name)
+        : delay_ms_{0}, status_{http::Status::ok},
+          server_ptr_{std::make_shared<http::server::HttpServer>(
+              pool.GetContextPtrs().front(), http::consts::kLocalhost, 0)} {
+        server_ptr_->AddListener("/name", http::Method::get, [this, name](http::Request&&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms_.load()));
+            http::Response response{status_.load(), http::consts::kVersion};
+            response.body() = name;
+            return response;
+        }, http::server::Execution::WorkerPool);
+        server_ptr_->Listen();
+    }
+
+    ~Replica() {
+        server_ptr_->Stop();
+    }
+
+    void SetDelay(std::chrono::milliseconds delay) {
+        delay_ms_ = delay.count();
+    }
+
+    void SetStatus(http::Status status) {
+        status_ = status;
+    }
+
+    http::client::Endpoint GetEndpoint() const {
+        return http::client::Endpoint{http::consts::kLocalhost, server_ptr_->GetPort()};
+    }
+
+private:
+    std::atomic<int64_t> delay_ms_;
+    std::atomic<http::Status> status_;
+    std::shared_ptr<http::server::HttpServer> server_ptr_;
+};
+
+const http::Request kRequest{http::Method::get, "/name", http::consts::kVersion};
+
+/// @brief Sends the requests one by one.
+/// @returns number of the responses by the replica names
+std::map<std::string, size_t> SendRequests(BalancedClient& client, size_t count) {
+    std::map<std::string, size_t> counts{};
+    for (size_t i = 0; i < count; i++) {
+        counts[client.Request(kRequest).body()]++;
+    }
+    return counts;
+}
+
+void WaitForOutstanding(const BalancedClient& client) {
+    const auto is_idle = [&client] {
+        for (const auto& endpoint : client.GetStats().endpoints) {
+            if (endpoint.outstanding > 0) {
+                return false;
+            }
+        }
+        return true;
+    };
+    while (!is_idle()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+} // namespace
+
+TEST_CASE("Balancing", "[BalancedClient]") {
+    common::threading::IoReactorPool pool(1);
+    Replica first(pool, "first");
+    Replica second(pool, "second");
+    Replica third(pool, "third");
+    pool.Run();
+    const std::vector<http::client::Endpoint> endpoints{
+        first.GetEndpoint(), second.GetEndpoint(), third.GetEndpoint()};
+
+    SECTION("No endpoints") {
+        CHECK_THROWS_AS(BalancedClient(std::vector<http::client::Endpoint>{}),
+                        std::invalid_argument);
+    }
+
+    SECTION("Least outstanding requests") {
+        BalancerSettings settings{};
+        settings.balancing = Balancing::LeastOutstanding;
+        BalancedClient client(endpoints, settings);
+
+        // the ties are broken round-robin
+        const auto counts = SendRequests(client, 9);
+        CHECK(counts.at("first") == 3);
+        CHECK(counts.at("second") == 3);
+        CHECK(counts.at("third") == 3);
+
+        // the requests in flight are spread over the endpoints
+        first.SetDelay(std::chrono::milliseconds(50));
+        second.SetDelay(std::chrono::milliseconds(50));
+        third.SetDelay(std::chrono::milliseconds(50));
+        std::vector<std::future<http::Response>> futures{};
+        for (size_t i = 0; i < 6; i++) {
+            futures.push_back(client.AsyncRequest(kRequest));
+        }
+        std::map<std::string, size_t> async_counts{};
+        for (auto& future : futures) {
+            async_counts[future.get().body()]++;
+        }
+        CHECK(async_counts.at("first") == 2);
+        CHECK(async_counts.at("second") == 2);
+        CHECK(async_counts.at("third") == 2);
+    }
+
+    SECTION("Power of two choices") {
+        second.SetDelay(std::chrono::milliseconds(20));
+        BalancedClient client({first.GetEndpoint(), second.GetEndpoint()});
+
+        // both of the endpoints are compared, the slow one loses once it is sampled
+        const auto counts = SendRequests(client, 20);
+        CHECK(counts.at("first") >= 18);
+
+        const auto stats = client.GetStats();
+        REQUIRE(stats.endpoints.size() == 2);
+        CHECK(stats.endpoints[1].latency_ewma_ms > stats.endpoints[0].latency_ewma_ms);
+        CHECK(stats.endpoints[0].requests + stats.endpoints[1].requests == 20);
+    }
+
+    SECTION("Failing endpoint is ejected") {
+        second.SetStatus(http::Status::internal_server_error);
+        BalancerSettings settings{};
+        settings.balancing = Balancing::LeastOutstanding;
+        settings.ejection_failures = 2;
+        settings.ejection_time = std::chrono::milliseconds(100);
+        BalancedClient client(endpoints, settings);
+
+        auto counts = SendRequests(client, 12);
+        CHECK(counts.at("second") == 2);
+        auto stats = client.GetStats();
+        CHECK(stats.endpoints[1].is_ejected);
+        CHECK(stats.endpoints[1].ejections == 1);
+        CHECK(stats.endpoints[1].failures == 2);
+
+        // the endpoint is readmitted after the ejection time
+        second.SetStatus(http::Status::ok);
+        std::this_thread::sleep_for(settings.ejection_time * 2);
+        counts = SendRequests(client, 6);
+        CHECK(counts.at("second") == 2);
+        stats = client.GetStats();
+        CHECK_FALSE(stats.endpoints[1].is_ejected);
+    }
+
+    SECTION("Slow endpoint is ejected") {
+        third.SetDelay(std::chrono::milliseconds(30));
+        BalancerSettings settings{};
+        settings.balancing = Balancing::LeastOutstanding;
+        settings.ejection_min_samples = 3;
+        BalancedClient client(endpoints, settings);
+
+        const auto counts = SendRequests(client, 15);
+        CHECK(counts.at("third") == 3);
+        const auto stats = client.GetStats();
+        CHECK(stats.endpoints[2].is_ejected);
+        CHECK(stats.endpoints[2].ejections == 1);
+    }
+
+    SECTION("At most a share of the endpoints is ejected") {
+        first.SetStatus(http::Status::internal_server_error);
+        second.SetStatus(http::Status::internal_server_error);
+        BalancerSettings settings{};
+        settings.balancing = Balancing::LeastOutstanding;
+        settings.ejection_failures = 1;
+        BalancedClient client(endpoints, settings);
+
+        SendRequests(client, 9);
+        const auto stats = client.GetStats();
+        CHECK(stats.endpoints[0].is_ejected);
+        CHECK_FALSE(stats.endpoints[1].is_ejected);
+        CHECK_FALSE(stats.endpoints[2].is_ejected);
+    }
+
+    pool.Stop();
+}
+
+TEST_CASE("Hedging", "[BalancedClient]") {
+    common::threading::IoReactorPool pool(1);
+    Replica first(pool, "first");
+    Replica second(pool, "second");
+    pool.Run();
+
+    BalancerSettings settings{};
+    settings.balancing = Balancing::LeastOutstanding;
+    settings.hedging = true;
+    settings.hedge_percentile = 50.0;
+    settings.hedge_window_size = 10;
+    settings.ejection_min_samples = 1000;
+    BalancedClient client({first.GetEndpoint(), second.GetEndpoint()}, settings);
+
+    // there is no hedging until the first window is over
+    SendRequests(client, 10);
+    auto stats = client.GetStats();
+    CHECK(stats.hedges == 0);
+    CHECK(stats.hedge_delay >= settings.min_hedge_delay);
+
+    first.SetDelay(std::chrono::milliseconds(500));
+    for (size_t i = 0; i < 4; i++) {
+        const auto started_at = std::chrono::steady_clock::now();
+        CHECK(client.Request(kRequest).body() == "second");
+        CHECK(std::chrono::steady_clock::now() - started_at < std::chrono::milliseconds(300));
+    }
+    stats = client.GetStats();
+    CHECK(stats.hedges >= 1);
+    CHECK(stats.hedge_wins >= 1);
+
+    // a request which is not idempotent is never hedged
+    const auto hedges = stats.hedges;
+    for (size_t i = 0; i < 2; i++) {
+        http::Request request{http::Method::post, "/name", http::consts::kVersion};
+        client.Request(request);
+    }
+    CHECK(client.GetStats().hedges == hedges);
+
+    WaitForOutstanding(client);
+    pool.Stop();
+}
+
+} // namespace http::tests::balanced_client
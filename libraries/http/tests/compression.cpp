@@ -0,0 +1,228 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <zlib.h>
+
+#include <catch2/catch.hpp>
+
+#include <common/include/thread_pool.hpp>
+#include <http/include/compression.hpp>
+#include <http/include/consts.hpp>
+#include <http/include/http_client.hpp>
+#include <http/include/http_server.hpp>
+
+namespace http::tests::compression {
+
+namespace {
+
+using http::compression::Encoding;
+
+/// @brief Inflates gzip or zlib stream.
+std::string Decompress(const std::string& data) {
+    z_stream stream{};
+    // detects gzip or zlib header automatically
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+        throw std::runtime_error("inflateInit2");
+    }
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    std::string result{};
+    int code = Z_OK;
+    while (code == Z_OK) {
+        char buffer[4096];
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = sizeof(buffer);
+        code = inflate(&stream, Z_NO_FLUSH);
+        result.append(buffer, sizeof(buffer) - stream.avail_out);
+    }
+    inflateEnd(&stream);
+    if (code != Z_STREAM_END) {
+        throw std::runtime_error("broken stream");
+    }
+    return result;
+}
+
+std::string MakeText(size_t size) {
+    std::string text{};
+    while (text.size() < size) {
+        text += "{\"id\": " + std::to_string(text.size()) + ", \"name\": \"document\"}, ";
+    }
+    text.resize(size);
+    return text;
+}
+
+struct EncodingCase {
+    std::string accept_encoding{};
+    Encoding expected{};
+};
+
+} // namespace
+
+TEST_CASE("ChooseEncoding", "[Compression]") {
+    auto test_case = GENERATE(
+        EncodingCase{"", Encoding::Identity},
+        EncodingCase{"identity", Encoding::Identity},
+        EncodingCase{"br", Encoding::Identity},
+        EncodingCase{"gzip", Encoding::Gzip},
+        EncodingCase{"GZip", Encoding::Gzip},
+        EncodingCase{"x-gzip", Encoding::Gzip},
+        EncodingCase{"deflate", Encoding::Deflate},
+        EncodingCase{"gzip, deflate, br", Encoding::Gzip},
+        EncodingCase{"deflate, gzip", Encoding::Gzip},
+        EncodingCase{"gzip;q=0.5, deflate", Encoding::Deflate},
+        EncodingCase{"gzip; q=0.8, deflate;q=0.9", Encoding::Deflate},
+        EncodingCase{"gzip;q=0, deflate;q=0", Encoding::Identity},
+        EncodingCase{"*", Encoding::Gzip},
+        EncodingCase{"gzip;q=0, *", Encoding::Deflate},
+        EncodingCase{"*;q=0", Encoding::Identity},
+        EncodingCase{"gzip;q=invalid", Encoding::Gzip}
+    );
+    CAPTURE(test_case.accept_encoding);
+    CHECK(http::compression::ChooseEncoding(test_case.accept_encoding) == test_case.expected);
+}
+
+TEST_CASE("Streaming compressor", "[Compression]") {
+    const auto encoding = GENERATE(Encoding::Gzip, Encoding::Deflate);
+    const auto text = MakeText(1024 * 1024);
+
+    SECTION("Single part") {
+        http::compression::Compressor compressor(encoding, 6);
+        std::string output{};
+        compressor.Compress(text, output);
+        compressor.Finish(output);
+        CHECK(output.size() < text.size() / 4);
+        CHECK(Decompress(output) == text);
+    }
+
+    SECTION("Many parts") {
+        http::compression::Compressor compressor(encoding, 1);
+        std::string output{};
+        for (size_t offset = 0; offset < text.size(); offset += 1000) {
+            compressor.Compress(std::string_view(text).substr(offset, 1000), output);
+        }
+        compressor.Finish(output);
+        CHECK(Decompress(output) == text);
+    }
+
+    SECTION("Empty input") {
+        http::compression::Compressor compressor(encoding, 6);
+        std::string output{};
+        compressor.Finish(output);
+        CHECK(Decompress(output).empty());
+    }
+}
+
+TEST_CASE("Compressed responses", "[HttpServer]") {
+    constexpr size_t kMinSize = 1000;
+    const auto text = MakeText(100 * 1000);
+
+    http::server::ServerSettings settings{};
+    settings.compression.enabled = true;
+    settings.compression.min_size = kMinSize;
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0, settings);
+    server_ptr->AddListener("/text", http::Method::get, [&text](http::Request&& request) {
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.body() = text.substr(0, std::stoul(std::string(request.body())));
+        return response;
+    });
+    server_ptr->AddListener("/stream", http::Method::get, [&text](http::Request&&) {
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.SetChunkGenerator([&text, offset = size_t{0}](std::string& chunk) mutable {
+            if (offset == text.size()) {
+                return false;
+            }
+            chunk = text.substr(offset, 1000);
+            offset += chunk.size();
+            return true;
+        });
+        return response;
+    });
+    server_ptr->Listen();
+    pool.Run();
+
+    http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+    const auto request = [&client](const std::string& target, const std::string& accept_encoding,
+                                   size_t size) {
+        http::Request request{http::Method::get, target, http::consts::kVersion};
+        if (!accept_encoding.empty()) {
+            request.set(boost::beast::http::field::accept_encoding, accept_encoding);
+        }
+        request.body() = std::to_string(size);
+        request.prepare_payload();
+        return client.Request(std::move(request));
+    };
+    const auto get_encoding = [](const http::Response& response) {
+        return response[boost::beast::http::field::content_encoding].to_string();
+    };
+
+    SECTION("Not accepted") {
+        const auto response = request("/text", "", text.size());
+        CHECK(get_encoding(response).empty());
+        CHECK(response.body() == text);
+    }
+
+    SECTION("Below the threshold") {
+        const auto response = request("/text", "gzip", kMinSize - 1);
+        CHECK(get_encoding(response).empty());
+        CHECK(response.body() == text.substr(0, kMinSize - 1));
+    }
+
+    SECTION("Negotiated") {
+        auto response = request("/text", "gzip", text.size());
+        CHECK(get_encoding(response) == "gzip");
+        CHECK(response[boost::beast::http::field::vary] == "Accept-Encoding");
+        CHECK(response.body().size() < text.size() / 4);
+        CHECK(Decompress(response.body()) == text);
+
+        response = request("/text", "deflate", text.size());
+        CHECK(get_encoding(response) == "deflate");
+        CHECK(Decompress(response.body()) == text);
+    }
+
+    SECTION("Chunked") {
+        const auto response = request("/stream", "gzip", 0);
+        CHECK(response.chunked());
+        CHECK(get_encoding(response) == "gzip");
+        CHECK(Decompress(response.body()) == text);
+    }
+
+    const auto stats = server_ptr->GetCompressionStats();
+    CHECK(stats.input_bytes >= stats.output_bytes);
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("Compression stats", "[HttpServer]") {
+    const auto text = MakeText(10 * 1000);
+    http::server::ServerSettings settings{};
+    settings.compression.enabled = true;
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0, settings);
+    server_ptr->AddListener("/text", http::Method::get, [&text](http::Request&&) {
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.body() = text;
+        return response;
+    });
+    server_ptr->Listen();
+    pool.Run();
+
+    http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+    http::Request request{http::Method::get, "/text", http::consts::kVersion};
+    request.set(boost::beast::http::field::accept_encoding, "gzip");
+    const auto response = client.Request(std::move(request));
+
+    const auto stats = server_ptr->GetCompressionStats();
+    CHECK(stats.responses == 1);
+    CHECK(stats.input_bytes == text.size());
+    CHECK(stats.output_bytes == response.body().size());
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+} // namespace http::tests::compression
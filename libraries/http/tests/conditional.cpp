@@ -0,0 +1,179 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include <common/include/thread_pool.hpp>
+#include <http/include/conditional.hpp>
+#include <http/include/consts.hpp>
+#include <http/include/exceptions.hpp>
+#include <http/include/http_client.hpp>
+#include <http/include/http_server.hpp>
+
+namespace http::tests::conditional {
+
+namespace {
+
+namespace boost_http = boost::beast::http;
+
+using http::conditional::Validators;
+
+// Sun, 06 Nov 1994 08:49:37 GMT
+const auto kTime = std::chrono::system_clock::from_time_t(784111777);
+
+Request MakeRequest(Method method = Method::get) {
+    return Request{method, "/", consts::kVersion};
+}
+
+} // namespace
+
+TEST_CASE("HTTP date", "[Conditional]") {
+    CHECK(http::conditional::ToHttpDate(kTime) == "Sun, 06 Nov 1994 08:49:37 GMT");
+    CHECK(http::conditional::ToHttpDate(kTime + std::chrono::milliseconds(999)) ==
+          "Sun, 06 Nov 1994 08:49:37 GMT");
+    CHECK(http::conditional::ParseHttpDate("Sun, 06 Nov 1994 08:49:37 GMT") == kTime);
+    CHECK_FALSE(http::conditional::ParseHttpDate("Sunday, 06-Nov-94 08:49:37 GMT").has_value());
+    CHECK_FALSE(http::conditional::ParseHttpDate("yesterday").has_value());
+}
+
+TEST_CASE("ETag preconditions", "[Conditional]") {
+    CHECK(http::conditional::MakeETag("1-2") == "\"1-2\"");
+    CHECK(http::conditional::MakeETag("1-2", true) == "W/\"1-2\"");
+
+    const Validators validators{
+        http::conditional::MakeETag("a,b"),  // etag
+        kTime,                               // last_modified
+    };
+    const auto is_not_modified = [&validators](const std::string& if_none_match,
+                                               Method method = Method::get) {
+        auto request = MakeRequest(method);
+        request.set(boost_http::field::if_none_match, if_none_match);
+        return http::conditional::IsNotModified(request, validators);
+    };
+
+    CHECK(is_not_modified("\"a,b\""));
+    CHECK(is_not_modified("W/\"a,b\""));
+    CHECK(is_not_modified("\"x\", \"a,b\""));
+    CHECK(is_not_modified("*"));
+    CHECK_FALSE(is_not_modified("\"a\""));
+    CHECK_FALSE(is_not_modified("\"a,b"));
+    CHECK_FALSE(is_not_modified("\"a,b\"", Method::post));
+
+    // If-None-Match takes precedence over If-Modified-Since
+    auto request = MakeRequest();
+    request.set(boost_http::field::if_none_match, "\"a\"");
+    request.set(boost_http::field::if_modified_since, http::conditional::ToHttpDate(kTime));
+    CHECK_FALSE(http::conditional::IsNotModified(request, validators));
+
+    // no entity tag matches nothing
+    CHECK_FALSE(http::conditional::IsNotModified(request, Validators{}));
+}
+
+TEST_CASE("Last-Modified preconditions", "[Conditional]") {
+    const Validators validators{
+        std::nullopt,                              // etag
+        kTime + std::chrono::milliseconds(500),    // last_modified
+    };
+    const auto is_not_modified = [&validators](const std::string& if_modified_since) {
+        auto request = MakeRequest();
+        request.set(boost_http::field::if_modified_since, if_modified_since);
+        return http::conditional::IsNotModified(request, validators);
+    };
+
+    CHECK(is_not_modified("Sun, 06 Nov 1994 08:49:37 GMT"));
+    CHECK(is_not_modified("Sun, 06 Nov 1994 08:49:38 GMT"));
+    CHECK_FALSE(is_not_modified("Sun, 06 Nov 1994 08:49:36 GMT"));
+    CHECK_FALSE(is_not_modified("invalid date"));
+    CHECK_FALSE(http::conditional::IsNotModified(MakeRequest(), validators));
+}
+
+TEST_CASE("Conditional GET", "[HttpServer]") {
+    std::atomic<size_t> handled{0};
+    std::atomic<size_t> version{1};
+
+    http::server::ServerSettings settings{};
+    settings.compression.enabled = true;
+    settings.compression.min_size = 16;
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0, settings);
+    server_ptr->AddListener("/resource", http::Method::get,
+        [&handled, &version](http::Request&&) {
+            handled++;
+            http::Response response{http::Status::ok, http::consts::kVersion};
+            response.body() = std::string(100, 'a') + std::to_string(version.load());
+            return response;
+        },
+        [&version](const http::Request& request) {
+            if (request.target().ends_with("missing")) {
+                throw http::exceptions::NotFound("missing");
+            }
+            return Validators{
+                http::conditional::MakeETag(std::to_string(version.load())),  // etag
+                kTime,                                                         // last_modified
+            };
+        });
+    server_ptr->Listen();
+    pool.Run();
+
+    http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+    const auto request = [&client](boost_http::field field, const std::string& value,
+                                   const std::string& target = "/resource") {
+        http::Request request{http::Method::get, target, http::consts::kVersion};
+        if (!value.empty()) {
+            request.set(field, value);
+        }
+        return client.Request(std::move(request));
+    };
+
+    SECTION("Validators are set") {
+        const auto response = request(boost_http::field::if_none_match, "");
+        CHECK(response.result() == http::Status::ok);
+        CHECK(response[boost_http::field::etag] == "\"1\"");
+        CHECK(response[boost_http::field::last_modified] == "Sun, 06 Nov 1994 08:49:37 GMT");
+        CHECK(handled == 1);
+    }
+
+    SECTION("Not modified") {
+        auto response = request(boost_http::field::if_none_match, "\"1\"");
+        CHECK(response.result() == http::Status::not_modified);
+        CHECK(response.body().empty());
+        CHECK(response[boost_http::field::etag] == "\"1\"");
+
+        response = request(boost_http::field::if_modified_since, "Sun, 06 Nov 1994 08:49:37 GMT");
+        CHECK(response.result() == http::Status::not_modified);
+        CHECK(handled == 0);
+
+        // the connection is kept alive after a response without a body
+        version = 2;
+        response = request(boost_http::field::if_none_match, "\"1\"");
+        CHECK(response.result() == http::Status::ok);
+        CHECK(response[boost_http::field::etag] == "\"2\"");
+        CHECK(handled == 1);
+    }
+
+    SECTION("Compressed representation") {
+        const auto response = request(boost_http::field::accept_encoding, "gzip");
+        CHECK(response[boost_http::field::content_encoding] == "gzip");
+        CHECK(response[boost_http::field::etag] == "W/\"1\"");
+
+        // the weak tag is still matched
+        http::Request conditional_request{http::Method::get, "/resource", http::consts::kVersion};
+        conditional_request.set(boost_http::field::accept_encoding, "gzip");
+        conditional_request.set(boost_http::field::if_none_match, "W/\"1\"");
+        CHECK(client.Request(conditional_request).result() == http::Status::not_modified);
+    }
+
+    SECTION("Validators error") {
+        const auto response = request(boost_http::field::if_none_match, "\"1\"",
+                                      "/resource?missing");
+        CHECK(response.result() == http::Status::not_found);
+        CHECK(handled == 0);
+    }
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+} // namespace http::tests::conditional
@@ -0,0 +1,251 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <common/include/thread_pool.hpp>
+#include <http/include/consts.hpp>
+#include <http/include/default_handlers.hpp>
+#include <http/include/dns_cache.hpp>
+#include <http/include/http_client.hpp>
+#include <http/include/http_server.hpp>
+
+namespace http::tests::dns_cache {
+
+namespace {
+
+using http::client::DnsCache;
+using http::client::Endpoints;
+
+/// @class Stand-in resolver of the tests. Resolves the known hosts to the
+/// configured address, the resolution may be held to observe the waiting.
+class LocalResolver {
+public:
+    void SetAddress(const std::string& host, const std::string& address) {
+        std::lock_guard lock(mutex_);
+        hosts_[host] = address;
+    }
+
+    void Hold() {
+        std::lock_guard lock(mutex_);
+        held_promise_ptr_ = std::make_shared<std::promise<void>>();
+        held_future_ = held_promise_ptr_->get_future().share();
+    }
+
+    void Resume() {
+        std::lock_guard lock(mutex_);
+        if (held_promise_ptr_ != nullptr) {
+            held_promise_ptr_->set_value();
+            held_promise_ptr_.reset();
+        }
+    }
+
+    size_t GetCallsCount() const {
+        return calls_count_;
+    }
+
+    http::client::ResolveFunction GetFunction() {
+        return [this](const std::string& host, const std::string& port) {
+            calls_count_++;
+            std::shared_future<void> held_future{};
+            std::string address{};
+            {
+                std::lock_guard lock(mutex_);
+                held_future = held_future_;
+                const auto it = hosts_.find(host);
+                if (it != hosts_.end()) {
+                    address = it->second;
+                }
+            }
+            if (held_future.valid()) {
+                held_future.wait();
+            }
+            if (address.empty()) {
+                throw std::runtime_error("Cannot resolve host \'" + host + "\'");
+            }
+            return Endpoints{boost::asio::ip::tcp::endpoint(
+                boost::asio::ip::make_address(address),
+                static_cast<unsigned short>(std::stoi(port)))};
+        };
+    }
+
+private:
+    std::mutex mutex_{};
+    std::unordered_map<std::string, std::string> hosts_{};
+    std::shared_ptr<std::promise<void>> held_promise_ptr_{};
+    std::shared_future<void> held_future_{};
+    std::atomic<size_t> calls_count_{0};
+};
+
+std::string GetAddress(const Endpoints& endpoints) {
+    REQUIRE(endpoints.size() == 1);
+    return endpoints.front().address().to_string();
+}
+
+} // namespace
+
+TEST_CASE("DNS cache", "[DnsCache]") {
+    LocalResolver resolver{};
+    resolver.SetAddress("service", "10.0.0.1");
+    http::client::DnsCacheSettings settings{};
+    settings.ttl = std::chrono::milliseconds(100);
+    settings.negative_ttl = std::chrono::milliseconds(100);
+    DnsCache cache(settings, resolver.GetFunction());
+
+    SECTION("Hit") {
+        CHECK(GetAddress(cache.Resolve("service", "80")) == "10.0.0.1");
+        CHECK(GetAddress(cache.Resolve("service", "80")) == "10.0.0.1");
+        CHECK(resolver.GetCallsCount() == 1);
+        // the port is a part of the key
+        CHECK(cache.Resolve("service", "81").front().port() == 81);
+        CHECK(resolver.GetCallsCount() == 2);
+
+        const auto stats = cache.GetStats();
+        CHECK(stats.hits == 1);
+        CHECK(stats.misses == 2);
+        CHECK(stats.resolutions == 2);
+    }
+
+    SECTION("Concurrent misses share the resolution") {
+        resolver.Hold();
+        std::vector<std::future<Endpoints>> futures{};
+        for (size_t i = 0; i < 4; i++) {
+            futures.push_back(std::async(std::launch::async, [&cache] {
+                return cache.Resolve("service", "80");
+            }));
+        }
+        while (cache.GetStats().misses < futures.size()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        resolver.Resume();
+        for (auto& future : futures) {
+            CHECK(GetAddress(future.get()) == "10.0.0.1");
+        }
+        CHECK(resolver.GetCallsCount() == 1);
+    }
+
+    SECTION("Negative caching") {
+        CHECK_THROWS_AS(cache.Resolve("missing", "80"), std::runtime_error);
+        CHECK_THROWS_AS(cache.Resolve("missing", "80"), std::runtime_error);
+        CHECK(resolver.GetCallsCount() == 1);
+
+        resolver.SetAddress("missing", "10.0.0.2");
+        std::this_thread::sleep_for(settings.negative_ttl * 2);
+        CHECK(GetAddress(cache.Resolve("missing", "80")) == "10.0.0.2");
+        CHECK(resolver.GetCallsCount() == 2);
+        CHECK(cache.GetStats().failures == 1);
+    }
+
+    SECTION("Stale host is refreshed in background") {
+        CHECK(GetAddress(cache.Resolve("service", "80")) == "10.0.0.1");
+        std::this_thread::sleep_for(settings.ttl * 2);
+
+        resolver.SetAddress("service", "10.0.0.3");
+        resolver.Hold();
+        // the stale address is returned in place while the refresh is held
+        bool is_invoked_in_place = false;
+        cache.Resolve("service", "80",
+            [&is_invoked_in_place](std::exception_ptr error_ptr, const Endpoints& endpoints) {
+                CHECK(error_ptr == nullptr);
+                CHECK(GetAddress(endpoints) == "10.0.0.1");
+                is_invoked_in_place = true;
+            });
+        CHECK(is_invoked_in_place);
+        CHECK(GetAddress(cache.Resolve("service", "80")) == "10.0.0.1");
+        resolver.Resume();
+
+        while (cache.GetStats().resolutions < 2) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK(GetAddress(cache.Resolve("service", "80")) == "10.0.0.3");
+        CHECK(resolver.GetCallsCount() == 2);
+        CHECK(cache.GetStats().stale_hits == 2);
+    }
+
+    SECTION("Failed refresh keeps the stale host") {
+        CHECK(GetAddress(cache.Resolve("service", "80")) == "10.0.0.1");
+        std::this_thread::sleep_for(settings.ttl * 2);
+
+        resolver.SetAddress("service", "");
+        CHECK(GetAddress(cache.Resolve("service", "80")) == "10.0.0.1");
+        while (cache.GetStats().resolutions < 2) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK(GetAddress(cache.Resolve("service", "80")) == "10.0.0.1");
+        CHECK(resolver.GetCallsCount() == 2);
+    }
+
+    SECTION("Clear") {
+        CHECK(GetAddress(cache.Resolve("service", "80")) == "10.0.0.1");
+        cache.Clear();
+        CHECK(GetAddress(cache.Resolve("service", "80")) == "10.0.0.1");
+        CHECK(resolver.GetCallsCount() == 2);
+    }
+
+    resolver.Resume();
+}
+
+TEST_CASE("HttpClient resolves through the cache", "[DnsCache]") {
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0);
+    server_ptr->AddListener("/ping", http::Method::get, &http::handlers::handle_ping);
+    server_ptr->Listen();
+    pool.Run();
+
+    LocalResolver resolver{};
+    resolver.SetAddress("ping.service", http::consts::kLocalhost);
+    http::client::ClientSettings settings{};
+    settings.dns_cache_ptr = std::make_shared<DnsCache>(
+        http::client::DnsCacheSettings{}, resolver.GetFunction());
+    // every request opens a connection of its own
+    settings.max_idle_connections = 0;
+
+    http::client::HttpClient client("ping.service", server_ptr->GetPort(), settings);
+    for (size_t i = 0; i < 3; i++) {
+        const auto response = client.Request(
+            http::Request{http::Method::get, "/ping", http::consts::kVersion});
+        CHECK(response.result() == http::Status::ok);
+    }
+    CHECK(client.GetPoolStats().connects == 3);
+    CHECK(resolver.GetCallsCount() == 1);
+
+    http::client::HttpClient missing_client("missing.service", server_ptr->GetPort(), settings);
+    CHECK_THROWS_AS(missing_client.Request(
+        http::Request{http::Method::get, "/ping", http::consts::kVersion}), std::runtime_error);
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("HttpClient destroyed while resolving", "[DnsCache]") {
+    LocalResolver resolver{};
+    resolver.SetAddress("ping.service", http::consts::kLocalhost);
+    resolver.Hold();
+    http::client::ClientSettings settings{};
+    settings.dns_cache_ptr = std::make_shared<DnsCache>(
+        http::client::DnsCacheSettings{}, resolver.GetFunction());
+
+    std::future<http::Response> future{};
+    {
+        http::client::HttpClient client("ping.service", 80, settings);
+        future = client.AsyncRequest(
+            http::Request{http::Method::get, "/ping", http::consts::kVersion});
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        CHECK(resolver.GetCallsCount() == 1);
+    }
+    // the resolution completes after the client context is gone
+    resolver.Resume();
+    settings.dns_cache_ptr.reset();
+    CHECK_THROWS(future.get());
+}
+
+} // namespace http::tests::dns_cache
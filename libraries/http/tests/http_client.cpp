@@ -0,0 +1,378 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <common/include/thread_pool.hpp>
+#include <http/include/consts.hpp>
+#include <http/include/default_handlers.hpp>
+#include <http/include/dns_cache.hpp>
+#include <http/include/http_client.hpp>
+#include <http/include/http_server.hpp>
+#include <http/include/models.hpp>
+
+namespace http::tests::http_client {
+
+namespace {
+
+http::Response Ping(http::client::HttpClient& client, bool keep_alive = true) {
+    http::Request request{http::Method::get, "/ping", http::consts::kVersion};
+    request.keep_alive(keep_alive);
+    return client.Request(request);
+}
+
+} // namespace
+
+TEST_CASE("Connection pool", "[HttpClient]") {
+    http::server::ServerSettings server_settings{};
+    server_settings.idle_timeout = std::chrono::milliseconds(200);
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0, server_settings);
+    server_ptr->AddListener("/ping", http::Method::get, &http::handlers::handle_ping);
+    server_ptr->Listen();
+    pool.Run();
+
+    SECTION("Keep-alive connection is reused") {
+        http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+        for (size_t i = 0; i < 8; i++) {
+            CHECK(Ping(client).result() == http::Status::ok);
+        }
+        const auto stats = client.GetPoolStats();
+        CHECK(stats.connects == 1);
+        CHECK(stats.reuses == 7);
+        CHECK(stats.active == 0);
+        CHECK(stats.idle == 1);
+    }
+
+    SECTION("Closed connection is not reused") {
+        http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+        CHECK(Ping(client, false).result() == http::Status::ok);
+        CHECK(client.GetPoolStats().idle == 0);
+        CHECK(Ping(client).result() == http::Status::ok);
+        CHECK(client.GetPoolStats().connects == 2);
+    }
+
+    SECTION("Connection closed by the server") {
+        http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+        CHECK(Ping(client).result() == http::Status::ok);
+        std::this_thread::sleep_for(server_settings.idle_timeout * 2);
+        // the health check drops the connection before the request is sent
+        CHECK(Ping(client).result() == http::Status::ok);
+        const auto stats = client.GetPoolStats();
+        CHECK(stats.connects == 2);
+        CHECK(stats.reuses == 0);
+    }
+
+    SECTION("Idle timeout") {
+        http::client::ClientSettings settings{};
+        settings.idle_timeout = std::chrono::milliseconds(50);
+        http::client::HttpClient client(
+            http::consts::kLocalhost, server_ptr->GetPort(), settings);
+        CHECK(Ping(client).result() == http::Status::ok);
+        std::this_thread::sleep_for(settings.idle_timeout * 2);
+        CHECK(Ping(client).result() == http::Status::ok);
+        CHECK(client.GetPoolStats().connects == 2);
+    }
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("Concurrent requests", "[HttpClient]") {
+    constexpr size_t kThreadsCount = 4;
+    constexpr size_t kRequestsCount = 10;
+
+    std::atomic<size_t> in_flight{0};
+    std::atomic<size_t> max_in_flight{0};
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0);
+    server_ptr->AddListener("/ping", http::Method::get,
+                            [&in_flight, &max_in_flight](http::Request&& request) {
+        const auto current = ++in_flight;
+        auto max = max_in_flight.load();
+        while (current > max && !max_in_flight.compare_exchange_weak(max, current)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        in_flight--;
+        return http::handlers::handle_ping(std::move(request));
+    }, http::server::Execution::WorkerPool);
+    server_ptr->Listen();
+    pool.Run();
+
+    http::client::ClientSettings settings{};
+    settings.max_connections = 2;
+    settings.max_idle_connections = 1;
+    http::client::HttpClient client(
+        http::consts::kLocalhost, server_ptr->GetPort(), settings);
+
+    std::atomic<size_t> ok_count{0};
+    std::vector<std::thread> threads{};
+    for (size_t i = 0; i < kThreadsCount; i++) {
+        threads.emplace_back([&client, &ok_count] {
+            for (size_t j = 0; j < kRequestsCount; j++) {
+                if (Ping(client).result() == http::Status::ok) {
+                    ok_count++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    CHECK(ok_count == kThreadsCount * kRequestsCount);
+    CHECK(max_in_flight <= settings.max_connections);
+    const auto stats = client.GetPoolStats();
+    CHECK(stats.connects + stats.reuses == kThreadsCount * kRequestsCount);
+    CHECK(stats.active == 0);
+    CHECK(stats.idle <= settings.max_idle_connections);
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("Asynchronous requests", "[HttpClient]") {
+    common::threading::IoReactorPool pool(1);
+    const auto context_ptr = pool.GetContextPtrs().front();
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        context_ptr, http::consts::kLocalhost, 0);
+    server_ptr->AddListener("/ping", http::Method::get, &http::handlers::handle_ping);
+    server_ptr->Listen();
+    pool.Run();
+
+    // the client shares the context of the server
+    http::client::HttpClient client(context_ptr, http::consts::kLocalhost, server_ptr->GetPort());
+    const http::Request ping_request{http::Method::get, "/ping", http::consts::kVersion};
+
+    SECTION("Callback") {
+        std::promise<std::thread::id> promise{};
+        client.AsyncRequest(ping_request,
+            [&promise](std::exception_ptr error_ptr, http::Response&& response) {
+                CHECK(error_ptr == nullptr);
+                CHECK(response.body() == std::string("OK"));
+                promise.set_value(std::this_thread::get_id());
+            });
+        const auto callback_thread_id = promise.get_future().get();
+        CHECK(callback_thread_id != std::this_thread::get_id());
+        CHECK(client.GetPoolStats().idle == 1);
+    }
+
+    SECTION("Future") {
+        auto first = client.AsyncRequest(ping_request);
+        auto second = client.AsyncRequest(ping_request);
+        CHECK(first.get().body() == std::string("OK"));
+        CHECK(second.get().body() == std::string("OK"));
+        CHECK(client.Request(ping_request).body() == std::string("OK"));
+    }
+
+    SECTION("Connection error") {
+        boost::asio::io_context context{};
+        boost::asio::ip::tcp::acceptor acceptor(context, boost::asio::ip::tcp::endpoint(
+            boost::asio::ip::make_address(http::consts::kLocalhost), 0));
+        const auto closed_port = acceptor.local_endpoint().port();
+        acceptor.close();
+
+        http::client::HttpClient closed_client(
+            context_ptr, http::consts::kLocalhost, closed_port);
+        auto future = closed_client.AsyncRequest(ping_request);
+        CHECK_THROWS_AS(future.get(), boost::system::system_error);
+        CHECK(closed_client.GetPoolStats().active == 0);
+    }
+
+    SECTION("Client destroyed while resolving") {
+        // the resolution is held until the client is gone
+        std::promise<void> resolve_promise{};
+        auto resolve_future = resolve_promise.get_future().share();
+        http::client::ClientSettings settings{};
+        settings.dns_cache_ptr = std::make_shared<http::client::DnsCache>(
+            http::client::DnsCacheSettings{},
+            [resolve_future](const std::string&, const std::string& port) {
+                resolve_future.wait();
+                return http::client::Endpoints{boost::asio::ip::tcp::endpoint(
+                    boost::asio::ip::make_address(http::consts::kLocalhost),
+                    static_cast<unsigned short>(std::stoi(port)))};
+            });
+        std::future<http::Response> future{};
+        {
+            http::client::HttpClient resolving_client(
+                context_ptr, "ping.service", server_ptr->GetPort(), settings);
+            future = resolving_client.AsyncRequest(ping_request);
+        }
+        resolve_promise.set_value();
+        // the context of the caller outlives the client and completes the request
+        REQUIRE(future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+        CHECK(future.get().body() == std::string("OK"));
+    }
+
+    SECTION("Blocking request from the context") {
+        std::promise<bool> promise{};
+        boost::asio::post(*context_ptr, [&client, &ping_request, &promise] {
+            try {
+                client.Request(ping_request);
+                promise.set_value(false);
+            } catch (const std::logic_error&) {
+                promise.set_value(true);
+            }
+        });
+        CHECK(promise.get_future().get());
+    }
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("Fan-out", "[HttpClient]") {
+    constexpr size_t kBackendsCount = 2;
+
+    std::mutex mutex{};
+    std::condition_variable all_arrived{};
+    size_t in_flight = 0;
+    size_t max_in_flight = 0;
+
+    common::threading::IoReactorPool pool(1);
+    const auto context_ptr = pool.GetContextPtrs().front();
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        context_ptr, http::consts::kLocalhost, 0);
+    // each backend request waits for the rest of them, so the gateway
+    // response is only complete if they are sent concurrently
+    server_ptr->AddListener("/backend", http::Method::get, [&](http::Request&& request) {
+        std::unique_lock lock(mutex);
+        in_flight++;
+        max_in_flight = std::max(max_in_flight, in_flight);
+        all_arrived.notify_all();
+        all_arrived.wait_for(lock, std::chrono::seconds(2),
+                             [&] { return max_in_flight == kBackendsCount; });
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.body() = request.target().to_string();
+        return response;
+    }, http::server::Execution::WorkerPool);
+    server_ptr->Listen();
+
+    http::client::HttpClient client(context_ptr, http::consts::kLocalhost, server_ptr->GetPort());
+    server_ptr->AddListener("/gateway", http::Method::get,
+        [&client](http::Request&&, http::ResponseCallback&& callback) {
+            std::vector<http::client::ClientRequest> requests{};
+            for (const auto target : {"/backend?id=1", "/backend?id=2"}) {
+                requests.push_back(http::client::ClientRequest{
+                    &client,                                                        // client_ptr
+                    http::Request{http::Method::get, target, http::consts::kVersion}, // request
+                });
+            }
+            http::client::RequestAll(std::move(requests),
+                [callback = std::move(callback)](
+                        std::vector<std::future<http::Response>>&& futures) {
+                    http::Response response{http::Status::ok, http::consts::kVersion};
+                    for (auto& future : futures) {
+                        response.body() += future.get().body() + ";";
+                    }
+                    callback(std::move(response));
+                });
+        });
+    pool.Run();
+
+    http::client::HttpClient gateway_client(http::consts::kLocalhost, server_ptr->GetPort());
+    const auto response = gateway_client.Request(
+        http::Request{http::Method::get, "/gateway", http::consts::kVersion});
+    CHECK(response.result() == http::Status::ok);
+    CHECK(response.body() == std::string("/backend?id=1;/backend?id=2;"));
+    CHECK(max_in_flight == kBackendsCount);
+
+    SECTION("Futures") {
+        std::vector<http::client::ClientRequest> requests{};
+        requests.push_back(http::client::ClientRequest{
+            &gateway_client,                                                    // client_ptr
+            http::Request{http::Method::get, "/gateway", http::consts::kVersion}, // request
+        });
+        auto futures = http::client::RequestAll(std::move(requests));
+        REQUIRE(futures.size() == 1);
+        CHECK(futures.front().get().result() == http::Status::ok);
+    }
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("Deadlines", "[HttpClient]") {
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0);
+    server_ptr->AddListener("/slow", http::Method::get, [](http::Request&&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        return http::Response{http::Status::ok, http::consts::kVersion};
+    }, http::server::Execution::WorkerPool);
+    server_ptr->AddListener("/timeout", http::Method::get, [](http::Request&& request) {
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.body() = request[http::consts::kTimeoutHeader].to_string();
+        return response;
+    });
+    server_ptr->Listen();
+    pool.Run();
+
+    const auto is_timeout = [](const boost::system::system_error& error) {
+        return error.code() == boost::beast::error::timeout;
+    };
+    const http::Request slow_request{http::Method::get, "/slow", http::consts::kVersion};
+    http::client::ClientSettings settings{};
+    settings.timeout = std::chrono::milliseconds(100);
+
+    SECTION("Client timeout") {
+        http::client::HttpClient client(
+            http::consts::kLocalhost, server_ptr->GetPort(), settings);
+        const auto started_at = std::chrono::steady_clock::now();
+        CHECK_THROWS_MATCHES(client.Request(slow_request), boost::system::system_error,
+                             Catch::Predicate<boost::system::system_error>(is_timeout));
+        const auto elapsed = std::chrono::steady_clock::now() - started_at;
+        CHECK(elapsed >= settings.timeout);
+        CHECK(elapsed < std::chrono::milliseconds(400));
+        // the expired connection is not reused
+        CHECK(client.GetPoolStats().idle == 0);
+    }
+
+    SECTION("Request deadline") {
+        http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+        auto request = slow_request;
+        request.SetDeadline(std::chrono::steady_clock::now() + settings.timeout);
+        CHECK_THROWS_MATCHES(client.Request(request), boost::system::system_error,
+                             Catch::Predicate<boost::system::system_error>(is_timeout));
+    }
+
+    SECTION("Waiting for a connection") {
+        settings.max_connections = 1;
+        settings.timeout = std::chrono::seconds(2);
+        http::client::HttpClient client(
+            http::consts::kLocalhost, server_ptr->GetPort(), settings);
+        auto slow_future = client.AsyncRequest(slow_request);
+        http::Request request{http::Method::get, "/timeout", http::consts::kVersion};
+        request.SetDeadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(100));
+        auto waiting_future = client.AsyncRequest(request);
+        CHECK_THROWS_MATCHES(waiting_future.get(), boost::system::system_error,
+                             Catch::Predicate<boost::system::system_error>(is_timeout));
+        CHECK(slow_future.get().result() == http::Status::ok);
+        CHECK(client.GetPoolStats().active == 0);
+    }
+
+    SECTION("Deadline propagation") {
+        http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+        http::Request request{http::Method::get, "/timeout", http::consts::kVersion};
+        request.SetDeadline(std::chrono::steady_clock::now() + std::chrono::seconds(1));
+        const auto timeout_ms = std::stoi(client.Request(request).body());
+        CHECK(timeout_ms > 0);
+        CHECK(timeout_ms <= 1000);
+    }
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+} // namespace http::tests::http_client
@@ -0,0 +1,297 @@
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/beast/core.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <common/include/thread_pool.hpp>
+#include <http/include/consts.hpp>
+#include <http/include/default_handlers.hpp>
+#include <http/include/http_client.hpp>
+#include <http/include/http_server.hpp>
+#include <tcp_session/io_uring.hpp>
+
+namespace http::tests::io_uring {
+
+namespace {
+
+using http::server::Transport;
+
+std::string MakeContent(size_t size) {
+    std::string content(size, '\0');
+    for (size_t i = 0; i < size; i++) {
+        content[i] = static_cast<char>('a' + i % 26);
+    }
+    return content;
+}
+
+} // namespace
+
+TEST_CASE("Transport fallback", "[IoUring]") {
+    http::server::ServerSettings settings{};
+    settings.transport = Transport::IoUring;
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0, settings);
+    server_ptr->Listen();
+    const auto expected = http::tcp::IoUring::IsSupported() ? Transport::IoUring : Transport::Asio;
+    CHECK(server_ptr->GetTransport() == expected);
+    server_ptr->Stop();
+}
+
+TEST_CASE("Serving over io_uring", "[IoUring]") {
+    if (!http::tcp::IoUring::IsSupported()) {
+        WARN("io_uring is not supported, skipped");
+        return;
+    }
+    constexpr size_t kFileSize = 3 * 1024 * 1024 + 17;
+    const auto content = MakeContent(kFileSize);
+    const auto path = std::filesystem::temp_directory_path() / "http_io_uring_test.bin";
+    std::ofstream(path, std::ios::binary) << content;
+
+    const bool is_multi_reactor = GENERATE(true, false);
+    CAPTURE(is_multi_reactor);
+    http::server::ServerSettings settings{};
+    settings.transport = Transport::IoUring;
+    settings.pipeline_depth = 4;
+    common::threading::IoReactorPool reactor_pool(2);
+    // a context shared by the threads, the sessions run within strands
+    auto shared_context_ptr = std::make_shared<boost::asio::io_context>();
+    std::vector<std::thread> shared_threads{};
+    auto server_ptr = is_multi_reactor ?
+        std::make_shared<http::server::HttpServer>(
+            reactor_pool.GetContextPtrs(), http::consts::kLocalhost, 0, settings) :
+        std::make_shared<http::server::HttpServer>(
+            shared_context_ptr, http::consts::kLocalhost, 0, settings);
+    server_ptr->AddListener("/ping", http::Method::get, &http::handlers::handle_ping);
+    server_ptr->AddListener("/echo", http::Method::post, [](http::Request&& request) {
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.body() = request.body();
+        return response;
+    });
+    server_ptr->AddListener("/stream", http::Method::get, [&content](http::Request&&) {
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.SetChunkGenerator([&content, offset = size_t{0}](std::string& chunk) mutable {
+            if (offset == content.size()) {
+                return false;
+            }
+            chunk = content.substr(offset, 64 * 1024);
+            offset += chunk.size();
+            return true;
+        });
+        return response;
+    });
+    server_ptr->AddListener("/file", http::Method::get, [&](http::Request&&) {
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.SetFileRange(std::make_shared<http::FileRange>(path, 0, kFileSize));
+        return response;
+    });
+    server_ptr->Listen();
+    REQUIRE(server_ptr->GetTransport() == Transport::IoUring);
+    if (is_multi_reactor) {
+        reactor_pool.Run();
+    } else {
+        for (size_t i = 0; i < 2; i++) {
+            shared_threads.emplace_back([&shared_context_ptr] { shared_context_ptr->run(); });
+        }
+    }
+
+    SECTION("Keep-alive connections") {
+        std::vector<std::thread> clients{};
+        std::atomic<size_t> ok_count{0};
+        for (size_t i = 0; i < 4; i++) {
+            clients.emplace_back([&server_ptr, &ok_count] {
+                http::client::HttpClient client(http::consts::kLocalhost,
+                                                server_ptr->GetPort());
+                for (size_t j = 0; j < 100; j++) {
+                    const auto response = client.Request(
+                        http::Request{http::Method::get, "/ping", http::consts::kVersion});
+                    if (response.result() == http::Status::ok && response.body() == "OK") {
+                        ok_count++;
+                    }
+                }
+            });
+        }
+        for (auto& client : clients) {
+            client.join();
+        }
+        CHECK(ok_count == 400);
+    }
+
+    SECTION("Large bodies") {
+        http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+        // within the default request body limit
+        const auto body = content.substr(0, 512 * 1024);
+        http::Request request{http::Method::post, "/echo", http::consts::kVersion};
+        request.body() = body;
+        request.prepare_payload();
+        auto response = client.Request(std::move(request));
+        CHECK(response.body() == body);
+
+        response = client.Request(
+            http::Request{http::Method::get, "/stream", http::consts::kVersion});
+        CHECK(response.chunked());
+        CHECK(response.body() == content);
+
+        response = client.Request(
+            http::Request{http::Method::get, "/file", http::consts::kVersion});
+        CHECK(response.body() == content);
+    }
+
+    SECTION("Pipelined requests") {
+        boost::asio::io_context context{};
+        boost::beast::tcp_stream stream(context);
+        stream.connect(boost::asio::ip::tcp::endpoint(
+            boost::asio::ip::make_address(http::consts::kLocalhost), server_ptr->GetPort()));
+        std::string requests{};
+        for (size_t i = 0; i < 10; i++) {
+            requests += "GET /ping HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        }
+        boost::asio::write(stream, boost::asio::buffer(requests));
+        boost::beast::flat_buffer buffer{};
+        for (size_t i = 0; i < 10; i++) {
+            http::Response response{};
+            boost::beast::http::read(stream, buffer, response);
+            CHECK(response.body() == "OK");
+        }
+    }
+
+    server_ptr->Stop();
+    reactor_pool.Stop();
+    shared_context_ptr->stop();
+    for (auto& thread : shared_threads) {
+        thread.join();
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("io_uring idle timeout", "[IoUring]") {
+    if (!http::tcp::IoUring::IsSupported()) {
+        WARN("io_uring is not supported, skipped");
+        return;
+    }
+    http::server::ServerSettings settings{};
+    settings.transport = Transport::IoUring;
+    settings.idle_timeout = std::chrono::milliseconds(200);
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs(), http::consts::kLocalhost, 0, settings);
+    server_ptr->Listen();
+    pool.Run();
+
+    // the pending receive is aborted once the connection is closed by the timeout
+    boost::asio::io_context context{};
+    boost::beast::tcp_stream stream(context);
+    stream.connect(boost::asio::ip::tcp::endpoint(
+        boost::asio::ip::make_address(http::consts::kLocalhost), server_ptr->GetPort()));
+    boost::beast::flat_buffer buffer{};
+    http::Response response{};
+    boost::beast::error_code error_code{};
+    boost::beast::http::read(stream, buffer, response, error_code);
+    CHECK(error_code == boost::beast::http::error::end_of_stream);
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("io_uring active timeout", "[IoUring]") {
+    if (!http::tcp::IoUring::IsSupported()) {
+        WARN("io_uring is not supported, skipped");
+        return;
+    }
+    constexpr size_t kFileSize = 16 * 1024 * 1024;
+    const auto path = std::filesystem::temp_directory_path() / "http_io_uring_timeout_test.bin";
+    std::ofstream(path, std::ios::binary) << MakeContent(kFileSize);
+
+    http::server::ServerSettings settings{};
+    settings.transport = Transport::IoUring;
+    settings.active_timeout = std::chrono::milliseconds(200);
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs(), http::consts::kLocalhost, 0, settings);
+    server_ptr->AddListener("/ping", http::Method::get, &http::handlers::handle_ping);
+    server_ptr->AddListener("/file", http::Method::get, [&](http::Request&&) {
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.SetFileRange(std::make_shared<http::FileRange>(path, 0, kFileSize));
+        return response;
+    });
+    server_ptr->Listen();
+    pool.Run();
+
+    // the file is not read, so the connection is closed by the timeout
+    // while the session waits for the socket with the ring operations
+    boost::asio::io_context context{};
+    boost::beast::tcp_stream stalled_stream(context);
+    stalled_stream.socket().open(boost::asio::ip::tcp::v4());
+    stalled_stream.socket().set_option(boost::asio::socket_base::receive_buffer_size(4096));
+    stalled_stream.connect(boost::asio::ip::tcp::endpoint(
+        boost::asio::ip::make_address(http::consts::kLocalhost), server_ptr->GetPort()));
+    boost::beast::http::write(
+        stalled_stream, http::Request{http::Method::get, "/file", http::consts::kVersion});
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    // the descriptors of the next connections are not touched by the closed session
+    for (size_t i = 0; i < 4; i++) {
+        http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+        const auto response = client.Request(
+            http::Request{http::Method::get, "/ping", http::consts::kVersion});
+        CHECK(response.body() == "OK");
+    }
+
+    server_ptr->Stop();
+    pool.Stop();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Batched submission", "[IoUring]") {
+    if (!http::tcp::IoUring::IsSupported()) {
+        WARN("io_uring is not supported, skipped");
+        return;
+    }
+    constexpr size_t kConnectionsCount = 16;
+    http::server::ServerSettings settings{};
+    settings.transport = Transport::IoUring;
+    common::threading::IoReactorPool pool(1);
+    const auto context_ptr = pool.GetContextPtrs().front();
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        std::vector{context_ptr}, http::consts::kLocalhost, 0, settings);
+    server_ptr->AddListener("/ping", http::Method::get, &http::handlers::handle_ping);
+    server_ptr->Listen();
+    pool.Run();
+
+    boost::asio::io_context context{};
+    std::vector<std::unique_ptr<boost::beast::tcp_stream>> streams{};
+    for (size_t i = 0; i < kConnectionsCount; i++) {
+        streams.push_back(std::make_unique<boost::beast::tcp_stream>(context));
+        streams.back()->connect(boost::asio::ip::tcp::endpoint(
+            boost::asio::ip::make_address(http::consts::kLocalhost), server_ptr->GetPort()));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const auto stats_before = boost::asio::use_service<http::tcp::IoUring>(*context_ptr).GetStats();
+    // the requests arrive at once, their operations share the system calls
+    http::Request request{http::Method::get, "/ping", http::consts::kVersion};
+    for (auto& stream_ptr : streams) {
+        boost::beast::http::write(*stream_ptr, request);
+    }
+    for (auto& stream_ptr : streams) {
+        boost::beast::flat_buffer buffer{};
+        http::Response response{};
+        boost::beast::http::read(*stream_ptr, buffer, response);
+        CHECK(response.body() == "OK");
+    }
+    const auto stats = boost::asio::use_service<http::tcp::IoUring>(*context_ptr).GetStats();
+    CHECK(stats.operations - stats_before.operations >= kConnectionsCount);
+    CHECK(stats.submit_calls - stats_before.submit_calls <=
+          stats.operations - stats_before.operations);
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+} // namespace http::tests::io_uring
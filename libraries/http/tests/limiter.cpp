@@ -0,0 +1,193 @@
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <catch2/catch.hpp>
+
+#include <http/include/concurrency_limiter.hpp>
+
+namespace http::tests::limiter {
+
+namespace {
+
+using Limiter = http::server::ConcurrencyLimiter;
+
+/// @brief Runs the handlers posted so far.
+void RunPosted(boost::asio::io_context& context) {
+    context.restart();
+    context.poll();
+}
+
+/// @brief Records admission results of the acquired tasks.
+struct Results {
+    std::vector<bool> admitted{};
+
+    Limiter::Task MakeTask() {
+        const auto index = admitted.size();
+        admitted.push_back(false);
+        return [this, index](bool is_admitted) {
+            admitted[index] = is_admitted;
+        };
+    }
+};
+
+} // namespace
+
+TEST_CASE("Unlimited", "[ConcurrencyLimiter]") {
+    Limiter limiter(http::server::LimiterSettings{});
+    CHECK_FALSE(limiter.IsRequestsLimited());
+
+    bool is_admitted = false;
+    boost::asio::io_context context{};
+    limiter.Acquire([&is_admitted](bool admitted) { is_admitted = admitted; },
+                    context.get_executor());
+    CHECK(is_admitted);
+    CHECK(limiter.TryAcquireConnection());
+    CHECK(limiter.GetState().connections == 1);
+}
+
+TEST_CASE("Connections limit", "[ConcurrencyLimiter]") {
+    http::server::LimiterSettings settings{};
+    settings.max_connections = 2;
+    Limiter limiter(settings);
+
+    CHECK(limiter.TryAcquireConnection());
+    CHECK(limiter.TryAcquireConnection());
+    CHECK_FALSE(limiter.TryAcquireConnection());
+    limiter.ReleaseConnection();
+    CHECK(limiter.TryAcquireConnection());
+
+    const auto state = limiter.GetState();
+    CHECK(state.connections == 2);
+    CHECK(state.rejected_connections == 1);
+}
+
+TEST_CASE("In-flight limit with queue", "[ConcurrencyLimiter]") {
+    http::server::LimiterSettings settings{};
+    settings.max_in_flight = 2;
+    settings.max_queue_size = 1;
+    settings.max_queue_wait = std::chrono::seconds(10);
+    auto limiter_ptr = std::make_shared<Limiter>(settings);
+    auto& limiter = *limiter_ptr;
+    boost::asio::io_context context{};
+    Results results{};
+
+    limiter.Acquire(results.MakeTask(), context.get_executor());
+    limiter.Acquire(results.MakeTask(), context.get_executor());
+    limiter.Acquire(results.MakeTask(), context.get_executor());  // queued
+    limiter.Acquire(results.MakeTask(), context.get_executor());  // rejected
+    CHECK(results.admitted == std::vector<bool>{true, true, false, false});
+
+    auto state = limiter.GetState();
+    CHECK(state.in_flight == 2);
+    CHECK(state.in_flight_limit == 2);
+    CHECK(state.queue_size == 1);
+    CHECK(state.rejected_requests == 1);
+
+    // the queued one takes the released slot on its own executor
+    limiter.Release(std::chrono::milliseconds(1));
+    CHECK(results.admitted == std::vector<bool>{true, true, false, false});
+    RunPosted(context);
+    CHECK(results.admitted == std::vector<bool>{true, true, true, false});
+    state = limiter.GetState();
+    CHECK(state.in_flight == 2);
+    CHECK(state.queue_size == 0);
+}
+
+TEST_CASE("Queue wait timeout", "[ConcurrencyLimiter]") {
+    http::server::LimiterSettings settings{};
+    settings.max_in_flight = 1;
+    settings.max_queue_size = 2;
+    settings.max_queue_wait = std::chrono::milliseconds(1);
+    auto limiter_ptr = std::make_shared<Limiter>(settings);
+    auto& limiter = *limiter_ptr;
+    boost::asio::io_context context{};
+    Results results{};
+
+    limiter.Acquire(results.MakeTask(), context.get_executor());
+    limiter.Acquire(results.MakeTask(), context.get_executor());
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    limiter.Acquire(results.MakeTask(), context.get_executor());
+
+    // the first queued task waited for too long
+    limiter.Release(std::chrono::milliseconds(1));
+    RunPosted(context);
+    CHECK(results.admitted == std::vector<bool>{true, false, true});
+    CHECK(limiter.GetState().rejected_requests == 1);
+}
+
+TEST_CASE("Queue wait timeout without releases", "[ConcurrencyLimiter]") {
+    http::server::LimiterSettings settings{};
+    settings.max_in_flight = 1;
+    settings.max_queue_size = 1;
+    settings.max_queue_wait = std::chrono::milliseconds(10);
+    auto limiter_ptr = std::make_shared<Limiter>(settings);
+    boost::asio::io_context context{};
+    Results results{};
+
+    limiter_ptr->Acquire(results.MakeTask(), context.get_executor());
+    limiter_ptr->Acquire(results.MakeTask(), context.get_executor());  // queued
+    CHECK(limiter_ptr->GetState().queue_size == 1);
+
+    // the queue timer rejects the task while the slot is still busy
+    const auto started_at = std::chrono::steady_clock::now();
+    context.run();
+    CHECK(std::chrono::steady_clock::now() - started_at >= settings.max_queue_wait);
+    CHECK(results.admitted == std::vector<bool>{true, false});
+    const auto state = limiter_ptr->GetState();
+    CHECK(state.in_flight == 1);
+    CHECK(state.queue_size == 0);
+    CHECK(state.rejected_requests == 1);
+
+    // the slot is released with nothing to admit
+    limiter_ptr->Release(std::chrono::milliseconds(1));
+    RunPosted(context);
+    CHECK(limiter_ptr->GetState().in_flight == 0);
+}
+
+TEST_CASE("Adaptive limit", "[ConcurrencyLimiter]") {
+    http::server::LimiterSettings settings{};
+    settings.adaptive = true;
+    settings.max_in_flight = 20;
+    settings.min_in_flight = 4;
+    settings.max_in_flight_adaptive = 100;
+    settings.adaptive_window_size = 10;
+    Limiter limiter(settings);
+    boost::asio::io_context context{};
+    CHECK(limiter.IsRequestsLimited());
+
+    // keeps the limiter saturated and reports the latency for each request
+    const auto run_windows = [&](size_t windows_count, std::chrono::milliseconds latency) {
+        for (size_t i = 0; i < windows_count * settings.adaptive_window_size; i++) {
+            const auto state = limiter.GetState();
+            for (size_t j = state.in_flight; j < state.in_flight_limit; j++) {
+                limiter.Acquire([](bool) {}, context.get_executor());
+            }
+            limiter.Release(latency);
+        }
+    };
+
+    SECTION("Grows under stable latency") {
+        run_windows(50, std::chrono::milliseconds(10));
+        CHECK(limiter.GetState().in_flight_limit > settings.max_in_flight);
+        CHECK(limiter.GetState().in_flight_limit <= settings.max_in_flight_adaptive);
+    }
+
+    SECTION("Shrinks when latency grows") {
+        run_windows(50, std::chrono::milliseconds(10));
+        const auto grown_limit = limiter.GetState().in_flight_limit;
+        run_windows(5, std::chrono::milliseconds(100));
+        CHECK(limiter.GetState().in_flight_limit < grown_limit);
+        CHECK(limiter.GetState().in_flight_limit < grown_limit);
+        CHECK(limiter.GetState().in_flight_limit >= settings.min_in_flight);
+
+        // the new latency becomes the long-term one eventually
+        const auto shrunk_limit = limiter.GetState().in_flight_limit;
+        run_windows(50, std::chrono::milliseconds(100));
+        CHECK(limiter.GetState().in_flight_limit > shrunk_limit);
+    }
+}
+
+} // namespace http::tests::limiter
@@ -0,0 +1,154 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <http/include/models.hpp>
+#include <http/include/request_parser.hpp>
+
+namespace http::tests::request_parser {
+
+namespace {
+
+using http::parser::Isa;
+using http::parser::ParseStatus;
+using http::parser::RequestHead;
+
+constexpr std::string_view kRequest =
+    "GET /api/v1/documents/get?id=42 HTTP/1.1\r\n"
+    "Host: localhost:5555\r\n"
+    "User-Agent: python-requests/2.28.1\r\n"
+    "Accept-Encoding: gzip, deflate\r\n"
+    "Accept: */*\r\n"
+    "Connection: keep-alive\r\n"
+    "If-None-Match:\t\"1-1697616000000000\" \t\r\n"
+    "\r\n";
+
+/// @brief Instruction sets supported by the CPU, each of them is tested.
+std::vector<Isa> GetIsas() {
+    std::vector<Isa> isas{Isa::Scalar};
+    if (http::parser::GetSupportedIsa() >= Isa::Sse42) {
+        isas.push_back(Isa::Sse42);
+    }
+    if (http::parser::GetSupportedIsa() >= Isa::Avx2) {
+        isas.push_back(Isa::Avx2);
+    }
+    return isas;
+}
+
+ParseStatus GetStatus(std::string_view buffer, Isa isa) {
+    RequestHead head{};
+    return http::parser::ParseRequestHead(buffer, head, isa).status;
+}
+
+} // namespace
+
+TEST_CASE("Request head parsing", "[RequestParser]") {
+    for (const auto isa : GetIsas()) {
+        INFO(http::parser::ToString(isa));
+        RequestHead head{};
+        const std::string buffer = std::string(kRequest) + "body";
+        const auto result = http::parser::ParseRequestHead(buffer, head, isa);
+        REQUIRE(result.status == ParseStatus::Complete);
+        CHECK(result.size == kRequest.size());
+        CHECK(head.method == "GET");
+        CHECK(head.target == "/api/v1/documents/get?id=42");
+        CHECK(head.version == 11);
+        REQUIRE(head.headers_count == 6);
+        CHECK(head.headers[0].name == "Host");
+        CHECK(head.headers[0].value == "localhost:5555");
+        CHECK(head.headers[5].value == "\"1-1697616000000000\"");
+        CHECK(head.FindHeader("accept-encoding") == "gzip, deflate");
+        CHECK_FALSE(head.FindHeader("Content-Length").has_value());
+        // the views refer to the buffer
+        CHECK(head.target.data() == buffer.data() + 4);
+    }
+}
+
+TEST_CASE("Request head corner cases", "[RequestParser]") {
+    for (const auto isa : GetIsas()) {
+        INFO(http::parser::ToString(isa));
+        RequestHead head{};
+        auto result = http::parser::ParseRequestHead(
+            "\r\nPOST / HTTP/1.0\r\nEmpty:\r\nX-Token: a|b~c\r\n\r\n", head, isa);
+        REQUIRE(result.status == ParseStatus::Complete);
+        CHECK(head.method == "POST");
+        CHECK(head.version == 10);
+        CHECK(head.FindHeader("empty") == "");
+        CHECK(head.FindHeader("x-token") == "a|b~c");
+
+        // the scanned spans are longer than the vectors
+        const std::string long_name(100, 'n');
+        const std::string long_value(100, 'v');
+        const auto long_request = "GET /" + std::string(100, 't') + " HTTP/1.1\r\n" +
+            long_name + "|~: " + long_value + "\x80\xff\r\n\r\n";
+        result = http::parser::ParseRequestHead(long_request, head, isa);
+        REQUIRE(result.status == ParseStatus::Complete);
+        CHECK(head.headers[0].name == long_name + "|~");
+        CHECK(head.headers[0].value == long_value + "\x80\xff");
+    }
+}
+
+TEST_CASE("Incomplete request head", "[RequestParser]") {
+    for (const auto isa : GetIsas()) {
+        INFO(http::parser::ToString(isa));
+        for (size_t size = 0; size < kRequest.size(); size++) {
+            INFO(size);
+            CHECK(GetStatus(kRequest.substr(0, size), isa) == ParseStatus::Incomplete);
+        }
+        CHECK(GetStatus(kRequest, isa) == ParseStatus::Complete);
+    }
+}
+
+TEST_CASE("Invalid request head", "[RequestParser]") {
+    const std::vector<std::string> requests{
+        " GET / HTTP/1.1\r\n\r\n",
+        "GET  / HTTP/1.1\r\n\r\n",
+        "G(T / HTTP/1.1\r\n\r\n",
+        "GET /\x7f HTTP/1.1\r\n\r\n",
+        "GET / HTTP/2.0\r\n\r\n",
+        "GET / HTTP/1.2\r\n\r\n",
+        "GET / HTTP/1.1\n\r\n",
+        "GET / HTTP/1.1\r\n\rX",
+        "GET / HTTP/1.1\r\nName : value\r\n\r\n",
+        "GET / HTTP/1.1\r\n: value\r\n\r\n",
+        "GET / HTTP/1.1\r\nName: value\r\n folded\r\n\r\n",
+        "GET / HTTP/1.1\r\nName: va\x01lue\r\n\r\n",
+        "GET / HTTP/1.1\r\nName: value\n\r\n",
+        "GET / HTTP/1.1\r\n" + std::string(40, 'n') + "\"" + std::string(40, 'n') + ": v\r\n\r\n",
+        "GET / HTTP/1.1\r\nName: " + std::string(70, 'v') + "\x7f" + "\r\n\r\n",
+    };
+    std::string too_many_headers = "GET / HTTP/1.1\r\n";
+    for (size_t i = 0; i <= RequestHead::kMaxHeaders; i++) {
+        too_many_headers += "Name: value\r\n";
+    }
+
+    for (const auto isa : GetIsas()) {
+        INFO(http::parser::ToString(isa));
+        for (const auto& request : requests) {
+            INFO(request);
+            CHECK(GetStatus(request, isa) == ParseStatus::Invalid);
+        }
+        CHECK(GetStatus(too_many_headers + "\r\n", isa) == ParseStatus::Invalid);
+    }
+}
+
+TEST_CASE("Request head adapter", "[RequestParser]") {
+    RequestHead head{};
+    REQUIRE(http::parser::ParseRequestHead(kRequest, head).status == ParseStatus::Complete);
+    const auto request = http::parser::ToRequest(head, "body");
+    CHECK(request.method() == http::Method::get);
+    CHECK(request.target() == "/api/v1/documents/get?id=42");
+    CHECK(request.version() == 11);
+    CHECK(request.keep_alive());
+    CHECK(request[boost::beast::http::field::host] == "localhost:5555");
+    CHECK(request[boost::beast::http::field::if_none_match] == "\"1-1697616000000000\"");
+    CHECK(request.body() == "body");
+
+    REQUIRE(http::parser::ParseRequestHead("BREW / HTTP/1.1\r\n\r\n", head).status ==
+            ParseStatus::Complete);
+    CHECK_THROWS_AS(http::parser::ToRequest(head, ""), std::invalid_argument);
+}
+
+} // namespace http::tests::request_parser
@@ -0,0 +1,143 @@
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <http/include/exceptions.hpp>
+#include <http/include/http_server.hpp>
+#include <http/include/models.hpp>
+#include <http/include/request_view.hpp>
+
+namespace http::tests::request_view {
+
+namespace {
+
+http::Request MakeRequest(const std::string& target) {
+    http::Request request{};
+    request.target(target);
+    return request;
+}
+
+} // namespace
+
+TEST_CASE("Request view path and query", "[RequestView]") {
+    auto request = MakeRequest("/api/v1/documents/get?id=42&name=doc");
+    const http::RequestView view(request);
+    CHECK(view.GetPath() == "/api/v1/documents/get");
+    CHECK(view.GetQuery() == "id=42&name=doc");
+
+    request = MakeRequest("/ping");
+    const http::RequestView no_query_view(request);
+    CHECK(no_query_view.GetPath() == "/ping");
+    CHECK(no_query_view.GetQuery().empty());
+}
+
+TEST_CASE("Request view raw params", "[RequestView]") {
+    const auto request = MakeRequest(
+        "/path?key=value&empty=&flag&=skipped&&repeated=1&repeated=2");
+    const http::RequestView view(request);
+    CHECK(view.GetRawParam("key") == "value");
+    CHECK(view.GetRawParam("empty") == "");
+    CHECK(view.GetRawParam("flag") == std::nullopt);
+    CHECK(view.GetRawParam("") == std::nullopt);
+    CHECK(view.GetRawParam("repeated") == "2");
+    CHECK(view.GetRawParam("unknown") == std::nullopt);
+
+    // the values refer to the target
+    const auto target = request.target();
+    const auto value = view.GetRawParam("key").value();
+    CHECK(value.data() >= target.data());
+    CHECK(value.data() < target.data() + target.size());
+
+    std::vector<std::pair<std::string_view, std::string_view>> params{};
+    view.ForEachParam([&params](std::string_view name, std::string_view value) {
+        params.emplace_back(name, value);
+    });
+    CHECK(params == std::vector<std::pair<std::string_view, std::string_view>>{
+        {"key", "value"}, {"empty", ""}, {"repeated", "1"}, {"repeated", "2"}});
+}
+
+TEST_CASE("Percent decoding", "[RequestView]") {
+    std::string buffer{};
+    CHECK(http::PercentDecode("plain", buffer));
+    CHECK(buffer == "plain");
+    CHECK(http::PercentDecode("a%20b+c%2Fd%2f", buffer));
+    CHECK(buffer == "a b c/d/");
+    CHECK(http::PercentDecode("a+b", buffer, false));
+    CHECK(buffer == "a+b");
+    CHECK(http::PercentDecode("%D0%BF%D1%80%D0%B8%D0%B2%D0%B5%D1%82", buffer));
+    CHECK(buffer == "\xD0\xBF\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82");
+    CHECK_FALSE(http::PercentDecode("%", buffer));
+    CHECK_FALSE(http::PercentDecode("%4", buffer));
+    CHECK_FALSE(http::PercentDecode("%zz", buffer));
+}
+
+TEST_CASE("Request view decoded params", "[RequestView]") {
+    const auto request = MakeRequest("/path?plain=value&encoded=hello%2C+world&bad=%G1");
+    const http::RequestView view(request);
+    std::string buffer{};
+
+    // nothing to decode, the buffer is not used
+    const auto plain = view.GetParam("plain", buffer).value();
+    CHECK(plain == "value");
+    CHECK(buffer.empty());
+
+    CHECK(view.GetParam("encoded", buffer) == "hello, world");
+    CHECK(view.GetParam("unknown", buffer) == std::nullopt);
+    CHECK_THROWS_AS(view.GetParam("bad", buffer), http::exceptions::BadRequest);
+}
+
+TEST_CASE("Request view integer params", "[RequestView]") {
+    const auto request = MakeRequest(
+        "/path?id=42&negative=-7&encoded=%31%32&big=18446744073709551616"
+        "&text=12abc&empty=&plus=%2B5&wide=300");
+    const http::RequestView view(request);
+    CHECK(view.GetParamAs<uint64_t>("id") == 42u);
+    CHECK(view.GetParamAs<int>("negative") == -7);
+    CHECK(view.GetParamAs<uint64_t>("encoded") == 12u);
+    CHECK(view.GetParamAs<uint64_t>("unknown") == std::nullopt);
+    CHECK_THROWS_AS(view.GetParamAs<uint64_t>("negative"), http::exceptions::BadRequest);
+    CHECK_THROWS_AS(view.GetParamAs<uint64_t>("big"), http::exceptions::BadRequest);
+    CHECK(view.GetParamAs<uint8_t>("id") == 42);
+    CHECK_THROWS_AS(view.GetParamAs<uint8_t>("wide"), http::exceptions::BadRequest);
+    CHECK_THROWS_AS(view.GetParamAs<uint64_t>("text"), http::exceptions::BadRequest);
+    CHECK_THROWS_AS(view.GetParamAs<uint64_t>("empty"), http::exceptions::BadRequest);
+    CHECK_THROWS_AS(view.GetParamAs<uint64_t>("plus"), http::exceptions::BadRequest);
+    CHECK_THROWS_WITH(view.GetParamAs<uint64_t>("text"), "Parameter 'text' is invalid");
+}
+
+TEST_CASE("Request view path params", "[RequestView]") {
+    http::server::HttpHandlers handlers{};
+    handlers.AddHandler("/files/{id}/{name}", http::Method::get,
+                        [](http::Request&&) { return http::Response{}; });
+    auto request = MakeRequest("/files/17/my%20file+1?id=5");
+    const auto target = request.target();
+    const auto path = std::string_view(target.data(), target.size());
+    REQUIRE(handlers.Match(path.substr(0, path.find('?')), http::Method::get,
+                           &request.GetPathParams()) != nullptr);
+
+    const http::RequestView view(request);
+    std::string buffer{};
+    CHECK(view.GetPathParamAs<uint64_t>("id") == 17u);
+    CHECK(view.GetParamAs<uint64_t>("id") == 5u);
+    // '+' is not a space within a path
+    CHECK(view.GetPathParam("name", buffer) == "my file+1");
+    CHECK(view.GetPathParam("unknown", buffer) == std::nullopt);
+    CHECK_THROWS_AS(view.GetPathParamAs<uint64_t>("name"), http::exceptions::BadRequest);
+}
+
+TEST_CASE("Request view of a header", "[RequestView]") {
+    http::RequestHeader header{};
+    header.target("/files/17?name=my%20file");
+    const http::RequestView view(header);
+    std::string buffer{};
+    CHECK(view.GetPath() == "/files/17");
+    CHECK(view.GetParam("name", buffer) == "my file");
+    // the header is not routed yet
+    CHECK(view.GetPathParam("id", buffer) == std::nullopt);
+}
+
+} // namespace http::tests::request_view
@@ -1,8 +1,28 @@
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/beast/core.hpp>
 
 #include <catch2/catch.hpp>
 
+#include <common/include/metrics.hpp>
+#include <common/include/thread_pool.hpp>
+#include <http/include/consts.hpp>
+#include <http/include/default_handlers.hpp>
+#include <http/include/exceptions.hpp>
+#include <http/include/http_client.hpp>
 #include <http/include/models.hpp>
 #include <http/include/http_server.hpp>
 
@@ -24,20 +44,860 @@ TEST_CASE("AddListener", "[HttpHandlers]") {
     handlers.AddHandler("/path/get", http::Method::get, get_handler);
     handlers.AddHandler("/path/post", http::Method::post, post_handler);
     
-    auto get_handler_opt = handlers.GetHandler("/path/get", http::Method::get);
-    CHECK(get_handler_opt.has_value());
-    CHECK(get_handler_opt->operator()(Request{}).body() == std::string("get handler"));
+    auto get_route_ptr = handlers.Match("/path/get", http::Method::get);
+    REQUIRE(get_route_ptr != nullptr);
+    CHECK(get_route_ptr->handler(Request{}).body() == std::string("get handler"));
+
+    auto post_route_ptr = handlers.Match("/path/post", http::Method::post);
+    REQUIRE(post_route_ptr != nullptr);
+    CHECK(post_route_ptr->handler(Request{}).body() == std::string("post handler"));
+
+    auto invalid_route_ptr = handlers.Match("/path/post", http::Method::get);
+    CHECK(invalid_route_ptr == nullptr);
+
+    auto invalid_path_ptr = handlers.Match("/path/invalid", http::Method::get);
+    CHECK(invalid_path_ptr == nullptr);
+
+    handlers.RemoveHandler("/path/get", http::Method::get);
+    CHECK(handlers.Match("/path/get", http::Method::get) == nullptr);
+    CHECK(handlers.Match("/path/post", http::Method::post) != nullptr);
+}
+
+TEST_CASE("Path params", "[HttpHandlers]") {
+    http::HttpHandler handler = [](http::Request&&) {
+        return http::Response{};
+    };
 
-    auto post_handler_opt = handlers.GetHandler("/path/post", http::Method::post);
-    CHECK(post_handler_opt.has_value());
-    CHECK(post_handler_opt->operator()(Request{}).body() == std::string("post handler"));
+    http::server::HttpHandlers handlers{};
+    handlers.AddHandler("/documents/list", http::Method::get, handler);
+    handlers.AddHandler("/documents/{id}", http::Method::get, handler);
+    handlers.AddHandler("/documents/{id}/history/{version}", http::Method::get, handler);
+    handlers.AddHandler("/doc", http::Method::get, handler);
+
+    http::Request request{};
+    request.target("/documents/42/history/7");
+    auto route_ptr = handlers.Match("/documents/42/history/7", http::Method::get,
+                                    &request.GetPathParams());
+    REQUIRE(route_ptr != nullptr);
+    CHECK(route_ptr->pattern == "/documents/{id}/history/{version}");
+    CHECK(request.GetPathParam("id") == "42");
+    CHECK(request.GetPathParam("version") == "7");
+    CHECK(request.GetPathParam("name") == std::nullopt);
+
+    request.target("/documents/list");
+    route_ptr = handlers.Match("/documents/list", http::Method::get,
+                               &request.GetPathParams());
+    REQUIRE(route_ptr != nullptr);
+    CHECK(route_ptr->pattern == "/documents/list");
+    CHECK(request.GetPathParams().Size() == 0);
+
+    request.target("/documents/43?key=value");
+    route_ptr = handlers.Match("/documents/43", http::Method::get,
+                               &request.GetPathParams());
+    REQUIRE(route_ptr != nullptr);
+    CHECK(route_ptr->pattern == "/documents/{id}");
+    CHECK(request.GetPathParam("id") == "43");
 
-    auto invalid_handler_opt = handlers.GetHandler("/path/post", http::Method::get);
-    CHECK(!invalid_handler_opt.has_value());
+    CHECK(handlers.Match("/doc", http::Method::get) != nullptr);
+    CHECK(handlers.Match("/documents", http::Method::get) == nullptr);
+    CHECK(handlers.Match("/documents/", http::Method::get) == nullptr);
+    CHECK(handlers.Match("/documents/42/history", http::Method::get) == nullptr);
+    CHECK(handlers.Match("/documents/42/history/7/8", http::Method::get) == nullptr);
+}
+
+TEST_CASE("Invalid patterns", "[HttpHandlers]") {
+    http::HttpHandler handler = [](http::Request&&) {
+        return http::Response{};
+    };
 
-    auto invalid_path_opt = handlers.GetHandler("/path/invalid", http::Method::get);
-    CHECK(!invalid_path_opt.has_value());
+    http::server::HttpHandlers handlers{};
+    handlers.AddHandler("/documents/{id}", http::Method::get, handler);
+    CHECK_THROWS_AS(handlers.AddHandler("/documents/{name}/data", http::Method::get, handler),
+                    std::logic_error);
+    CHECK_THROWS_AS(handlers.AddHandler("/documents/{}", http::Method::get, handler),
+                    std::logic_error);
+    CHECK_THROWS_AS(handlers.AddHandler("/documents/{id", http::Method::get, handler),
+                    std::logic_error);
+    CHECK_THROWS_AS(handlers.AddHandler("/documents/id_{id}", http::Method::get, handler),
+                    std::logic_error);
 }
 
+TEST_CASE("Multi-reactor server", "[HttpServer]") {
+    constexpr size_t kReactorsCount = 2;
+    constexpr size_t kRequestsCount = 8;
+
+    common::threading::IoReactorPool pool(kReactorsCount);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs(), http::consts::kLocalhost, 0);
+    server_ptr->AddListener("/ping", http::Method::get, &http::handlers::handle_ping);
+    server_ptr->Listen();
+    pool.Run();
+
+    CHECK(server_ptr->GetPort() != 0);
+    http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+    for (size_t i = 0; i < kRequestsCount; i++) {
+        http::Request request{http::Method::get, "/ping", http::consts::kVersion};
+        const auto response = client.Request(request);
+        CHECK(response.result() == http::Status::ok);
+        CHECK(response.body() == std::string("OK"));
+    }
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("Async and worker pool handlers", "[HttpServer]") {
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0);
+
+    std::thread::id reactor_thread_id{};
+    std::thread::id worker_thread_id{};
+    server_ptr->AddListener("/reactor", http::Method::get, [&](http::Request&&) {
+        reactor_thread_id = std::this_thread::get_id();
+        return http::Response{http::Status::ok, http::consts::kVersion};
+    });
+    server_ptr->AddListener("/worker", http::Method::get, [&](http::Request&&) {
+        worker_thread_id = std::this_thread::get_id();
+        return http::Response{http::Status::ok, http::consts::kVersion};
+    }, http::server::Execution::WorkerPool);
+    server_ptr->AddListener("/async", http::Method::get,
+        [](http::Request&& request, http::ResponseCallback&& callback) {
+            std::thread([callback = std::move(callback), id = request.GetPathParams().Size()] {
+                http::Response response{http::Status::ok, http::consts::kVersion};
+                response.body() = "async " + std::to_string(id);
+                callback(std::move(response));
+            }).detach();
+        });
+    server_ptr->AddListener("/async/throw", http::Method::get,
+        [](http::Request&&, http::ResponseCallback&&) {
+            throw std::runtime_error("error");
+        });
+    server_ptr->Listen();
+    pool.Run();
+
+    http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+    const auto get = [&client](const std::string& path) {
+        return client.Request(http::Request{http::Method::get, path, http::consts::kVersion});
+    };
+
+    CHECK(get("/reactor").result() == http::Status::ok);
+    CHECK(get("/worker").result() == http::Status::ok);
+    CHECK(reactor_thread_id != std::thread::id{});
+    CHECK(worker_thread_id != std::thread::id{});
+    CHECK(reactor_thread_id != worker_thread_id);
+
+    const auto async_response = get("/async");
+    CHECK(async_response.result() == http::Status::ok);
+    CHECK(async_response.body() == std::string("async 0"));
+    CHECK(get("/async/throw").result() == http::Status::internal_server_error);
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("Async handler responding and throwing", "[HttpServer]") {
+    http::server::ServerSettings settings{};
+    settings.limiter.max_in_flight = 4;
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0, settings);
+    server_ptr->AddListener("/async", http::Method::get,
+        [](http::Request&&, http::ResponseCallback&& callback) {
+            http::Response response{http::Status::ok, http::consts::kVersion};
+            response.body() = "OK";
+            callback(std::move(response));
+            throw std::runtime_error("error");
+        });
+    server_ptr->Listen();
+    pool.Run();
+
+    // a single response per request, the connection keeps working
+    http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+    for (size_t i = 0; i < 3; i++) {
+        const auto response = client.Request(
+            http::Request{http::Method::get, "/async", http::consts::kVersion});
+        CHECK(response.result() == http::Status::ok);
+        CHECK(response.body() == std::string("OK"));
+    }
+    CHECK(client.GetPoolStats().connects == 1);
+    CHECK(server_ptr->GetLimiterState().in_flight == 0);
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("Pipelining", "[HttpServer]") {
+    constexpr size_t kRequestsCount = 6;
+
+    http::server::ServerSettings settings{};
+    settings.worker_pool_size = kRequestsCount;
+    settings.pipeline_depth = 4;
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0, settings);
+
+    std::atomic<size_t> in_flight_count{0};
+    std::atomic<size_t> max_in_flight_count{0};
+    server_ptr->AddListener("/delay/{ms}", http::Method::get, [&](http::Request&& request) {
+        const auto count = ++in_flight_count;
+        max_in_flight_count = std::max(max_in_flight_count.load(), count);
+        const auto delay = std::stoi(std::string(request.GetPathParam("ms").value()));
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+        in_flight_count--;
+
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.body() = std::to_string(delay);
+        return response;
+    }, http::server::Execution::WorkerPool);
+    server_ptr->Listen();
+    pool.Run();
+
+    // earlier requests take longer to handle
+    boost::asio::io_context context{};
+    boost::beast::tcp_stream stream(context);
+    stream.connect(boost::asio::ip::tcp::endpoint(
+        boost::asio::ip::make_address(http::consts::kLocalhost), server_ptr->GetPort()));
+    for (size_t i = 0; i < kRequestsCount; i++) {
+        http::Request request{http::Method::get,
+                              "/delay/" + std::to_string((kRequestsCount - i) * 20),
+                              http::consts::kVersion};
+        request.keep_alive(i + 1 != kRequestsCount);
+        boost::beast::http::write(stream, request);
+    }
+
+    boost::beast::flat_buffer buffer{};
+    for (size_t i = 0; i < kRequestsCount; i++) {
+        http::Response response{};
+        boost::beast::http::read(stream, buffer, response);
+        CHECK(response.result() == http::Status::ok);
+        CHECK(response.body() == std::to_string((kRequestsCount - i) * 20));
+    }
+    CHECK(max_in_flight_count > 1);
+    CHECK(max_in_flight_count <= settings.pipeline_depth);
+
+    // the last request asked to close the connection
+    http::Response response{};
+    boost::beast::error_code error_code{};
+    boost::beast::http::read(stream, buffer, response, error_code);
+    CHECK(error_code == boost::beast::http::error::end_of_stream);
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("Pipelined unsafe requests", "[HttpServer]") {
+    http::server::ServerSettings settings{};
+    settings.pipeline_depth = 4;
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0, settings);
+
+    // a document both of the handlers take time to get to
+    std::mutex document_mutex{};
+    std::string document = "initial";
+    const auto delay = std::chrono::milliseconds(50);
+    server_ptr->AddListener("/document", http::Method::get, [&](http::Request&&) {
+        std::this_thread::sleep_for(delay);
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        std::lock_guard lock(document_mutex);
+        response.body() = document;
+        return response;
+    }, http::server::Execution::WorkerPool);
+    server_ptr->AddListener("/document", http::Method::post, [&](http::Request&& request) {
+        std::this_thread::sleep_for(delay);
+        std::lock_guard lock(document_mutex);
+        document = request.body();
+        return http::Response{http::Status::ok, http::consts::kVersion};
+    }, http::server::Execution::WorkerPool);
+    server_ptr->Listen();
+    pool.Run();
+
+    boost::asio::io_context context{};
+    boost::beast::tcp_stream stream(context);
+    stream.connect(boost::asio::ip::tcp::endpoint(
+        boost::asio::ip::make_address(http::consts::kLocalhost), server_ptr->GetPort()));
+    // the write is handled after the first read and before the second one
+    const std::vector<std::pair<http::Method, std::string>> requests{
+        {http::Method::get, ""},
+        {http::Method::post, "updated"},
+        {http::Method::get, ""},
+    };
+    for (const auto& [method, body] : requests) {
+        http::Request request{method, "/document", http::consts::kVersion};
+        request.keep_alive(true);
+        request.body() = body;
+        request.prepare_payload();
+        boost::beast::http::write(stream, request);
+    }
+
+    boost::beast::flat_buffer buffer{};
+    std::vector<std::string> bodies{};
+    for (size_t i = 0; i < requests.size(); i++) {
+        http::Response response{};
+        boost::beast::http::read(stream, buffer, response);
+        CHECK(response.result() == http::Status::ok);
+        bodies.push_back(response.body());
+    }
+    CHECK(bodies == std::vector<std::string>{"initial", "", "updated"});
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("Chunked response", "[HttpServer]") {
+    constexpr size_t kChunksCount = 1000;
+
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0);
+    server_ptr->AddListener("/stream", http::Method::get, [](http::Request&&) {
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.SetChunkGenerator([index = size_t{0}](std::string& chunk) mutable {
+            if (index == kChunksCount) {
+                return false;
+            }
+            // empty chunks are skipped
+            if (index % 2 == 0) {
+                chunk = std::to_string(index);
+            }
+            index++;
+            return true;
+        });
+        return response;
+    });
+    server_ptr->AddListener("/stream/broken", http::Method::get, [](http::Request&&) {
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.SetChunkGenerator([](std::string&) -> bool {
+            throw std::runtime_error("error");
+        });
+        return response;
+    });
+    // the chunks of a worker pool route are generated on the workers
+    std::promise<std::thread::id> reactor_thread_id_promise{};
+    auto reactor_thread_id = reactor_thread_id_promise.get_future().share();
+    std::atomic<bool> is_generated_on_reactor{false};
+    server_ptr->AddListener("/stream/worker", http::Method::get, [&](http::Request&&) {
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.SetChunkGenerator([&, index = size_t{0}](std::string& chunk) mutable {
+            if (std::this_thread::get_id() == reactor_thread_id.get()) {
+                is_generated_on_reactor = true;
+            }
+            if (index == kChunksCount) {
+                return false;
+            }
+            chunk = std::to_string(index++);
+            return true;
+        });
+        return response;
+    }, http::server::Execution::WorkerPool);
+    server_ptr->Listen();
+    pool.Run();
+    boost::asio::post(*pool.GetContextPtrs().front(), [&reactor_thread_id_promise] {
+        reactor_thread_id_promise.set_value(std::this_thread::get_id());
+    });
+
+    std::string expected_body{};
+    for (size_t i = 0; i < kChunksCount; i += 2) {
+        expected_body += std::to_string(i);
+    }
+
+    http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+    const auto response = client.Request(
+        http::Request{http::Method::get, "/stream", http::consts::kVersion});
+    CHECK(response.result() == http::Status::ok);
+    CHECK(response.chunked());
+    CHECK(response.body() == expected_body);
+
+    CHECK_THROWS(client.Request(
+        http::Request{http::Method::get, "/stream/broken", http::consts::kVersion}));
+
+    expected_body.clear();
+    for (size_t i = 0; i < kChunksCount; i++) {
+        expected_body += std::to_string(i);
+    }
+    http::client::HttpClient worker_client(http::consts::kLocalhost, server_ptr->GetPort());
+    const auto worker_response = worker_client.Request(
+        http::Request{http::Method::get, "/stream/worker", http::consts::kVersion});
+    CHECK(worker_response.result() == http::Status::ok);
+    CHECK(worker_response.body() == expected_body);
+    CHECK_FALSE(is_generated_on_reactor);
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("File range response", "[HttpServer]") {
+    // larger than a single sendfile call
+    constexpr size_t kFileSize = 3 * 1024 * 1024 + 17;
+    constexpr size_t kOffset = 100;
+    const auto path = std::filesystem::temp_directory_path() / "http_file_range_test.bin";
+    std::string content(kFileSize, '\0');
+    for (size_t i = 0; i < kFileSize; i++) {
+        content[i] = static_cast<char>('a' + i % 26);
+    }
+    std::ofstream(path, std::ios::binary) << content;
+
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0);
+    server_ptr->AddListener("/file", http::Method::get, [&](http::Request&&) {
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.set(boost::beast::http::field::content_type, "application/octet-stream");
+        response.SetFileRange(std::make_shared<http::FileRange>(
+            path, kOffset, kFileSize - kOffset));
+        return response;
+    });
+    server_ptr->AddListener("/file/missing", http::Method::get, [](http::Request&&) {
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.SetFileRange(std::make_shared<http::FileRange>(
+            "/not/existing/file", 0, 1));
+        return response;
+    });
+    server_ptr->Listen();
+    pool.Run();
+
+    http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+    // the connection stays usable after the file is sent
+    for (size_t i = 0; i < 2; i++) {
+        const auto response = client.Request(
+            http::Request{http::Method::get, "/file", http::consts::kVersion});
+        CHECK(response.result() == http::Status::ok);
+        CHECK(response[boost::beast::http::field::content_type] == "application/octet-stream");
+        CHECK(response.body() == content.substr(kOffset));
+    }
+
+    const auto response = client.Request(
+        http::Request{http::Method::get, "/file/missing", http::consts::kVersion});
+    CHECK(response.result() == http::Status::internal_server_error);
+
+    server_ptr->Stop();
+    pool.Stop();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Admission control", "[HttpServer]") {
+    http::server::ServerSettings settings{};
+    settings.limiter.max_connections = 2;
+    settings.limiter.max_in_flight = 1;
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0, settings);
+
+    std::atomic<bool> is_started{false};
+    std::atomic<bool> is_released{false};
+    server_ptr->AddListener("/slow", http::Method::get, [&](http::Request&&) {
+        is_started = true;
+        while (!is_released) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return http::Response{http::Status::ok, http::consts::kVersion};
+    }, http::server::Execution::WorkerPool);
+    server_ptr->Listen();
+    pool.Run();
+
+    const auto endpoint = boost::asio::ip::tcp::endpoint(
+        boost::asio::ip::make_address(http::consts::kLocalhost), server_ptr->GetPort());
+    boost::asio::io_context context{};
+    boost::beast::tcp_stream slow_stream(context);
+    slow_stream.connect(endpoint);
+    boost::beast::http::write(
+        slow_stream, http::Request{http::Method::get, "/slow", http::consts::kVersion});
+    while (!is_started) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // the only request slot is taken
+    http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+    const auto rejected_response = client.Request(
+        http::Request{http::Method::get, "/slow", http::consts::kVersion});
+    CHECK(rejected_response.result() == http::Status::service_unavailable);
+
+    // the connection slots are taken once the client connection is gone
+    while (server_ptr->GetLimiterState().connections != 1) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    boost::beast::tcp_stream idle_stream(context);
+    idle_stream.connect(endpoint);
+    boost::beast::tcp_stream rejected_stream(context);
+    rejected_stream.connect(endpoint);
+    boost::beast::flat_buffer buffer{};
+    http::Response response{};
+    boost::beast::http::read(rejected_stream, buffer, response);
+    CHECK(response.result() == http::Status::service_unavailable);
+
+    auto state = server_ptr->GetLimiterState();
+    CHECK(state.connections == 2);
+    CHECK(state.in_flight == 1);
+    CHECK(state.rejected_connections == 1);
+    CHECK(state.rejected_requests == 1);
+
+    is_released = true;
+    buffer.clear();
+    boost::beast::http::read(slow_stream, buffer, response);
+    CHECK(response.result() == http::Status::ok);
+    CHECK(server_ptr->GetLimiterState().in_flight == 0);
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("Connection timeouts", "[HttpServer]") {
+    http::server::ServerSettings settings{};
+    settings.idle_timeout = std::chrono::milliseconds(300);
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0, settings);
+    server_ptr->AddListener("/ping", http::Method::get, &http::handlers::handle_ping);
+    server_ptr->AddListener("/slow", http::Method::get, [](http::Request&&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(600));
+        return http::Response{http::Status::ok, http::consts::kVersion};
+    }, http::server::Execution::WorkerPool);
+    server_ptr->Listen();
+    pool.Run();
+
+    boost::asio::io_context context{};
+    const auto connect = [&context, &server_ptr] {
+        auto stream_ptr = std::make_unique<boost::beast::tcp_stream>(context);
+        stream_ptr->connect(boost::asio::ip::tcp::endpoint(
+            boost::asio::ip::make_address(http::consts::kLocalhost), server_ptr->GetPort()));
+        return stream_ptr;
+    };
+    const auto request = [](boost::beast::tcp_stream& stream, const std::string& target) {
+        http::Request request{http::Method::get, target, http::consts::kVersion};
+        request.keep_alive(true);
+        boost::beast::http::write(stream, request);
+        boost::beast::flat_buffer buffer{};
+        http::Response response{};
+        boost::beast::error_code error_code{};
+        boost::beast::http::read(stream, buffer, response, error_code);
+        return error_code;
+    };
+    const auto is_closed = [](boost::beast::tcp_stream& stream) {
+        boost::beast::flat_buffer buffer{};
+        http::Response response{};
+        boost::beast::error_code error_code{};
+        boost::beast::http::read(stream, buffer, response, error_code);
+        return error_code == boost::beast::http::error::end_of_stream;
+    };
+
+    SECTION("Idle connection") {
+        auto stream_ptr = connect();
+        const auto started_at = std::chrono::steady_clock::now();
+        CHECK(is_closed(*stream_ptr));
+        CHECK(std::chrono::steady_clock::now() - started_at >= settings.idle_timeout);
+    }
+
+    SECTION("Idle after a request") {
+        auto stream_ptr = connect();
+        for (size_t i = 0; i < 3; i++) {
+            // activity keeps the connection open
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            CHECK_FALSE(request(*stream_ptr, "/ping"));
+        }
+        CHECK(is_closed(*stream_ptr));
+    }
+
+    SECTION("Handler time is not limited") {
+        auto stream_ptr = connect();
+        CHECK_FALSE(request(*stream_ptr, "/slow"));
+    }
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("Read ahead of a closed connection", "[HttpServer]") {
+    http::server::ServerSettings settings{};
+    settings.pipeline_depth = 4;
+    settings.active_timeout = std::chrono::milliseconds(300);
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0, settings);
+    server_ptr->AddListener("/broken", http::Method::get, [](http::Request&&) {
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.SetChunkGenerator([](std::string&) -> bool {
+            throw std::runtime_error("error");
+        });
+        return response;
+    });
+    server_ptr->Listen();
+    pool.Run();
+
+    // the broken response closes the connection while the next request is being read
+    boost::asio::io_context context{};
+    boost::beast::tcp_stream stream(context);
+    stream.connect(boost::asio::ip::tcp::endpoint(
+        boost::asio::ip::make_address(http::consts::kLocalhost), server_ptr->GetPort()));
+    http::Request request{http::Method::get, "/broken", http::consts::kVersion};
+    request.keep_alive(true);
+    boost::beast::http::write(stream, request);
+    boost::beast::flat_buffer buffer{};
+    http::Response response{};
+    boost::beast::error_code error_code{};
+    boost::beast::http::read(stream, buffer, response, error_code);
+    CHECK(error_code);
+
+    // the peer keeps the connection open, the session is not kept for longer than the timeout
+    const auto started_at = std::chrono::steady_clock::now();
+    while (server_ptr->GetLimiterState().connections != 0 &&
+           std::chrono::steady_clock::now() - started_at < std::chrono::seconds(3)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(server_ptr->GetLimiterState().connections == 0);
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("Request metrics", "[HttpServer]") {
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0);
+    server_ptr->AddListener("/metrics-test/{id}", http::Method::get, [](http::Request&& request) {
+        if (request.target() == "/metrics-test/missing") {
+            throw http::exceptions::NotFound("not found");
+        }
+        return http::Response{http::Status::ok, http::consts::kVersion};
+    });
+    server_ptr->AddListener("/metrics", http::Method::get, &http::handlers::handle_metrics);
+    server_ptr->Listen();
+    pool.Run();
+
+    http::client::HttpClient client(http::consts::kLocalhost, server_ptr->GetPort());
+    const auto request = [&client](const std::string& target) {
+        return client.Request(http::Request{http::Method::get, target, http::consts::kVersion});
+    };
+    request("/metrics-test/1");
+    request("/metrics-test/2");
+    request("/metrics-test/missing");
+
+    const auto response = request("/metrics");
+    CHECK(response[boost::beast::http::field::content_type] == "text/plain; version=0.0.4");
+    const auto& text = response.body();
+    // the requests are accounted to the route pattern rather than the path
+    CHECK_THAT(text, Catch::Matchers::Contains(
+        "http_requests_total{route=\"/metrics-test/{id}\",method=\"GET\",status=\"200\"} 2\n"));
+    CHECK_THAT(text, Catch::Matchers::Contains(
+        "http_requests_total{route=\"/metrics-test/{id}\",method=\"GET\",status=\"404\"} 1\n"));
+    CHECK_THAT(text, Catch::Matchers::Contains(
+        "http_request_duration_seconds_count{route=\"/metrics-test/{id}\",method=\"GET\"} 3\n"));
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("Request body streaming", "[HttpServer]") {
+    constexpr uint64_t kUploadLimit = 4 * 1024 * 1024;
+
+    /// @class Counts the body bytes and the parts it came by.
+    /// Checks that the reactor thread never calls it.
+    class CountingSink : public http::BodySink {
+    public:
+        explicit CountingSink(std::thread::id reactor_thread_id)
+            : reactor_thread_id_{reactor_thread_id},
+              is_on_reactor_{std::this_thread::get_id() == reactor_thread_id} {}
+
+        void Write(std::string_view data) override {
+            size_ += data.size();
+            parts_count_++;
+            is_on_reactor_ = is_on_reactor_ || std::this_thread::get_id() == reactor_thread_id_;
+        }
+
+        http::Response Finish(http::Request&& request) override {
+            CHECK(request.body().empty());
+            CHECK_FALSE(is_on_reactor_);
+            http::Response response{http::Status::ok, http::consts::kVersion};
+            response.body() = std::to_string(size_) + " " + std::to_string(parts_count_);
+            return response;
+        }
+
+    private:
+        const std::thread::id reactor_thread_id_;
+        bool is_on_reactor_;
+        size_t size_{0};
+        size_t parts_count_{0};
+    };
+
+    http::server::ServerSettings settings{};
+    settings.max_body_size = 1024;
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0, settings);
+    std::promise<std::thread::id> reactor_thread_id_promise{};
+    auto reactor_thread_id = reactor_thread_id_promise.get_future().share();
+    boost::asio::post(*pool.GetContextPtrs().front(), [&reactor_thread_id_promise] {
+        reactor_thread_id_promise.set_value(std::this_thread::get_id());
+    });
+    server_ptr->AddListener("/echo", http::Method::post, [](http::Request&& request) {
+        http::Response response{http::Status::ok, http::consts::kVersion};
+        response.body() = std::move(request.body());
+        return response;
+    });
+    server_ptr->AddListener("/upload", http::Method::post,
+                            [reactor_thread_id](const http::RequestHeader& header,
+                                                std::optional<uint64_t>) {
+        if (header.target() == "/upload?reject") {
+            throw http::exceptions::BadRequest("rejected");
+        }
+        return std::make_shared<CountingSink>(reactor_thread_id.get());
+    }, kUploadLimit, http::server::Execution::WorkerPool);
+    server_ptr->Listen();
+    pool.Run();
+
+    boost::asio::io_context context{};
+    boost::beast::tcp_stream stream(context);
+    stream.connect(boost::asio::ip::tcp::endpoint(
+        boost::asio::ip::make_address(http::consts::kLocalhost), server_ptr->GetPort()));
+    boost::beast::flat_buffer buffer{};
+    const auto read_response = [&stream, &buffer] {
+        http::Response response{};
+        boost::beast::http::read(stream, buffer, response);
+        return response;
+    };
+    const auto make_request = [](const std::string& target, std::string body) {
+        http::Request request{http::Method::post, target, http::consts::kVersion};
+        request.keep_alive(true);
+        request.body() = std::move(body);
+        request.prepare_payload();
+        return request;
+    };
+
+    SECTION("Body within the limit") {
+        boost::beast::http::write(stream, make_request("/echo", std::string(1024, 'x')));
+        const auto response = read_response();
+        CHECK(response.result() == http::Status::ok);
+        CHECK(response.body() == std::string(1024, 'x'));
+    }
+
+    SECTION("Body over the limit is rejected by Content-Length") {
+        // the body is not sent at all, the response comes anyway
+        boost::asio::write(stream, boost::asio::buffer(std::string(
+            "POST /echo HTTP/1.1\r\nContent-Length: 1025\r\n\r\n")));
+        const auto response = read_response();
+        CHECK(response.result() == http::Status::payload_too_large);
+        CHECK_FALSE(response.keep_alive());
+    }
+
+    SECTION("Chunked body over the limit") {
+        http::Request request{http::Method::post, "/echo", http::consts::kVersion};
+        request.body() = std::string(2048, 'x');
+        request.chunked(true);
+        boost::beast::http::write(stream, request);
+        const auto response = read_response();
+        CHECK(response.result() == http::Status::payload_too_large);
+        CHECK_FALSE(response.keep_alive());
+    }
+
+    SECTION("Expect 100-continue") {
+        auto request = make_request("/echo", "hello");
+        request.set(boost::beast::http::field::expect, "100-continue");
+        boost::beast::http::request_serializer<http::StringBody, http::Fields> serializer(request);
+        boost::beast::http::write_header(stream, serializer);
+
+        http::Response interim{};
+        boost::beast::http::read(stream, buffer, interim);
+        CHECK(interim.result() == http::Status::continue_);
+
+        boost::beast::http::write(stream, serializer);
+        const auto response = read_response();
+        CHECK(response.result() == http::Status::ok);
+        CHECK(response.body() == "hello");
+    }
+
+    SECTION("Expect 100-continue over the limit") {
+        auto request = make_request("/echo", std::string(2048, 'x'));
+        request.set(boost::beast::http::field::expect, "100-continue");
+        boost::beast::http::request_serializer<http::StringBody, http::Fields> serializer(request);
+        boost::beast::http::write_header(stream, serializer);
+        // the final response comes instead of the interim one
+        const auto response = read_response();
+        CHECK(response.result() == http::Status::payload_too_large);
+    }
+
+    SECTION("Streamed body") {
+        // the route limit is over the server one
+        constexpr size_t kBodySize = 2 * 1024 * 1024;
+        boost::beast::http::write(stream, make_request("/upload", std::string(kBodySize, 'x')));
+        const auto response = read_response();
+        CHECK(response.result() == http::Status::ok);
+        const auto delimiter = response.body().find(' ');
+        CHECK(response.body().substr(0, delimiter) == std::to_string(kBodySize));
+        CHECK(std::stoul(response.body().substr(delimiter + 1)) > 1);
+
+        // the connection is kept alive after a streamed body
+        http::Request request{http::Method::post, "/upload", http::consts::kVersion};
+        request.body() = "abc";
+        request.chunked(true);
+        boost::beast::http::write(stream, request);
+        CHECK(read_response().body() == "3 1");
+    }
+
+    SECTION("Streamed body rejected by the sink factory") {
+        boost::beast::http::write(stream, make_request("/upload?reject", "abc"));
+        const auto response = read_response();
+        CHECK(response.result() == http::Status::bad_request);
+        CHECK(response.body() == "rejected");
+    }
+
+    server_ptr->Stop();
+    pool.Stop();
+}
+
+TEST_CASE("Expired requests", "[HttpServer]") {
+    http::server::ServerSettings settings{};
+    settings.worker_pool_size = 1;
+    common::threading::IoReactorPool pool(1);
+    auto server_ptr = std::make_shared<http::server::HttpServer>(
+        pool.GetContextPtrs().front(), http::consts::kLocalhost, 0, settings);
+    std::atomic<size_t> handled_count{0};
+    server_ptr->AddListener("/work", http::Method::get, [&handled_count](http::Request&&) {
+        handled_count++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        return http::Response{http::Status::ok, http::consts::kVersion};
+    }, http::server::Execution::WorkerPool);
+    server_ptr->Listen();
+    pool.Run();
+
+    // the raw requests, the client would give up on the deadline itself
+    const auto request = [&server_ptr](std::optional<std::string> timeout_ms) {
+        boost::asio::io_context context{};
+        boost::beast::tcp_stream stream(context);
+        stream.connect(boost::asio::ip::tcp::endpoint(
+            boost::asio::ip::make_address(http::consts::kLocalhost), server_ptr->GetPort()));
+        http::Request request{http::Method::get, "/work", http::consts::kVersion};
+        if (timeout_ms.has_value()) {
+            request.set(http::consts::kTimeoutHeader, timeout_ms.value());
+        }
+        boost::beast::http::write(stream, request);
+        boost::beast::flat_buffer buffer{};
+        http::Response response{};
+        boost::beast::http::read(stream, buffer, response);
+        return response.result();
+    };
+
+    SECTION("Expired on arrival") {
+        CHECK(request("0") == http::Status::gateway_timeout);
+        CHECK(handled_count == 0);
+        // the invalid header is ignored
+        CHECK(request("soon") == http::Status::ok);
+        CHECK(handled_count == 1);
+    }
+
+    SECTION("Expired in the worker queue") {
+        auto busy_future = std::async(std::launch::async, [&request] {
+            return request(std::nullopt);
+        });
+        while (handled_count == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK(request("100") == http::Status::gateway_timeout);
+        CHECK(busy_future.get() == http::Status::ok);
+        CHECK(handled_count == 1);
+    }
+
+    server_ptr->Stop();
+    pool.Stop();
+}
 
-} // namespace http::tests::http_server
\ No newline at end of file
+} // namespace http::tests::http_server
@@ -0,0 +1,40 @@
+#! /bin/bash
+# usage: run_benchmarks.sh [output_dir] [baseline_dir]
+# Builds the benchmarks in release mode and writes their results as JSON
+# into the output dir (./benchmarks_<commit> by default). Compares the
+# results with the ones of the baseline dir if specified.
+# Extra google benchmark flags may be passed via BENCHMARK_FLAGS.
+
+set -e # exit on any error
+
+commit=$(git rev-parse --short HEAD)
+output_dir=${1:-./benchmarks_${commit}}
+baseline_dir=$2
+build_dir=./_bench_build
+
+declare -A benchmarks=(
+    ["bench_common"]="libraries/common"
+    ["bench_http"]="libraries/http"
+)
+
+cmake -S . -B ${build_dir} -DCMAKE_BUILD_TYPE=Release
+cmake --build ${build_dir} -j"$(nproc)" --target "${!benchmarks[@]}"
+
+mkdir -p ${output_dir}
+for bench in "${!benchmarks[@]}"
+do
+    echo "Running ${bench}..."
+    ${build_dir}/${benchmarks[$bench]}/${bench} \
+        --benchmark_out=${output_dir}/${bench}.json \
+        --benchmark_out_format=json \
+        ${BENCHMARK_FLAGS}
+done
+
+if [ -n "${baseline_dir}" ]
+then
+    for bench in "${!benchmarks[@]}"
+    do
+        python3 ./utils/compare_benchmarks.py \
+            ${baseline_dir}/${bench}.json ${output_dir}/${bench}.json
+    done
+fi
@@ -1,6 +1,7 @@
 #include <iostream>
 
 #include <common/include/config/logging_config.hpp>
+#include <common/include/config/thread_pool_config.hpp>
 #include <common/include/format.hpp>
 #include <common/include/logging.hpp>
 #include <common/include/thread_pool.hpp>
@@ -39,14 +40,13 @@ auto InitComponents() {
 }
 
 int main() {
-    const size_t kThreadsCount = 4;
-
     try {
         const auto log_controller = InitLogger();
         const auto components_controller_ptr = InitComponents();
 
         LOG_INFO() << "Setting up the server...";
-        common::threading::IoThreadPool pool(kThreadsCount);
+        common::threading::IoThreadPool pool(common::config::GetThreadPoolConfig());
+        LOG_INFO() << "I/O threads: " << pool.GetPoolSize();
         auto server_ptr = std::make_shared<http::server::HttpServer>(
             pool.GetContextPtr(), http::consts::kLocalhost, kPort);
         server_ptr->AddListener("/ping", http::Method::get,
@@ -58,7 +58,8 @@ int main() {
         server_ptr->AddListener("/api/v1/api-config/get", http::Method::get,
                                 &api_config::handlers::handle_get);
         server_ptr->AddListener("/api/v1/api-config/list", http::Method::get,
-                                &api_config::handlers::handle_list);
+                                &api_config::handlers::handle_list,
+                                &api_config::handlers::get_list_validators);
         server_ptr->AddListener("/api/v1/api-config/update", http::Method::post,
                                 &api_config::handlers::handle_update);
         server_ptr->Listen();
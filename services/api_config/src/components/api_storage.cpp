@@ -12,7 +12,11 @@ using models::Metadata;
 
 } // namespace
 
-ApiConfigStorage::ApiConfigStorage() : id_counter_{0}, apis_() {}
+ApiConfigStorage::ApiConfigStorage()
+    : apis_(), id_counter_{0},
+      epoch_{static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count())},
+      modifications_count_{0} {}
 ApiConfigStorage::~ApiConfigStorage() {}
 
 const char* ApiConfigStorage::Name() const {
@@ -23,6 +27,7 @@ void ApiConfigStorage::Init() {}
 
 void ApiConfigStorage::Reset() {
     apis_.clear();
+    OnModified();
 }
 
 ApiConfigData ApiConfigStorage::Insert(const models::ApiConfig& api) {
@@ -38,6 +43,7 @@ ApiConfigData ApiConfigStorage::Insert(const models::ApiConfig& api) {
         std::move(meta), // metadata
     };
     apis_[data.metadata.id] = data;
+    OnModified();
     return data;
 }
 
@@ -47,6 +53,7 @@ std::optional<ApiConfigData> ApiConfigStorage::Update(
     if (it != apis_.end()) {
         it->second.metadata.updated = std::chrono::system_clock::now();
         it->second.data = api;
+        OnModified();
         return it->second;
     }
     return std::nullopt;
@@ -57,6 +64,7 @@ std::optional<ApiConfigData> ApiConfigStorage::Delete(models::ApiConfigId id) {
     if (it != apis_.end()) {
         auto data = it->second;
         apis_.erase(it);
+        OnModified();
         return data;
     }
     return std::nullopt;
@@ -79,8 +87,16 @@ std::vector<models::ApiConfigData> ApiConfigStorage::List() const {
     return result;
 }
 
+std::string ApiConfigStorage::GetVersion() const {
+    return common::format::Format("{}-{}", epoch_, modifications_count_.load());
+}
+
 models::ApiConfigId ApiConfigStorage::GetNextId() {
     return models::ApiConfigId(id_counter_++);
 }
 
+void ApiConfigStorage::OnModified() {
+    modifications_count_++;
+}
+
 } // namespace api_config::components
\ No newline at end of file
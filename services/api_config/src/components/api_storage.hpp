@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <optional>
 #include <string>
 #include <vector>
@@ -32,11 +33,20 @@ public:
     std::optional<models::ApiConfigData> Get(models::ApiConfigId id) const;
     std::vector<models::ApiConfigData> List() const;
 
+    /// @brief Returns the version of the stored configs, changed by every
+    /// modification. Versions are unique across the storage restarts too.
+    std::string GetVersion() const;
+
 private:
     models::ApiConfigId GetNextId();
+    void OnModified();
 
     std::unordered_map<models::ApiConfigId, models::ApiConfigData> apis_;
     uint64_t id_counter_;
+    // the storage is in memory, so the counter starts over with the epoch
+    uint64_t epoch_;
+    // read by the version checks concurrently with the modifications
+    std::atomic<uint64_t> modifications_count_;
 };
 
 } // namespace api_config::components
\ No newline at end of file
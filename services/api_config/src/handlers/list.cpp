@@ -1,4 +1,4 @@
-#include "get.hpp"
+#include "list.hpp"
 
 #include <common/include/json.hpp>
 #include <common/include/logging.hpp>
@@ -30,4 +30,13 @@ http::Response handle_list(http::Request&& request) {
     return response;
 }
 
+http::conditional::Validators get_list_validators(const http::Request& /*request*/) {
+    auto storage_ptr = ::components::ComponentsEngine::GetInstance()
+        .Get<components::ApiConfigStorage>();
+    return http::conditional::Validators{
+        http::conditional::MakeETag(storage_ptr->GetVersion()),  // etag
+        std::nullopt,                                            // last_modified
+    };
+}
+
 } // namespace api_config::handlers
\ No newline at end of file
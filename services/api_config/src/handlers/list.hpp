@@ -1,9 +1,14 @@
 #pragma once
 
+#include <http/include/conditional.hpp>
 #include <http/include/models.hpp>
 
 namespace api_config::handlers {
 
 http::Response handle_list(http::Request&& request);
 
+/// @brief Validators of the configs list, the entity tag
+/// is the storage version, no configs are copied.
+http::conditional::Validators get_list_validators(const http::Request& request);
+
 } // namespace api_config::handlers
\ No newline at end of file
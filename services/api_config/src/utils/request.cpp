@@ -1,30 +1,18 @@
 #include "request.hpp"
 
-#include <exception>
+#include <cstdint>
 
-#include <common/include/utils/algo.hpp>
 #include <http/include/exceptions.hpp>
-#include <http/include/utils.hpp>
+#include <http/include/request_view.hpp>
 
 namespace api_config::utils {
 
 models::ApiConfigId GetId(const http::Request& request) {
-    auto params = http::utils::GetParams(request);
-    auto id_opt = common::utils::algo::GetOptional(params, "id");
+    const auto id_opt = http::RequestView(request).GetParamAs<uint64_t>("id");
     if (!id_opt.has_value()) {
         throw http::exceptions::BadRequest("Parameter 'id' not found");
     }
-
-    // negative numbers
-    if (id_opt->at(0) == '-') {
-        throw http::exceptions::BadRequest("Parameter 'id' is invalid");
-    }
-    
-    try {
-        return models::ApiConfigId(std::stoul(id_opt.value().data()));
-    } catch (const std::logic_error& ex) {
-        throw http::exceptions::BadRequest("Parameter 'id' is invalid");
-    }
+    return models::ApiConfigId(id_opt.value());
 }
 
-} // namespace api_config::utils
\ No newline at end of file
+} // namespace api_config::utils
@@ -220,3 +220,18 @@ def test_update_missing(api_config):
     assert(response.status_code == 404)
     assert(response.text == 'API config with id \'0\' not found')
 
+
+def test_list_not_modified(api_config):
+    response = api_config.get('/api/v1/api-config/list')
+    assert(response.status_code == 200)
+    etag = response.headers['ETag']
+
+    response = api_config.get('/api/v1/api-config/list', headers={'If-None-Match': etag})
+    assert(response.status_code == 304)
+    assert(response.headers['ETag'] == etag)
+
+    _create_api_config(api_config, name='config')
+    response = api_config.get('/api/v1/api-config/list', headers={'If-None-Match': etag})
+    assert(response.status_code == 200)
+    assert(response.headers['ETag'] != etag)
+    assert(len(response.json()['items']) == 1)
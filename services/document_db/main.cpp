@@ -1,6 +1,7 @@
 #include <iostream>
 
 #include <common/include/config/logging_config.hpp>
+#include <common/include/config/thread_pool_config.hpp>
 #include <common/include/logging.hpp>
 #include <common/include/thread_pool.hpp>
 #include <components/include/components_controller.hpp>
@@ -16,6 +17,7 @@
 #include <handlers/get.hpp>
 #include <handlers/list.hpp>
 #include <handlers/update.hpp>
+#include <handlers/upload.hpp>
 
 
 namespace {
@@ -48,23 +50,46 @@ auto InitComponents() {
 } // namespace
 
 int main() {
-    const size_t kThreadsCount = 4;
+    const size_t kPipelineDepth = 16;
+    const size_t kMaxConnections = 4096;
+    const size_t kInitialInFlightLimit = 64;
+    const size_t kRequestsQueueSize = 64;
+    const uint64_t kMaxUploadSize = 256 * 1024 * 1024;
 
     try {
         const auto log_controller = InitLogger();
         const auto components_controller_ptr = InitComponents();
 
         LOG_INFO() << "Setting up the server...";
-        common::threading::IoThreadPool pool(kThreadsCount);
+        http::server::ServerSettings settings{};
+        settings.pipeline_depth = kPipelineDepth;
+        settings.limiter.max_connections = kMaxConnections;
+        settings.limiter.adaptive = true;
+        settings.limiter.max_in_flight = kInitialInFlightLimit;
+        settings.limiter.max_queue_size = kRequestsQueueSize;
+        // documents JSON is verbose, the bandwidth is worth the CPU
+        settings.compression.enabled = true;
+        common::threading::IoReactorPool pool(common::config::GetThreadPoolConfig());
+        LOG_INFO() << "I/O threads: " << pool.GetPoolSize();
         auto server_ptr = std::make_shared<http::server::HttpServer>(
-            pool.GetContextPtr(), http::consts::kLocalhost, kPort);
+            pool.GetContextPtrs(), http::consts::kLocalhost, kPort, settings);
         server_ptr->AddListener("/ping", http::Method::get, &http::handlers::handle_ping);
-        server_ptr->AddListener(MakePath("clear"), http::Method::post, &documents::handlers::HandleClear);
-        server_ptr->AddListener(MakePath("create"), http::Method::post, &documents::handlers::handle_create);
-        server_ptr->AddListener(MakePath("delete"), http::Method::post, &documents::handlers::handle_delete);
-        server_ptr->AddListener(MakePath("get"), http::Method::get, &documents::handlers::handle_get);
-        server_ptr->AddListener(MakePath("list"), http::Method::get, &documents::handlers::handle_list);
-        server_ptr->AddListener(MakePath("update"), http::Method::post, &documents::handlers::handle_update);
+        server_ptr->AddListener("/server/limiter", http::Method::get,
+                                http::handlers::MakeLimiterStateHandler(server_ptr));
+        server_ptr->AddListener("/server/compression", http::Method::get,
+                                http::handlers::MakeCompressionStatsHandler(server_ptr));
+        // storage handlers block on the file I/O, keep them off the reactors
+        const auto kBlocking = http::server::Execution::WorkerPool;
+        server_ptr->AddListener(MakePath("clear"), http::Method::post, &documents::handlers::HandleClear, kBlocking);
+        server_ptr->AddListener(MakePath("create"), http::Method::post, &documents::handlers::handle_create, kBlocking);
+        server_ptr->AddListener(MakePath("delete"), http::Method::post, &documents::handlers::handle_delete, kBlocking);
+        server_ptr->AddListener(MakePath("get"), http::Method::get, &documents::handlers::handle_get, &documents::handlers::get_validators, kBlocking);
+        server_ptr->AddListener(MakePath("list"), http::Method::get, &documents::handlers::handle_list, kBlocking);
+        server_ptr->AddListener(MakePath("update"), http::Method::post, &documents::handlers::handle_update, kBlocking);
+        // raw payloads are streamed to the page files, the rest of the bodies are small
+        server_ptr->AddListener(MakePath("upload"), http::Method::post, &documents::handlers::make_upload_sink, kMaxUploadSize, kBlocking);
+        server_ptr->AddListener(MakePath("{id}"), http::Method::get, &documents::handlers::handle_get, &documents::handlers::get_validators, kBlocking);
+        server_ptr->AddListener(MakePath("{id}/payload"), http::Method::get, &documents::handlers::handle_get_payload, &documents::handlers::get_validators, kBlocking);
 
         server_ptr->Listen();
         pool.RunInThisThread();
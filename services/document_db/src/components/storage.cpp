@@ -55,6 +55,17 @@ documents::models::Document Storage::Get(models::DocumentId id, bool fetch_paylo
     return result;
 }
 
+http::FileRangePtr Storage::GetPayloadRange(models::DocumentId id) {
+    boost::shared_lock lock(data_access_mutex_);
+    const auto info_it = FindDocumentInfo(documents_info_, id);
+    const auto& position_opt = info_it->second->position;
+    if (!position_opt.has_value()) {
+        throw std::runtime_error("Missing document position");
+    }
+    const auto range = sink_.LocatePayload(position_opt.value());
+    return std::make_shared<http::FileRange>(range.path, range.offset, range.size);
+}
+
 std::vector<models::Document> Storage::List() {
     std::vector<models::Document> result{};
     result.reserve(documents_info_.size());
@@ -69,6 +80,23 @@ std::vector<models::Document> Storage::List() {
     return result;
 }
 
+std::vector<models::Document> Storage::List(std::optional<models::DocumentId> after,
+                                            size_t limit) {
+    std::vector<models::Document> result{};
+    result.reserve(limit);
+    boost::shared_lock lock(data_access_mutex_);
+    auto it = after.has_value() ?
+        documents_info_.upper_bound(after.value()) : documents_info_.begin();
+    for (; it != documents_info_.end() && result.size() < limit; it++) {
+        result.push_back(
+            models::Document{
+                *it->second,    // info
+                std::nullopt,   // payload
+            });
+    }
+    return result;
+}
+
 models::Document Storage::Add(models::DocumentInput&& input) {  
     const auto id = NextId();
     auto created = std::chrono::system_clock::now();
@@ -97,6 +125,41 @@ models::Document Storage::Add(models::DocumentInput&& input) {
     };
 }
 
+fs_sink::PayloadWriter Storage::BeginUpload(std::optional<size_t> size) {
+    boost::lock_guard lock(data_access_mutex_);
+    return sink_.BeginPayload(size);
+}
+
+models::Document Storage::Add(models::DocumentInput&& input, fs_sink::PayloadWriter&& writer) {
+    const auto id = NextId();
+    auto created = std::chrono::system_clock::now();
+    auto updated = created;
+
+    models::DocumentInfo info{
+        id,                               // id
+        std::move(created),               // created
+        std::move(updated),               // updated
+        std::move(input.name),            // name
+        std::move(input.owner),           // owner
+        std::move(input.namespace_name),  // namespace_name
+        std::nullopt,                     // position
+    };
+
+    boost::lock_guard lock(data_access_mutex_);
+    info.position = sink_.Store(std::nullopt, std::move(writer));
+    documents_info_[id] = std::make_shared<models::DocumentInfo>(info);
+    OnDocumentUpdated();
+    return models::Document{
+        std::move(info),  // info
+        std::nullopt,     // payload
+    };
+}
+
+void Storage::DiscardUpload(fs_sink::PayloadWriter&& writer) {
+    boost::lock_guard lock(data_access_mutex_);
+    sink_.Discard(std::move(writer));
+}
+
 models::Document Storage::Update(models::DocumentId id,
                                  models::DocumentUpdateInput&& input) {
     boost::upgrade_lock read_lock(data_access_mutex_);
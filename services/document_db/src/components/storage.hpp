@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <optional>
 #include <shared_mutex>
 #include <vector>
 #include <unordered_map>
@@ -9,6 +10,7 @@
 #include <boost/thread.hpp>
 
 #include <components/include/component_base.hpp>
+#include <http/include/models.hpp>
 
 #include <fs_sink/fs_sink.hpp>
 #include <models/document.hpp>
@@ -35,14 +37,46 @@ public:
     /// @throws NotFoundException if document is not found
     models::Document Get(models::DocumentId id, bool fetch_payload = false);
 
+    /// @brief Opens a document payload within the storage files,
+    /// so it can be sent without being loaded. The file is opened under the
+    /// storage lock, so the range stays valid even if the payload is updated
+    /// or the page is removed afterwards.
+    /// @param id document id
+    /// @return opened range of the payload bytes
+    /// @throws NotFoundException if document is not found
+    http::FileRangePtr GetPayloadRange(models::DocumentId id);
+
     /// @brief Retrieves all existing documents.
     /// @return vector of documents
     std::vector<models::Document> List();
 
+    /// @brief Retrieves a page of documents ordered by id.
+    /// @param after id to start after, the first page is retrieved if not set
+    /// @param limit max number of documents in the page
+    /// @return vector of documents, less than limit only for the last page
+    std::vector<models::Document> List(std::optional<models::DocumentId> after,
+                                       size_t limit);
+
     /// @brief Stores a document.
     /// @param input document data
     /// @return stored document
     models::Document Add(models::DocumentInput&& input);
+
+    /// @brief Starts a payload upload. The payload is written part by part
+    /// right to the storage files, so it is never held in memory as a whole.
+    /// @param size payload size if known in advance
+    /// @return payload writer to be stored or discarded
+    fs_sink::PayloadWriter BeginUpload(std::optional<size_t> size);
+
+    /// @brief Stores a document with an uploaded payload.
+    /// @param input document data, the payload is ignored
+    /// @param writer writer of the uploaded payload
+    /// @return stored document
+    models::Document Add(models::DocumentInput&& input, fs_sink::PayloadWriter&& writer);
+
+    /// @brief Drops a payload upload which is not going to be stored.
+    /// @param writer writer of the uploaded payload
+    void DiscardUpload(fs_sink::PayloadWriter&& writer);
     
     /// @brief Updates previously stored document.
     /// @param id document id
@@ -1,5 +1,7 @@
 #include "fs_sink.hpp"
 
+#include <algorithm>
+
 #include <boost/regex.hpp>
 
 #include <common/include/binary.hpp>
@@ -55,7 +57,7 @@ auto OpenMetaFileOut(const std::filesystem::path& path) {
 }
 
 size_t GetPayloadSize(models::DocumentPayloadPtr payload) {
-    return sizeof(bool) + sizeof(size_t) + payload->GetUnderlying().size();  // move to binary size traits
+    return kPayloadHeaderSize + payload->GetUnderlying().size();
 }
 
 std::unordered_map<size_t, PageFile> LoadPageFilesMap(const std::filesystem::path& path) {
@@ -77,7 +79,8 @@ std::unordered_map<size_t, PageFile> LoadPageFilesMap(const std::filesystem::pat
 } // namespace
 
 FileStorageSink::FileStorageSink(const std::filesystem::path& path) 
-    : path_(path), meta_path_(GetIndexPath(path_)), page_index_counter_(0), pages_map_() {}
+    : path_(path), meta_path_(GetIndexPath(path_)), page_index_counter_(0), pages_map_(),
+      reservations_() {}
 
 FileStorageSink::~FileStorageSink() {}
 
@@ -98,6 +101,11 @@ void FileStorageSink::Reset() {
     pages_map_.clear();
     page_index_counter_ = 0;
     InitFs();
+    // the page sizes are reloaded from the files, the payloads being
+    // written would be overwritten by the next ones otherwise
+    for (const auto& [position, size] : reservations_) {
+        ReservePage(position.first, size);
+    }
 }
     
 void FileStorageSink::Store(const models::DocumentInfoMap& documents_info) {
@@ -145,6 +153,87 @@ models::DocumentPosition FileStorageSink::Store(const std::optional<models::Docu
     return new_position;
 }
 
+PayloadWriter FileStorageSink::BeginPayload(std::optional<size_t> size) {
+    // a payload of unknown size takes the whole page, so only an empty
+    // or a new one fits it, and it may not take more than that
+    const size_t reserved_size = size.has_value() ?
+        kPayloadHeaderSize + size.value() : kMaxPageSize - PageFile::GetDefaultPageSize();
+    const auto position = FindAvailablePosition(reserved_size);
+
+    const auto page_size = position.page_offset + reserved_size;
+    ReservePage(position.page_index, page_size);
+    reservations_.insert_or_assign({position.page_index, position.page_offset}, page_size);
+
+    LOG_DEBUG() << "Payload is reserved at " << position.page_index << ":" << position.page_offset;
+    return PayloadWriter(pages_map_.at(position.page_index).Path(), position, size,
+                         reserved_size - kPayloadHeaderSize);
+}
+
+models::DocumentPosition FileStorageSink::Store(const std::optional<models::DocumentPosition>& old_position_opt,
+                                                PayloadWriter&& writer) {
+    const auto new_position = writer.Position();
+    reservations_.erase({new_position.page_index, new_position.page_offset});
+    PageFile page(path_, new_position.page_index);
+    {
+        TransactionGuard page_guard(page.Path());
+        writer.Commit();
+
+        if (old_position_opt.has_value()) {
+            PageFile old_page(path_, old_position_opt.value().page_index);
+            if (old_page.Index() == page.Index()) {
+                old_page.DisablePayload(old_position_opt.value().page_offset);
+            } else {
+                TransactionGuard old_page_guard(old_page.Path());
+                old_page.DisablePayload(old_position_opt.value().page_offset);
+                old_page_guard.Commit();
+            }
+        }
+
+        page_guard.Commit();
+    }
+
+    // the page reserved as a whole gets the rest of its space back,
+    // its size is the actual one once the payload is flushed
+    if (!writer.ExpectedSize().has_value()) {
+        pages_map_.insert_or_assign(page.Index(), PageFile(path_, page.Index()));
+    }
+
+    LOG_DEBUG() << "Payload of " << writer.Size() << " bytes is stored to "
+                << new_position.page_index << ":" << new_position.page_offset;
+    return new_position;
+}
+
+void FileStorageSink::Discard(PayloadWriter&& writer) {
+    const auto position = writer.Position();
+    size_t reserved_page_size = 0;
+    if (const auto it = reservations_.find({position.page_index, position.page_offset});
+        it != reservations_.end()) {
+        reserved_page_size = it->second;
+        reservations_.erase(it);
+    }
+    {
+        // the buffered data is written out before the space is reused
+        PayloadWriter discarded(std::move(writer));
+    }
+    LOG_DEBUG() << "Payload at " << position.page_index << ":" << position.page_offset
+                << " is discarded";
+
+    // the space in the middle of the page stays taken, the next payloads
+    // may be placed after it already, the one at the tail is released
+    const auto page_it = pages_map_.find(position.page_index);
+    if (page_it == pages_map_.end() || page_it->second.Size() != reserved_page_size) {
+        return;
+    }
+    // the page takes the written part of the payload and the space
+    // of the other payloads being written
+    PageFile page(path_, position.page_index);
+    for (auto it = reservations_.lower_bound({position.page_index, 0});
+         it != reservations_.end() && it->first.first == position.page_index; ++it) {
+        page.Reserve(it->second);
+    }
+    page_it->second = std::move(page);
+}
+
 void FileStorageSink::Delete(const models::DocumentPosition& position) {
     PageFile page(path_, position.page_index);
     TransactionGuard page_guard(page.Path());
@@ -193,6 +282,11 @@ models::DocumentPayloadPtr FileStorageSink::LoadPayload(const models::DocumentPo
     return page.LoadPayload(position.page_offset);
 }
 
+PayloadRange FileStorageSink::LocatePayload(const models::DocumentPosition& position) {
+    PageFile page(path_, position.page_index);
+    return page.LocatePayload(position.page_offset);
+}
+
 void FileStorageSink::InitFs() {
     LOG_INFO() << "Init document DB file system storage at " << meta_path_;
 
@@ -228,6 +322,15 @@ models::DocumentPosition FileStorageSink::FindAvailablePosition(size_t size) {
     };
 }
 
+void FileStorageSink::ReservePage(size_t page_index, size_t size) {
+    auto it = pages_map_.find(page_index);
+    if (it == pages_map_.end()) {
+        it = pages_map_.emplace(page_index, PageFile(path_, page_index)).first;
+    }
+    it->second.Reserve(size);
+    page_index_counter_ = std::max(page_index_counter_, page_index);
+}
+
 void FileStorageSink::Swap(FileStorageSink&& other) {
     std::swap(path_, other.path_);
     std::swap(meta_path_, other.meta_path_);
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <filesystem>
+#include <map>
 #include <optional>
 #include <unordered_map>
+#include <utility>
 
 #include <boost/noncopyable.hpp>
 
@@ -25,7 +27,8 @@ public:
     /// @brief Init file system manager.
     void Init();
 
-    /// @brief Reset manager state.
+    /// @brief Reset manager state. The space of the payloads being
+    /// written stays reserved.
     void Reset();
 
     /// @brief stores document info index to FS (should be process-safe)
@@ -38,6 +41,25 @@ public:
     models::DocumentPosition Store(const std::optional<models::DocumentPosition>& old_position_opt,
                                    const models::DocumentPayloadPtr payload_ptr);
 
+    /// @brief reserves a position for a payload written part by part
+    /// @param size payload size if known, otherwise an empty page is reserved as a whole
+    /// and the payload may not exceed it
+    /// @return writer of the payload
+    PayloadWriter BeginPayload(std::optional<size_t> size);
+
+    /// @brief completes a payload written part by part
+    /// @param old_position_opt current DocumentPosition
+    /// @param writer writer of the payload
+    /// @return new DocumentPosition where the document is stored
+    models::DocumentPosition Store(const std::optional<models::DocumentPosition>& old_position_opt,
+                                   PayloadWriter&& writer);
+
+    /// @brief Releases the space of a payload which is not going to be completed.
+    /// Only the space at the page tail is released, the one followed by
+    /// other payloads stays unused.
+    /// @param writer writer of the payload
+    void Discard(PayloadWriter&& writer);
+
     /// @brief Deletes document payload.
     /// @param position document payload position
     void Delete(const models::DocumentPosition& position);
@@ -48,6 +70,9 @@ public:
     /// @brief Loads document payload by document id
     models::DocumentPayloadPtr LoadPayload(const models::DocumentPosition& position);
 
+    /// @brief Locates document payload bytes without loading them
+    PayloadRange LocatePayload(const models::DocumentPosition& position);
+
 private:
 
     /// @brief inits FS files in the current directory
@@ -58,12 +83,18 @@ private:
     /// @return available DocumentPosition
     models::DocumentPosition FindAvailablePosition(size_t size);
 
+    /// @brief Marks the page space up to the specified size as used.
+    void ReservePage(size_t page_index, size_t size);
+
     void Swap(FileStorageSink&& other);
     
     std::filesystem::path path_;
     std::filesystem::path meta_path_;
     size_t page_index_counter_;
     std::unordered_map<size_t, PageFile> pages_map_;
+    // page sizes reserved by the payloads being written by (page index, page offset),
+    // the page files may not have grown up to them yet
+    std::map<std::pair<size_t, size_t>, size_t> reservations_;
 };
 
 } // namespace documents::fs_sink
@@ -1,5 +1,6 @@
 #include "page.hpp"
 
+#include <algorithm>
 #include <string>
 
 #include <common/include/binary.hpp>
@@ -129,7 +130,8 @@ void PageFile::StorePayload(models::DocumentPayloadPtr payload_ptr, size_t offse
     file.Seek(offset);
     file << is_active;
     file << *payload_ptr;
-    size_ += sizeof(bool) + sizeof(size_t) + payload_ptr->GetUnderlying().size(); // TODO move to binary size traits
+    // the page may have space reserved beyond the end of the file
+    size_ = std::max(size_, offset + kPayloadHeaderSize + payload_ptr->GetUnderlying().size());
 
     // disable old payload if needed
     if (old_offset_opt.has_value()) {
@@ -137,6 +139,10 @@ void PageFile::StorePayload(models::DocumentPayloadPtr payload_ptr, size_t offse
     }
 }
 
+void PageFile::Reserve(size_t size) {
+    size_ = std::max(size_, size);
+}
+
 void PageFile::DisablePayload(size_t offset) {
     common::binary::BinaryOutStream file(path_);
     DisablePayloadInPage(file, offset);
@@ -144,6 +150,25 @@ void PageFile::DisablePayload(size_t offset) {
 
 models::DocumentPayloadPtr PageFile::LoadPayload(size_t page_offset) {
     common::binary::BinaryInStream file(path_);
+    SeekActivePayload(file, page_offset);
+    models::DocumentPayload payload;
+    file >> payload;
+    return std::make_shared<models::DocumentPayload>(std::move(payload));
+}
+
+PayloadRange PageFile::LocatePayload(size_t page_offset) {
+    common::binary::BinaryInStream file(path_);
+    SeekActivePayload(file, page_offset);
+    size_t size{};
+    file >> size;
+    return PayloadRange{
+        path_,                                             // path
+        page_offset + kPayloadHeaderSize,                  // offset
+        size,                                              // size
+    };
+}
+
+void PageFile::SeekActivePayload(common::binary::BinaryInStream& file, size_t page_offset) {
     file.Seek(page_offset);
     bool is_active{};
     file >> is_active;
@@ -152,9 +177,6 @@ models::DocumentPayloadPtr PageFile::LoadPayload(size_t page_offset) {
                     << path_ << ":" << page_offset;
         throw exceptions::FilesystemException();
     }
-    models::DocumentPayload payload;
-    file >> payload;
-    return std::make_shared<models::DocumentPayload>(std::move(payload));
 }
 
 std::filesystem::path PageFile::Path() const {
@@ -173,4 +195,55 @@ size_t PageFile::GetDefaultPageSize() {
     return kPagePrefixSize;
 }
 
+PayloadWriter::PayloadWriter(const std::filesystem::path& path,
+                             const models::DocumentPosition& position,
+                             std::optional<size_t> expected_size, size_t max_size)
+    : position_(position), expected_size_(expected_size), max_size_(max_size),
+      size_(0), file_(path) {
+    const bool is_active = false;
+    const size_t size = 0;
+    file_.Seek(position_.page_offset);
+    file_ << is_active;
+    file_ << size;
+}
+
+PayloadWriter::PayloadWriter(PayloadWriter&& other)
+    : position_(other.position_), expected_size_(other.expected_size_),
+      max_size_(other.max_size_), size_(other.size_), file_(std::move(other.file_)) {}
+
+PayloadWriter::~PayloadWriter() {}
+
+void PayloadWriter::Write(std::string_view data) {
+    if (size_ + data.size() > max_size_) {
+        throw exceptions::PayloadTooLargeException(common::format::Format(
+            "Payload exceeds the reserved size of {} bytes", max_size_));
+    }
+    file_.Write(data);
+    size_ += data.size();
+}
+
+void PayloadWriter::Commit() {
+    const bool is_active = true;
+    file_.Seek(position_.page_offset);
+    file_ << is_active;
+    file_ << size_;
+    file_.Flush();
+}
+
+const models::DocumentPosition& PayloadWriter::Position() const {
+    return position_;
+}
+
+size_t PayloadWriter::Size() const {
+    return size_;
+}
+
+std::optional<size_t> PayloadWriter::ExpectedSize() const {
+    return expected_size_;
+}
+
+size_t PayloadWriter::MaxSize() const {
+    return max_size_;
+}
+
 } // namespace documents::fs_sink
@@ -2,12 +2,27 @@
 
 #include <filesystem>
 #include <optional>
+#include <string_view>
+
+#include <boost/noncopyable.hpp>
+
+#include <common/include/binary.hpp>
 
 #include <models/document.hpp>
 
 
 namespace documents::fs_sink {
 
+/// @brief Size of the stored payload header: the active flag and the payload size.
+constexpr size_t kPayloadHeaderSize = sizeof(bool) + sizeof(size_t);  // TODO move to binary size traits
+
+/// @brief Location of the raw payload bytes within a page file.
+struct PayloadRange {
+    std::filesystem::path path{};
+    size_t offset{};
+    size_t size{};
+};
+
 /// @brief Meta info about a single DB payload page file.
 class PageFile {
 public:
@@ -35,6 +50,11 @@ public:
     void StorePayload(
         models::DocumentPayloadPtr payload_ptr, size_t offset, std::optional<size_t> old_offset = std::nullopt);
 
+    /// @brief Marks the page space up to the specified size as used,
+    /// so no other payload is placed there.
+    /// @param size page size including the reserved space
+    void Reserve(size_t size);
+
     /// @brief Disables previously stored payload
     /// @param offset payload offset within the page file
     void DisablePayload(size_t offset);
@@ -44,6 +64,11 @@ public:
     /// @return smart pointer to payload data
     models::DocumentPayloadPtr LoadPayload(size_t page_offset);
 
+    /// @brief Locates payload data within the page file without loading it.
+    /// @param page_offset offset to the stored payload in the file
+    /// @return range of the payload bytes
+    PayloadRange LocatePayload(size_t page_offset);
+
     std::filesystem::path Path() const;
     size_t Size() const;
     size_t Index() const;
@@ -53,10 +78,46 @@ public:
 
 private:
     void Init();
+    void SeekActivePayload(common::binary::BinaryInStream& file, size_t page_offset);
 
     std::filesystem::path path_;
     size_t size_;
     size_t index_;
 };
 
+/// @brief Writes a payload to the reserved position of a page file part by
+/// part, so the payload is never held in memory as a whole. The payload is
+/// inactive until committed, an abandoned one only takes the page space.
+class PayloadWriter : private boost::noncopyable {
+public:
+    /// @brief Ctor. Writes the inactive payload header.
+    /// @param path path to the page file
+    /// @param position reserved payload position
+    /// @param expected_size payload size if known in advance
+    /// @param max_size reserved payload space
+    PayloadWriter(const std::filesystem::path& path, const models::DocumentPosition& position,
+                  std::optional<size_t> expected_size, size_t max_size);
+    PayloadWriter(PayloadWriter&& other);
+    ~PayloadWriter();
+
+    /// @brief Appends data to the payload.
+    /// @throws PayloadTooLargeException if the payload exceeds the reserved space
+    void Write(std::string_view data);
+
+    /// @brief Writes the payload size and marks the payload as active.
+    void Commit();
+
+    const models::DocumentPosition& Position() const;
+    size_t Size() const;
+    std::optional<size_t> ExpectedSize() const;
+    size_t MaxSize() const;
+
+private:
+    models::DocumentPosition position_;
+    std::optional<size_t> expected_size_;
+    size_t max_size_;
+    size_t size_;
+    common::binary::BinaryOutStream file_;
+};
+
 } // namespace documents::fs_sink
@@ -1,5 +1,6 @@
 #include "get.hpp"
 
+#include <common/include/format.hpp>
 #include <components/include/components_engine.hpp>
 #include <http/include/exceptions.hpp>
 
@@ -22,4 +23,37 @@ http::Response handle_get(http::Request&& request) {
     }
 }
 
+http::conditional::Validators get_validators(const http::Request& request) {
+    const auto id = utils::request::GetId(request);
+    auto storage_ptr = ::components::ComponentsEngine::GetInstance()
+        .Get<components::Storage>();
+    try {
+        const auto updated = storage_ptr->Get(id, false).info.updated;
+        const auto updated_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            updated.time_since_epoch()).count();
+        // ids start over once the storage is cleared, the update time tells the documents apart
+        return http::conditional::Validators{
+            http::conditional::MakeETag(common::format::Format("{}-{}", id, updated_us)),  // etag
+            updated,                                                                      // last_modified
+        };
+    } catch (const exceptions::NotFoundException& ex) {
+        throw http::exceptions::NotFound(ex.what());
+    }
+}
+
+http::Response handle_get_payload(http::Request&& request) {
+    const auto id = utils::request::GetId(request);
+    auto storage_ptr = ::components::ComponentsEngine::GetInstance()
+        .Get<components::Storage>();
+    try {
+        auto range_ptr = storage_ptr->GetPayloadRange(id);
+        http::Response response{http::Status::ok, request.version()};
+        response.set(boost::beast::http::field::content_type, "application/octet-stream");
+        response.SetFileRange(std::move(range_ptr));
+        return response;
+    } catch (const exceptions::NotFoundException& ex) {
+        throw http::exceptions::NotFound(ex.what());
+    }
+}
+
 } // namespace documents::handlers
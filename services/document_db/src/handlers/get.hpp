@@ -1,9 +1,18 @@
 #pragma once
 
+#include <http/include/conditional.hpp>
 #include <http/include/models.hpp>
 
 namespace documents::handlers {
 
 http::Response handle_get(http::Request&& request);
 
+/// @brief Validators of a document derived from its update time,
+/// only the document info is looked up, the payload is not read.
+http::conditional::Validators get_validators(const http::Request& request);
+
+/// @brief Responds with the raw document payload. The payload is sent
+/// right from the page file, it is neither loaded nor copied.
+http::Response handle_get_payload(http::Request&& request);
+
 } // namespace documents::handlers
@@ -8,16 +8,20 @@
 
 namespace documents::handlers {
 
+namespace {
+
+// documents serialized into a single chunk of the response
+constexpr size_t kPageSize = 64;
+
+} // namespace
+
 http::Response handle_list(http::Request&& request) {
     auto storage_ptr = ::components::ComponentsEngine::GetInstance()
         .Get<components::Storage>();
-    auto documents = storage_ptr->List();
-    std::sort(
-        documents.begin(), documents.end(),
-        [](const auto& lhs, const auto& rhs) {
-            return lhs.info.id.GetUnderlying() < rhs.info.id.GetUnderlying();
+    return utils::response::ToChunkedResponse(
+        [storage_ptr](std::optional<models::DocumentId> after) {
+            return storage_ptr->List(after, kPageSize);
         });
-    return utils::response::ToResponse(std::move(documents));
 }
 
 } // namespace documents::handlers
@@ -0,0 +1,111 @@
+#include "upload.hpp"
+
+#include <string>
+
+#include <common/include/logging.hpp>
+#include <components/include/components_engine.hpp>
+#include <http/include/exceptions.hpp>
+#include <http/include/request_view.hpp>
+
+#include <components/storage.hpp>
+#include <models/document.hpp>
+#include <models/exceptions.hpp>
+#include <utils/response.hpp>
+
+namespace documents::handlers {
+
+namespace {
+
+std::string GetParam(const http::RequestView& view, std::string_view name, bool is_required) {
+    std::string buffer{};
+    const auto value_opt = view.GetParam(name, buffer);
+    if (!value_opt.has_value()) {
+        if (is_required) {
+            throw http::exceptions::BadRequest(common::format::Format(
+                "Parameter \'{}\' not found", name).c_str());
+        }
+        return std::string{};
+    }
+    return std::string(value_opt.value());
+}
+
+models::DocumentInput ParseHeader(const http::RequestHeader& header) {
+    const http::RequestView view(header);
+    models::DocumentInput document{};
+    document.name = GetParam(view, "name", true);
+    document.owner = GetParam(view, "owner", false);
+    document.namespace_name = GetParam(view, "namespace", false);
+    return document;
+}
+
+/// @class Writes the body to the storage as it arrives. The payload is
+/// discarded unless the document is stored.
+class UploadSink : public http::BodySink {
+public:
+    UploadSink(std::shared_ptr<components::Storage> storage_ptr,
+               models::DocumentInput&& document, fs_sink::PayloadWriter&& writer)
+        : storage_ptr_(std::move(storage_ptr)), document_(std::move(document)),
+          writer_opt_(std::move(writer)), error_(), is_too_large_(false) {}
+
+    ~UploadSink() override {
+        if (!writer_opt_.has_value()) {
+            return;
+        }
+        try {
+            storage_ptr_->DiscardUpload(std::move(writer_opt_.value()));
+        } catch (const std::exception& ex) {
+            LOG_ERROR() << "Cannot discard the payload upload: " << ex.what();
+        }
+    }
+
+    void Write(std::string_view data) override {
+        if (!error_.empty()) {
+            return;
+        }
+        try {
+            writer_opt_->Write(data);
+        } catch (const exceptions::PayloadTooLargeException& ex) {
+            error_ = ex.what();
+            is_too_large_ = true;
+        } catch (const std::exception& ex) {
+            error_ = ex.what();
+        }
+    }
+
+    http::Response Finish(http::Request&& /*request*/) override {
+        if (is_too_large_) {
+            LOG_WARNING() << "Payload upload rejected: " << error_;
+            throw http::exceptions::PayloadTooLarge("Payload too large");
+        }
+        if (!error_.empty()) {
+            LOG_ERROR() << "Payload upload failed: " << error_;
+            throw http::exceptions::ServerError("Payload upload failed");
+        }
+        auto stored = storage_ptr_->Add(std::move(document_), std::move(writer_opt_.value()));
+        writer_opt_.reset();
+        return utils::response::ToResponse(std::move(stored));
+    }
+
+private:
+    std::shared_ptr<components::Storage> storage_ptr_;
+    models::DocumentInput document_;
+    std::optional<fs_sink::PayloadWriter> writer_opt_;
+    std::string error_;
+    // a body of unknown size is over the space reserved for it
+    bool is_too_large_;
+};
+
+} // namespace
+
+http::BodySinkPtr make_upload_sink(const http::RequestHeader& header,
+                                   std::optional<uint64_t> content_length) {
+    // a request without the name is rejected before its body is sent
+    auto document = ParseHeader(header);
+    auto storage_ptr = ::components::ComponentsEngine::GetInstance()
+        .Get<components::Storage>();
+    auto writer = storage_ptr->BeginUpload(content_length);
+    return std::make_shared<UploadSink>(std::move(storage_ptr), std::move(document),
+                                        std::move(writer));
+}
+
+} // namespace documents::handlers
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include <http/include/models.hpp>
+
+namespace documents::handlers {
+
+/// @brief Makes a sink storing the raw request body as a new document payload.
+/// The name, owner and namespace query parameters are parsed from the header,
+/// so a request without the name is rejected before its body. The body is
+/// written right to the page file as it arrives, the document is created
+/// once the body is over.
+http::BodySinkPtr make_upload_sink(const http::RequestHeader& header,
+                                   std::optional<uint64_t> content_length);
+
+} // namespace documents::handlers
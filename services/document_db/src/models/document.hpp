@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -54,8 +55,9 @@ struct Document {
     std::optional<DocumentPayload> payload{};
 };
 
+/// @brief Documents info ordered by id, allows to list documents page by page
 using DocumentInfoMap = 
-    std::unordered_map<models::DocumentId, models::DocumentInfoPtr>;
+    std::map<models::DocumentId, models::DocumentInfoPtr>;
 
 void to_json(common::json::json& json, const Document& document);
 
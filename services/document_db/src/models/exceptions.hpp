@@ -34,6 +34,11 @@ public:
             "Missing required argument \'{}\'", argument_name)) {}
 };
 
+class PayloadTooLargeException : public Exception {
+public:
+    PayloadTooLargeException(const std::string& msg) : Exception(msg) {}
+};
+
 class FilesystemException : public Exception {
 public:
     FilesystemException(const std::string& msg = "Corrupted database files found") : Exception(msg) {}
@@ -1,28 +1,23 @@
 #include "request.hpp"
 
-#include <common/include/utils/algo.hpp>
+#include <cstdint>
+#include <optional>
+
 #include <http/include/exceptions.hpp>
-#include <http/include/utils.hpp>
+#include <http/include/request_view.hpp>
 
 namespace documents::utils::request {
 
 models::DocumentId GetId(const http::Request& request) {
-    auto params = http::utils::GetParams(request);
-    auto id_opt = common::utils::algo::GetOptional(params, "id");
+    const http::RequestView view(request);
+    auto id_opt = view.GetPathParamAs<uint64_t>("id");
     if (!id_opt.has_value()) {
-        throw http::exceptions::BadRequest("Parameter 'id' not found");
-    }
-
-    // negative numbers
-    if (id_opt->at(0) == '-') {
-        throw http::exceptions::BadRequest("Parameter 'id' is invalid");
+        id_opt = view.GetParamAs<uint64_t>("id");
     }
-    
-    try {
-        return models::DocumentId(std::stoul(id_opt.value().data()));
-    } catch (const std::logic_error& ex) {
-        throw http::exceptions::BadRequest("Parameter 'id' is invalid");
+    if (!id_opt.has_value()) {
+        throw http::exceptions::BadRequest("Parameter 'id' not found");
     }
+    return models::DocumentId(id_opt.value());
 }
 
 } // namespace documents::utils::request
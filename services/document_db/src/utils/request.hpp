@@ -6,7 +6,7 @@
 
 namespace documents::utils::request {
 
-/// @brief Gets id from request params.
+/// @brief Gets id from request path params or query params.
 models::DocumentId GetId(const http::Request& request);
 
 } // namespace documents::utils::request
@@ -1,5 +1,7 @@
 #include "response.hpp"
 
+#include <string_view>
+
 #include <common/include/format.hpp>
 #include <common/include/json.hpp>
 
@@ -22,6 +24,10 @@ common::json::json ToJson(models::Document&& document) {
     return data;
 }
 
+constexpr std::string_view kItemsBegin = "{\"items\":[";
+constexpr std::string_view kItemsEnd = "]}";
+constexpr char kItemsDelimiter = ',';
+
 } // namespace
 
 http::Response ToResponse(models::Document&& document) {
@@ -41,4 +47,35 @@ http::Response ToResponse(std::vector<models::Document>&& documents) {
     return response;
 }
 
+http::Response ToChunkedResponse(DocumentsPageFetcher&& fetch_page) {
+    http::Response response{};
+    response.SetChunkGenerator(
+        [fetch_page = std::move(fetch_page), last_id = std::optional<models::DocumentId>{},
+         is_begin = true, is_end = false](std::string& chunk) mutable {
+            if (is_end) {
+                return false;
+            }
+            if (is_begin) {
+                chunk.append(kItemsBegin);
+            }
+
+            auto documents = fetch_page(last_id);
+            for (auto& document : documents) {
+                if (last_id.has_value()) {
+                    chunk.push_back(kItemsDelimiter);
+                }
+                last_id = document.info.id;
+                chunk.append(ToJson(std::move(document)).dump());
+            }
+            is_begin = false;
+
+            if (documents.empty()) {
+                chunk.append(kItemsEnd);
+                is_end = true;
+            }
+            return true;
+        });
+    return response;
+}
+
 } // namespace documents::utils::response
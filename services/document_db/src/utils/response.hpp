@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+#include <optional>
 #include <vector>
 
 #include <http/include/models.hpp>
@@ -12,4 +14,16 @@ http::Response ToResponse(models::Document&& document);
 
 http::Response ToResponse(std::vector<models::Document>&& documents);
 
+/// @brief Fetches the page of documents following the specified id.
+/// Returns an empty page once there are no more documents.
+using DocumentsPageFetcher = std::function<
+    std::vector<models::Document>(std::optional<models::DocumentId> after)>;
+
+/// @brief Makes a chunked response with the same layout as ToResponse
+/// of a vector has. Serializes a single page of documents per chunk,
+/// so the memory does not depend on the number of documents. The pages
+/// are fetched while the response is sent, with the execution of the route,
+/// so a route fetching them from the storage must run on the worker pool.
+http::Response ToChunkedResponse(DocumentsPageFetcher&& fetch_page);
+
 } // namespace documents::utils::response
@@ -1,4 +1,7 @@
 
+import socket
+import time
+
 from utils.test_utils.mocks import MockAny
 from services.document_db.tests.conftest import DocumentDbService
 
@@ -121,6 +124,28 @@ def test_get(document_db: DocumentDbService):
     })
 
 
+def test_get_by_path(document_db: DocumentDbService):
+    doc = _create_document(document_db, payload='payload')
+    id = doc['id']
+    response = document_db.get(f'/api/v1/documents/{id}')
+    assert(response.status_code == 200)
+    assert(response.json() == {
+        'id': id,
+        'created': doc['created'],
+        'updated': doc['updated'],
+        'name': 'doc',
+        'owner': 'me',
+        'namespace': '',
+        'payload': 'payload',
+    })
+
+
+def test_get_by_path_bad_request(document_db: DocumentDbService):
+    response = document_db.get(f'/api/v1/documents/abc')
+    assert(response.status_code == 400)
+    assert(response.text == 'Parameter \'id\' is invalid')
+
+
 def test_get_missing(document_db: DocumentDbService):
     response = document_db.get(f'/api/v1/documents/get?id=0')
     assert(response.status_code == 404)
@@ -133,6 +158,173 @@ def test_get_bad_request(document_db: DocumentDbService):
     assert(response.text == 'Parameter \'id\' not found')
 
 
+def test_get_payload(document_db: DocumentDbService):
+    doc = _create_document(document_db, payload='raw payload')
+    id = doc['id']
+    response = document_db.get(f'/api/v1/documents/{id}/payload')
+    assert(response.status_code == 200)
+    assert(response.headers['Content-Type'] == 'application/octet-stream')
+    assert(response.text == 'raw payload')
+
+
+def test_get_payload_updated(document_db: DocumentDbService):
+    doc = _create_document(document_db, payload='payload')
+    id = doc['id']
+    payload = 'x' * 100000
+    response = document_db.post('/api/v1/documents/update', body={'id': id, 'payload': payload})
+    assert(response.status_code == 200)
+    response = document_db.get(f'/api/v1/documents/{id}/payload')
+    assert(response.status_code == 200)
+    assert(response.text == payload)
+
+
+def test_upload(document_db: DocumentDbService):
+    payload = b'x' * (3 * 1024 * 1024)
+    response = document_db.post_raw('/api/v1/documents/upload?name=doc&owner=me&namespace=local',
+                                    payload)
+    assert(response.status_code == 200)
+    doc = response.json()
+    assert(doc == {
+        'id': MockAny(),
+        'created': MockAny(),
+        'updated': MockAny(),
+        'name': 'doc',
+        'owner': 'me',
+        'namespace': 'local',
+    })
+    response = document_db.get(f'/api/v1/documents/{doc["id"]}/payload')
+    assert(response.status_code == 200)
+    assert(response.content == payload)
+
+
+def test_upload_chunked(document_db: DocumentDbService):
+    parts = [b'part%d;' % i * 1000 for i in range(100)]
+    response = document_db.post_raw('/api/v1/documents/upload?name=doc', (part for part in parts))
+    assert(response.status_code == 200)
+    id = response.json()['id']
+
+    # the next payloads take the rest of the page
+    doc = _create_document(document_db, payload='payload')
+    response = document_db.get(f'/api/v1/documents/{id}/payload')
+    assert(response.content == b''.join(parts))
+    response = document_db.get(f'/api/v1/documents/{doc["id"]}/payload')
+    assert(response.text == 'payload')
+
+
+def test_upload_chunked_clear(document_db: DocumentDbService):
+    # the storage is cleared and written to while the upload is in flight
+    created = []
+    def parts():
+        yield b'first;' * 1000
+        time.sleep(0.1)
+        response = document_db.post('/api/v1/documents/clear')
+        assert(response.status_code == 200)
+        created.append(_create_document(document_db, payload='payload'))
+        yield b'second;' * 1000
+
+    response = document_db.post_raw('/api/v1/documents/upload?name=doc', parts())
+    assert(response.status_code == 200)
+    response = document_db.get(f'/api/v1/documents/{response.json()["id"]}/payload')
+    assert(response.content == b'first;' * 1000 + b'second;' * 1000)
+    response = document_db.get(f'/api/v1/documents/{created[0]["id"]}/payload')
+    assert(response.text == 'payload')
+
+
+def test_upload_chunked_too_large(document_db: DocumentDbService):
+    # a body of unknown size may take a single page only
+    parts = [b'x' * (1024 * 1024) for _ in range(5)]
+    response = document_db.post_raw('/api/v1/documents/upload?name=doc', (part for part in parts))
+    assert(response.status_code == 413)
+    response = document_db.get('/api/v1/documents/list')
+    assert(response.json() == {'items': []})
+
+
+def test_upload_abandoned(document_db: DocumentDbService):
+    # the space reserved for the abandoned upload is given back to the next payloads
+    with socket.create_connection((document_db.host, document_db.port)) as connection:
+        connection.sendall(b'POST /api/v1/documents/upload?name=doc HTTP/1.1\r\n'
+                           b'Host: localhost\r\n'
+                           b'Content-Length: %d\r\n\r\n' % (3 * 1024 * 1024) + b'z' * 1024)
+        time.sleep(0.1)
+    doc = _create_document(document_db, payload='payload')
+    payload = b'x' * (3 * 1024 * 1024)
+    response = document_db.post_raw('/api/v1/documents/upload?name=doc', payload)
+    assert(response.status_code == 200)
+    response = document_db.get(f'/api/v1/documents/{response.json()["id"]}/payload')
+    assert(response.content == payload)
+    response = document_db.get(f'/api/v1/documents/{doc["id"]}/payload')
+    assert(response.text == 'payload')
+    response = document_db.get('/api/v1/documents/list')
+    assert(len(response.json()['items']) == 2)
+
+
+def test_upload_expect_continue(document_db: DocumentDbService):
+    payload = b'y' * 100000
+    response = document_db.post_raw('/api/v1/documents/upload?name=doc', payload,
+                                    headers={'Expect': '100-continue'})
+    assert(response.status_code == 200)
+    response = document_db.get(f'/api/v1/documents/{response.json()["id"]}/payload')
+    assert(response.content == payload)
+
+
+def test_upload_without_name(document_db: DocumentDbService):
+    response = document_db.post_raw('/api/v1/documents/upload', b'payload')
+    assert(response.status_code == 400)
+    assert(response.text == 'Parameter \'name\' not found')
+    response = document_db.get('/api/v1/documents/list')
+    assert(response.json() == {'items': []})
+
+
+def test_upload_without_name_expect_continue(document_db: DocumentDbService):
+    # the request is rejected by the header, the body is never sent
+    response = document_db.post_raw('/api/v1/documents/upload', b'payload',
+                                    headers={'Expect': '100-continue'})
+    assert(response.status_code == 400)
+
+
+def test_body_too_large(document_db: DocumentDbService):
+    response = document_db.post('/api/v1/documents/create', body={
+        'name': 'doc', 'owner': 'me', 'namespace': '', 'payload': 'x' * (2 * 1024 * 1024)})
+    assert(response.status_code == 413)
+
+
+def test_get_not_modified(document_db: DocumentDbService):
+    doc = _create_document(document_db, payload='payload')
+    id = doc['id']
+    response = document_db.get(f'/api/v1/documents/get?id={id}')
+    assert(response.status_code == 200)
+    etag = response.headers['ETag']
+    last_modified = response.headers['Last-Modified']
+
+    response = document_db.get(f'/api/v1/documents/get?id={id}', headers={'If-None-Match': etag})
+    assert(response.status_code == 304)
+    assert(response.headers['ETag'] == etag)
+    assert(response.text == '')
+    response = document_db.get(f'/api/v1/documents/{id}/payload', headers={'If-None-Match': etag})
+    assert(response.status_code == 304)
+    response = document_db.get(f'/api/v1/documents/{id}',
+                               headers={'If-Modified-Since': last_modified})
+    assert(response.status_code == 304)
+
+    response = document_db.post('/api/v1/documents/update', body={'id': id, 'name': 'new'})
+    assert(response.status_code == 200)
+    response = document_db.get(f'/api/v1/documents/get?id={id}', headers={'If-None-Match': etag})
+    assert(response.status_code == 200)
+    assert(response.headers['ETag'] != etag)
+    assert(response.json()['name'] == 'new')
+
+
+def test_get_not_modified_missing(document_db: DocumentDbService):
+    response = document_db.get('/api/v1/documents/get?id=0', headers={'If-None-Match': '*'})
+    assert(response.status_code == 404)
+
+
+def test_get_payload_missing(document_db: DocumentDbService):
+    response = document_db.get(f'/api/v1/documents/0/payload')
+    assert(response.status_code == 404)
+    assert(response.text == 'Document with id=\'0\' not found')
+
+
 def test_list_empty(document_db: DocumentDbService):
     response = document_db.get(f'/api/v1/documents/list')
     assert(response.status_code == 200)
@@ -151,6 +343,21 @@ def test_list(document_db: DocumentDbService):
     assert(response.json() == {'items': documents})
 
 
+def test_list_multiple_pages(document_db: DocumentDbService):
+    documents = [
+        _create_document(document_db, f'name{i}', 'owner', 'namespace', f'payload{i}')
+        for i in range(150)
+    ]
+    response = document_db.post(f'/api/v1/documents/delete', body={'id': documents[70]['id']})
+    assert(response.status_code == 200)
+    del documents[70]
+
+    response = document_db.get(f'/api/v1/documents/list')
+    assert(response.status_code == 200)
+    assert(response.headers['Transfer-Encoding'] == 'chunked')
+    assert(response.json() == {'items': documents})
+
+
 def test_update(document_db: DocumentDbService):
     document = _create_document(document_db)
     response = document_db.post(f'/api/v1/documents/update', body={
@@ -3,3 +3,36 @@ def test_ping(document_db):
     response = document_db.get('/ping')
     assert(response.status_code == 200)
     assert(response.text == 'OK')
+
+
+def test_limiter_state(document_db):
+    response = document_db.get('/server/limiter')
+    assert(response.status_code == 200)
+    state = response.json()
+    assert(state['connections'] >= 1)
+    assert(state['max_connections'] == 4096)
+    assert(state['in_flight'] >= 1)
+    assert(state['in_flight_limit'] >= 1)
+    assert(state['queue_size'] == 0)
+    assert(state['rejected_connections'] == 0)
+    assert(state['rejected_requests'] == 0)
+
+
+def test_compression(document_db):
+    for _ in range(20):
+        response = document_db.post('/api/v1/documents/create', body={
+            'name': 'document', 'owner': 'owner', 'namespace': 'namespace', 'payload': ''})
+        assert(response.status_code == 200)
+
+    # the test client accepts gzip and decompresses the body
+    response = document_db.get('/api/v1/documents/list')
+    assert(response.status_code == 200)
+    assert(response.headers['Content-Encoding'] == 'gzip')
+    assert(len(response.json()['items']) == 20)
+
+    response = document_db.get('/server/compression')
+    assert(response.status_code == 200)
+    stats = response.json()
+    assert(stats['responses'] >= 1)
+    assert(stats['output_bytes'] < stats['input_bytes'])
+    assert(stats['cpu_time_us'] >= 0)
@@ -4,9 +4,9 @@
 
 #include <common/include/logging.hpp>
 #include <common/include/json.hpp>
-#include <common/include/utils/algo.hpp>
 #include <components/include/components_engine.hpp>
 #include <http/include/exceptions.hpp>
+#include <http/include/request_view.hpp>
 #include <http/include/utils.hpp>
 
 #include <components/dict.hpp>
@@ -40,15 +40,15 @@ http::Response handle_dict_add(http::Request&& request) {
 
 http::Response handle_dict_get(http::Request&& request) {
     LOG_INFO() << "/test/dict-get";
-    const auto params = http::utils::GetParams(request);
-    auto key_opt = common::utils::algo::GetOptional(params, "key");
+    std::string buffer{};
+    const auto key_opt = http::RequestView(request).GetParam("key", buffer);
     if (!key_opt.has_value()) {
         throw http::exceptions::BadRequest("Missing required param \'key\'");
     }
     
     auto& engine = ::components::ComponentsEngine::GetInstance();
     auto dict_ptr = engine.Get<components::DummyDict>();
-    auto value_opt = dict_ptr->Get(key_opt.value());
+    auto value_opt = dict_ptr->Get(std::string(key_opt.value()));
     
     common::json::json json_data = {{"value", nullptr}};
     if (value_opt.has_value()) {
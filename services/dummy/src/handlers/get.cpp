@@ -2,7 +2,8 @@
 
 #include <common/include/logging.hpp>
 #include <common/include/json.hpp>
-#include <http/include/utils.hpp>
+#include <http/include/exceptions.hpp>
+#include <http/include/request_view.hpp>
 
 namespace dummy::handlers {
 
@@ -16,8 +17,16 @@ http::Response handle_get(http::Request&& request) {
 
 http::Response handle_get_parametrized(http::Request&& request) {
     LOG_INFO() << "/test/get_parametrized";
-    auto params = http::utils::GetParams(request);
-    common::json::json response_json = {{"params", params}};
+    common::json::json params = common::json::json::object();
+    std::string buffer{};
+    http::RequestView(request).ForEachParam(
+        [&params, &buffer](std::string_view name, std::string_view value) {
+            if (!http::PercentDecode(value, buffer)) {
+                throw http::exceptions::BadRequest("Bad request");
+            }
+            params[std::string(name)] = buffer;
+        });
+    common::json::json response_json = {{"params", std::move(params)}};
     http::Response response{};
     response.body() = response_json.dump();
     return response;
@@ -48,3 +48,20 @@ def test_post_bad_request(dummy_service, json):
     result = dummy_service.post('/post', json)
     assert(result.status_code == 400)
     assert(result.text == 'Bad request')
+
+
+def test_metrics(dummy_service):
+    for _ in range(3):
+        assert(dummy_service.get('/ping').status_code == 200)
+    dummy_service.get('/unknown')
+
+    response = dummy_service.metrics()
+    assert(response.status_code == 200)
+    assert(response.headers['Content-Type'].startswith('text/plain'))
+    lines = response.text.splitlines()
+    assert('# TYPE http_requests_total counter' in lines)
+    assert('# TYPE http_request_duration_seconds histogram' in lines)
+    ping_count = next(line for line in lines if line.startswith(
+        'http_requests_total{route="/ping",method="GET",status="200"}'))
+    assert(int(ping_count.split()[-1]) >= 3)
+    assert(any(line.startswith('http_requests_total{route="unmatched",') for line in lines))
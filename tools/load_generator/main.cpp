@@ -0,0 +1,108 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <common/include/format.hpp>
+#include <common/include/json.hpp>
+
+#include <generator.hpp>
+#include <report.hpp>
+#include <scenario.hpp>
+
+namespace {
+
+constexpr const char* kUsage =
+    "Usage: load_generator <scenario.json> [options]\n"
+    "Options override the scenario fields:\n"
+    "  --host <host>\n"
+    "  --port <port>\n"
+    "  --connections <count>   keep-alive connections\n"
+    "  --threads <count>       threads driving the connections\n"
+    "  --mode <closed|open>    closed or open (constant arrival rate) loop\n"
+    "  --rate <rps>            total requests per second of the open loop\n"
+    "  --duration <seconds>    measured interval\n"
+    "  --warmup <seconds>      interval before the measured one\n"
+    "  --json <path>           writes the report as JSON\n"
+    "  --hdr <path>            writes the HDR percentile distribution, ms\n";
+
+struct Arguments {
+    std::string scenario_path{};
+    common::json::json overrides = common::json::json::object();
+    std::string json_path{};
+    std::string hdr_path{};
+};
+
+Arguments ParseArguments(int argc, char* argv[]) {
+    if (argc < 2) {
+        throw std::invalid_argument("Scenario path is required");
+    }
+    Arguments arguments{};
+    arguments.scenario_path = argv[1];
+    for (int i = 2; i < argc; i += 2) {
+        const std::string name = argv[i];
+        if (i + 1 == argc) {
+            throw std::invalid_argument(common::format::Format("Option {} has no value", name));
+        }
+        const std::string value = argv[i + 1];
+        if (name == "--host" || name == "--mode") {
+            arguments.overrides[name.substr(2)] = value;
+        } else if (name == "--port" || name == "--connections" || name == "--threads") {
+            arguments.overrides[name.substr(2)] = std::stoul(value);
+        } else if (name == "--rate") {
+            arguments.overrides["rate"] = std::stod(value);
+        } else if (name == "--duration" || name == "--warmup") {
+            arguments.overrides[name.substr(2) + "_s"] = std::stod(value);
+        } else if (name == "--json") {
+            arguments.json_path = value;
+        } else if (name == "--hdr") {
+            arguments.hdr_path = value;
+        } else {
+            throw std::invalid_argument(common::format::Format("Unknown option {}", name));
+        }
+    }
+    return arguments;
+}
+
+void WriteFile(const std::string& path, const std::string& content) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error(common::format::Format("Cannot write \'{}\'", path));
+    }
+    file << content;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Arguments arguments{};
+    try {
+        arguments = ParseArguments(argc, argv);
+    } catch (const std::logic_error& ex) {
+        std::cerr << ex.what() << "\n" << kUsage;
+        return 2;
+    }
+
+    try {
+        const auto scenario = load_generator::LoadScenario(
+            arguments.scenario_path, arguments.overrides);
+        const auto variables = load_generator::RunSetup(scenario);
+        const auto report = load_generator::RunLoad(scenario, variables);
+
+        report.Print(std::cout);
+        if (!arguments.json_path.empty()) {
+            WriteFile(arguments.json_path, report.ToJson().dump(4));
+        }
+        if (!arguments.hdr_path.empty()) {
+            std::stringstream stream{};
+            report.stats.latency.PrintPercentiles(stream, 5, 1000.0);
+            WriteFile(arguments.hdr_path, stream.str());
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,313 @@
+#include "generator.hpp"
+
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include <common/include/format.hpp>
+#include <http/include/consts.hpp>
+#include <http/include/http_client.hpp>
+
+namespace load_generator {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Endpoints = boost::asio::ip::tcp::resolver::results_type;
+
+// delay of a reconnection, so a dead server is not flooded with connects
+constexpr auto kReconnectDelay = std::chrono::milliseconds(10);
+
+/// @struct Time frame of the load shared by the connections.
+struct Schedule {
+    Clock::time_point start;
+    // responses to the requests scheduled earlier are not recorded
+    Clock::time_point record_from;
+    Clock::time_point end;
+};
+
+http::Request MakeRequest(const Scenario& scenario, const RequestTemplate& request_template,
+                          const Variables& variables, const std::string& seq,
+                          std::mt19937& random) {
+    http::Request request{request_template.method,
+                          Render(request_template.target, variables, seq, random),
+                          http::consts::kVersion};
+    request.set(boost::beast::http::field::host, scenario.host);
+    for (const auto& [name, value] : request_template.headers) {
+        request.set(name, value);
+    }
+    if (!request_template.body.empty()) {
+        request.body() = Render(request_template.body, variables, seq, random);
+    }
+    request.keep_alive(true);
+    request.prepare_payload();
+    return request;
+}
+
+/**
+ * @class Keep-alive connection sending the scenario requests one at
+ * a time. In the closed loop the next request is sent right after the
+ * response. In the open loop the requests are scheduled with the fixed
+ * interval, a late request is sent immediately, and the latency is
+ * measured from its scheduled time.
+ */
+class Connection : public std::enable_shared_from_this<Connection> {
+public:
+    Connection(boost::asio::io_context& context, const Scenario& scenario,
+               const Variables& variables, const Endpoints& endpoints,
+               const Schedule& schedule, size_t index, Stats& stats)
+        : scenario_{scenario}, variables_{variables}, endpoints_{endpoints},
+          schedule_{schedule}, index_{index}, stats_{stats},
+          stream_{context}, timer_{context}, buffer_{}, request_{}, response_{},
+          random_{static_cast<std::mt19937::result_type>(index)}, distribution_{},
+          interval_{}, scheduled_time_{schedule.start}, sequence_{0} {
+        std::vector<double> weights{};
+        for (const auto& request : scenario.requests) {
+            weights.push_back(static_cast<double>(request.weight));
+        }
+        distribution_ = std::discrete_distribution<size_t>(weights.begin(), weights.end());
+        if (scenario.mode == Mode::Open) {
+            interval_ = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(scenario.connections / scenario.rate));
+            // spread the connections evenly over the interval
+            scheduled_time_ += interval_ * index / scenario.connections;
+        }
+    }
+
+    void Start() {
+        Connect();
+    }
+
+private:
+    void Connect() {
+        stream_.expires_after(scenario_.timeout);
+        stream_.async_connect(endpoints_, boost::beast::bind_front_handler(
+            &Connection::OnConnected, shared_from_this()));
+    }
+
+    void OnConnected(const boost::system::error_code& error_code,
+                     const boost::asio::ip::tcp::endpoint&) {
+        if (error_code) {
+            Fail(error_code, Clock::now());
+            return;
+        }
+        stats_.connects++;
+        if (scenario_.mode == Mode::Closed) {
+            scheduled_time_ = Clock::now();
+        }
+        SendScheduled();
+    }
+
+    void SendScheduled() {
+        if (scheduled_time_ >= schedule_.end) {
+            Close();
+            return;
+        }
+        if (scheduled_time_ <= Clock::now()) {
+            Send();
+            return;
+        }
+        timer_.expires_at(scheduled_time_);
+        timer_.async_wait([self_ptr = shared_from_this()](
+                const boost::system::error_code& error_code) {
+            if (!error_code) {
+                self_ptr->Send();
+            }
+        });
+    }
+
+    void Send() {
+        request_index_ = distribution_(random_);
+        const auto seq = common::format::Format("{}-{}", index_, sequence_++);
+        request_ = MakeRequest(scenario_, scenario_.requests[request_index_], variables_,
+                               seq, random_);
+        stream_.expires_after(scenario_.timeout);
+        boost::beast::http::async_write(stream_, request_, boost::beast::bind_front_handler(
+            &Connection::OnWritten, shared_from_this()));
+    }
+
+    void OnWritten(const boost::system::error_code& error_code, size_t) {
+        if (error_code) {
+            Fail(error_code, scheduled_time_);
+            return;
+        }
+        response_ = http::Response{};
+        boost::beast::http::async_read(stream_, buffer_, response_,
+            boost::beast::bind_front_handler(&Connection::OnRead, shared_from_this()));
+    }
+
+    void OnRead(const boost::system::error_code& error_code, size_t size) {
+        if (error_code) {
+            Fail(error_code, scheduled_time_);
+            return;
+        }
+        const auto now = Clock::now();
+        if (scheduled_time_ >= schedule_.record_from) {
+            const auto latency_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                now - scheduled_time_).count();
+            stats_.latency.Record(latency_us);
+            stats_.request_latencies[request_index_].Record(latency_us);
+            stats_.statuses[std::min<size_t>(response_.result_int() / 100,
+                                             stats_.statuses.size() - 1)]++;
+            stats_.bytes_received += size;
+        }
+
+        scheduled_time_ = scenario_.mode == Mode::Open ? scheduled_time_ + interval_ : now;
+        if (!response_.keep_alive()) {
+            Reconnect();
+            return;
+        }
+        SendScheduled();
+    }
+
+    /// @param scheduled_time time the failed request was scheduled at
+    void Fail(const boost::system::error_code& error_code, Clock::time_point scheduled_time) {
+        if (scheduled_time >= schedule_.record_from && scheduled_time < schedule_.end) {
+            if (error_code == boost::beast::error::timeout) {
+                stats_.timeouts++;
+            } else {
+                stats_.errors++;
+            }
+        }
+        if (scenario_.mode == Mode::Open) {
+            // the missed request is not retried, the schedule goes on
+            scheduled_time_ += interval_;
+        }
+        Reconnect();
+    }
+
+    void Reconnect() {
+        Close();
+        if (Clock::now() >= schedule_.end) {
+            return;
+        }
+        timer_.expires_after(kReconnectDelay);
+        timer_.async_wait([self_ptr = shared_from_this()](
+                const boost::system::error_code& error_code) {
+            if (!error_code) {
+                self_ptr->Connect();
+            }
+        });
+    }
+
+    void Close() {
+        boost::system::error_code error_code{};
+        stream_.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, error_code);
+        stream_.close();
+        buffer_.clear();
+    }
+
+    const Scenario& scenario_;
+    const Variables& variables_;
+    const Endpoints& endpoints_;
+    const Schedule& schedule_;
+    const size_t index_;
+    Stats& stats_;
+
+    boost::beast::tcp_stream stream_;
+    boost::asio::steady_timer timer_;
+    boost::beast::flat_buffer buffer_;
+    http::Request request_;
+    http::Response response_;
+    size_t request_index_{};
+
+    std::mt19937 random_;
+    std::discrete_distribution<size_t> distribution_;
+    Clock::duration interval_;
+    Clock::time_point scheduled_time_;
+    size_t sequence_;
+};
+
+Endpoints Resolve(const Scenario& scenario) {
+    boost::asio::io_context context{};
+    boost::asio::ip::tcp::resolver resolver(context);
+    try {
+        return resolver.resolve(scenario.host, std::to_string(scenario.port));
+    } catch (const boost::system::system_error& ex) {
+        throw std::runtime_error(common::format::Format(
+            "Cannot resolve host \'{}\': {}", scenario.host, ex.what()));
+    }
+}
+
+std::string ToCapturedValue(const common::json::json& value) {
+    return value.is_string() ? value.get<std::string>() : value.dump();
+}
+
+} // namespace
+
+Variables RunSetup(const Scenario& scenario) {
+    Variables variables{};
+    std::mt19937 random{};
+    http::client::HttpClient client(scenario.host, scenario.port);
+    size_t sequence = 0;
+    for (const auto& step : scenario.setup) {
+        for (size_t i = 0; i < step.repeat; i++) {
+            const auto seq = common::format::Format("setup-{}", sequence++);
+            const auto request = MakeRequest(scenario, step.request, variables, seq, random);
+            const auto response = client.Request(request);
+            if (response.result_int() / 100 != 2) {
+                throw std::runtime_error(common::format::Format(
+                    "Setup request \'{}\' failed with status {}: {}", step.request.name,
+                    response.result_int(), response.body()));
+            }
+            if (!step.capture.has_value()) {
+                continue;
+            }
+            try {
+                const auto data = common::json::json::parse(response.body());
+                variables[step.capture.value()].push_back(
+                    ToCapturedValue(data.at(step.capture.value())));
+            } catch (const common::json::detail::exception& ex) {
+                throw std::runtime_error(common::format::Format(
+                    "Cannot capture \'{}\' of setup request \'{}\': {}",
+                    step.capture.value(), step.request.name, ex.what()));
+            }
+        }
+    }
+    return variables;
+}
+
+Report RunLoad(const Scenario& scenario, const Variables& variables) {
+    const auto endpoints = Resolve(scenario);
+    const auto start = Clock::now();
+    const Schedule schedule{
+        start, // start
+        start + scenario.warmup, // record_from
+        start + scenario.warmup + scenario.duration, // end
+    };
+
+    std::vector<std::unique_ptr<boost::asio::io_context>> contexts{};
+    std::vector<Stats> stats(scenario.threads, Stats(scenario.requests.size()));
+    for (size_t i = 0; i < scenario.threads; i++) {
+        contexts.push_back(std::make_unique<boost::asio::io_context>(1));
+    }
+    for (size_t i = 0; i < scenario.connections; i++) {
+        const auto thread_index = i % scenario.threads;
+        std::make_shared<Connection>(*contexts[thread_index], scenario, variables, endpoints,
+                                     schedule, i, stats[thread_index])->Start();
+    }
+
+    // every context runs out of work once its connections are done
+    std::vector<std::thread> threads{};
+    for (auto& context_ptr : contexts) {
+        threads.emplace_back([&context = *context_ptr] { context.run(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    Report report{scenario, Stats(scenario.requests.size()), scenario.duration};
+    for (const auto& thread_stats : stats) {
+        report.stats.Merge(thread_stats);
+    }
+    return report;
+}
+
+} // namespace load_generator
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <report.hpp>
+#include <scenario.hpp>
+
+namespace load_generator {
+
+/// @brief Sends the setup requests of the scenario one by one
+/// and collects the captured variables.
+/// @throws std::runtime_error if a request fails
+Variables RunSetup(const Scenario& scenario);
+
+/**
+ * @brief Drives the scenario requests over the keep-alive connections
+ * spread over the threads, blocks until the scenario duration is over.
+ * Every thread runs its own I/O context, the connections of a thread
+ * record into the thread stats, merged once the load is done.
+ * @throws std::runtime_error if the host cannot be resolved
+ */
+Report RunLoad(const Scenario& scenario, const Variables& variables);
+
+} // namespace load_generator
@@ -0,0 +1,132 @@
+#include "report.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+namespace load_generator {
+
+namespace {
+
+constexpr int64_t kLowestLatencyUs = 1;
+constexpr int64_t kHighestLatencyUs = 60LL * 1000 * 1000;
+constexpr int kSignificantDigits = 3;
+constexpr double kUsPerMs = 1000.0;
+
+constexpr std::array<double, 6> kPercentiles = {50.0, 75.0, 90.0, 99.0, 99.9, 99.99};
+
+std::string ToString(double percentile) {
+    std::stringstream stream{};
+    stream << "p" << percentile;
+    return stream.str();
+}
+
+void PrintLatencies(std::ostream& stream, const common::metrics::HdrHistogram& histogram) {
+    for (const auto percentile : kPercentiles) {
+        stream << std::setw(10) << histogram.GetValueAtPercentile(percentile) / kUsPerMs;
+    }
+    stream << std::setw(10) << histogram.GetMax() / kUsPerMs << "\n";
+}
+
+common::json::json HistogramToJson(const common::metrics::HdrHistogram& histogram) {
+    common::json::json data = {
+        {"count", histogram.GetTotalCount()},
+        {"min_ms", histogram.GetMin() / kUsPerMs},
+        {"mean_ms", histogram.GetMean() / kUsPerMs},
+        {"max_ms", histogram.GetMax() / kUsPerMs},
+    };
+    for (const auto percentile : kPercentiles) {
+        data[ToString(percentile) + "_ms"] = histogram.GetValueAtPercentile(percentile) / kUsPerMs;
+    }
+    return data;
+}
+
+} // namespace
+
+common::metrics::HdrHistogram MakeLatencyHistogram() {
+    return common::metrics::HdrHistogram(kLowestLatencyUs, kHighestLatencyUs, kSignificantDigits);
+}
+
+Stats::Stats(size_t requests_count)
+    : latency{MakeLatencyHistogram()},
+      request_latencies(requests_count, MakeLatencyHistogram()),
+      statuses{}, errors{0}, timeouts{0}, connects{0}, bytes_received{0} {}
+
+void Stats::Merge(const Stats& other) {
+    latency.Merge(other.latency);
+    for (size_t i = 0; i < request_latencies.size(); i++) {
+        request_latencies[i].Merge(other.request_latencies[i]);
+    }
+    for (size_t i = 0; i < statuses.size(); i++) {
+        statuses[i] += other.statuses[i];
+    }
+    errors += other.errors;
+    timeouts += other.timeouts;
+    connects += other.connects;
+    bytes_received += other.bytes_received;
+}
+
+double Report::GetThroughput() const {
+    return elapsed.count() > 0.0 ? stats.latency.GetTotalCount() / elapsed.count() : 0.0;
+}
+
+void Report::Print(std::ostream& stream) const {
+    const auto flags = stream.flags();
+    stream << std::fixed << std::setprecision(2);
+    stream << "Scenario: " << scenario.name << " (" << scenario.host << ":" << scenario.port
+           << ")\n";
+    stream << "Mode: " << (scenario.mode == Mode::Open ? "open loop" : "closed loop");
+    if (scenario.mode == Mode::Open) {
+        stream << ", target rate " << scenario.rate << " rps";
+    }
+    stream << ", " << scenario.connections << " connections, " << scenario.threads
+           << " threads\n";
+    stream << "Duration: " << elapsed.count() << " s\n";
+    stream << "Throughput: " << GetThroughput() << " rps, "
+           << stats.bytes_received / elapsed.count() / 1024 / 1024 << " MB/s\n";
+    stream << "Responses:";
+    for (size_t i = 1; i < stats.statuses.size(); i++) {
+        stream << " " << i << "xx=" << stats.statuses[i];
+    }
+    stream << ", errors=" << stats.errors << ", timeouts=" << stats.timeouts
+           << ", connects=" << stats.connects << "\n\n";
+
+    stream << "Latency, ms" << std::string(21, ' ');
+    for (const auto percentile : kPercentiles) {
+        stream << std::setw(10) << ToString(percentile);
+    }
+    stream << std::setw(10) << "max" << "\n";
+    stream << std::left << std::setw(32) << "all" << std::right;
+    PrintLatencies(stream, stats.latency);
+    for (size_t i = 0; i < scenario.requests.size(); i++) {
+        stream << std::left << std::setw(32) << scenario.requests[i].name << std::right;
+        PrintLatencies(stream, stats.request_latencies[i]);
+    }
+    stream.flags(flags);
+}
+
+common::json::json Report::ToJson() const {
+    common::json::json requests = common::json::json::object();
+    for (size_t i = 0; i < scenario.requests.size(); i++) {
+        requests[scenario.requests[i].name] = HistogramToJson(stats.request_latencies[i]);
+    }
+    common::json::json statuses = common::json::json::object();
+    for (size_t i = 1; i < stats.statuses.size(); i++) {
+        statuses[std::to_string(i) + "xx"] = stats.statuses[i];
+    }
+    return {
+        {"scenario", scenario.name},
+        {"mode", scenario.mode == Mode::Open ? "open" : "closed"},
+        {"connections", scenario.connections},
+        {"duration_s", elapsed.count()},
+        {"throughput_rps", GetThroughput()},
+        {"bytes_received", stats.bytes_received},
+        {"statuses", std::move(statuses)},
+        {"errors", stats.errors},
+        {"timeouts", stats.timeouts},
+        {"connects", stats.connects},
+        {"latency", HistogramToJson(stats.latency)},
+        {"requests", std::move(requests)},
+    };
+}
+
+} // namespace load_generator
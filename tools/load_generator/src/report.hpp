@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <common/include/hdr_histogram.hpp>
+#include <common/include/json.hpp>
+
+#include <scenario.hpp>
+
+namespace load_generator {
+
+/// @brief Latency histogram in microseconds, up to a minute with 3 digits.
+common::metrics::HdrHistogram MakeLatencyHistogram();
+
+/// @struct Results of a load thread, merged into the report.
+struct Stats {
+    explicit Stats(size_t requests_count);
+
+    void Merge(const Stats& other);
+
+    common::metrics::HdrHistogram latency;
+    // per request of the scenario
+    std::vector<common::metrics::HdrHistogram> request_latencies;
+    // responses by the status class, 1xx to 5xx
+    std::array<uint64_t, 6> statuses;
+    uint64_t errors;
+    uint64_t timeouts;
+    uint64_t connects;
+    uint64_t bytes_received;
+};
+
+struct Report {
+    const Scenario& scenario;
+    Stats stats;
+    // of the measured interval, excluding the warmup
+    std::chrono::duration<double> elapsed;
+
+    double GetThroughput() const;
+    void Print(std::ostream& stream) const;
+    common::json::json ToJson() const;
+};
+
+} // namespace load_generator
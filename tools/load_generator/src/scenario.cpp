@@ -0,0 +1,170 @@
+#include "scenario.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <stdexcept>
+
+#include <common/include/format.hpp>
+
+namespace load_generator {
+
+namespace {
+
+constexpr const char* kSeqVariable = "seq";
+
+http::Method ParseMethod(const std::string& name) {
+    const auto method = boost::beast::http::string_to_verb(name);
+    if (method == http::Method::unknown) {
+        throw std::runtime_error(common::format::Format("Unknown HTTP method \'{}\'", name));
+    }
+    return method;
+}
+
+Mode ParseMode(const std::string& name) {
+    if (name == "closed") {
+        return Mode::Closed;
+    }
+    if (name == "open") {
+        return Mode::Open;
+    }
+    throw std::runtime_error(common::format::Format(
+        "Unknown mode \'{}\', expected \'closed\' or \'open\'", name));
+}
+
+RequestTemplate ParseRequest(const common::json::json& data) {
+    RequestTemplate request{};
+    request.target = data.at("target").get<std::string>();
+    request.name = data.value("name", request.target);
+    request.method = ParseMethod(data.value("method", "GET"));
+    request.body = data.value("body", "");
+    request.weight = data.value("weight", request.weight);
+    if (const auto it = data.find("headers"); it != data.end()) {
+        for (const auto& [name, value] : it->items()) {
+            request.headers.emplace_back(name, value.get<std::string>());
+        }
+    }
+    return request;
+}
+
+std::chrono::milliseconds ParseSeconds(const common::json::json& data, const char* key,
+                                       std::chrono::milliseconds default_value) {
+    const auto seconds = data.value(key, std::chrono::duration<double>(default_value).count());
+    return std::chrono::milliseconds(static_cast<int64_t>(seconds * 1000));
+}
+
+bool IsVariableName(const std::string& name) {
+    return !name.empty() && std::all_of(name.begin(), name.end(), [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    });
+}
+
+} // namespace
+
+Scenario ParseScenario(const common::json::json& data) {
+    try {
+        Scenario scenario{};
+        scenario.name = data.value("name", scenario.name);
+        scenario.host = data.value("host", scenario.host);
+        scenario.port = data.value("port", scenario.port);
+        scenario.connections = data.value("connections", scenario.connections);
+        scenario.threads = data.value("threads", scenario.threads);
+        scenario.mode = ParseMode(data.value("mode", "closed"));
+        scenario.rate = data.value("rate", scenario.rate);
+        scenario.duration = ParseSeconds(data, "duration_s", scenario.duration);
+        scenario.warmup = ParseSeconds(data, "warmup_s", scenario.warmup);
+        scenario.timeout = std::chrono::milliseconds(
+            data.value("timeout_ms", scenario.timeout.count()));
+        if (const auto it = data.find("setup"); it != data.end()) {
+            for (const auto& step_data : *it) {
+                SetupStep step{};
+                step.request = ParseRequest(step_data);
+                step.repeat = step_data.value("repeat", step.repeat);
+                if (const auto capture_it = step_data.find("capture");
+                    capture_it != step_data.end()) {
+                    step.capture = capture_it->get<std::string>();
+                }
+                scenario.setup.push_back(std::move(step));
+            }
+        }
+        for (const auto& request_data : data.at("requests")) {
+            scenario.requests.push_back(ParseRequest(request_data));
+        }
+
+        if (scenario.requests.empty()) {
+            throw std::runtime_error("Scenario has no requests");
+        }
+        if (std::all_of(scenario.requests.begin(), scenario.requests.end(),
+                        [](const auto& request) { return request.weight == 0; })) {
+            throw std::runtime_error("Scenario requests have zero weights");
+        }
+        if (scenario.connections == 0 || scenario.threads == 0) {
+            throw std::runtime_error("Connections and threads count must be positive");
+        }
+        if (scenario.mode == Mode::Open && scenario.rate <= 0.0) {
+            throw std::runtime_error("Open loop rate must be positive");
+        }
+        return scenario;
+    } catch (const common::json::detail::exception& ex) {
+        throw std::runtime_error(common::format::Format("Invalid scenario: {}", ex.what()));
+    }
+}
+
+Scenario LoadScenario(const std::string& path, const common::json::json& overrides) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error(common::format::Format("Cannot open scenario \'{}\'", path));
+    }
+    common::json::json data{};
+    try {
+        data = common::json::json::parse(file);
+    } catch (const common::json::detail::exception& ex) {
+        throw std::runtime_error(common::format::Format(
+            "Cannot parse scenario \'{}\': {}", path, ex.what()));
+    }
+    data.update(overrides);
+    return ParseScenario(data);
+}
+
+std::string Render(const std::string& text, const Variables& variables, const std::string& seq,
+                   std::mt19937& random) {
+    std::string result{};
+    result.reserve(text.size());
+    size_t position = 0;
+    while (position < text.size()) {
+        const auto begin = text.find('{', position);
+        if (begin == std::string::npos) {
+            break;
+        }
+        const auto end = text.find('}', begin);
+        if (end == std::string::npos) {
+            break;
+        }
+        const auto name = text.substr(begin + 1, end - begin - 1);
+        result.append(text, position, begin - position);
+        position = begin + 1;
+        // JSON bodies contain braces, only the known names are substituted
+        if (!IsVariableName(name)) {
+            result.push_back('{');
+            continue;
+        }
+        if (name == kSeqVariable) {
+            result += seq;
+        } else if (const auto it = variables.find(name); it != variables.end()) {
+            if (it->second.empty()) {
+                throw std::runtime_error(common::format::Format(
+                    "Variable \'{}\' has no values", name));
+            }
+            std::uniform_int_distribution<size_t> distribution(0, it->second.size() - 1);
+            result += it->second[distribution(random)];
+        } else {
+            result.push_back('{');
+            continue;
+        }
+        position = end + 1;
+    }
+    result.append(text, position, std::string::npos);
+    return result;
+}
+
+} // namespace load_generator
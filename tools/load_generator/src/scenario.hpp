@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <common/include/json.hpp>
+#include <http/include/models.hpp>
+
+namespace load_generator {
+
+/// @brief Closed loop sends the next request of a connection once the
+/// previous response arrives. Open loop sends the requests at a constant
+/// rate regardless of the responses, the latency is measured from the
+/// scheduled send time, so the queueing delays are not hidden.
+enum class Mode {
+    Closed,
+    Open,
+};
+
+/// @struct Request of a scenario. The target and the body may refer
+/// to the variables as {name}, {seq} is unique within a run.
+struct RequestTemplate {
+    std::string name{};
+    http::Method method{http::Method::get};
+    std::string target{};
+    std::string body{};
+    std::vector<std::pair<std::string, std::string>> headers{};
+    // relative frequency of the request in the mix
+    size_t weight{1};
+};
+
+/// @struct Request sent once before the load, e.g. to fill the storage.
+struct SetupStep {
+    RequestTemplate request{};
+    size_t repeat{1};
+    // field of the JSON response collected into the variable of the same name
+    std::optional<std::string> capture{};
+};
+
+struct Scenario {
+    std::string name{};
+    std::string host{"127.0.0.1"};
+    unsigned short port{80};
+    size_t connections{16};
+    size_t threads{1};
+    Mode mode{Mode::Closed};
+    // requests per second of all the connections, open loop only
+    double rate{1000.0};
+    std::chrono::milliseconds duration{std::chrono::seconds(10)};
+    // responses are not recorded meanwhile
+    std::chrono::milliseconds warmup{std::chrono::seconds(1)};
+    std::chrono::milliseconds timeout{std::chrono::seconds(5)};
+    std::vector<SetupStep> setup{};
+    std::vector<RequestTemplate> requests{};
+};
+
+/// @brief Values of the variables captured by the setup.
+using Variables = std::unordered_map<std::string, std::vector<std::string>>;
+
+/// @throws std::runtime_error if the scenario is invalid
+Scenario ParseScenario(const common::json::json& data);
+
+/// @brief Reads the scenario JSON file, the overrides replace its fields.
+/// @throws std::runtime_error if the file cannot be read or is invalid
+Scenario LoadScenario(const std::string& path, const common::json::json& overrides);
+
+/// @brief Substitutes {name} of the variables with their random values
+/// and {seq} with the sequence number.
+/// @throws std::runtime_error if a variable has no values
+std::string Render(const std::string& text, const Variables& variables, const std::string& seq,
+                   std::mt19937& random);
+
+} // namespace load_generator
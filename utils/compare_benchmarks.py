@@ -0,0 +1,58 @@
+"""Compares two google benchmark JSON outputs.
+
+Usage: compare_benchmarks.py <baseline.json> <contender.json> [--threshold PERCENT]
+Prints the time change of every benchmark present in both files. Exits
+with 1 if a benchmark got slower by more than the threshold.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as file:
+        data = json.load(file)
+    results = {}
+    for benchmark in data['benchmarks']:
+        # repetitions are reduced to the mean if aggregates are present
+        if benchmark.get('run_type') == 'aggregate' and benchmark.get('aggregate_name') != 'mean':
+            continue
+        name = benchmark.get('run_name', benchmark['name'])
+        results[name] = benchmark
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('baseline')
+    parser.add_argument('contender')
+    parser.add_argument('--threshold', type=float, default=10.0,
+                        help='regression threshold, percents of the baseline time')
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    contender = load(args.contender)
+    regressions = []
+    print(f'{"Benchmark":<60} {"Baseline":>14} {"Contender":>14} {"Change":>9}')
+    for name, result in contender.items():
+        if name not in baseline:
+            continue
+        before = baseline[name]['real_time']
+        after = result['real_time']
+        change = (after - before) / before * 100 if before else 0.0
+        unit = result.get('time_unit', 'ns')
+        print(f'{name:<60} {before:>11.1f} {unit} {after:>11.1f} {unit} {change:>+8.1f}%')
+        if change > args.threshold:
+            regressions.append(name)
+
+    if regressions:
+        print(f'\n{len(regressions)} benchmarks regressed by more than {args.threshold}%:')
+        for name in regressions:
+            print(f'  {name}')
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
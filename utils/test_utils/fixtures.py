@@ -30,12 +30,19 @@ class ServiceBase(ABC):
     def make_uri(self, address: str, path: str):
         return 'http://' + address + ('' if path.startswith('/') else '') + path
 
-    def get(self, path: str) -> requests.Response:
-        return requests.get(self.make_uri(self.address, path))
+    def get(self, path: str, headers: Optional[dict] = None) -> requests.Response:
+        return requests.get(self.make_uri(self.address, path), headers=headers)
 
     def post(self, path: str, body: dict = {}) -> requests.Response:
         return requests.post(self.make_uri(self.address, path), json=body)
 
+    def post_raw(self, path: str, data: Any, headers: Optional[dict] = None) -> requests.Response:
+        """
+        Post a raw body. A generator is sent with the chunked transfer encoding.
+        """
+
+        return requests.post(self.make_uri(self.address, path), data=data, headers=headers)
+
     def reset(self, component_name: Optional[str] = None):
         """
         Reset service components system state. If component name is specified - clears the component state.
@@ -46,6 +53,13 @@ class ServiceBase(ABC):
             body['component_name'] = component_name
         return requests.post(self.make_uri(self.test_address, '/test-control/reset'), json=body)
 
+    def metrics(self) -> requests.Response:
+        """
+        Get service metrics in the Prometheus text format.
+        """
+
+        return requests.get(self.make_uri(self.test_address, '/metrics'))
+
 
 class FactoryBase(ABC):
     """